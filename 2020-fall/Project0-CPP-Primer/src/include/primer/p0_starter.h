@@ -12,12 +12,40 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <type_traits>
 #include <utility>
+#include <vector>
 #include "../common/logger.h"
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+// LowPrecisionOperations has AVX2 and AVX-512 kernels, picked at run time
+#define BUSTUB_LOW_PRECISION_SIMD
+#endif
+
 namespace bustub {
 
+template <typename T>
+class MatrixOperations;
+class LowPrecisionOperations;
+
+// How the elements of a Matrix are laid out in its linear array
+enum class MatrixLayout {
+  // Row after row: RowMatrix
+  ROW_MAJOR,
+  // Column after column: ColMatrix
+  COLUMN_MAJOR,
+  // Square row-major tiles in Z-order: BlockedMatrix
+  BLOCKED,
+};
+
 /*
  * The base class defining a Matrix
  */
@@ -48,9 +76,12 @@ class Matrix {
   // Sets the (i,j)th  matrix element to val
   virtual void SetElem(int i, int j, T val) = 0;
 
-  // Sets the matrix elements based on the array arr
+  // Sets the matrix elements based on the array arr, in row-major order
   virtual void MatImport(T *arr) = 0;
 
+  // Return how the elements are laid out in linear
+  virtual MatrixLayout GetLayout() = 0;
+
   // TODO(P0): Add implementation
   virtual ~Matrix() {
     delete[] this->linear;
@@ -58,6 +89,11 @@ class Matrix {
     this->rows = 0;
     this->cols = 0;
   }
+
+ private:
+  template <typename U>
+  friend class MatrixOperations;
+  friend class LowPrecisionOperations;
 };
 
 template <typename T>
@@ -91,6 +127,8 @@ class RowMatrix : public Matrix<T> {
     }
   }
 
+  MatrixLayout GetLayout() override { return MatrixLayout::ROW_MAJOR; }
+
   // TODO(P0): Add implementation
   ~RowMatrix() override {
     delete[] this->data_;
@@ -105,6 +143,451 @@ class RowMatrix : public Matrix<T> {
   T **data_;
 };
 
+/*
+ * A matrix stored column after column. As the second operand of a multiply it is read along its columns, which are
+ * contiguous.
+ */
+template <typename T>
+class ColMatrix : public Matrix<T> {
+ public:
+  ColMatrix(int r, int c) : Matrix<T>(r, c), data_(new T *[c]) {
+    for (int j = 0; j < c; ++j) {
+      this->data_[j] = this->linear + j * r;
+    }
+  }
+
+  int GetRows() override { return this->rows; }
+
+  int GetColumns() override { return this->cols; }
+
+  T GetElem(int i, int j) override { return this->data_[j][i]; }
+
+  void SetElem(int i, int j, T val) override { this->data_[j][i] = val; }
+
+  void MatImport(T *arr) override {
+    MatrixOperations<T>::Transpose(arr, this->cols, this->linear, this->rows, this->rows, this->cols);
+  }
+
+  MatrixLayout GetLayout() override { return MatrixLayout::COLUMN_MAJOR; }
+
+  ~ColMatrix() override {
+    delete[] this->data_;
+    this->data_ = nullptr;
+  }
+
+ private:
+  // Column pointers into the linear array
+  T **data_;
+};
+
+/*
+ * A matrix stored as square tiles of BLOCK x BLOCK elements, the last row and column of tiles being cut to the
+ * dimensions of the matrix. A tile is row-major and contiguous, and the tiles follow each other in Z-order (the bits
+ * of the tile row and column interleaved), so that the tiles of any square quadrant of the matrix are close together
+ * at every scale. A multiply on blocked matrices works on a few tiles at a time, which stay in the cache.
+ */
+template <typename T>
+class BlockedMatrix : public Matrix<T> {
+ public:
+  // Elements on a side of a tile; three float tiles take 12KB and fit the L1 cache
+  static constexpr int BLOCK = 32;
+
+  BlockedMatrix(int r, int c)
+      : Matrix<T>(r, c),
+        tile_rows_((r + BLOCK - 1) / BLOCK),
+        tile_cols_((c + BLOCK - 1) / BLOCK),
+        tile_offset_(static_cast<size_t>(tile_rows_) * tile_cols_) {
+    std::vector<std::pair<uint64_t, int>> order(tile_offset_.size());
+    for (int t = 0; t < static_cast<int>(order.size()); ++t) {
+      order[t] = {Morton(t / tile_cols_, t % tile_cols_), t};
+    }
+    std::sort(order.begin(), order.end());
+    int offset = 0;
+    for (const auto &[key, t] : order) {
+      this->tile_offset_[t] = offset;
+      offset += TileRows(t / tile_cols_) * TileColumns(t % tile_cols_);
+    }
+  }
+
+  int GetRows() override { return this->rows; }
+
+  int GetColumns() override { return this->cols; }
+
+  T GetElem(int i, int j) override { return this->linear[Offset(i, j)]; }
+
+  void SetElem(int i, int j, T val) override { this->linear[Offset(i, j)] = val; }
+
+  void MatImport(T *arr) override {
+    for (int ti = 0; ti < tile_rows_; ++ti) {
+      for (int tj = 0; tj < tile_cols_; ++tj) {
+        T *tile = Tile(ti, tj);
+        int width = TileColumns(tj);
+        for (int i = 0; i < TileRows(ti); ++i) {
+          std::copy_n(arr + (ti * BLOCK + i) * this->cols + tj * BLOCK, width, tile + i * width);
+        }
+      }
+    }
+  }
+
+  MatrixLayout GetLayout() override { return MatrixLayout::BLOCKED; }
+
+  // Return the # of rows of tiles
+  int GetTileRows() const { return tile_rows_; }
+
+  // Return the # of columns of tiles
+  int GetTileColumns() const { return tile_cols_; }
+
+  // Return the # of rows of the tiles in row ti
+  int TileRows(int ti) const { return std::min(BLOCK, this->rows - ti * BLOCK); }
+
+  // Return the # of columns of the tiles in column tj
+  int TileColumns(int tj) const { return std::min(BLOCK, this->cols - tj * BLOCK); }
+
+  // Return the (ti,tj)th tile, TileRows(ti) x TileColumns(tj) elements in row-major order
+  T *Tile(int ti, int tj) { return this->linear + this->tile_offset_[ti * tile_cols_ + tj]; }
+
+ private:
+  // Return the Z-order key of tile (ti,tj)
+  static uint64_t Morton(uint32_t ti, uint32_t tj) {
+    uint64_t key = 0;
+    for (int bit = 0; bit < 32; ++bit) {
+      key |= static_cast<uint64_t>((ti >> bit) & 1) << (2 * bit + 1);
+      key |= static_cast<uint64_t>((tj >> bit) & 1) << (2 * bit);
+    }
+    return key;
+  }
+
+  // Return the position of the (i,j)th element in linear
+  int Offset(int i, int j) const {
+    return this->tile_offset_[i / BLOCK * tile_cols_ + j / BLOCK] + i % BLOCK * TileColumns(j / BLOCK) + j % BLOCK;
+  }
+
+  int tile_rows_;
+  int tile_cols_;
+  // Position of the first element of each tile in linear, tiles in row-major order
+  std::vector<int> tile_offset_;
+};
+
+/*
+ * Operations on matrices of any layout. The result of an operation has the layout of its first operand.
+ *
+ * A multiply picks the loop order from the layouts, so that the innermost loop walks memory contiguously in every
+ * operand it touches: along a row of mat2 and of the result if both are row-major, along a column of mat1 and of the
+ * result if both are column-major, and otherwise along a row of mat1 and a column of mat2 (a dot product). Once
+ * every dimension is a tile or more, the operands are converted to blocked matrices, which costs O(n^2) against the
+ * O(n^3) of the multiply, multiplied tile by tile and converted back: a full tile has constant bounds, which the
+ * compiler vectorizes, and the tiles of a product stay in the cache however large the matrices are.
+ *
+ * Every loop order adds up the products of an element in increasing k, so all of them give the same result.
+ */
+template <typename T>
+class MatrixOperations {
+ public:
+  // Transpose a rows x cols row-major matrix: dst[j * dst_stride + i] = src[i * src_stride + j].
+  // Cache-oblivious: the longer side is halved until the block is small, so that at some depth of the recursion the
+  // source and destination blocks fit any level of the cache.
+  static void Transpose(const T *src, int src_stride, T *dst, int dst_stride, int rows, int cols) {
+    if (rows <= TRANSPOSE_LEAF && cols <= TRANSPOSE_LEAF) {
+      for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+          dst[j * dst_stride + i] = src[i * src_stride + j];
+        }
+      }
+    } else if (rows >= cols) {
+      int half = rows / 2;
+      Transpose(src, src_stride, dst, dst_stride, half, cols);
+      Transpose(src + half * src_stride, src_stride, dst + half, dst_stride, rows - half, cols);
+    } else {
+      int half = cols / 2;
+      Transpose(src, src_stride, dst, dst_stride, rows, half);
+      Transpose(src + half, src_stride, dst + half * dst_stride, dst_stride, rows, cols - half);
+    }
+  }
+
+  // Return a new r x c zero matrix of the given layout
+  static std::unique_ptr<Matrix<T>> MakeMatrix(MatrixLayout layout, int r, int c) {
+    std::unique_ptr<Matrix<T>> res;
+    switch (layout) {
+      case MatrixLayout::ROW_MAJOR:
+        res = std::make_unique<RowMatrix<T>>(r, c);
+        break;
+      case MatrixLayout::COLUMN_MAJOR:
+        res = std::make_unique<ColMatrix<T>>(r, c);
+        break;
+      case MatrixLayout::BLOCKED:
+        res = std::make_unique<BlockedMatrix<T>>(r, c);
+        break;
+    }
+    std::fill_n(res->linear, r * c, T{});
+    return res;
+  }
+
+  // Return a copy of mat in the given layout
+  static std::unique_ptr<Matrix<T>> Convert(Matrix<T> *mat, MatrixLayout layout) {
+    std::unique_ptr<Matrix<T>> res = MakeMatrix(layout, mat->GetRows(), mat->GetColumns());
+    Copy(mat, res.get());
+    return res;
+  }
+
+  // Return the transpose of mat, in the layout of mat
+  static std::unique_ptr<Matrix<T>> TransposeMatrix(Matrix<T> *mat) {
+    MatrixLayout layout = mat->GetLayout();
+    if (layout == MatrixLayout::BLOCKED) {
+      // A blocked matrix has no transposed view; go through row-major.
+      std::unique_ptr<Matrix<T>> row = Convert(mat, MatrixLayout::ROW_MAJOR);
+      std::unique_ptr<Matrix<T>> col = MakeMatrix(MatrixLayout::COLUMN_MAJOR, mat->GetColumns(), mat->GetRows());
+      std::copy_n(row->linear, mat->GetRows() * mat->GetColumns(), col->linear);
+      return Convert(col.get(), layout);
+    }
+    // The transpose of a row-major matrix has the same linear array read column-major, and the other way around.
+    std::unique_ptr<Matrix<T>> res = MakeMatrix(layout, mat->GetColumns(), mat->GetRows());
+    View src = ViewOf(mat);
+    View dst = ViewOf(res.get());
+    Copy(View{src.data_, src.col_stride_, src.row_stride_}, dst, mat->GetColumns(), mat->GetRows());
+    return res;
+  }
+
+  // Compute (mat1 + mat2) and return the result.
+  // Return nullptr if dimensions mismatch for input matrices.
+  static std::unique_ptr<Matrix<T>> AddMatrices(std::unique_ptr<Matrix<T>> mat1, std::unique_ptr<Matrix<T>> mat2) {
+    if (mat1 == nullptr || mat2 == nullptr) {
+      return nullptr;
+    }
+    if (mat1->GetRows() != mat2->GetRows() || mat1->GetColumns() != mat2->GetColumns()) {
+      return nullptr;
+    }
+    if (mat2->GetLayout() != mat1->GetLayout()) {
+      mat2 = Convert(mat2.get(), mat1->GetLayout());
+    }
+    // Two matrices of the same dimensions and layout put every element at the same place.
+    std::unique_ptr<Matrix<T>> res = MakeMatrix(mat1->GetLayout(), mat1->GetRows(), mat1->GetColumns());
+    for (int e = 0; e < mat1->GetRows() * mat1->GetColumns(); ++e) {
+      res->linear[e] = mat1->linear[e] + mat2->linear[e];
+    }
+    return res;
+  }
+
+  // Compute matrix multiplication (mat1 * mat2) and return the result.
+  // Return nullptr if dimensions mismatch for input matrices.
+  static std::unique_ptr<Matrix<T>> MultiplyMatrices(std::unique_ptr<Matrix<T>> mat1,
+                                                     std::unique_ptr<Matrix<T>> mat2) {
+    if (mat1 == nullptr || mat2 == nullptr || mat1->GetColumns() != mat2->GetRows()) {
+      return nullptr;
+    }
+    std::unique_ptr<Matrix<T>> res = MakeMatrix(mat1->GetLayout(), mat1->GetRows(), mat2->GetColumns());
+    MultiplyInto(mat1.get(), mat2.get(), res.get());
+    return res;
+  }
+
+  // Simplified GEMM (general matrix multiply) operation
+  // Compute (matA * matB + matC). Return nullptr if dimensions mismatch for input matrices
+  static std::unique_ptr<Matrix<T>> GemmMatrices(std::unique_ptr<Matrix<T>> matA, std::unique_ptr<Matrix<T>> matB,
+                                                 std::unique_ptr<Matrix<T>> matC) {
+    return AddMatrices(MultiplyMatrices(std::move(matA), std::move(matB)), std::move(matC));
+  }
+
+  // Compute (mat1 * mat2) into res, of matching dimensions and any layout
+  static void MultiplyInto(Matrix<T> *mat1, Matrix<T> *mat2, Matrix<T> *res) {
+    int m = mat1->GetRows();
+    int k = mat1->GetColumns();
+    int n = mat2->GetColumns();
+    std::fill_n(res->linear, m * n, T{});
+    bool blocked = mat1->GetLayout() == MatrixLayout::BLOCKED || mat2->GetLayout() == MatrixLayout::BLOCKED ||
+                   res->GetLayout() == MatrixLayout::BLOCKED;
+    if (!blocked && (m < BLOCKED_MIN || k < BLOCKED_MIN || n < BLOCKED_MIN)) {
+      Kernel(ViewOf(mat1), ViewOf(mat2), ViewOf(res), m, k, n);
+      return;
+    }
+    std::unique_ptr<Matrix<T>> a_copy;
+    std::unique_ptr<Matrix<T>> b_copy;
+    std::unique_ptr<Matrix<T>> c_copy;
+    auto *a = AsBlocked(mat1, &a_copy);
+    auto *b = AsBlocked(mat2, &b_copy);
+    auto *c = AsBlocked(res, &c_copy);
+    MultiplyTiles(a, b, c, 0, a->GetTileRows(), 0, a->GetTileColumns(), 0, b->GetTileColumns());
+    if (c_copy != nullptr) {
+      Copy(c, res);
+    }
+  }
+
+ private:
+  // Largest side of a block that Transpose copies directly
+  static constexpr int TRANSPOSE_LEAF = 16;
+  // Smallest dimension from which a multiply of row-major and column-major matrices goes through blocked copies
+  static constexpr int BLOCKED_MIN = BlockedMatrix<T>::BLOCK;
+  // Columns of a tile whose sums FullTileKernel keeps in registers
+  static constexpr int STRIP = 8;
+
+  // A row-major or column-major matrix, or a tile: element (i,j) is data_[i * row_stride_ + j * col_stride_]
+  struct View {
+    T *data_;
+    int row_stride_;
+    int col_stride_;
+  };
+
+  // Return the view of a row-major or column-major matrix
+  static View ViewOf(Matrix<T> *mat) {
+    if (mat->GetLayout() == MatrixLayout::COLUMN_MAJOR) {
+      return View{mat->linear, 1, mat->GetRows()};
+    }
+    return View{mat->linear, mat->GetColumns(), 1};
+  }
+
+  // Return the view of the (ti,tj)th tile of a blocked matrix
+  static View TileView(BlockedMatrix<T> *mat, int ti, int tj) {
+    return View{mat->Tile(ti, tj), mat->TileColumns(tj), 1};
+  }
+
+  // Return mat if it is blocked, or else a blocked copy of it kept in copy
+  static BlockedMatrix<T> *AsBlocked(Matrix<T> *mat, std::unique_ptr<Matrix<T>> *copy) {
+    if (mat->GetLayout() != MatrixLayout::BLOCKED) {
+      *copy = Convert(mat, MatrixLayout::BLOCKED);
+      mat = copy->get();
+    }
+    return static_cast<BlockedMatrix<T> *>(mat);
+  }
+
+  // Copy a rows x cols block, transposing it if one view is row-major and the other column-major
+  static void Copy(View src, View dst, int rows, int cols) {
+    if (src.col_stride_ == 1 && dst.col_stride_ == 1) {
+      for (int i = 0; i < rows; ++i) {
+        std::copy_n(src.data_ + i * src.row_stride_, cols, dst.data_ + i * dst.row_stride_);
+      }
+    } else if (src.row_stride_ == 1 && dst.row_stride_ == 1) {
+      for (int j = 0; j < cols; ++j) {
+        std::copy_n(src.data_ + j * src.col_stride_, rows, dst.data_ + j * dst.col_stride_);
+      }
+    } else if (src.col_stride_ == 1) {
+      Transpose(src.data_, src.row_stride_, dst.data_, dst.col_stride_, rows, cols);
+    } else {
+      Transpose(src.data_, src.col_stride_, dst.data_, dst.row_stride_, cols, rows);
+    }
+  }
+
+  // Copy the elements of src into dst, of the same dimensions
+  static void Copy(Matrix<T> *src, Matrix<T> *dst) {
+    bool src_blocked = src->GetLayout() == MatrixLayout::BLOCKED;
+    bool dst_blocked = dst->GetLayout() == MatrixLayout::BLOCKED;
+    if (!src_blocked && !dst_blocked) {
+      Copy(ViewOf(src), ViewOf(dst), src->GetRows(), src->GetColumns());
+      return;
+    }
+    if (src_blocked && dst_blocked) {
+      std::copy_n(src->linear, src->GetRows() * src->GetColumns(), dst->linear);
+      return;
+    }
+    // One tile at a time, between the tile and the same block of the other matrix.
+    auto *blocked = static_cast<BlockedMatrix<T> *>(src_blocked ? src : dst);
+    View other = ViewOf(src_blocked ? dst : src);
+    constexpr int B = BlockedMatrix<T>::BLOCK;
+    for (int ti = 0; ti < blocked->GetTileRows(); ++ti) {
+      for (int tj = 0; tj < blocked->GetTileColumns(); ++tj) {
+        View tile = TileView(blocked, ti, tj);
+        View block{other.data_ + ti * B * other.row_stride_ + tj * B * other.col_stride_, other.row_stride_,
+                   other.col_stride_};
+        if (src_blocked) {
+          Copy(tile, block, blocked->TileRows(ti), blocked->TileColumns(tj));
+        } else {
+          Copy(block, tile, blocked->TileRows(ti), blocked->TileColumns(tj));
+        }
+      }
+    }
+  }
+
+  // Add the m x n product of a (m x k) and b (k x n) to c, in the loop order that suits the views
+  static void Kernel(View a, View b, View c, int m, int k, int n) {
+    if (c.col_stride_ == 1 && b.col_stride_ == 1) {
+      // Along the rows of b and c
+      for (int i = 0; i < m; ++i) {
+        T *c_row = c.data_ + i * c.row_stride_;
+        for (int p = 0; p < k; ++p) {
+          T x = a.data_[i * a.row_stride_ + p * a.col_stride_];
+          const T *b_row = b.data_ + p * b.row_stride_;
+          for (int j = 0; j < n; ++j) {
+            c_row[j] += x * b_row[j];
+          }
+        }
+      }
+    } else if (c.row_stride_ == 1 && a.row_stride_ == 1) {
+      // Along the columns of a and c
+      for (int j = 0; j < n; ++j) {
+        T *c_col = c.data_ + j * c.col_stride_;
+        for (int p = 0; p < k; ++p) {
+          T y = b.data_[p * b.row_stride_ + j * b.col_stride_];
+          const T *a_col = a.data_ + p * a.col_stride_;
+          for (int i = 0; i < m; ++i) {
+            c_col[i] += a_col[i] * y;
+          }
+        }
+      }
+    } else {
+      // Along a row of a and a column of b
+      for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+          T sum = c.data_[i * c.row_stride_ + j * c.col_stride_];
+          for (int p = 0; p < k; ++p) {
+            sum += a.data_[i * a.row_stride_ + p * a.col_stride_] * b.data_[p * b.row_stride_ + j * b.col_stride_];
+          }
+          c.data_[i * c.row_stride_ + j * c.col_stride_] = sum;
+        }
+      }
+    }
+  }
+
+  // Add the product of two full tiles to a third. The bounds are constant and the sums of a row are local, so the
+  // compiler vectorizes the loop along the row without checking whether c overlaps b, and keeps the sums of a strip
+  // of STRIP columns in registers across the loop over k.
+  static void FullTileKernel(const T *a, const T *b, T *c) {
+    constexpr int B = BlockedMatrix<T>::BLOCK;
+    for (int i = 0; i < B; ++i) {
+      for (int j0 = 0; j0 < B; j0 += STRIP) {
+        T sum[STRIP];
+        std::copy_n(c + i * B + j0, STRIP, sum);
+        for (int p = 0; p < B; ++p) {
+          T x = a[i * B + p];
+          for (int j = 0; j < STRIP; ++j) {
+            sum[j] += x * b[p * B + j0 + j];
+          }
+        }
+        std::copy_n(sum, STRIP, c + i * B + j0);
+      }
+    }
+  }
+
+  // Add the product of the tiles [i0, i1) x [k0, k1) of a and [k0, k1) x [j0, j1) of b to c.
+  // The longest range is halved until a single tile of each is left: the tiles a level of the recursion works on fit
+  // some level of the cache, whatever its size. The lower half of k goes first, to add the products in order.
+  static void MultiplyTiles(BlockedMatrix<T> *a, BlockedMatrix<T> *b, BlockedMatrix<T> *c, int i0, int i1, int k0,
+                            int k1, int j0, int j1) {
+    int di = i1 - i0;
+    int dk = k1 - k0;
+    int dj = j1 - j0;
+    if (di == 0 || dk == 0 || dj == 0) {
+      return;
+    }
+    if (di == 1 && dk == 1 && dj == 1) {
+      int m = a->TileRows(i0);
+      int k = a->TileColumns(k0);
+      int n = b->TileColumns(j0);
+      constexpr int B = BlockedMatrix<T>::BLOCK;
+      if (m == B && k == B && n == B) {
+        FullTileKernel(a->Tile(i0, k0), b->Tile(k0, j0), c->Tile(i0, j0));
+      } else {
+        Kernel(TileView(a, i0, k0), TileView(b, k0, j0), TileView(c, i0, j0), m, k, n);
+      }
+    } else if (di >= dk && di >= dj) {
+      MultiplyTiles(a, b, c, i0, i0 + di / 2, k0, k1, j0, j1);
+      MultiplyTiles(a, b, c, i0 + di / 2, i1, k0, k1, j0, j1);
+    } else if (dj >= dk) {
+      MultiplyTiles(a, b, c, i0, i1, k0, k1, j0, j0 + dj / 2);
+      MultiplyTiles(a, b, c, i0, i1, k0, k1, j0 + dj / 2, j1);
+    } else {
+      MultiplyTiles(a, b, c, i0, i1, k0, k0 + dk / 2, j0, j1);
+      MultiplyTiles(a, b, c, i0, i1, k0 + dk / 2, k1, j0, j1);
+    }
+  }
+};
+
 template <typename T>
 class RowMatrixOperations {
  public:
@@ -136,15 +619,8 @@ class RowMatrixOperations {
     if (mat1->GetColumns() != mat2->GetRows()) { return nullptr; }
 
     std::unique_ptr<RowMatrix<T>> res = std::make_unique<RowMatrix<T>>(mat1->GetRows(), mat2->GetColumns());
-    for (int r = 0; r < res->GetRows(); ++r) {
-      for (int c = 0; c < res->GetColumns(); ++c) {
-        int sum = 0;
-        for (int k = 0; k < mat1->GetColumns(); ++k) {
-          sum += mat1->GetElem(r, k) * mat2->GetElem(k, c);
-        }
-        res->SetElem(r, c, sum);
-      }
-    }
+    // Walks the rows of mat2 rather than its columns; see MatrixOperations.
+    MatrixOperations<T>::MultiplyInto(mat1.get(), mat2.get(), res.get());
     return res;
   }
 
@@ -157,4 +633,839 @@ class RowMatrixOperations {
     return AddMatrices(MultiplyMatrices(std::move(matA), std::move(matB)), std::move(matC));
   }
 };
+
+// A bfloat16: the upper half of a float, with its range and an 8-bit significand
+struct BFloat16 {
+  uint16_t bits_;
+
+  // Round f to the nearest bfloat16, ties to even
+  static BFloat16 FromFloat(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    if ((u & 0x7fffffff) > 0x7f800000) {
+      // Keep a NaN quiet rather than letting the rounding turn it into an infinity.
+      return BFloat16{static_cast<uint16_t>((u >> 16) | 0x40)};
+    }
+    return BFloat16{static_cast<uint16_t>((u + 0x7fff + ((u >> 16) & 1)) >> 16)};
+  }
+
+  float ToFloat() const {
+    uint32_t u = static_cast<uint32_t>(bits_) << 16;
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+  }
+};
+
+// An IEEE 754 half-precision float
+struct Float16 {
+  uint16_t bits_;
+
+  // Round f to the nearest half, ties to even
+  static Float16 FromFloat(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    auto sign = static_cast<uint16_t>((u >> 16) & 0x8000);
+    uint32_t abs = u & 0x7fffffff;
+    if (abs > 0x7f800000) {
+      return Float16{static_cast<uint16_t>(sign | 0x7e00)};
+    }
+    if (abs >= 0x477ff000) {
+      // 65520 and up round past the largest half, 65504.
+      return Float16{static_cast<uint16_t>(sign | 0x7c00)};
+    }
+    if (abs < 0x38800000) {
+      // Below 2^-14 a half is subnormal, a multiple of 2^-24; the scaling is exact and nearbyint rounds to even.
+      return Float16{static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(std::fabs(f) * 0x1p24f)))};
+    }
+    // Rebias the exponent from 127 to 15 and round the significand from 23 bits to 10.
+    return Float16{static_cast<uint16_t>(sign | ((abs - 0x38000000 + 0xfff + ((abs >> 13) & 1)) >> 13))};
+  }
+
+  float ToFloat() const {
+    uint32_t sign = static_cast<uint32_t>(bits_ & 0x8000) << 16;
+    uint32_t exp = (bits_ >> 10) & 0x1f;
+    uint32_t man = bits_ & 0x3ff;
+    float f;
+    if (exp == 0) {
+      f = static_cast<float>(man) * 0x1p-24f;
+      return sign != 0 ? -f : f;
+    }
+    uint32_t u = sign | (exp == 0x1f ? 0x7f800000 | (man << 13) : ((exp + 112) << 23) | (man << 13));
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+  }
+};
+
+// The instruction set extensions a low-precision kernel is compiled for
+enum class SimdLevel {
+  // Plain C++
+  SCALAR,
+  // AVX2, FMA and F16C
+  AVX2,
+  // AVX-512 with VNNI for int8, and BF16 for bfloat16
+  AVX512,
+};
+
+/*
+ * The second operand of a low-precision multiply, repacked once for the kernel of one SIMD level so that it can be
+ * multiplied many times.
+ *
+ * The columns are cut into panels of panel_ columns, padded with zeros, and a panel is stored from its first row to
+ * its last, group_ rows at a time: the group_ elements of a column in consecutive rows are next to each other, which
+ * is what the dot product instructions (VNNI, VPMADDWD, VDPBF16PS) take in one 32-bit lane.
+ */
+template <typename E>
+struct PackedMatrix {
+  SimdLevel level_;
+  int rows_;
+  int cols_;
+  // Rows summed by one lane of the kernel
+  int group_;
+  // Columns of a panel
+  int panel_;
+  // Rows, padded to a multiple of group_
+  int padded_rows_;
+  // Columns, padded to a multiple of panel_
+  int padded_cols_;
+  // Element (k,j) of panel p = j / panel_ is at p * panel_ * padded_rows_ + k / group_ * panel_ * group_ +
+  // j % panel_ * group_ + k % group_
+  std::vector<E> data_;
+  // Sum of each column, for the int8 kernels
+  std::vector<int32_t> col_sums_;
+};
+
+/*
+ * Multiplies of low-precision matrices that accumulate in a wider type: int8 x int8 into int32, and bfloat16 or half
+ * x bfloat16 or half into float. RowMatrixOperations would add up int8 products in int8 and half products in half.
+ *
+ * The second operand is packed into panels (see PackedMatrix) and the first into rows padded to the kernel's group of
+ * rows; the kernel then keeps a block of MR rows by one panel of sums in registers while it walks down the panel.
+ * Which kernel runs is decided at run time from the CPU, once: the int8 kernels use VPDPBUSD (AVX-512 VNNI, 64
+ * multiply-adds an instruction) or VPMADDWD (AVX2), bfloat16 uses VDPBF16PS (AVX-512 BF16) and half widens with
+ * VCVTPH2PS before a float FMA. AVX512-FP16 is not used even where the CPU has it: its FMAs round each product and sum
+ * to half, and it has no half x half -> float dot product. Every kernel is compiled with a target attribute, so the
+ * header needs no -m flags, and SimdLevel::SCALAR runs everywhere.
+ *
+ * int32 sums are exact up to 131072 columns of mat1; float sums are not in the order of RowMatrixOperations.
+ */
+class LowPrecisionOperations {
+ public:
+  // Return the best level this CPU supports for elements of type E
+  template <typename E>
+  static SimdLevel DetectSimdLevel() {
+    static const SimdLevel LEVEL = Detect<E>();
+    return LEVEL;
+  }
+
+  // Pack mat, the second operand of a multiply, for a level no higher than DetectSimdLevel<E>()
+  template <typename E>
+  static std::unique_ptr<PackedMatrix<E>> Pack(RowMatrix<E> *mat, SimdLevel level = DetectSimdLevel<E>()) {
+    level = std::min(level, DetectSimdLevel<E>());
+    auto packed = std::make_unique<PackedMatrix<E>>();
+    packed->level_ = level;
+    packed->rows_ = mat->GetRows();
+    packed->cols_ = mat->GetColumns();
+    packed->group_ = Group<E>(level);
+    packed->panel_ = Panel(level);
+    packed->padded_rows_ = RoundUp(packed->rows_, packed->group_);
+    packed->padded_cols_ = RoundUp(packed->cols_, packed->panel_);
+    packed->data_.assign(static_cast<size_t>(packed->padded_rows_) * packed->padded_cols_, E{});
+    int group = packed->group_;
+    int panel = packed->panel_;
+    for (int k = 0; k < packed->rows_; ++k) {
+      const E *row = mat->linear + static_cast<size_t>(k) * packed->cols_;
+      for (int j = 0; j < packed->cols_; ++j) {
+        size_t pos = static_cast<size_t>(j / panel) * panel * packed->padded_rows_ + k / group * panel * group +
+                     j % panel * group + k % group;
+        packed->data_[pos] = row[j];
+      }
+    }
+    if constexpr (std::is_same_v<E, int8_t>) {
+      packed->col_sums_.assign(packed->cols_, 0);
+      for (int k = 0; k < packed->rows_; ++k) {
+        for (int j = 0; j < packed->cols_; ++j) {
+          packed->col_sums_[j] += mat->linear[static_cast<size_t>(k) * packed->cols_ + j];
+        }
+      }
+    }
+    return packed;
+  }
+
+  // Compute (mat1 * mat2) with int32 sums and return the result.
+  // Return nullptr if dimensions mismatch for input matrices.
+  static std::unique_ptr<RowMatrix<int32_t>> MultiplyMatrices(std::unique_ptr<RowMatrix<int8_t>> mat1,
+                                                              std::unique_ptr<RowMatrix<int8_t>> mat2) {
+    if (mat1 == nullptr || mat2 == nullptr) {
+      return nullptr;
+    }
+    return MultiplyPacked(mat1.get(), *Pack(mat2.get()));
+  }
+
+  // Compute (mat1 * mat2) with float sums and return the result.
+  // Return nullptr if dimensions mismatch for input matrices.
+  static std::unique_ptr<RowMatrix<float>> MultiplyMatrices(std::unique_ptr<RowMatrix<BFloat16>> mat1,
+                                                            std::unique_ptr<RowMatrix<BFloat16>> mat2) {
+    if (mat1 == nullptr || mat2 == nullptr) {
+      return nullptr;
+    }
+    return MultiplyPacked(mat1.get(), *Pack(mat2.get()));
+  }
+
+  // Compute (mat1 * mat2) with float sums and return the result.
+  // Return nullptr if dimensions mismatch for input matrices.
+  static std::unique_ptr<RowMatrix<float>> MultiplyMatrices(std::unique_ptr<RowMatrix<Float16>> mat1,
+                                                            std::unique_ptr<RowMatrix<Float16>> mat2) {
+    if (mat1 == nullptr || mat2 == nullptr) {
+      return nullptr;
+    }
+    return MultiplyPacked(mat1.get(), *Pack(mat2.get()));
+  }
+
+  // Compute (mat1 * mat2) for a packed mat2, with the kernel it was packed for.
+  // Return nullptr if dimensions mismatch for input matrices.
+  static std::unique_ptr<RowMatrix<int32_t>> MultiplyPacked(RowMatrix<int8_t> *mat1, const PackedMatrix<int8_t> &mat2) {
+    if (mat1->GetColumns() != mat2.rows_) {
+      return nullptr;
+    }
+    int m = mat1->GetRows();
+    int padded_m = RoundUp(m, MR);
+    std::vector<int32_t> out(static_cast<size_t>(padded_m) * mat2.padded_cols_);
+    switch (mat2.level_) {
+#ifdef BUSTUB_LOW_PRECISION_SIMD
+      case SimdLevel::AVX512: {
+        // VPDPBUSD multiplies unsigned bytes by signed ones: mat1 is shifted by 128, and 128 times the column sums of
+        // mat2 taken off at the end.
+        std::vector<uint8_t> a = PackRows<uint8_t>(mat1, mat2.padded_rows_, padded_m,
+                                                   [](int8_t x) { return static_cast<uint8_t>(x + 128); });
+        Int8Avx512(a.data(), mat2, padded_m, out.data());
+        break;
+      }
+      case SimdLevel::AVX2: {
+        std::vector<int16_t> a = PackRows<int16_t>(mat1, mat2.padded_rows_, padded_m, [](int8_t x) { return x; });
+        Int8Avx2(a.data(), mat2, padded_m, out.data());
+        break;
+      }
+#endif
+      default: {
+        std::vector<int32_t> a = PackRows<int32_t>(mat1, mat2.padded_rows_, padded_m, [](int8_t x) { return x; });
+        Scalar(a.data(), mat2, padded_m, out.data(), [](int8_t x) { return static_cast<int32_t>(x); });
+        break;
+      }
+    }
+    std::unique_ptr<RowMatrix<int32_t>> res = std::make_unique<RowMatrix<int32_t>>(m, mat2.cols_);
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < mat2.cols_; ++j) {
+        int32_t sum = out[static_cast<size_t>(i) * mat2.padded_cols_ + j];
+        res->linear[static_cast<size_t>(i) * mat2.cols_ + j] =
+            mat2.level_ == SimdLevel::AVX512 ? sum - 128 * mat2.col_sums_[j] : sum;
+      }
+    }
+    return res;
+  }
+
+  // Compute (mat1 * mat2) for a packed mat2, with the kernel it was packed for.
+  // Return nullptr if dimensions mismatch for input matrices.
+  static std::unique_ptr<RowMatrix<float>> MultiplyPacked(RowMatrix<BFloat16> *mat1,
+                                                          const PackedMatrix<BFloat16> &mat2) {
+    if (mat1->GetColumns() != mat2.rows_) {
+      return nullptr;
+    }
+    int padded_m = RoundUp(mat1->GetRows(), MR);
+    std::vector<float> out(static_cast<size_t>(padded_m) * mat2.padded_cols_);
+    switch (mat2.level_) {
+#ifdef BUSTUB_LOW_PRECISION_SIMD
+      case SimdLevel::AVX512: {
+        std::vector<BFloat16> a = PackRows<BFloat16>(mat1, mat2.padded_rows_, padded_m, [](BFloat16 x) { return x; });
+        BFloat16Avx512(a.data(), mat2, padded_m, out.data());
+        break;
+      }
+      case SimdLevel::AVX2: {
+        std::vector<float> a = PackRows<float>(mat1, mat2.padded_rows_, padded_m, ToFloat<BFloat16>);
+        HalfAvx2<false>(a.data(), mat2.data_.data(), mat2.padded_rows_, mat2.padded_cols_, padded_m, out.data());
+        break;
+      }
+#endif
+      default: {
+        std::vector<float> a = PackRows<float>(mat1, mat2.padded_rows_, padded_m, ToFloat<BFloat16>);
+        Scalar(a.data(), mat2, padded_m, out.data(), ToFloat<BFloat16>);
+        break;
+      }
+    }
+    return Unpad(out, mat1->GetRows(), mat2);
+  }
+
+  // Compute (mat1 * mat2) for a packed mat2, with the kernel it was packed for.
+  // Return nullptr if dimensions mismatch for input matrices.
+  static std::unique_ptr<RowMatrix<float>> MultiplyPacked(RowMatrix<Float16> *mat1, const PackedMatrix<Float16> &mat2) {
+    if (mat1->GetColumns() != mat2.rows_) {
+      return nullptr;
+    }
+    int padded_m = RoundUp(mat1->GetRows(), MR);
+    std::vector<float> out(static_cast<size_t>(padded_m) * mat2.padded_cols_);
+    std::vector<float> a = PackRows<float>(mat1, mat2.padded_rows_, padded_m, ToFloat<Float16>);
+    switch (mat2.level_) {
+#ifdef BUSTUB_LOW_PRECISION_SIMD
+      case SimdLevel::AVX512:
+        HalfAvx512(a.data(), mat2.data_.data(), mat2.padded_rows_, mat2.padded_cols_, padded_m, out.data());
+        break;
+      case SimdLevel::AVX2:
+        HalfAvx2<true>(a.data(), mat2.data_.data(), mat2.padded_rows_, mat2.padded_cols_, padded_m, out.data());
+        break;
+#endif
+      default:
+        Scalar(a.data(), mat2, padded_m, out.data(), ToFloat<Float16>);
+        break;
+    }
+    return Unpad(out, mat1->GetRows(), mat2);
+  }
+
+ private:
+  // Rows of mat1 a kernel works on at once
+  static constexpr int MR = 4;
+  // Rows of a panel of mat2 a kernel works on at once; a multiple of every group
+  static constexpr int KC = 256;
+
+  static int RoundUp(int x, int multiple) { return (x + multiple - 1) / multiple * multiple; }
+
+  template <typename E>
+  static float ToFloat(E x) {
+    return x.ToFloat();
+  }
+
+  template <typename E>
+  static SimdLevel Detect() {
+#ifdef BUSTUB_LOW_PRECISION_SIMD
+    __builtin_cpu_init();
+    bool avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                  __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+    if constexpr (std::is_same_v<E, int8_t>) {
+      avx512 = avx512 && __builtin_cpu_supports("avx512vnni");
+    } else if constexpr (std::is_same_v<E, BFloat16>) {
+      avx512 = avx512 && __builtin_cpu_supports("avx512bf16");
+    }
+    if (avx512) {
+      return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c")) {
+      return SimdLevel::AVX2;
+    }
+#endif
+    return SimdLevel::SCALAR;
+  }
+
+  // Return the rows of mat2 a lane of the kernel sums: four bytes for VPDPBUSD, two for VPMADDWD and VDPBF16PS
+  template <typename E>
+  static constexpr int Group(SimdLevel level) {
+    if constexpr (std::is_same_v<E, int8_t>) {
+      return level == SimdLevel::AVX512 ? 4 : level == SimdLevel::AVX2 ? 2 : 1;
+    } else if constexpr (std::is_same_v<E, BFloat16>) {
+      return level == SimdLevel::AVX512 ? 2 : 1;
+    } else {
+      return 1;
+    }
+  }
+
+  // Return the columns of a panel: two registers of 32-bit sums
+  static constexpr int Panel(SimdLevel level) { return level == SimdLevel::AVX512 ? 32 : 16; }
+
+  // Copy the rows of mat1 into a padded_m x padded_k array, converting each element with convert
+  template <typename A, typename E, typename Convert>
+  static std::vector<A> PackRows(RowMatrix<E> *mat1, int padded_k, int padded_m, Convert convert) {
+    std::vector<A> a(static_cast<size_t>(padded_m) * padded_k, A{});
+    int k = mat1->GetColumns();
+    for (int i = 0; i < mat1->GetRows(); ++i) {
+      for (int p = 0; p < k; ++p) {
+        a[static_cast<size_t>(i) * padded_k + p] = convert(mat1->linear[static_cast<size_t>(i) * k + p]);
+      }
+    }
+    return a;
+  }
+
+  // Copy the first m rows and mat2.cols_ columns of a padded result into a RowMatrix
+  template <typename E>
+  static std::unique_ptr<RowMatrix<float>> Unpad(const std::vector<float> &out, int m, const PackedMatrix<E> &mat2) {
+    std::unique_ptr<RowMatrix<float>> res = std::make_unique<RowMatrix<float>>(m, mat2.cols_);
+    for (int i = 0; i < m; ++i) {
+      std::copy_n(out.data() + static_cast<size_t>(i) * mat2.padded_cols_, mat2.cols_,
+                  res->linear + static_cast<size_t>(i) * mat2.cols_);
+    }
+    return res;
+  }
+
+  // Portable kernel of a matrix packed for SimdLevel::SCALAR, a group of one row. A panel is widened once; the sums of
+  // a row of it are local and of constant length, which the compiler vectorizes.
+  template <typename A, typename E, typename Widen>
+  static void Scalar(const A *a, const PackedMatrix<E> &mat2, int padded_m, A *out, Widen widen) {
+    constexpr int PANEL = Panel(SimdLevel::SCALAR);
+    int kp = mat2.padded_rows_;
+    int np = mat2.padded_cols_;
+    std::vector<A> panel(static_cast<size_t>(kp) * PANEL);
+    for (int p = 0; p < np; p += PANEL) {
+      const E *b = mat2.data_.data() + static_cast<size_t>(p) * kp;
+      for (size_t e = 0; e < panel.size(); ++e) {
+        panel[e] = widen(b[e]);
+      }
+      for (int i = 0; i < padded_m; ++i) {
+        A sum[PANEL] = {};
+        for (int k = 0; k < kp; ++k) {
+          A x = a[static_cast<size_t>(i) * kp + k];
+          for (int j = 0; j < PANEL; ++j) {
+            sum[j] += x * panel[k * PANEL + j];
+          }
+        }
+        std::copy_n(sum, PANEL, out + static_cast<size_t>(i) * np + p);
+      }
+    }
+  }
+
+#ifdef BUSTUB_LOW_PRECISION_SIMD
+  // Return the 32-bit lane at p, holding one group of a row of mat1
+  static int32_t LoadGroup(const void *p) {
+    int32_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return x;
+  }
+
+  // The SIMD kernels below share one loop nest. For each panel of mat2, and each KC rows of it, MR rows of mat1 at a
+  // time: the sums of the MR rows by the panel, two registers a row, are loaded from out, updated for every group of
+  // rows of the panel, and stored back. KC rows of a panel stay in the L1 cache while all of mat1 goes by.
+
+  // int8 with VPDPBUSD: a lane adds up four products of a byte of mat1 (shifted to unsigned) and one of mat2
+  __attribute__((target("avx512f,avx512bw,avx512vnni"))) static void Int8Avx512(const uint8_t *a,
+                                                                                const PackedMatrix<int8_t> &mat2,
+                                                                                int padded_m, int32_t *out) {
+    int kp = mat2.padded_rows_;
+    int np = mat2.padded_cols_;
+    for (int p = 0; p < np; p += 32) {
+      for (int k0 = 0; k0 < kp; k0 += KC) {
+        int k1 = std::min(kp, k0 + KC);
+        const int8_t *b = mat2.data_.data() + static_cast<size_t>(p) * kp;
+        for (int i = 0; i < padded_m; i += MR) {
+          int32_t *c = out + static_cast<size_t>(i) * np + p;
+          __m512i sum[MR][2];
+          for (int r = 0; r < MR; ++r) {
+            sum[r][0] = _mm512_loadu_si512(c + r * np);
+            sum[r][1] = _mm512_loadu_si512(c + r * np + 16);
+          }
+          for (int k = k0; k < k1; k += 4) {
+            __m512i b0 = _mm512_loadu_si512(b + k * 32);
+            __m512i b1 = _mm512_loadu_si512(b + k * 32 + 64);
+            for (int r = 0; r < MR; ++r) {
+              __m512i x = _mm512_set1_epi32(LoadGroup(a + static_cast<size_t>(i + r) * kp + k));
+              sum[r][0] = _mm512_dpbusd_epi32(sum[r][0], x, b0);
+              sum[r][1] = _mm512_dpbusd_epi32(sum[r][1], x, b1);
+            }
+          }
+          for (int r = 0; r < MR; ++r) {
+            _mm512_storeu_si512(c + r * np, sum[r][0]);
+            _mm512_storeu_si512(c + r * np + 16, sum[r][1]);
+          }
+        }
+      }
+    }
+  }
+
+  // int8 with VPMADDWD: a lane adds up two products of 16-bit values, mat2 being widened as it is loaded
+  __attribute__((target("avx2,fma,f16c"))) static void Int8Avx2(const int16_t *a, const PackedMatrix<int8_t> &mat2,
+                                                                int padded_m, int32_t *out) {
+    int kp = mat2.padded_rows_;
+    int np = mat2.padded_cols_;
+    for (int p = 0; p < np; p += 16) {
+      for (int k0 = 0; k0 < kp; k0 += KC) {
+        int k1 = std::min(kp, k0 + KC);
+        const int8_t *b = mat2.data_.data() + static_cast<size_t>(p) * kp;
+        for (int i = 0; i < padded_m; i += MR) {
+          int32_t *c = out + static_cast<size_t>(i) * np + p;
+          __m256i sum[MR][2];
+          for (int r = 0; r < MR; ++r) {
+            sum[r][0] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + r * np));
+            sum[r][1] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + r * np + 8));
+          }
+          for (int k = k0; k < k1; k += 2) {
+            __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + k * 16)));
+            __m256i b1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + k * 16 + 16)));
+            for (int r = 0; r < MR; ++r) {
+              __m256i x = _mm256_set1_epi32(LoadGroup(a + static_cast<size_t>(i + r) * kp + k));
+              sum[r][0] = _mm256_add_epi32(sum[r][0], _mm256_madd_epi16(x, b0));
+              sum[r][1] = _mm256_add_epi32(sum[r][1], _mm256_madd_epi16(x, b1));
+            }
+          }
+          for (int r = 0; r < MR; ++r) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + r * np), sum[r][0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + r * np + 8), sum[r][1]);
+          }
+        }
+      }
+    }
+  }
+
+  // bfloat16 with VDPBF16PS: a lane adds up two products of bfloat16 values in float
+  __attribute__((target("avx512f,avx512bw,avx512bf16"))) static void BFloat16Avx512(const BFloat16 *a,
+                                                                                    const PackedMatrix<BFloat16> &mat2,
+                                                                                    int padded_m, float *out) {
+    int kp = mat2.padded_rows_;
+    int np = mat2.padded_cols_;
+    for (int p = 0; p < np; p += 32) {
+      for (int k0 = 0; k0 < kp; k0 += KC) {
+        int k1 = std::min(kp, k0 + KC);
+        const BFloat16 *b = mat2.data_.data() + static_cast<size_t>(p) * kp;
+        for (int i = 0; i < padded_m; i += MR) {
+          float *c = out + static_cast<size_t>(i) * np + p;
+          __m512 sum[MR][2];
+          for (int r = 0; r < MR; ++r) {
+            sum[r][0] = _mm512_loadu_ps(c + r * np);
+            sum[r][1] = _mm512_loadu_ps(c + r * np + 16);
+          }
+          for (int k = k0; k < k1; k += 2) {
+            auto b0 = reinterpret_cast<__m512bh>(_mm512_loadu_si512(b + k * 32));
+            auto b1 = reinterpret_cast<__m512bh>(_mm512_loadu_si512(b + k * 32 + 32));
+            for (int r = 0; r < MR; ++r) {
+              __m512i group = _mm512_set1_epi32(LoadGroup(a + static_cast<size_t>(i + r) * kp + k));
+              auto x = reinterpret_cast<__m512bh>(group);
+              sum[r][0] = _mm512_dpbf16_ps(sum[r][0], x, b0);
+              sum[r][1] = _mm512_dpbf16_ps(sum[r][1], x, b1);
+            }
+          }
+          for (int r = 0; r < MR; ++r) {
+            _mm512_storeu_ps(c + r * np, sum[r][0]);
+            _mm512_storeu_ps(c + r * np + 16, sum[r][1]);
+          }
+        }
+      }
+    }
+  }
+
+  // Half with AVX-512: sixteen halves of mat2 are widened with VCVTPH2PS, then one FMA per row. The product of two
+  // halves fits a float exactly; VFMADD*PH (AVX512-FP16) would round it and the sum to half.
+  __attribute__((target("avx512f,avx512bw,fma,f16c"))) static void HalfAvx512(const float *a, const Float16 *b, int kp,
+                                                                              int np, int padded_m, float *out) {
+    for (int p = 0; p < np; p += 32) {
+      for (int k0 = 0; k0 < kp; k0 += KC) {
+        int k1 = std::min(kp, k0 + KC);
+        const Float16 *panel = b + static_cast<size_t>(p) * kp;
+        for (int i = 0; i < padded_m; i += MR) {
+          float *c = out + static_cast<size_t>(i) * np + p;
+          __m512 sum[MR][2];
+          for (int r = 0; r < MR; ++r) {
+            sum[r][0] = _mm512_loadu_ps(c + r * np);
+            sum[r][1] = _mm512_loadu_ps(c + r * np + 16);
+          }
+          for (int k = k0; k < k1; ++k) {
+            __m256i h0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(panel + k * 32));
+            __m256i h1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(panel + k * 32 + 16));
+            // The zero-masked form is the same instruction; the plain one trips -Wmaybe-uninitialized in GCC 12.
+            __m512 b0 = _mm512_maskz_cvtph_ps(0xffff, h0);
+            __m512 b1 = _mm512_maskz_cvtph_ps(0xffff, h1);
+            for (int r = 0; r < MR; ++r) {
+              __m512 x = _mm512_set1_ps(a[static_cast<size_t>(i + r) * kp + k]);
+              sum[r][0] = _mm512_fmadd_ps(x, b0, sum[r][0]);
+              sum[r][1] = _mm512_fmadd_ps(x, b1, sum[r][1]);
+            }
+          }
+          for (int r = 0; r < MR; ++r) {
+            _mm512_storeu_ps(c + r * np, sum[r][0]);
+            _mm512_storeu_ps(c + r * np + 16, sum[r][1]);
+          }
+        }
+      }
+    }
+  }
+
+  // Half (IS_HALF) or bfloat16 with AVX2: eight values of mat2 are widened to floats, then one FMA per row
+  template <bool IS_HALF, typename E>
+  __attribute__((target("avx2,fma,f16c"))) static void HalfAvx2(const float *a, const E *b, int kp, int np,
+                                                                int padded_m, float *out) {
+    for (int p = 0; p < np; p += 16) {
+      for (int k0 = 0; k0 < kp; k0 += KC) {
+        int k1 = std::min(kp, k0 + KC);
+        const E *panel = b + static_cast<size_t>(p) * kp;
+        for (int i = 0; i < padded_m; i += MR) {
+          float *c = out + static_cast<size_t>(i) * np + p;
+          __m256 sum[MR][2];
+          for (int r = 0; r < MR; ++r) {
+            sum[r][0] = _mm256_loadu_ps(c + r * np);
+            sum[r][1] = _mm256_loadu_ps(c + r * np + 8);
+          }
+          for (int k = k0; k < k1; ++k) {
+            __m128i h0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(panel + k * 16));
+            __m128i h1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(panel + k * 16 + 8));
+            __m256 b0;
+            __m256 b1;
+            if constexpr (IS_HALF) {
+              b0 = _mm256_cvtph_ps(h0);
+              b1 = _mm256_cvtph_ps(h1);
+            } else {
+              // A bfloat16 is the upper half of a float.
+              b0 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h0), 16));
+              b1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h1), 16));
+            }
+            for (int r = 0; r < MR; ++r) {
+              __m256 x = _mm256_set1_ps(a[static_cast<size_t>(i + r) * kp + k]);
+              sum[r][0] = _mm256_fmadd_ps(x, b0, sum[r][0]);
+              sum[r][1] = _mm256_fmadd_ps(x, b1, sum[r][1]);
+            }
+          }
+          for (int r = 0; r < MR; ++r) {
+            _mm256_storeu_ps(c + r * np, sum[r][0]);
+            _mm256_storeu_ps(c + r * np + 8, sum[r][1]);
+          }
+        }
+      }
+    }
+  }
+#endif
+};
+
+/*
+ * A matrix whose dimensions are known at compile time, for the small matrices (2x2 to 16x16) that most of our
+ * RowMatrixOperations calls work on. The elements are stored inline in row-major order, so a FixedMatrix never
+ * allocates, no call is virtual, and FixedMatrixOperations unrolls its loops at compile time. Mismatched dimensions
+ * do not compile.
+ */
+template <typename T, int R, int C>
+class FixedMatrix {
+  static_assert(R > 0 && C > 0, "A matrix has at least one row and one column");
+
+ public:
+  constexpr FixedMatrix() : linear_{} {}
+
+  // Return the # of rows in the matrix
+  static constexpr int GetRows() { return R; }
+
+  // Return the # of columns in the matrix
+  static constexpr int GetColumns() { return C; }
+
+  // Return the (i,j)th  matrix element
+  constexpr T GetElem(int i, int j) const { return linear_[i * C + j]; }
+
+  // Sets the (i,j)th  matrix element to val
+  constexpr void SetElem(int i, int j, T val) { linear_[i * C + j] = val; }
+
+  // Sets the matrix elements based on the array arr, in row-major order
+  constexpr void MatImport(const T *arr) {
+    for (int i = 0; i < R * C; ++i) {
+      linear_[i] = arr[i];
+    }
+  }
+
+  // Copy a RowMatrix of the same dimensions. Return false if the dimensions mismatch.
+  bool Import(RowMatrix<T> *mat) {
+    if (mat->GetRows() != R || mat->GetColumns() != C) {
+      return false;
+    }
+    for (int r = 0; r < R; ++r) {
+      for (int c = 0; c < C; ++c) {
+        SetElem(r, c, mat->GetElem(r, c));
+      }
+    }
+    return true;
+  }
+
+  // Return a RowMatrix holding the same elements
+  std::unique_ptr<RowMatrix<T>> ToRowMatrix() const {
+    std::unique_ptr<RowMatrix<T>> res = std::make_unique<RowMatrix<T>>(R, C);
+    for (int r = 0; r < R; ++r) {
+      for (int c = 0; c < C; ++c) {
+        res->SetElem(r, c, GetElem(r, c));
+      }
+    }
+    return res;
+  }
+
+ private:
+  template <typename U>
+  friend class FixedMatrixOperations;
+
+  std::array<T, R * C> linear_;
+};
+
+/*
+ * A batch of matrices of the same fixed dimensions, stored in groups of GROUP_SIZE matrices. A group is element-major:
+ * element (i,j) of its matrices is contiguous, in a lane. The batched operations of FixedMatrixOperations run their
+ * innermost loop along the lanes, which the compiler vectorizes across the matrices instead of within a small matrix,
+ * and a group is one contiguous block that stays in the cache while it is worked on. The last group is padded with
+ * zero matrices.
+ */
+template <typename T, int R, int C>
+class FixedMatrixBatch {
+  static_assert(R > 0 && C > 0, "A matrix has at least one row and one column");
+
+ public:
+  // Matrices interleaved in a group
+  static constexpr int GROUP_SIZE = 32;
+
+  // Create a batch of n zero matrices
+  explicit FixedMatrixBatch(int n)
+      : size_(n), linear_(static_cast<size_t>((n + GROUP_SIZE - 1) / GROUP_SIZE) * R * C * GROUP_SIZE) {}
+
+  // Return the # of matrices in the batch
+  int GetSize() const { return size_; }
+
+  // Return the # of groups of the batch
+  int GetGroups() const { return (size_ + GROUP_SIZE - 1) / GROUP_SIZE; }
+
+  // Return the (i,j)th element of matrix b
+  T GetElem(int b, int i, int j) const { return Lane(b / GROUP_SIZE, i, j)[b % GROUP_SIZE]; }
+
+  // Sets the (i,j)th element of matrix b to val
+  void SetElem(int b, int i, int j, T val) { Lane(b / GROUP_SIZE, i, j)[b % GROUP_SIZE] = val; }
+
+  // Return a copy of matrix b
+  FixedMatrix<T, R, C> GetMatrix(int b) const {
+    FixedMatrix<T, R, C> mat;
+    for (int i = 0; i < R; ++i) {
+      for (int j = 0; j < C; ++j) {
+        mat.SetElem(i, j, GetElem(b, i, j));
+      }
+    }
+    return mat;
+  }
+
+  // Sets matrix b to mat
+  void SetMatrix(int b, const FixedMatrix<T, R, C> &mat) {
+    for (int i = 0; i < R; ++i) {
+      for (int j = 0; j < C; ++j) {
+        SetElem(b, i, j, mat.GetElem(i, j));
+      }
+    }
+  }
+
+  // Return the (i,j)th element of the GROUP_SIZE matrices of group g
+  const T *Lane(int g, int i, int j) const { return linear_.data() + LaneOffset(g, i, j); }
+  T *Lane(int g, int i, int j) { return linear_.data() + LaneOffset(g, i, j); }
+
+ private:
+  template <typename U>
+  friend class FixedMatrixOperations;
+
+  static size_t LaneOffset(int g, int i, int j) { return (static_cast<size_t>(g) * R * C + i * C + j) * GROUP_SIZE; }
+
+  int size_;
+  std::vector<T> linear_;
+};
+
+template <typename T>
+class FixedMatrixOperations {
+ public:
+  // Compute (mat1 + mat2) and return the result.
+  template <int R, int C>
+  static constexpr FixedMatrix<T, R, C> AddMatrices(const FixedMatrix<T, R, C> &mat1,
+                                                    const FixedMatrix<T, R, C> &mat2) {
+    return AddImpl(mat1, mat2, std::make_index_sequence<R * C>{});
+  }
+
+  // Compute matrix multiplication (mat1 * mat2) and return the result.
+  // Up to UNROLL_LIMIT multiply-adds every one of them is unrolled; past that the unrolled code no longer fits the
+  // instruction cache, and the rows are summed in loops of constant bounds that the compiler vectorizes instead.
+  template <int R, int K, int C>
+  static constexpr FixedMatrix<T, R, C> MultiplyMatrices(const FixedMatrix<T, R, K> &mat1,
+                                                         const FixedMatrix<T, K, C> &mat2) {
+    if constexpr (R * K * C <= UNROLL_LIMIT) {
+      return MultiplyImpl(mat1, mat2, std::make_index_sequence<R * C>{});
+    } else {
+      FixedMatrix<T, R, C> res;
+      for (int i = 0; i < R; ++i) {
+        T sum[C] = {};
+        for (int k = 0; k < K; ++k) {
+          T x = mat1.linear_[i * K + k];
+          for (int j = 0; j < C; ++j) {
+            sum[j] += x * mat2.linear_[k * C + j];
+          }
+        }
+        for (int j = 0; j < C; ++j) {
+          res.linear_[i * C + j] = sum[j];
+        }
+      }
+      return res;
+    }
+  }
+
+  // Simplified GEMM (general matrix multiply) operation
+  // Compute (matA * matB + matC) and return the result.
+  template <int R, int K, int C>
+  static constexpr FixedMatrix<T, R, C> GemmMatrices(const FixedMatrix<T, R, K> &matA, const FixedMatrix<T, K, C> &matB,
+                                                     const FixedMatrix<T, R, C> &matC) {
+    return AddMatrices(MultiplyMatrices(matA, matB), matC);
+  }
+
+  // Compute (mat1 + mat2) for every pair of matrices of two batches and return the results.
+  // Return nullptr if the batch sizes mismatch.
+  template <int R, int C>
+  static std::unique_ptr<FixedMatrixBatch<T, R, C>> AddBatch(const FixedMatrixBatch<T, R, C> &mat1,
+                                                             const FixedMatrixBatch<T, R, C> &mat2) {
+    if (mat1.GetSize() != mat2.GetSize()) {
+      return nullptr;
+    }
+    std::unique_ptr<FixedMatrixBatch<T, R, C>> res = std::make_unique<FixedMatrixBatch<T, R, C>>(mat1.GetSize());
+    // Both batches have the same layout, padding included.
+    for (size_t e = 0; e < res->linear_.size(); ++e) {
+      res->linear_[e] = mat1.linear_[e] + mat2.linear_[e];
+    }
+    return res;
+  }
+
+  // Compute (mat1 * mat2) for every pair of matrices of two batches and return the results.
+  // Return nullptr if the batch sizes mismatch.
+  template <int R, int K, int C>
+  static std::unique_ptr<FixedMatrixBatch<T, R, C>> MultiplyBatch(const FixedMatrixBatch<T, R, K> &mat1,
+                                                                  const FixedMatrixBatch<T, K, C> &mat2) {
+    if (mat1.GetSize() != mat2.GetSize()) {
+      return nullptr;
+    }
+    std::unique_ptr<FixedMatrixBatch<T, R, C>> res = std::make_unique<FixedMatrixBatch<T, R, C>>(mat1.GetSize());
+    constexpr int G = FixedMatrixBatch<T, R, C>::GROUP_SIZE;
+    for (int g = 0; g < res->GetGroups(); ++g) {
+      for (int i = 0; i < R; ++i) {
+        for (int j = 0; j < C; ++j) {
+          // One sum per matrix of the group, with the sum over k unrolled so that it stays in a register.
+          const T *x[K];
+          const T *y[K];
+          for (int k = 0; k < K; ++k) {
+            x[k] = mat1.Lane(g, i, k);
+            y[k] = mat2.Lane(g, k, j);
+          }
+          T *out = res->Lane(g, i, j);
+          for (int b = 0; b < G; ++b) {
+            out[b] = LaneDot(x, y, b, std::make_index_sequence<K>{});
+          }
+        }
+      }
+    }
+    return res;
+  }
+
+ private:
+  // Multiply-adds MultiplyMatrices unrolls, 8x8 times 8x8
+  static constexpr int UNROLL_LIMIT = 512;
+
+  template <int R, int C, size_t... I>
+  static constexpr FixedMatrix<T, R, C> AddImpl(const FixedMatrix<T, R, C> &mat1, const FixedMatrix<T, R, C> &mat2,
+                                                std::index_sequence<I...> /*unused*/) {
+    FixedMatrix<T, R, C> res;
+    ((res.linear_[I] = mat1.linear_[I] + mat2.linear_[I]), ...);
+    return res;
+  }
+
+  template <int R, int K, int C, size_t... I>
+  static constexpr FixedMatrix<T, R, C> MultiplyImpl(const FixedMatrix<T, R, K> &mat1, const FixedMatrix<T, K, C> &mat2,
+                                                     std::index_sequence<I...> /*unused*/) {
+    FixedMatrix<T, R, C> res;
+    ((res.linear_[I] = Dot<I / C, I % C>(mat1, mat2, std::make_index_sequence<K>{})), ...);
+    return res;
+  }
+
+  // Return the (i,j)th element of mat1 * mat2, summed in the order of k like MultiplyMatrices
+  template <size_t I, size_t J, int R, int K, int C, size_t... P>
+  static constexpr T Dot(const FixedMatrix<T, R, K> &mat1, const FixedMatrix<T, K, C> &mat2,
+                         std::index_sequence<P...> /*unused*/) {
+    return (T{} + ... + (mat1.linear_[I * K + P] * mat2.linear_[P * C + J]));
+  }
+
+  // Return the bth element of the sum over k of the lanes x[k] * y[k]
+  template <size_t... P>
+  static T LaneDot(const T *const *x, const T *const *y, int b, std::index_sequence<P...> /*unused*/) {
+    return (T{} + ... + (x[P][b] * y[P][b]));
+  }
+};
 }  // namespace bustub
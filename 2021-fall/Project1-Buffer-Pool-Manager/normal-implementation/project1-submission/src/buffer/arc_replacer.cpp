@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_pages) : capacity_(num_pages), frames_(num_pages) {}
+
+ARCReplacer::~ARCReplacer() = default;
+
+auto ARCReplacer::Victim(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+
+  if (this->num_evictable_ == 0) {
+    return false;
+  }
+
+  // REPLACE(p): take from T1 while it is above its target, otherwise from T2. Fall back to the other list when every
+  // frame of the preferred one is pinned.
+  if (this->t1_.size() > this->target_t1_ || this->t2_.empty()) {
+    return this->EvictFrom(&this->t1_, &this->b1_, frame_id) || this->EvictFrom(&this->t2_, &this->b2_, frame_id);
+  }
+  return this->EvictFrom(&this->t2_, &this->b2_, frame_id) || this->EvictFrom(&this->t1_, &this->b1_, frame_id);
+}
+
+void ARCReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  FrameInfo &info = this->frames_[frame_id];
+  if (info.list_ != ListType::NONE && info.evictable_) {
+    info.evictable_ = false;
+    --this->num_evictable_;
+  }
+}
+
+void ARCReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  FrameInfo &info = this->frames_[frame_id];
+  if (info.list_ == ListType::NONE) {
+    // Nobody told us which page the frame holds, treat it as seen once.
+    this->Insert(frame_id, ListType::T1, INVALID_PAGE_ID, true);
+    return;
+  }
+  if (!info.evictable_) {
+    info.evictable_ = true;
+    ++this->num_evictable_;
+  }
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  return this->num_evictable_;
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  FrameInfo &info = this->frames_[frame_id];
+
+  // Case I: hit in T1 or T2, the page has now been seen at least twice.
+  if (info.list_ != ListType::NONE && info.page_id_ == page_id) {
+    bool evictable = info.evictable_;
+    this->Unlink(frame_id);
+    this->Insert(frame_id, ListType::T2, page_id, evictable);
+    return;
+  }
+
+  // The frame was handed out without going through Victim (free list after a delete).
+  if (info.list_ != ListType::NONE) {
+    this->Unlink(frame_id);
+  }
+
+  const size_t b1_size = this->b1_.Size();
+  const size_t b2_size = this->b2_.Size();
+  if (this->b1_.Contains(page_id)) {
+    // Case II: recency was undervalued, grow the target of T1.
+    size_t delta = std::max<size_t>(1, b2_size / b1_size);
+    this->target_t1_ = std::min(this->capacity_, this->target_t1_ + delta);
+    this->b1_.Erase(page_id);
+    this->Insert(frame_id, ListType::T2, page_id, false);
+  } else if (this->b2_.Contains(page_id)) {
+    // Case III: frequency was undervalued, shrink the target of T1.
+    size_t delta = std::max<size_t>(1, b1_size / b2_size);
+    this->target_t1_ = this->target_t1_ > delta ? this->target_t1_ - delta : 0;
+    this->b2_.Erase(page_id);
+    this->Insert(frame_id, ListType::T2, page_id, false);
+  } else {
+    // Case IV: a page we know nothing about.
+    this->Insert(frame_id, ListType::T1, page_id, false);
+  }
+  this->TrimGhosts();
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  if (this->frames_[frame_id].list_ != ListType::NONE) {
+    this->Unlink(frame_id);
+  }
+}
+
+void ARCReplacer::SetCapacity(size_t num_pages) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  if (this->frames_.size() < num_pages) {
+    this->frames_.resize(num_pages);
+  }
+  this->capacity_ = num_pages;
+  this->target_t1_ = std::min(this->target_t1_, this->capacity_);
+  this->TrimGhosts();
+}
+
+auto ARCReplacer::GetTargetRecencySize() -> size_t {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  return this->target_t1_;
+}
+
+void ARCReplacer::Insert(frame_id_t frame_id, ListType list, page_id_t page_id, bool evictable) {
+  FrameInfo &info = this->frames_[frame_id];
+  std::list<frame_id_t> *l = list == ListType::T1 ? &this->t1_ : &this->t2_;
+  l->push_front(frame_id);
+  info.list_ = list;
+  info.pos_ = l->begin();
+  info.page_id_ = page_id;
+  info.evictable_ = evictable;
+  if (evictable) {
+    ++this->num_evictable_;
+  }
+}
+
+void ARCReplacer::Unlink(frame_id_t frame_id) {
+  FrameInfo &info = this->frames_[frame_id];
+  (info.list_ == ListType::T1 ? this->t1_ : this->t2_).erase(info.pos_);
+  if (info.evictable_) {
+    --this->num_evictable_;
+  }
+  info = FrameInfo{};
+}
+
+auto ARCReplacer::EvictFrom(std::list<frame_id_t> *list, GhostList *ghost, frame_id_t *frame_id) -> bool {
+  for (auto itr = list->rbegin(); itr != list->rend(); ++itr) {
+    FrameInfo &info = this->frames_[*itr];
+    if (!info.evictable_) {
+      continue;
+    }
+    *frame_id = *itr;
+    page_id_t page_id = info.page_id_;
+    this->Unlink(*frame_id);
+    if (page_id != INVALID_PAGE_ID) {
+      ghost->PushFront(page_id);
+      this->TrimGhosts();
+    }
+    return true;
+  }
+  return false;
+}
+
+void ARCReplacer::TrimGhosts() {
+  while (this->t1_.size() + this->b1_.Size() > this->capacity_ && this->b1_.Size() > 0) {
+    this->b1_.PopBack();
+  }
+  while (this->t1_.size() + this->t2_.size() + this->b1_.Size() + this->b2_.Size() > 2 * this->capacity_ &&
+         this->b2_.Size() > 0) {
+    this->b2_.PopBack();
+  }
+}
+
+}  // namespace bustub
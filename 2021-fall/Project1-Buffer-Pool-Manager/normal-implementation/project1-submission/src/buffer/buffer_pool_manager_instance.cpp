@@ -12,16 +12,29 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <utility>
+
 #include "common/macros.h"
 
 namespace bustub {
 
+namespace {
+
+/** Hands every thread a reader stripe once. */
+std::atomic<size_t> next_reader_index{0};
+
+}  // namespace
+
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager) {}
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_type) {}
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                                                     DiskManager *disk_manager, LogManager *log_manager)
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerType replacer_type)
     : pool_size_(pool_size),
       num_instances_(num_instances),
       instance_index_(instance_index),
@@ -32,92 +45,256 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t
   BUSTUB_ASSERT(
       instance_index < num_instances,
       "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
-  // We allocate a consecutive memory space for the buffer pool.
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size);
-
-  // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+  switch (replacer_type) {
+    case ReplacerType::ARC:
+      replacer_ = new ARCReplacer(pool_size);
+      break;
+    case ReplacerType::TINY_LFU:
+      replacer_ = new TinyLFUReplacer(pool_size, new LRUReplacer(pool_size));
+      break;
+    case ReplacerType::BUFFERED_LRU:
+      replacer_ = new BufferedReplacer(pool_size, new LRUReplacer(pool_size));
+      break;
+    case ReplacerType::LRU:
+    default:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
   }
+
+  // We allocate a consecutive memory space for the buffer pool. Initially, every page is in the free list.
+  AddFrames(pool_size);
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  DrainLoads();
+  shutdown_ = true;
+  if (resize_worker_.joinable()) {
+    resize_worker_.join();
+  }
+  for (FrameChunk &chunk : chunks_) {
+    delete[] chunk.pages_;
+  }
+  for (Page *pages : retired_chunks_) {
+    delete[] pages;
+  }
+  delete free_space_map_;
   delete replacer_;
 }
 
-auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
-  // Make sure you call DiskManager::WritePage!
-  std::lock_guard<std::mutex> lg(this->latch_);
+void BufferPoolManagerInstance::Resize(size_t pool_size) {
+  BUSTUB_ASSERT(pool_size > 0, "Buffer pool cannot shrink to zero frames.");
+  std::lock_guard<std::shared_mutex> lg(this->latch_);
 
-  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot flush invalid page.");
+  const size_t old_size = this->pool_size_;
+  if (pool_size == old_size) {
+    return;
+  }
+  this->pool_size_ = pool_size;
 
-  auto itr = this->page_table_.find(page_id);
-  if (itr == this->page_table_.end()) {
+  if (pool_size > old_size) {
+    // Frames of an unfinished shrink come back first, the ones still holding a page keep it.
+    size_t reused = std::min(pool_size, this->frames_.size());
+    for (size_t i = old_size; i < reused; ++i) {
+      if (this->frame_status_[i] == FrameStatus::RETIRED) {
+        this->free_list_.push_back(static_cast<frame_id_t>(i));
+      }
+      this->frame_status_[i] = FrameStatus::ACTIVE;
+    }
+    if (pool_size > this->frames_.size()) {
+      this->AddFrames(pool_size - this->frames_.size());
+    }
+    this->page_table_.reserve(pool_size);
+    this->replacer_->SetCapacity(pool_size);
+    return;
+  }
+
+  this->free_list_.remove_if([pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; });
+  for (size_t i = pool_size; i < old_size; ++i) {
+    this->frame_status_[i] = FrameStatus::RETIRING;
+  }
+  if (this->RetireFrames() || this->resize_worker_running_) {
+    return;
+  }
+  // Pinned frames are retired in the background once they are released.
+  if (this->resize_worker_.joinable()) {
+    this->resize_worker_.join();
+  }
+  this->resize_worker_running_ = true;
+  this->resize_worker_ = std::thread(&BufferPoolManagerInstance::RunResizeWorker, this);
+}
+
+void BufferPoolManagerInstance::WaitForResize() {
+  std::thread worker;
+  {
+    std::lock_guard<std::shared_mutex> lg(this->latch_);
+    worker = std::move(this->resize_worker_);
+  }
+  if (worker.joinable()) {
+    worker.join();
+  }
+}
+
+void BufferPoolManagerInstance::EnableFreeSpaceMap() {
+  BUSTUB_ASSERT(this->free_space_map_ == nullptr, "Free-space map is already enabled.");
+  this->free_space_map_ = new FreeSpaceMap(this, this->num_instances_, this->instance_index_);
+}
+
+auto BufferPoolManagerInstance::NewPageExtent(size_t count, std::vector<page_id_t> *page_ids, Page **pages) -> bool {
+  BUSTUB_ASSERT(this->free_space_map_ != nullptr, "Extents are allocated from the free-space map.");
+  std::vector<page_id_t> extent;
+  if (!this->free_space_map_->AllocateExtent(count, &extent)) {
     return false;
   }
 
-  frame_id_t frame_id = itr->second;
-  Page *page_ptr = &this->pages_[frame_id];
-  this->disk_manager_->WritePage(page_ptr->page_id_, page_ptr->data_);
+  std::unique_lock<std::shared_mutex> lk(this->latch_);
+
+  std::vector<frame_id_t> frame_ids;
+  frame_ids.reserve(count);
+  frame_id_t frame_id;
+  while (frame_ids.size() < count && this->AcquireFrame(&frame_id)) {
+    frame_ids.push_back(frame_id);
+  }
+  if (frame_ids.size() < count) {
+    for (frame_id_t reserved : frame_ids) {
+      Page *page_ptr = this->frames_[reserved];
+      page_ptr->page_id_ = INVALID_PAGE_ID;
+      page_ptr->EndUpdate();
+      this->free_list_.push_back(reserved);
+    }
+    lk.unlock();
+    for (page_id_t page_id : extent) {
+      this->DeallocatePage(page_id);
+    }
+    return false;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    Page *page_ptr = this->frames_[frame_ids[i]];
+    page_ptr->page_id_ = extent[i];
+    page_ptr->pin_count_ = 1;
+    page_ptr->ResetMemory();
+    page_ptr->is_dirty_ = true;
+    page_ptr->rec_lsn_ = this->GetEndOfLog();
+    page_ptr->EndUpdate();
+    this->page_table_[extent[i]] = frame_ids[i];
+    this->replacer_->RecordAccess(frame_ids[i], extent[i]);
+    this->last_access_[frame_ids[i]] = ++this->access_clock_;
+    pages[i] = page_ptr;
+  }
+  page_ids->insert(page_ids->end(), extent.begin(), extent.end());
   return true;
 }
 
+auto BufferPoolManagerInstance::GetDirtyPages() -> std::vector<std::pair<page_id_t, lsn_t>> {
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_pages;
+  std::lock_guard<std::shared_mutex> lg(this->latch_);
+  for (const auto &[page_id, frame_id] : this->page_table_) {
+    Page *page_ptr = this->frames_[frame_id];
+    if (page_ptr->is_dirty_) {
+      dirty_pages.emplace_back(page_id, page_ptr->rec_lsn_.load());
+    }
+  }
+  // Taken under latch_ too: a page moving between the pool and the cache is in exactly one of the two lists.
+  if (this->compressed_cache_ != nullptr) {
+    this->compressed_cache_->GetDirtyPages(&dirty_pages);
+  }
+  return dirty_pages;
+}
+
+void BufferPoolManagerInstance::CheckpointPage(page_id_t page_id) {
+  if (!this->WritePageBack(page_id, true) && this->compressed_cache_ != nullptr) {
+    this->compressed_cache_->FlushPage(page_id);
+  }
+}
+
+auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
+  // Make sure you call DiskManager::WritePage!
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot flush invalid page.");
+  return this->WritePageBack(page_id, false);
+}
+
 void BufferPoolManagerInstance::FlushAllPgsImp() {
   // You can do it!
-  std::lock_guard<std::mutex> lg(this->latch_);
+  // Listed under latch_ like GetDirtyPages, then written one page at a time. A page that moved between the pool and
+  // the compressed cache since is written from wherever it is now.
+  std::vector<page_id_t> page_ids;
+  {
+    std::lock_guard<std::shared_mutex> lg(this->latch_);
+    for (const auto &[page_id, frame_id] : this->page_table_) {
+      page_ids.push_back(page_id);
+    }
+    if (this->compressed_cache_ != nullptr) {
+      std::vector<std::pair<page_id_t, lsn_t>> cached_pages;
+      this->compressed_cache_->GetDirtyPages(&cached_pages);
+      for (const auto &[page_id, rec_lsn] : cached_pages) {
+        page_ids.push_back(page_id);
+      }
+    }
+  }
 
-  for (size_t i = 0; i < this->pool_size_; ++i) {
-    Page *page_ptr = &this->pages_[i];
-    BUSTUB_ASSERT(page_ptr->page_id_ != INVALID_PAGE_ID, "Cannot flush invalid page.");
-    this->disk_manager_->WritePage(page_ptr->page_id_, page_ptr->data_);
+  for (page_id_t page_id : page_ids) {
+    if (!this->WritePageBack(page_id, false) && this->compressed_cache_ != nullptr) {
+      this->compressed_cache_->FlushPage(page_id);
+    }
   }
 }
 
 auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
+  frame_id_t frame_id;
+  return this->NewFrame(page_id, &frame_id);
+}
+
+auto BufferPoolManagerInstance::NewFrame(page_id_t *page_id, frame_id_t *frame_id) -> Page * {
   // 0.   Make sure you call AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-  std::lock_guard<std::mutex> lg(this->latch_);
 
-  if (this->free_list_.empty() && this->replacer_->Size() == 0) {
-    return nullptr;
+  // The free-space map fetches its pages through this pool, so it runs before latch_ is taken.
+  page_id_t new_page_id = INVALID_PAGE_ID;
+  if (this->free_space_map_ != nullptr) {
+    new_page_id = this->free_space_map_->AllocatePage();
+    if (new_page_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
   }
 
-  frame_id_t frame_id;
-  Page *page_ptr;
+  std::unique_lock<std::shared_mutex> lk(this->latch_);
 
-  if (!this->free_list_.empty()) {
-    frame_id = this->free_list_.front();
-    this->free_list_.pop_front();
-    page_ptr = &this->pages_[frame_id];
-  } else {
-    this->replacer_->Victim(&frame_id);
-    page_ptr = &this->pages_[frame_id];
-
-    assert(page_ptr->page_id_ != INVALID_PAGE_ID);
-
-    if (page_ptr->is_dirty_) {
-      this->disk_manager_->WritePage(page_ptr->page_id_, page_ptr->data_);
-      page_ptr->is_dirty_ = false;
+  if (!this->AcquireFrame(frame_id)) {
+    lk.unlock();
+    if (new_page_id != INVALID_PAGE_ID) {
+      this->DeallocatePage(new_page_id);
     }
-    this->page_table_.erase(page_ptr->page_id_);
+    return nullptr;
   }
 
-  page_id_t new_page_id = this->AllocatePage();
+  Page *page_ptr = this->frames_[*frame_id];
+  if (new_page_id == INVALID_PAGE_ID) {
+    new_page_id = this->AllocatePage();
+  }
   page_ptr->page_id_ = new_page_id;
   page_ptr->pin_count_ = 1;
   page_ptr->ResetMemory();
-  this->page_table_[new_page_id] = frame_id;
+  // A reused id still has the deleted page on disk, the zeroed page must replace it even if it is never written to.
+  page_ptr->is_dirty_ = this->free_space_map_ != nullptr;
+  page_ptr->rec_lsn_ = this->GetEndOfLog();
+  page_ptr->EndUpdate();
+  this->page_table_[new_page_id] = *frame_id;
+  this->replacer_->RecordAccess(*frame_id, new_page_id);
+  this->last_access_[*frame_id] = ++this->access_clock_;
   *page_id = new_page_id;
 
   return page_ptr;
 }
 
 auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
+  frame_id_t frame_id;
+  return this->FetchFrame(page_id, &frame_id);
+}
+
+auto BufferPoolManagerInstance::FetchFrame(page_id_t page_id, frame_id_t *frame_id) -> Page * {
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -125,50 +302,294 @@ auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  std::lock_guard<std::mutex> lg(this->latch_);
+  auto request_start = std::chrono::steady_clock::now();
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot fetch invalid page.");
+
+  {
+    // Hits share latch_, so they only meet on the replacer and the page itself.
+    std::shared_lock<std::shared_mutex> lk(this->latch_);
+    auto start = std::chrono::steady_clock::now();
+    Page *page_ptr = this->PinIfLoaded(page_id, frame_id);
+    if (page_ptr != nullptr) {
+      this->stats_.pool_.RecordHit(ElapsedNs(start));
+      this->stats_.fetch_latency_.Record(ElapsedNs(request_start));
+      return page_ptr;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lk(this->latch_);
+  auto start = std::chrono::steady_clock::now();
+  auto itr = this->FindPageToPin(&lk, page_id);
+  if (itr != this->page_table_.end()) {
+    *frame_id = itr->second;
+    Page *page_ptr = this->PinFrame(*frame_id, page_id);
+    this->stats_.pool_.RecordHit(ElapsedNs(start));
+    this->stats_.fetch_latency_.Record(ElapsedNs(request_start));
+    return page_ptr;
+  }
+  this->stats_.pool_.RecordMiss();
+
+  Page *page_ptr = this->ReserveFrame(page_id, frame_id);
+  if (page_ptr == nullptr) {
+    this->stats_.fetch_latency_.Record(ElapsedNs(request_start));
+    return nullptr;
+  }
+  if (this->LoadFromCompressedCache(page_id, page_ptr)) {
+    page_ptr->EndUpdate();
+    this->stats_.fetch_latency_.Record(ElapsedNs(request_start));
+    return page_ptr;
+  }
+
+  // The disk read runs without latch_. Fetches of the page wait for it meanwhile, the others go on.
+  this->pending_loads_.try_emplace(*frame_id);
+  lk.unlock();
+  this->ReadFromDisk(page_id, page_ptr);
+  this->FinishLoad(*frame_id, page_ptr, nullptr);
+
+  this->stats_.fetch_latency_.Record(ElapsedNs(request_start));
+  return page_ptr;
+}
+
+void BufferPoolManagerInstance::FetchPageAsync(page_id_t page_id, IoExecutor *executor,
+                                               std::function<void(Page *)> callback) {
+  std::unique_lock<std::shared_mutex> lk(this->latch_);
 
   BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot fetch invalid page.");
 
   auto itr = this->page_table_.find(page_id);
+  if (itr != this->page_table_.end() && this->MoveRetiringPage(itr->second)) {
+    itr = this->page_table_.find(page_id);
+  }
+  if (itr != this->page_table_.end() && this->frame_status_[itr->second] == FrameStatus::RETIRING) {
+    // Held by other threads: a worker waits for the page to move instead of pinning the retiring frame again.
+    lk.unlock();
+    executor->Submit(page_id, [this, page_id, callback = std::move(callback)] {
+      frame_id_t frame_id;
+      callback(this->FetchFrame(page_id, &frame_id));
+    });
+    return;
+  }
   if (itr != this->page_table_.end()) {
     frame_id_t frame_id = itr->second;
-    Page *page_ptr = &this->pages_[frame_id];
-    if (++page_ptr->pin_count_ == 1) {
-      this->replacer_->Pin(frame_id);
+    Page *page_ptr = this->PinFrame(frame_id, page_id);
+    this->stats_.pool_.RecordHit(0);
+    // A read of the page is already under way: wait for it instead of reading twice.
+    auto load = this->pending_loads_.find(frame_id);
+    if (load != this->pending_loads_.end()) {
+      load->second.push_back(std::move(callback));
+      return;
     }
-    return page_ptr;
+    lk.unlock();
+    callback(page_ptr);
+    return;
   }
+  this->stats_.pool_.RecordMiss();
 
-  if (this->free_list_.empty() && this->replacer_->Size() == 0) {
-    return nullptr;
+  frame_id_t frame_id;
+  Page *page_ptr = this->ReserveFrame(page_id, &frame_id);
+  if (page_ptr == nullptr) {
+    lk.unlock();
+    callback(nullptr);
+    return;
+  }
+  // Under latch_ like every other miss: once the cache lets go of a dirty page, the frame must already be dirty.
+  if (this->LoadFromCompressedCache(page_id, page_ptr)) {
+    page_ptr->EndUpdate();
+    lk.unlock();
+    callback(page_ptr);
+    return;
   }
+  this->pending_loads_[frame_id].push_back(std::move(callback));
+  lk.unlock();
 
-  Page *page_ptr;
-  frame_id_t frame_id;
+  // The frame is pinned and in the middle of an update, so nobody else touches it until EndUpdate.
+  FrameLoad load{page_id, frame_id, page_ptr};
+  executor->Submit(page_id, [this, load, executor] { this->StartRead(load, executor); });
+}
 
-  if (!this->free_list_.empty()) {
-    frame_id = this->free_list_.front();
-    this->free_list_.pop_front();
-    page_ptr = &this->pages_[frame_id];
-  } else {
-    this->replacer_->Victim(&frame_id);
-    page_ptr = &this->pages_[frame_id];
+auto BufferPoolManagerInstance::FetchPages(const std::vector<page_id_t> &page_ids, Page **pages, IoExecutor *executor)
+    -> bool {
+  std::vector<frame_id_t> frame_ids;
+  std::vector<FrameLoad> loads;
+  if (!this->PinPages(page_ids, pages, &frame_ids, &loads)) {
+    return false;
+  }
+  this->StartLoads(loads, executor);
+  this->WaitForLoads(frame_ids);
+  return true;
+}
 
-    BUSTUB_ASSERT(page_ptr->page_id_ != INVALID_PAGE_ID, "Cannot fetch invalid page.");
+auto BufferPoolManagerInstance::PinPages(const std::vector<page_id_t> &page_ids, Page **pages,
+                                         std::vector<frame_id_t> *frame_ids, std::vector<FrameLoad> *loads) -> bool {
+  std::lock_guard<std::shared_mutex> lg(this->latch_);
 
-    if (page_ptr->is_dirty_) {
-      this->disk_manager_->WritePage(page_ptr->page_id_, page_ptr->data_);
-      page_ptr->is_dirty_ = false;
+  frame_ids->resize(page_ids.size());
+  // Position of the first occurrence of every id; a duplicate only takes another pin.
+  std::unordered_map<page_id_t, size_t> first;
+  size_t fetched = 0;
+  for (; fetched < page_ids.size(); ++fetched) {
+    page_id_t page_id = page_ids[fetched];
+    BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot fetch invalid page.");
+    this->ValidatePageId(page_id);
+
+    auto dup = first.find(page_id);
+    if (dup != first.end()) {
+      pages[fetched] = pages[dup->second];
+      (*frame_ids)[fetched] = (*frame_ids)[dup->second];
+      ++pages[fetched]->pin_count_;
+      continue;
     }
-    this->page_table_.erase(page_ptr->page_id_);
+    first.emplace(page_id, fetched);
+
+    // A batch cannot wait for a retiring frame to be released, it pins the page there if it cannot move.
+    auto itr = this->page_table_.find(page_id);
+    if (itr != this->page_table_.end() && this->MoveRetiringPage(itr->second)) {
+      itr = this->page_table_.find(page_id);
+    }
+    if (itr != this->page_table_.end()) {
+      pages[fetched] = this->PinFrame(itr->second, page_id);
+      (*frame_ids)[fetched] = itr->second;
+      this->stats_.pool_.RecordHit(0);
+      continue;
+    }
+    this->stats_.pool_.RecordMiss();
+
+    frame_id_t frame_id;
+    Page *page_ptr = this->ReserveFrame(page_id, &frame_id);
+    if (page_ptr == nullptr) {
+      break;
+    }
+    pages[fetched] = page_ptr;
+    (*frame_ids)[fetched] = frame_id;
+    if (this->LoadFromCompressedCache(page_id, page_ptr)) {
+      page_ptr->EndUpdate();
+      continue;
+    }
+    this->pending_loads_.try_emplace(frame_id);
+    loads->push_back({page_id, frame_id, page_ptr});
   }
 
-  this->page_table_[page_id] = frame_id;
-  page_ptr->page_id_ = page_id;
-  page_ptr->pin_count_ = 1;
-  this->disk_manager_->ReadPage(page_id, page_ptr->data_);
+  if (fetched < page_ids.size()) {
+    // Out of frames: give back every pin of this batch. latch_ was held all along, so nobody else has pinned the
+    // frames reserved for unread misses: they go back to the free list. Pages evicted to make room for them are not
+    // brought back.
+    for (size_t i = 0; i < fetched; ++i) {
+      Page *page_ptr = pages[i];
+      frame_id_t frame_id = (*frame_ids)[i];
+      if (--page_ptr->pin_count_ > 0) {
+        continue;
+      }
+      if (this->pending_loads_.erase(frame_id) != 0) {
+        this->page_table_.erase(page_ptr->page_id_);
+        page_ptr->page_id_ = INVALID_PAGE_ID;
+        page_ptr->EndUpdate();
+        this->free_list_.push_back(frame_id);
+      } else {
+        this->replacer_->Unpin(frame_id);
+      }
+    }
+    frame_ids->clear();
+    loads->clear();
+    return false;
+  }
 
-  return page_ptr;
+  // The reads are issued as one sorted sweep over the file.
+  std::sort(loads->begin(), loads->end(),
+            [](const FrameLoad &a, const FrameLoad &b) { return a.page_id_ < b.page_id_; });
+  return true;
+}
+
+void BufferPoolManagerInstance::StartLoads(const std::vector<FrameLoad> &loads, IoExecutor *executor) {
+  for (const FrameLoad &load : loads) {
+    if (executor == nullptr) {
+      this->ReadFromDisk(load.page_id_, load.page_);
+      this->FinishLoad(load.frame_id_, load.page_, nullptr);
+      continue;
+    }
+    executor->Submit(load.page_id_, [this, load, executor] { this->StartRead(load, executor); });
+  }
+}
+
+void BufferPoolManagerInstance::StartRead(const FrameLoad &load, IoExecutor *executor) {
+  auto start = std::chrono::steady_clock::now();
+  // DiskManager leaves the buffer untouched on a read past the end of the file, which must read as a zero page.
+  load.page_->ResetMemory();
+  this->disk_manager_->ReadPageAsync(load.page_id_, load.page_->data_, [this, load, executor, start] {
+    this->stats_.disk_.RecordHit(ElapsedNs(start));
+    this->FinishLoad(load.frame_id_, load.page_, executor);
+  });
+}
+
+void BufferPoolManagerInstance::DrainLoads() {
+  std::unique_lock<std::shared_mutex> lk(this->latch_);
+  this->load_cv_.wait(lk, [this] { return this->pending_loads_.empty(); });
+}
+
+void BufferPoolManagerInstance::WaitForLoads(const std::vector<frame_id_t> &frame_ids) {
+  std::unique_lock<std::shared_mutex> lk(this->latch_);
+  // The frames are pinned, so they still hold the same pages once their reads are done.
+  this->load_cv_.wait(lk, [this, &frame_ids] {
+    return std::none_of(frame_ids.begin(), frame_ids.end(),
+                        [this](frame_id_t frame_id) { return this->pending_loads_.count(frame_id) != 0; });
+  });
+}
+
+auto BufferPoolManagerInstance::GetHotPages() -> std::vector<page_id_t> {
+  std::vector<std::pair<uint64_t, page_id_t>> resident;
+  {
+    std::shared_lock<std::shared_mutex> lk(this->latch_);
+    resident.reserve(this->page_table_.size());
+    for (const auto &[page_id, frame_id] : this->page_table_) {
+      resident.emplace_back(this->last_access_[frame_id].load(), page_id);
+    }
+  }
+  std::sort(resident.begin(), resident.end(), std::greater<>());
+
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(resident.size());
+  for (const auto &entry : resident) {
+    page_ids.push_back(entry.second);
+  }
+  return page_ids;
+}
+
+auto BufferPoolManagerInstance::PrefetchPages(const std::vector<page_id_t> &page_ids, size_t *loaded) -> bool {
+  std::vector<FrameLoad> loads;
+  bool has_room = true;
+  {
+    std::lock_guard<std::shared_mutex> lg(this->latch_);
+    for (page_id_t page_id : page_ids) {
+      this->ValidatePageId(page_id);
+      if (this->page_table_.count(page_id) != 0) {
+        continue;
+      }
+      if (this->free_list_.empty()) {
+        has_room = false;
+        break;
+      }
+
+      frame_id_t frame_id;
+      Page *page_ptr = this->ReserveFrame(page_id, &frame_id);
+      // Not used yet: ranks below every page the workload touched in the next dump.
+      this->last_access_[frame_id] = 0;
+      ++*loaded;
+      if (this->LoadFromCompressedCache(page_id, page_ptr)) {
+        page_ptr->EndUpdate();
+        this->ReleasePage(page_ptr, frame_id, false);
+        continue;
+      }
+      this->pending_loads_.try_emplace(frame_id);
+      loads.push_back({page_id, frame_id, page_ptr});
+    }
+  }
+
+  // The reserved frames stay pinned while they are read, fetches of their pages wait for the reads.
+  for (const FrameLoad &load : loads) {
+    this->ReadFromDisk(load.page_id_, load.page_);
+    this->FinishLoad(load.frame_id_, load.page_, nullptr);
+    this->ReleasePage(load.page_, load.frame_id_, false);
+  }
+  return has_room;
 }
 
 auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
@@ -177,33 +598,45 @@ auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
   // 1.   If P does not exist, return true.
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  std::lock_guard<std::mutex> lg(this->latch_);
+  std::unique_lock<std::shared_mutex> lk(this->latch_);
 
   BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot delete invalid page");
 
   auto itr = this->page_table_.find(page_id);
   if (itr == this->page_table_.end()) {
+    if (this->compressed_cache_ != nullptr) {
+      this->compressed_cache_->Erase(page_id);
+    }
+    lk.unlock();
+    this->DeallocatePage(page_id);
     return true;
   }
 
   frame_id_t frame_id = itr->second;
-  Page *page_ptr = &this->pages_[frame_id];
+  Page *page_ptr = this->frames_[frame_id];
 
   if (page_ptr->pin_count_ > 0) {
     return false;
   }
 
   this->page_table_.erase(page_id);
+  page_ptr->BeginUpdate();
   page_ptr->page_id_ = INVALID_PAGE_ID;
+  page_ptr->EndUpdate();
   page_ptr->is_dirty_ = false;
-  this->replacer_->Pin(frame_id);
-  this->free_list_.push_back(frame_id);
+  this->replacer_->Remove(frame_id);
+  if (this->frame_status_[frame_id] == FrameStatus::ACTIVE) {
+    this->free_list_.push_back(frame_id);
+  } else {
+    this->frame_status_[frame_id] = FrameStatus::RETIRED;
+  }
+  lk.unlock();
   this->DeallocatePage(page_id);
   return true;
 }
 
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
-  std::lock_guard<std::mutex> lg(this->latch_);
+  std::shared_lock<std::shared_mutex> lk(this->latch_);
 
   BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot unpin invalid page.");
 
@@ -213,20 +646,432 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
   }
 
   frame_id_t frame_id = itr->second;
-  Page *page_ptr = &this->pages_[frame_id];
+  Page *page_ptr = this->frames_[frame_id];
+
+  // Other unpins run concurrently: the count is checked and decremented in one step.
+  int pin_count = page_ptr->pin_count_.load();
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+    // Visible before the pin goes away, like in ReleasePage.
+    if (is_dirty) {
+      page_ptr->is_dirty_ = true;
+    }
+  } while (!page_ptr->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  if (pin_count == 1) {
+    this->replacer_->Unpin(frame_id);
+  }
+
+  return true;
+}
+
+auto BufferPoolManagerInstance::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
+  frame_id_t frame_id;
+  Page *page_ptr = this->FetchFrame(page_id, &frame_id);
+  if (page_ptr == nullptr) {
+    return {};
+  }
+  page_ptr->RLatch();
+  return ReadPageGuard(BasicPageGuard(this, page_ptr, frame_id));
+}
+
+auto BufferPoolManagerInstance::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
+  frame_id_t frame_id;
+  Page *page_ptr = this->FetchFrame(page_id, &frame_id);
+  if (page_ptr == nullptr) {
+    return {};
+  }
+  page_ptr->WLatch();
+  return WritePageGuard(BasicPageGuard(this, page_ptr, frame_id));
+}
+
+auto BufferPoolManagerInstance::NewPageGuarded(page_id_t *page_id) -> WritePageGuard {
+  frame_id_t frame_id;
+  Page *page_ptr = this->NewFrame(page_id, &frame_id);
+  if (page_ptr == nullptr) {
+    return {};
+  }
+  page_ptr->WLatch();
+  // A new page is zeroed memory that has never been written out, so it is dirty from the start.
+  BasicPageGuard guard(this, page_ptr, frame_id);
+  guard.GetDataMut();
+  return WritePageGuard(std::move(guard));
+}
+
+auto BufferPoolManagerInstance::LookupPage(page_id_t page_id) -> Page * {
+  std::shared_lock<std::shared_mutex> lk(this->latch_);
+  auto itr = this->page_table_.find(page_id);
+  if (itr == this->page_table_.end()) {
+    return nullptr;
+  }
+  return this->frames_[itr->second];
+}
+
+void BufferPoolManagerInstance::ReleasePage(Page *page, frame_id_t frame_id, bool is_dirty) {
+  // The dirty flag must be visible before the pin goes away, eviction only looks at unpinned pages.
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
+  int pin_count = page->pin_count_.fetch_sub(1);
+  BUSTUB_ASSERT(pin_count > 0, "Page guard released an unpinned page.");
+  if (pin_count == 1) {
+    this->replacer_->Unpin(frame_id);
+  }
+}
+
+auto BufferPoolManagerInstance::PinIfLoaded(page_id_t page_id, frame_id_t *frame_id) -> Page * {
+  auto itr = this->page_table_.find(page_id);
+  if (itr == this->page_table_.end() || this->pending_loads_.count(itr->second) != 0 ||
+      this->frame_status_[itr->second] != FrameStatus::ACTIVE) {
+    return nullptr;
+  }
+  *frame_id = itr->second;
+  return this->PinFrame(*frame_id, page_id);
+}
+
+auto BufferPoolManagerInstance::PinFrame(frame_id_t frame_id, page_id_t page_id) -> Page * {
+  Page *page_ptr = this->frames_[frame_id];
+  this->replacer_->RecordAccess(frame_id, page_id);
+  this->last_access_[frame_id].store(this->access_clock_.fetch_add(1, std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+  // Read before taking the pin: a concurrent hit that pins the page after us only logs records past it.
+  lsn_t end_of_log = this->GetEndOfLog();
+  if (page_ptr->pin_count_.fetch_add(1) == 0) {
+    this->replacer_->Pin(frame_id);
+    // Nobody else held the page, so a clean page cannot have changes that are not on disk yet.
+    if (!page_ptr->is_dirty_) {
+      page_ptr->rec_lsn_ = end_of_log;
+    }
+  }
+  return page_ptr;
+}
+
+auto BufferPoolManagerInstance::ReserveFrame(page_id_t page_id, frame_id_t *frame_id) -> Page * {
+  if (!this->AcquireFrame(frame_id)) {
+    return nullptr;
+  }
+  Page *page_ptr = this->frames_[*frame_id];
+  this->page_table_[page_id] = *frame_id;
+  this->replacer_->RecordAccess(*frame_id, page_id);
+  this->last_access_[*frame_id] = ++this->access_clock_;
+  page_ptr->page_id_ = page_id;
+  page_ptr->pin_count_ = 1;
+  return page_ptr;
+}
+
+void BufferPoolManagerInstance::FinishLoad(frame_id_t frame_id, Page *page, IoExecutor *executor) {
+  std::vector<std::function<void(Page *)>> callbacks;
+  {
+    std::lock_guard<std::shared_mutex> lg(this->latch_);
+    page->EndUpdate();
+    auto load = this->pending_loads_.find(frame_id);
+    callbacks = std::move(load->second);
+    this->pending_loads_.erase(load);
+    // Notified under latch_: DrainLoads may return, and the instance go away, as soon as latch_ is released.
+    this->load_cv_.notify_all();
+  }
+  for (auto &callback : callbacks) {
+    if (executor == nullptr) {
+      callback(page);
+      continue;
+    }
+    // Off the device's completion thread, which may deliver other reads meanwhile.
+    executor->Submit(page->GetPageId(), [callback = std::move(callback), page] { callback(page); });
+  }
+}
 
-  if (page_ptr->pin_count_ <= 0) {
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id) -> bool {
+  if (!this->free_list_.empty()) {
+    *frame_id = this->free_list_.front();
+    this->free_list_.pop_front();
+    this->frames_[*frame_id]->BeginUpdate();
+    return true;
+  }
+
+  Page *page_ptr;
+  while (true) {
+    if (!this->replacer_->Victim(frame_id)) {
+      return false;
+    }
+    // A frame retired by a shrink can still reach the replacer through a late unpin.
+    if (static_cast<size_t>(*frame_id) >= this->frames_.size() ||
+        this->frame_status_[*frame_id] == FrameStatus::RETIRED) {
+      continue;
+    }
+    page_ptr = this->frames_[*frame_id];
+    // ReleasePage tells the replacer after dropping the pin, so the frame may have been pinned again or deleted in
+    // between. Such a stale entry is simply dropped: the next unpin puts the frame back.
+    if (page_ptr->pin_count_ > 0 || page_ptr->page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    if (this->frame_status_[*frame_id] == FrameStatus::RETIRING) {
+      this->TryRetireFrame(*frame_id);
+      continue;
+    }
+    break;
+  }
+
+  this->EvictPage(page_ptr);
+  this->page_table_.erase(page_ptr->page_id_);
+  page_ptr->BeginUpdate();
+  return true;
+}
+
+void BufferPoolManagerInstance::AddFrames(size_t count) {
+  auto first_frame = static_cast<frame_id_t>(this->frames_.size());
+  auto *pages = new Page[count];
+  this->chunks_.push_back({pages, first_frame, count});
+  for (size_t i = 0; i < count; ++i) {
+    this->frames_.push_back(&pages[i]);
+    this->frame_status_.push_back(FrameStatus::ACTIVE);
+    this->last_access_.emplace_back(0);
+    this->free_list_.push_back(first_frame + static_cast<frame_id_t>(i));
+  }
+}
+
+auto BufferPoolManagerInstance::TryRetireFrame(frame_id_t frame_id) -> bool {
+  Page *page_ptr = this->frames_[frame_id];
+  // Pins are only taken under latch_, a frame seen unpinned here stays unpinned.
+  if (page_ptr->pin_count_ > 0) {
     return false;
   }
+  if (page_ptr->page_id_ != INVALID_PAGE_ID) {
+    this->EvictPage(page_ptr);
+    this->page_table_.erase(page_ptr->page_id_);
+    page_ptr->BeginUpdate();
+    page_ptr->page_id_ = INVALID_PAGE_ID;
+    page_ptr->EndUpdate();
+  }
+  this->replacer_->Remove(frame_id);
+  this->frame_status_[frame_id] = FrameStatus::RETIRED;
+  return true;
+}
+
+auto BufferPoolManagerInstance::RetireFrames() -> bool {
+  const size_t pool_size = this->pool_size_;
+  bool retired_all = true;
+  for (size_t i = pool_size; i < this->frames_.size(); ++i) {
+    if (this->frame_status_[i] == FrameStatus::RETIRING && !this->TryRetireFrame(static_cast<frame_id_t>(i))) {
+      retired_all = false;
+    }
+  }
+
+  if (retired_all) {
+    // Chunks entirely past the new size are unlinked. The constructor's chunk starts at frame 0 and always stays.
+    bool unlinked = false;
+    while (static_cast<size_t>(this->chunks_.back().first_frame_) >= pool_size) {
+      FrameChunk chunk = this->chunks_.back();
+      this->chunks_.pop_back();
+      this->frames_.resize(chunk.first_frame_);
+      this->frame_status_.resize(chunk.first_frame_);
+      this->last_access_.resize(chunk.first_frame_);
+      this->retired_chunks_.push_back(chunk.pages_);
+      unlinked = true;
+    }
+    if (unlinked) {
+      ++this->frame_epoch_;
+    }
+    this->replacer_->SetCapacity(pool_size);
+  }
+
+  // An optimistic read that started before the epoch moved on may still look at an unlinked chunk. One that starts
+  // later does not, so seeing every stripe at zero once is enough.
+  if (!this->retired_chunks_.empty()) {
+    bool quiescent = true;
+    for (ReaderCount &readers : this->optimistic_readers_) {
+      if (readers.count_.load() != 0) {
+        quiescent = false;
+        break;
+      }
+    }
+    if (quiescent) {
+      for (Page *pages : this->retired_chunks_) {
+        delete[] pages;
+      }
+      this->retired_chunks_.clear();
+    }
+  }
+  return retired_all && this->retired_chunks_.empty();
+}
+
+void BufferPoolManagerInstance::RunResizeWorker() {
+  while (!this->shutdown_) {
+    {
+      std::lock_guard<std::shared_mutex> lg(this->latch_);
+      if (this->RetireFrames()) {
+        this->resize_worker_running_ = false;
+        return;
+      }
+    }
+    std::this_thread::sleep_for(RESIZE_POLL_INTERVAL);
+  }
+}
+
+auto BufferPoolManagerInstance::LocalReaderCount() -> std::atomic<int64_t> & {
+  thread_local const size_t thread_index = next_reader_index.fetch_add(1);
+  return this->optimistic_readers_[thread_index % READER_STRIPES].count_;
+}
+
+void BufferPoolManagerInstance::EvictPage(Page *page) {
+  // A dirty page handed to the compressed cache may be written back from there, so the log is forced either way.
+  if (page->is_dirty_) {
+    this->ForceLogForPage(page);
+  }
+
+  // Clean pages are worth keeping too: a compressed hit saves the disk read either way.
+  if (this->compressed_cache_ != nullptr &&
+      this->compressed_cache_->Insert(page->page_id_, page->data_, page->is_dirty_, page->rec_lsn_)) {
+    page->is_dirty_ = false;
+    return;
+  }
+
+  if (page->is_dirty_) {
+    this->disk_manager_->WritePage(page->page_id_, page->data_);
+    page->is_dirty_ = false;
+  }
+}
+
+auto BufferPoolManagerInstance::FindLoadedPage(std::unique_lock<std::shared_mutex> *lk, page_id_t page_id)
+    -> std::unordered_map<page_id_t, frame_id_t>::iterator {
+  auto itr = this->page_table_.find(page_id);
+  while (itr != this->page_table_.end() && this->pending_loads_.count(itr->second) != 0) {
+    this->load_cv_.wait(*lk);
+    // The page may have been evicted again in the meantime.
+    itr = this->page_table_.find(page_id);
+  }
+  return itr;
+}
+
+auto BufferPoolManagerInstance::FindPageToPin(std::unique_lock<std::shared_mutex> *lk, page_id_t page_id)
+    -> std::unordered_map<page_id_t, frame_id_t>::iterator {
+  auto deadline = std::chrono::steady_clock::now() + RETIRE_WAIT_LIMIT;
+  while (true) {
+    auto itr = this->FindLoadedPage(lk, page_id);
+    if (itr == this->page_table_.end() || this->frame_status_[itr->second] != FrameStatus::RETIRING) {
+      return itr;
+    }
+    if (this->MoveRetiringPage(itr->second)) {
+      return this->page_table_.find(page_id);
+    }
+    // Unpinned with no frame to move to, or held past the limit, maybe by this very thread.
+    if (this->frames_[itr->second]->pin_count_ == 0 || std::chrono::steady_clock::now() >= deadline) {
+      return itr;
+    }
+    // Page guards release pins without latch_, so this polls like the resize worker.
+    this->load_cv_.wait_for(*lk, RESIZE_POLL_INTERVAL);
+  }
+}
 
-  page_ptr->is_dirty_ |= is_dirty;
-  if (--page_ptr->pin_count_ == 0) {
+auto BufferPoolManagerInstance::MoveRetiringPage(frame_id_t frame_id) -> bool {
+  Page *from = this->frames_[frame_id];
+  if (this->frame_status_[frame_id] != FrameStatus::RETIRING || from->pin_count_ > 0 ||
+      this->pending_loads_.count(frame_id) != 0) {
+    return false;
+  }
+  // Otherwise the victim search could pick this frame and evict the page it is about to move.
+  this->replacer_->Pin(frame_id);
+  frame_id_t to_frame_id;
+  if (!this->AcquireFrame(&to_frame_id)) {
     this->replacer_->Unpin(frame_id);
+    return false;
+  }
+
+  Page *to = this->frames_[to_frame_id];
+  std::memcpy(to->data_, from->data_, PAGE_SIZE);
+  to->page_id_ = from->page_id_;
+  to->is_dirty_ = from->is_dirty_.load();
+  to->rec_lsn_ = from->rec_lsn_.load();
+  to->EndUpdate();
+  this->page_table_[to->page_id_] = to_frame_id;
+  this->last_access_[to_frame_id] = this->last_access_[frame_id].load();
+
+  from->BeginUpdate();
+  from->page_id_ = INVALID_PAGE_ID;
+  from->EndUpdate();
+  from->is_dirty_ = false;
+  this->replacer_->Remove(frame_id);
+  this->frame_status_[frame_id] = FrameStatus::RETIRED;
+  return true;
+}
+
+auto BufferPoolManagerInstance::WritePageBack(page_id_t page_id, bool only_dirty) -> bool {
+  Page *page_ptr;
+  frame_id_t frame_id;
+  {
+    std::unique_lock<std::shared_mutex> lk(this->latch_);
+    auto itr = this->FindLoadedPage(&lk, page_id);
+    if (itr == this->page_table_.end()) {
+      return false;
+    }
+    frame_id = itr->second;
+    page_ptr = this->frames_[frame_id];
+    if (only_dirty && !page_ptr->is_dirty_) {
+      return true;
+    }
+    if (++page_ptr->pin_count_ == 1) {
+      this->replacer_->Pin(frame_id);
+    }
+  }
+
+  // No writer holds the page while it is copied. Changes made after the copy set the dirty flag again on unpin and
+  // get log records at or past the new recovery LSN.
+  char data[PAGE_SIZE];
+  page_ptr->RLatch();
+  memcpy(data, page_ptr->data_, PAGE_SIZE);
+  page_ptr->is_dirty_ = false;
+  page_ptr->rec_lsn_ = this->GetEndOfLog();
+  page_ptr->RUnlatch();
+
+  if (this->log_manager_ != nullptr && enable_logging) {
+    lsn_t page_lsn;
+    memcpy(&page_lsn, data + Page::OFFSET_LSN, sizeof(lsn_t));
+    this->log_manager_->FlushToLSN(page_lsn);
+  }
+  this->disk_manager_->WritePage(page_id, data);
+  this->ReleasePage(page_ptr, frame_id, false);
+  return true;
+}
+
+void BufferPoolManagerInstance::ForceLogForPage(Page *page) {
+  if (this->log_manager_ == nullptr || !enable_logging) {
+    return;
+  }
+  lsn_t page_lsn = page->GetLSN();
+  // Most of the time the flush thread is already past the page LSN and the log latch is not even taken.
+  if (page_lsn > this->log_manager_->GetPersistentLSN()) {
+    this->log_manager_->FlushToLSN(page_lsn);
   }
+}
 
+auto BufferPoolManagerInstance::LoadFromCompressedCache(page_id_t page_id, Page *page) -> bool {
+  page->rec_lsn_ = this->GetEndOfLog();
+  if (this->compressed_cache_ == nullptr) {
+    return false;
+  }
+  auto start = std::chrono::steady_clock::now();
+  bool is_dirty;
+  lsn_t rec_lsn;
+  if (!this->compressed_cache_->Lookup(page_id, page->data_, &is_dirty, &rec_lsn)) {
+    this->stats_.compressed_.RecordMiss();
+    return false;
+  }
+  page->is_dirty_ = is_dirty;
+  if (is_dirty) {
+    page->rec_lsn_ = rec_lsn;
+  }
+  this->stats_.compressed_.RecordHit(ElapsedNs(start));
   return true;
 }
 
+void BufferPoolManagerInstance::ReadFromDisk(page_id_t page_id, Page *page) {
+  auto start = std::chrono::steady_clock::now();
+  // DiskManager leaves the buffer untouched on a read past the end of the file, which must read as a zero page.
+  page->ResetMemory();
+  this->disk_manager_->ReadPage(page_id, page->data_);
+  this->stats_.disk_.RecordHit(ElapsedNs(start));
+}
+
 auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
   const page_id_t next_page_id = next_page_id_;
   next_page_id_ += num_instances_;
@@ -234,6 +1079,12 @@ auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
   return next_page_id;
 }
 
+void BufferPoolManagerInstance::DeallocatePage(page_id_t page_id) {
+  if (this->free_space_map_ != nullptr) {
+    this->free_space_map_->DeallocatePage(page_id);
+  }
+}
+
 void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
   assert(page_id % num_instances_ == instance_index_);  // allocated pages mod back to this BPI
 }
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_warmer.cpp
+//
+// Identification: src/buffer/buffer_pool_warmer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_warmer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+BufferPoolWarmer::BufferPoolWarmer(BufferPoolManagerInstance *bpm, std::string path_prefix)
+    : instances_{bpm}, path_prefix_(std::move(path_prefix)) {}
+
+BufferPoolWarmer::BufferPoolWarmer(ParallelBufferPoolManager *bpm, std::string path_prefix)
+    : path_prefix_(std::move(path_prefix)) {
+  for (size_t i = 0; i < bpm->GetNumInstances(); ++i) {
+    this->instances_.push_back(bpm->GetInstance(i));
+  }
+}
+
+BufferPoolWarmer::~BufferPoolWarmer() {
+  {
+    std::lock_guard<std::mutex> lg(this->mutex_);
+    this->stop_ = true;
+  }
+  this->cv_.notify_all();
+  if (this->load_thread_.joinable()) {
+    this->load_thread_.join();
+  }
+  if (this->dump_thread_.joinable()) {
+    this->dump_thread_.join();
+  }
+}
+
+auto BufferPoolWarmer::Dump() -> bool {
+  bool ok = true;
+  for (size_t i = 0; i < this->instances_.size(); ++i) {
+    ok = this->DumpInstance(i) && ok;
+  }
+  return ok;
+}
+
+void BufferPoolWarmer::StartPeriodicDump(std::chrono::milliseconds interval) {
+  BUSTUB_ASSERT(!this->dump_thread_.joinable(), "Periodic dump is already running.");
+  this->dump_thread_ = std::thread([this, interval] {
+    std::unique_lock<std::mutex> lk(this->mutex_);
+    while (!this->stop_) {
+      this->cv_.wait_for(lk, interval, [this] { return this->stop_; });
+      lk.unlock();
+      this->Dump();
+      lk.lock();
+    }
+  });
+}
+
+void BufferPoolWarmer::StartLoad(size_t batch_size) {
+  BUSTUB_ASSERT(!this->load_thread_.joinable(), "Load is already running.");
+  BUSTUB_ASSERT(batch_size > 0, "Batch size must be positive.");
+  this->load_thread_ = std::thread([this, batch_size] {
+    for (size_t i = 0; i < this->instances_.size(); ++i) {
+      this->LoadInstance(i, batch_size);
+    }
+  });
+}
+
+void BufferPoolWarmer::WaitForLoad() {
+  if (this->load_thread_.joinable()) {
+    this->load_thread_.join();
+  }
+}
+
+auto BufferPoolWarmer::GetPath(size_t instance_index) -> std::string {
+  return this->path_prefix_ + "." + std::to_string(instance_index);
+}
+
+auto BufferPoolWarmer::DumpInstance(size_t instance_index) -> bool {
+  std::vector<page_id_t> page_ids = this->instances_[instance_index]->GetHotPages();
+
+  std::string path = this->GetPath(instance_index);
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::out | std::ios::trunc);
+    for (page_id_t page_id : page_ids) {
+      out << page_id << '\n';
+    }
+    if (!out.good()) {
+      LOG_WARN("could not write hot page list %s", tmp_path.c_str());
+      return false;
+    }
+  }
+  // The list must be on disk before the rename replaces the previous one, or a crash can leave an empty dump.
+  int fd = open(tmp_path.c_str(), O_RDONLY);
+  if (fd < 0 || fsync(fd) != 0) {
+    LOG_WARN("could not sync hot page list %s: %s", tmp_path.c_str(), std::strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  close(fd);
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG_WARN("could not replace hot page list %s: %s", path.c_str(), std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void BufferPoolWarmer::LoadInstance(size_t instance_index, size_t batch_size) {
+  BufferPoolManagerInstance *bpm = this->instances_[instance_index];
+  std::ifstream in(this->GetPath(instance_index));
+  if (!in.is_open()) {
+    return;
+  }
+
+  // Only the hottest pool-size pages can fit.
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  while (page_ids.size() < bpm->GetPoolSize() && in >> page_id) {
+    if (bpm->IsOwnPage(page_id)) {
+      page_ids.push_back(page_id);
+    }
+  }
+
+  for (size_t start = 0; start < page_ids.size(); start += batch_size) {
+    {
+      std::lock_guard<std::mutex> lg(this->mutex_);
+      if (this->stop_) {
+        return;
+      }
+    }
+    std::vector<page_id_t> batch(page_ids.begin() + start,
+                                 page_ids.begin() + std::min(start + batch_size, page_ids.size()));
+    std::sort(batch.begin(), batch.end());
+    size_t loaded = 0;
+    bool has_room = bpm->PrefetchPages(batch, &loaded);
+    this->loaded_pages_ += loaded;
+    if (!has_room) {
+      return;
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_replacer.cpp
+//
+// Identification: src/buffer/buffered_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffered_replacer.h"
+
+#include <thread>  // NOLINT
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+/** Hands every thread a stripe index once, so that threads spread evenly over the stripes. */
+std::atomic<size_t> next_thread_index{0};
+
+}  // namespace
+
+BufferedReplacer::BufferedReplacer(size_t num_pages, Replacer *policy)
+    : policy_(policy), segments_(new std::atomic<FrameState *>[MAX_SEGMENTS]) {
+  for (size_t i = 0; i < MAX_SEGMENTS; ++i) {
+    this->segments_[i].store(nullptr, std::memory_order_relaxed);
+  }
+  this->AllocateSegments(num_pages);
+  size_t num_stripes = 4;
+  while (num_stripes < std::thread::hardware_concurrency()) {
+    num_stripes <<= 1;
+  }
+  for (size_t i = 0; i < num_stripes; ++i) {
+    this->stripes_.emplace_back(new Stripe);
+  }
+}
+
+BufferedReplacer::~BufferedReplacer() {
+  for (size_t i = 0; i < MAX_SEGMENTS; ++i) {
+    delete[] this->segments_[i].load(std::memory_order_relaxed);
+  }
+  delete this->policy_;
+}
+
+auto BufferedReplacer::Victim(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->DrainAll();
+  if (!this->policy_->Victim(frame_id)) {
+    return false;
+  }
+  // The frame leaves the policy. Replaying an access of its next page must not make it evictable again.
+  this->GetFrameState(*frame_id).evictable_.store(false);
+  return true;
+}
+
+void BufferedReplacer::Pin(frame_id_t frame_id) {
+  this->GetFrameState(frame_id).evictable_.store(false);
+  this->Enqueue(frame_id);
+}
+
+void BufferedReplacer::Unpin(frame_id_t frame_id) {
+  this->GetFrameState(frame_id).evictable_.store(true);
+  this->Enqueue(frame_id);
+}
+
+auto BufferedReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->DrainAll();
+  return this->policy_->Size();
+}
+
+void BufferedReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  FrameState &state = this->GetFrameState(frame_id);
+  state.page_id_.store(page_id);
+  state.accessed_.store(true);
+  this->Enqueue(frame_id);
+}
+
+void BufferedReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->DrainAll();
+  FrameState &state = this->GetFrameState(frame_id);
+  state.evictable_.store(false);
+  state.accessed_.store(false);
+  this->policy_->Remove(frame_id);
+}
+
+void BufferedReplacer::SetCapacity(size_t num_pages) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->AllocateSegments(num_pages);
+  this->DrainAll();
+  this->policy_->SetCapacity(num_pages);
+}
+
+void BufferedReplacer::Enqueue(frame_id_t frame_id) {
+  // The state was stored before this exchange. If the frame is queued already, the replay clears queued_ before it
+  // reads the state, so it is bound to see what was just stored.
+  if (this->GetFrameState(frame_id).queued_.exchange(true)) {
+    return;
+  }
+
+  Stripe *stripe = this->LocalStripe();
+  if (this->TryAppend(stripe, frame_id)) {
+    if (stripe->tail_.load(std::memory_order_relaxed) - stripe->head_.load(std::memory_order_relaxed) >=
+            STRIPE_CAPACITY / 2 &&
+        this->mutex_.try_lock()) {
+      this->Drain(stripe);
+      this->mutex_.unlock();
+    }
+    return;
+  }
+
+  // The stripe is full or contended: replay under the lock instead.
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->Drain(stripe);
+  this->Replay(frame_id);
+}
+
+auto BufferedReplacer::TryAppend(Stripe *stripe, frame_id_t frame_id) -> bool {
+  uint64_t tail = stripe->tail_.load(std::memory_order_relaxed);
+  if (tail - stripe->head_.load(std::memory_order_acquire) >= STRIPE_CAPACITY) {
+    return false;
+  }
+  if (!stripe->tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_relaxed)) {
+    return false;
+  }
+  // The slot is claimed, publish the frame id. The consumer stops at a slot that still reads -1.
+  stripe->slots_[tail % STRIPE_CAPACITY].store(frame_id, std::memory_order_release);
+  return true;
+}
+
+void BufferedReplacer::DrainAll() {
+  for (auto &stripe : this->stripes_) {
+    this->Drain(stripe.get());
+  }
+}
+
+void BufferedReplacer::Drain(Stripe *stripe) {
+  uint64_t head = stripe->head_.load(std::memory_order_relaxed);
+  uint64_t tail = stripe->tail_.load(std::memory_order_acquire);
+  for (; head != tail; ++head) {
+    std::atomic<frame_id_t> &slot = stripe->slots_[head % STRIPE_CAPACITY];
+    frame_id_t frame_id = slot.load(std::memory_order_acquire);
+    if (frame_id == -1) {
+      // Claimed but not written yet, the rest is picked up by the next drain.
+      break;
+    }
+    slot.store(-1, std::memory_order_relaxed);
+    this->Replay(frame_id);
+  }
+  stripe->head_.store(head, std::memory_order_release);
+}
+
+void BufferedReplacer::Replay(frame_id_t frame_id) {
+  FrameState &state = this->GetFrameState(frame_id);
+  // Cleared before the state is read, see Enqueue.
+  state.queued_.store(false);
+  if (state.accessed_.exchange(false)) {
+    this->policy_->RecordAccess(frame_id, state.page_id_.load());
+  }
+  if (state.evictable_.load()) {
+    this->policy_->Unpin(frame_id);
+  } else {
+    this->policy_->Pin(frame_id);
+  }
+}
+
+void BufferedReplacer::AllocateSegments(size_t num_pages) {
+  size_t num_segments = (num_pages + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
+  BUSTUB_ASSERT(num_segments <= MAX_SEGMENTS, "Too many frames for BufferedReplacer.");
+  for (size_t i = 0; i < num_segments; ++i) {
+    if (this->segments_[i].load(std::memory_order_relaxed) == nullptr) {
+      this->segments_[i].store(new FrameState[SEGMENT_SIZE], std::memory_order_release);
+    }
+  }
+}
+
+auto BufferedReplacer::LocalStripe() -> Stripe * {
+  thread_local const size_t thread_index = next_thread_index.fetch_add(1);
+  return this->stripes_[thread_index & (this->stripes_.size() - 1)].get();
+}
+
+}  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+CompressedPageCache::CompressedPageCache(size_t capacity_bytes, PageCompressor *compressor, DiskManager *disk_manager)
+    : capacity_bytes_(capacity_bytes), compressor_(compressor), disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(compressor != nullptr, "Compressed page cache needs a codec.");
+}
+
+auto CompressedPageCache::Insert(page_id_t page_id, const char *page_data, bool is_dirty, lsn_t rec_lsn) -> bool {
+  char buf[MAX_COMPRESSED_SIZE];
+  // Compress outside of the latch, it is the expensive part.
+  size_t size = this->compressor_->Compress(page_data, PAGE_SIZE, buf, sizeof(buf));
+  if (size == 0 || size > this->capacity_bytes_) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lg(this->latch_);
+
+  auto itr = this->index_.find(page_id);
+  if (itr != this->index_.end()) {
+    if (itr->second->is_dirty_) {
+      // The older changes are not on disk either.
+      rec_lsn = is_dirty ? std::min(rec_lsn, itr->second->rec_lsn_) : itr->second->rec_lsn_;
+      is_dirty = true;
+    }
+    this->used_bytes_ -= itr->second->data_.size();
+    this->lru_list_.erase(itr->second);
+    this->index_.erase(itr);
+  }
+
+  while (this->used_bytes_ + size > this->capacity_bytes_) {
+    this->EvictOne();
+  }
+
+  this->lru_list_.push_front(Entry{page_id, is_dirty, rec_lsn, std::vector<char>(buf, buf + size)});
+  this->index_[page_id] = this->lru_list_.begin();
+  this->used_bytes_ += size;
+  return true;
+}
+
+auto CompressedPageCache::Lookup(page_id_t page_id, char *page_data, bool *is_dirty, lsn_t *rec_lsn) -> bool {
+  std::vector<char> data;
+  {
+    std::lock_guard<std::mutex> lg(this->latch_);
+    auto itr = this->index_.find(page_id);
+    if (itr == this->index_.end()) {
+      return false;
+    }
+    *is_dirty = itr->second->is_dirty_;
+    if (rec_lsn != nullptr) {
+      *rec_lsn = itr->second->rec_lsn_;
+    }
+    data = std::move(itr->second->data_);
+    this->used_bytes_ -= data.size();
+    this->lru_list_.erase(itr->second);
+    this->index_.erase(itr);
+  }
+
+  bool ok = this->compressor_->Decompress(data.data(), data.size(), page_data, PAGE_SIZE);
+  BUSTUB_ASSERT(ok, "Compressed page image is corrupted.");
+  return ok;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::lock_guard<std::mutex> lg(this->latch_);
+  auto itr = this->index_.find(page_id);
+  if (itr == this->index_.end()) {
+    return;
+  }
+  this->used_bytes_ -= itr->second->data_.size();
+  this->lru_list_.erase(itr->second);
+  this->index_.erase(itr);
+}
+
+void CompressedPageCache::FlushAll() {
+  std::lock_guard<std::mutex> lg(this->latch_);
+  for (Entry &entry : this->lru_list_) {
+    if (entry.is_dirty_) {
+      this->WriteBack(entry);
+      entry.is_dirty_ = false;
+    }
+  }
+}
+
+void CompressedPageCache::FlushPage(page_id_t page_id) {
+  std::lock_guard<std::mutex> lg(this->latch_);
+  auto itr = this->index_.find(page_id);
+  if (itr != this->index_.end() && itr->second->is_dirty_) {
+    this->WriteBack(*itr->second);
+    itr->second->is_dirty_ = false;
+  }
+}
+
+void CompressedPageCache::GetDirtyPages(std::vector<std::pair<page_id_t, lsn_t>> *dirty_pages) {
+  std::lock_guard<std::mutex> lg(this->latch_);
+  for (const Entry &entry : this->lru_list_) {
+    if (entry.is_dirty_) {
+      dirty_pages->emplace_back(entry.page_id_, entry.rec_lsn_);
+    }
+  }
+}
+
+auto CompressedPageCache::GetUsedBytes() -> size_t {
+  std::lock_guard<std::mutex> lg(this->latch_);
+  return this->used_bytes_;
+}
+
+auto CompressedPageCache::Size() -> size_t {
+  std::lock_guard<std::mutex> lg(this->latch_);
+  return this->index_.size();
+}
+
+void CompressedPageCache::EvictOne() {
+  BUSTUB_ASSERT(!this->lru_list_.empty(), "Cannot evict from an empty compressed page cache.");
+  const Entry &victim = this->lru_list_.back();
+  if (victim.is_dirty_) {
+    this->WriteBack(victim);
+  }
+  this->used_bytes_ -= victim.data_.size();
+  this->index_.erase(victim.page_id_);
+  this->lru_list_.pop_back();
+}
+
+void CompressedPageCache::WriteBack(const Entry &entry) {
+  char page_data[PAGE_SIZE];
+  bool ok = this->compressor_->Decompress(entry.data_.data(), entry.data_.size(), page_data, PAGE_SIZE);
+  BUSTUB_ASSERT(ok, "Compressed page image is corrupted.");
+  this->disk_manager_->WritePage(entry.page_id_, page_data);
+}
+
+}  // namespace bustub
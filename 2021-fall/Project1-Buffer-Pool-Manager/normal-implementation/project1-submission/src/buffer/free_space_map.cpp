@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/buffer/free_space_map.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/free_space_map.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *bpm, uint32_t num_instances, uint32_t instance_index)
+    : bpm_(bpm), num_instances_(num_instances), instance_index_(instance_index) {}
+
+auto FreeSpaceMap::AllocatePage() -> page_id_t {
+  for (uint32_t group = this->first_group_;; ++group) {
+    uint32_t bit;
+    if (!this->AllocateInGroup(group, 0, 1, &bit)) {
+      return INVALID_PAGE_ID;
+    }
+    if (bit != FreeSpaceMapPage::NUM_BITS) {
+      return this->ToPageId(group, bit);
+    }
+  }
+}
+
+auto FreeSpaceMap::AllocateExtent(size_t count, std::vector<page_id_t> *page_ids) -> bool {
+  BUSTUB_ASSERT(count > 0 && count < FreeSpaceMapPage::NUM_BITS, "Extent does not fit in a group.");
+  for (uint32_t group = this->first_group_;; ++group) {
+    // Bit 0 is separated from bit 1 by the map page, runs start at bit 1 to be contiguous.
+    uint32_t bit;
+    if (!this->AllocateInGroup(group, 1, static_cast<uint32_t>(count), &bit)) {
+      return false;
+    }
+    if (bit != FreeSpaceMapPage::NUM_BITS) {
+      for (size_t i = 0; i < count; ++i) {
+        page_ids->push_back(this->ToPageId(group, bit + static_cast<uint32_t>(i)));
+      }
+      return true;
+    }
+  }
+}
+
+void FreeSpaceMap::DeallocatePage(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id % this->num_instances_ == this->instance_index_, "Page belongs to another instance.");
+  if (this->IsMapPage(page_id)) {
+    return;
+  }
+  uint32_t local = static_cast<uint32_t>(page_id) / this->num_instances_;
+  uint32_t group = local / GROUP_SPAN;
+  uint32_t offset = local % GROUP_SPAN;
+  uint32_t bit = offset == 0 ? 0 : offset - 1;
+
+  Page *page = this->bpm_->FetchPage(this->GetMapPageId(group));
+  if (page == nullptr) {
+    // Leaks the page until the next time it is deleted, nothing is lost.
+    return;
+  }
+  page->WLatch();
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->SetAllocated(bit, false);
+  this->LowerFirstGroup(group);
+  page->WUnlatch();
+  this->bpm_->UnpinPage(page->GetPageId(), true);
+}
+
+auto FreeSpaceMap::IsMapPage(page_id_t page_id) const -> bool {
+  return (static_cast<uint32_t>(page_id) / this->num_instances_) % GROUP_SPAN == 1;
+}
+
+auto FreeSpaceMap::GetMapPageId(uint32_t group) const -> page_id_t {
+  return static_cast<page_id_t>((group * GROUP_SPAN + 1) * this->num_instances_ + this->instance_index_);
+}
+
+auto FreeSpaceMap::ToPageId(uint32_t group, uint32_t bit) const -> page_id_t {
+  uint32_t offset = bit == 0 ? 0 : bit + 1;
+  return static_cast<page_id_t>((group * GROUP_SPAN + offset) * this->num_instances_ + this->instance_index_);
+}
+
+auto FreeSpaceMap::AllocateInGroup(uint32_t group, uint32_t start, uint32_t count, uint32_t *bit) -> bool {
+  Page *page = this->bpm_->FetchPage(this->GetMapPageId(group));
+  if (page == nullptr) {
+    return false;
+  }
+  page->WLatch();
+  auto *map = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  if (map->IsFull()) {
+    // The hint moves under the map page latch, so a concurrent DeallocatePage of this group lowers it afterwards.
+    uint32_t expected = group;
+    this->first_group_.compare_exchange_strong(expected, group + 1);
+    *bit = FreeSpaceMapPage::NUM_BITS;
+  } else {
+    *bit = map->FindFreeRun(start, count);
+  }
+  bool found = *bit != FreeSpaceMapPage::NUM_BITS;
+  if (found) {
+    for (uint32_t i = 0; i < count; ++i) {
+      map->SetAllocated(*bit + i, true);
+    }
+  }
+  page->WUnlatch();
+  this->bpm_->UnpinPage(page->GetPageId(), found);
+  return true;
+}
+
+void FreeSpaceMap::LowerFirstGroup(uint32_t group) {
+  uint32_t first = this->first_group_;
+  while (group < first && !this->first_group_.compare_exchange_weak(first, group)) {
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_executor.cpp
+//
+// Identification: src/buffer/io_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/io_executor.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bustub {
+
+IoExecutor::IoExecutor(size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+  for (size_t i = 0; i < num_threads; ++i) {
+    this->workers_.push_back(std::make_unique<Worker>());
+  }
+  for (auto &worker : this->workers_) {
+    worker->thread_ = std::thread(&IoExecutor::Run, worker.get());
+  }
+}
+
+IoExecutor::~IoExecutor() {
+  for (auto &worker : this->workers_) {
+    {
+      std::lock_guard<std::mutex> lg(worker->mutex_);
+      worker->stop_ = true;
+    }
+    worker->cv_.notify_one();
+  }
+  for (auto &worker : this->workers_) {
+    worker->thread_.join();
+  }
+}
+
+void IoExecutor::Submit(size_t key, std::function<void()> task) {
+  Worker *worker = this->workers_[key % this->workers_.size()].get();
+  {
+    std::lock_guard<std::mutex> lg(worker->mutex_);
+    worker->tasks_.push_back(std::move(task));
+  }
+  worker->cv_.notify_one();
+}
+
+void IoExecutor::Run(Worker *worker) {
+  std::unique_lock<std::mutex> lk(worker->mutex_);
+  while (true) {
+    worker->cv_.wait(lk, [worker] { return worker->stop_ || !worker->tasks_.empty(); });
+    if (worker->tasks_.empty()) {
+      return;
+    }
+    std::function<void()> task = std::move(worker->tasks_.front());
+    worker->tasks_.pop_front();
+    lk.unlock();
+    task();
+    lk.lock();
+  }
+}
+
+}  // namespace bustub
@@ -52,4 +52,10 @@ auto LRUReplacer::Size() -> size_t {
   return this->list_.Size();
 }
 
+void LRUReplacer::SetCapacity(size_t num_pages) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->list_.Grow(num_pages);
+  this->hash_.Grow(num_pages);
+}
+
 }  // namespace bustub
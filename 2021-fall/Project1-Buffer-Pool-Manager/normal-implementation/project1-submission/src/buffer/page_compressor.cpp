@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.cpp
+//
+// Identification: src/buffer/page_compressor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_compressor.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+inline auto Read32(const char *p) -> uint32_t {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline auto HashSequence(uint32_t seq, int hash_log) -> uint32_t { return (seq * 2654435761U) >> (32 - hash_log); }
+
+// Writes the extension bytes of a length whose nibble in the token was saturated.
+inline auto PutLength(size_t len, char *dst, size_t dst_capacity, size_t *op) -> bool {
+  while (len >= 255) {
+    if (*op >= dst_capacity) {
+      return false;
+    }
+    dst[(*op)++] = static_cast<char>(255);
+    len -= 255;
+  }
+  if (*op >= dst_capacity) {
+    return false;
+  }
+  dst[(*op)++] = static_cast<char>(len);
+  return true;
+}
+
+// Reads the extension bytes of a saturated length nibble.
+inline auto GetLength(const unsigned char *src, size_t src_size, size_t *ip, size_t *len) -> bool {
+  unsigned char b;
+  do {
+    if (*ip >= src_size) {
+      return false;
+    }
+    b = src[(*ip)++];
+    *len += b;
+  } while (b == 255);
+  return true;
+}
+
+}  // namespace
+
+auto LZPageCompressor::Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t {
+  uint32_t table[1 << HASH_LOG] = {};  // position + 1 of the last occurrence, 0 means empty
+  size_t ip = 0;
+  size_t anchor = 0;
+  size_t op = 0;
+
+  // Emits one sequence: literals [anchor, anchor + lit_len), then an optional match (match_len == 0 means none).
+  auto emit = [&](size_t lit_len, size_t offset, size_t match_len) -> bool {
+    if (op >= dst_capacity) {
+      return false;
+    }
+    size_t token_pos = op++;
+    unsigned char token = static_cast<unsigned char>((lit_len >= 15 ? 15 : lit_len) << 4);
+    if (lit_len >= 15 && !PutLength(lit_len - 15, dst, dst_capacity, &op)) {
+      return false;
+    }
+    if (op + lit_len > dst_capacity) {
+      return false;
+    }
+    memcpy(dst + op, src + anchor, lit_len);
+    op += lit_len;
+    if (match_len > 0) {
+      if (op + 2 > dst_capacity) {
+        return false;
+      }
+      dst[op++] = static_cast<char>(offset & 0xFF);
+      dst[op++] = static_cast<char>(offset >> 8);
+      size_t ml = match_len - MIN_MATCH;
+      token |= static_cast<unsigned char>(ml >= 15 ? 15 : ml);
+      if (ml >= 15 && !PutLength(ml - 15, dst, dst_capacity, &op)) {
+        return false;
+      }
+    }
+    dst[token_pos] = static_cast<char>(token);
+    return true;
+  };
+
+  if (src_size > MIN_MATCH + LAST_LITERALS) {
+    const size_t match_limit = src_size - LAST_LITERALS;
+    while (ip + MIN_MATCH <= match_limit) {
+      uint32_t seq = Read32(src + ip);
+      uint32_t h = HashSequence(seq, HASH_LOG);
+      size_t ref = table[h];
+      table[h] = static_cast<uint32_t>(ip + 1);
+      if (ref == 0 || ip - (ref - 1) > MAX_OFFSET || Read32(src + ref - 1) != seq) {
+        ++ip;
+        continue;
+      }
+      size_t match = ref - 1;
+      size_t len = MIN_MATCH;
+      while (ip + len < match_limit && src[match + len] == src[ip + len]) {
+        ++len;
+      }
+      if (!emit(ip - anchor, ip - match, len)) {
+        return 0;
+      }
+      ip += len;
+      anchor = ip;
+    }
+  }
+
+  // The last sequence carries only literals.
+  if (!emit(src_size - anchor, 0, 0)) {
+    return 0;
+  }
+  return op;
+}
+
+auto LZPageCompressor::Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool {
+  const auto *in = reinterpret_cast<const unsigned char *>(src);
+  size_t ip = 0;
+  size_t op = 0;
+
+  while (ip < src_size) {
+    unsigned char token = in[ip++];
+    size_t lit_len = token >> 4;
+    if (lit_len == 15 && !GetLength(in, src_size, &ip, &lit_len)) {
+      return false;
+    }
+    if (ip + lit_len > src_size || op + lit_len > dst_size) {
+      return false;
+    }
+    memcpy(dst + op, src + ip, lit_len);
+    ip += lit_len;
+    op += lit_len;
+
+    if (ip == src_size) {
+      break;  // last sequence
+    }
+
+    if (ip + 2 > src_size) {
+      return false;
+    }
+    size_t offset = in[ip] | (static_cast<size_t>(in[ip + 1]) << 8);
+    ip += 2;
+    size_t match_len = token & 0x0F;
+    if (match_len == 15 && !GetLength(in, src_size, &ip, &match_len)) {
+      return false;
+    }
+    match_len += MIN_MATCH;
+    if (offset == 0 || offset > op || op + match_len > dst_size) {
+      return false;
+    }
+    // Byte-by-byte copy: the match may overlap the bytes being produced.
+    for (size_t i = 0; i < match_len; ++i, ++op) {
+      dst[op] = dst[op - offset];
+    }
+  }
+
+  return op == dst_size;
+}
+
+}  // namespace bustub
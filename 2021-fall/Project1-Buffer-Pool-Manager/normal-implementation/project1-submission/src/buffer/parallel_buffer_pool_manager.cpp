@@ -12,23 +12,38 @@
 
 #include "buffer/parallel_buffer_pool_manager.h"
 
+#include <algorithm>
+#include <future>  // NOLINT
+#include <memory>
+#include <utility>
+
+#include "common/macros.h"
+
 namespace bustub {
 
 ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : buffer_pool_managers_(num_instances), buffer_pool_manager_index_(0) {
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : buffer_pool_managers_(num_instances), buffer_pool_manager_index_(0), disk_manager_(disk_manager) {
   // Allocate and create individual BufferPoolManagerInstances
   for (size_t i = 0; i < num_instances; ++i) {
     this->buffer_pool_managers_[i] =
-        new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager);
+        new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager, replacer_type);
   }
 }
 
 // Update constructor to destruct all BufferPoolManagerInstances and deallocate any associated memory
 ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // Pending reads finish before the instances they load into go away, and before the executor their callbacks go to.
+  for (BufferPoolManagerInstance *b : this->buffer_pool_managers_) {
+    b->DrainLoads();
+  }
+  delete this->io_executor_;
   for (BufferPoolManager *b : this->buffer_pool_managers_) {
     delete b;
   }
+  for (CompressedPageCache *c : this->compressed_caches_) {
+    delete c;
+  }
 }
 
 auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
@@ -41,7 +56,69 @@ auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
   return total_size;
 }
 
-auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager * {
+void ParallelBufferPoolManager::Resize(size_t pool_size) {
+  for (BufferPoolManagerInstance *b : this->buffer_pool_managers_) {
+    b->Resize(pool_size);
+  }
+}
+
+void ParallelBufferPoolManager::WaitForResize() {
+  for (BufferPoolManagerInstance *b : this->buffer_pool_managers_) {
+    b->WaitForResize();
+  }
+}
+
+void ParallelBufferPoolManager::EnableAsyncFetch(size_t num_threads) {
+  BUSTUB_ASSERT(this->io_executor_ == nullptr, "Async fetch is already enabled.");
+  this->io_executor_ = new IoExecutor(num_threads);
+}
+
+void ParallelBufferPoolManager::FetchPageAsync(page_id_t page_id, std::function<void(Page *)> callback) {
+  BUSTUB_ASSERT(this->io_executor_ != nullptr, "Async fetch is not enabled.");
+  this->GetBufferPoolManager(page_id)->FetchPageAsync(page_id, this->io_executor_, std::move(callback));
+}
+
+auto ParallelBufferPoolManager::FetchPageAsync(page_id_t page_id) -> std::future<Page *> {
+  auto promise = std::make_shared<std::promise<Page *>>();
+  std::future<Page *> future = promise->get_future();
+  this->FetchPageAsync(page_id, [promise](Page *page) { promise->set_value(page); });
+  return future;
+}
+
+void ParallelBufferPoolManager::EnableFreeSpaceMap() {
+  for (BufferPoolManagerInstance *b : this->buffer_pool_managers_) {
+    b->EnableFreeSpaceMap();
+  }
+}
+
+void ParallelBufferPoolManager::EnableCompressedPageCache(size_t capacity_bytes, PageCompressor *compressor) {
+  BUSTUB_ASSERT(this->compressed_caches_.empty(), "Compressed page cache is already enabled.");
+  size_t capacity_per_instance = capacity_bytes / this->buffer_pool_managers_.size();
+  for (BufferPoolManagerInstance *b : this->buffer_pool_managers_) {
+    auto *cache = new CompressedPageCache(capacity_per_instance, compressor, this->disk_manager_);
+    this->compressed_caches_.push_back(cache);
+    b->SetCompressedPageCache(cache);
+  }
+}
+
+void ParallelBufferPoolManager::CollectStats(BufferPoolStats *stats) {
+  auto add = [](CacheTierStats *dst, const CacheTierStats &src) {
+    dst->hits_ += src.hits_.load();
+    dst->misses_ += src.misses_.load();
+    dst->hit_latency_ns_ += src.hit_latency_ns_.load();
+  };
+  for (BufferPoolManagerInstance *b : this->buffer_pool_managers_) {
+    const BufferPoolStats &s = b->GetStats();
+    add(&stats->pool_, s.pool_);
+    add(&stats->compressed_, s.compressed_);
+    add(&stats->disk_, s.disk_);
+    for (size_t i = 0; i < LatencyHistogram::NUM_BUCKETS; ++i) {
+      stats->fetch_latency_.buckets_[i] += s.fetch_latency_.buckets_[i].load();
+    }
+  }
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
   // Get BufferPoolManager responsible for handling given page id. You can use this method in your other methods.
   return this->buffer_pool_managers_[page_id % this->buffer_pool_managers_.size()];
 }
@@ -90,6 +167,80 @@ auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
   return b->DeletePage(page_id);
 }
 
+auto ParallelBufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
+  return this->GetBufferPoolManager(page_id)->FetchPageRead(page_id);
+}
+
+auto ParallelBufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
+  return this->GetBufferPoolManager(page_id)->FetchPageWrite(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPageGuarded(page_id_t *page_id) -> WritePageGuard {
+  std::lock_guard<std::mutex> lg(this->latch_);
+  for (size_t i = 0; i < this->buffer_pool_managers_.size(); ++i) {
+    BufferPoolManagerInstance *b = this->buffer_pool_managers_[this->buffer_pool_manager_index_];
+    this->buffer_pool_manager_index_ = (this->buffer_pool_manager_index_ + 1) % this->buffer_pool_managers_.size();
+    WritePageGuard guard = b->NewPageGuarded(page_id);
+    if (guard.IsValid()) {
+      return guard;
+    }
+  }
+
+  return {};
+}
+
+auto ParallelBufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) -> bool {
+  const size_t num_instances = this->buffer_pool_managers_.size();
+  std::vector<std::vector<page_id_t>> group_ids(num_instances);
+  std::vector<std::vector<size_t>> group_positions(num_instances);
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    size_t instance = page_ids[i] % num_instances;
+    group_ids[instance].push_back(page_ids[i]);
+    group_positions[instance].push_back(i);
+  }
+
+  pages->assign(page_ids.size(), nullptr);
+  std::vector<std::vector<Page *>> group_pages(num_instances);
+  std::vector<std::vector<frame_id_t>> group_frames(num_instances);
+  std::vector<std::vector<BufferPoolManagerInstance::FrameLoad>> group_loads(num_instances);
+  std::vector<char> ok(num_instances, 1);
+  for (size_t instance = 0; instance < num_instances; ++instance) {
+    if (group_ids[instance].empty()) {
+      continue;
+    }
+    group_pages[instance].resize(group_ids[instance].size());
+    ok[instance] = static_cast<char>(this->buffer_pool_managers_[instance]->PinPages(
+        group_ids[instance], group_pages[instance].data(), &group_frames[instance], &group_loads[instance]));
+  }
+
+  // The reads of all the groups are issued before any is waited for, so that they overlap on the executor. A group
+  // that got its frames is read even if another one did not, its pins are then given back below.
+  for (size_t instance = 0; instance < num_instances; ++instance) {
+    this->buffer_pool_managers_[instance]->StartLoads(group_loads[instance], this->io_executor_);
+  }
+  for (size_t instance = 0; instance < num_instances; ++instance) {
+    this->buffer_pool_managers_[instance]->WaitForLoads(group_frames[instance]);
+  }
+
+  bool all_ok = std::find(ok.begin(), ok.end(), 0) == ok.end();
+  for (size_t instance = 0; instance < num_instances; ++instance) {
+    if (group_ids[instance].empty() || !ok[instance]) {
+      continue;
+    }
+    for (size_t i = 0; i < group_ids[instance].size(); ++i) {
+      if (all_ok) {
+        (*pages)[group_positions[instance][i]] = group_pages[instance][i];
+      } else {
+        this->buffer_pool_managers_[instance]->UnpinPage(group_ids[instance][i], false);
+      }
+    }
+  }
+  if (!all_ok) {
+    pages->clear();
+  }
+  return all_ok;
+}
+
 void ParallelBufferPoolManager::FlushAllPgsImp() {
   // flush all pages from all BufferPoolManagerInstances
   for (BufferPoolManager *b : buffer_pool_managers_) {
@@ -0,0 +1,249 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tinylfu_replacer.cpp
+//
+// Identification: src/buffer/tinylfu_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/tinylfu_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+namespace {
+
+constexpr uint64_t ROW_SEEDS[] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+                                  0xD6E8FEB86659FD93ULL};
+
+}  // namespace
+
+FrequencySketch::FrequencySketch(size_t num_pages) : width_(COUNTERS_PER_WORD) {
+  while (this->width_ < 4 * num_pages) {
+    this->width_ <<= 1;
+  }
+  this->sample_size_ = 10 * std::max<size_t>(num_pages, 1);
+  this->table_.assign(DEPTH * this->width_ / COUNTERS_PER_WORD, 0);
+}
+
+void FrequencySketch::Increment(page_id_t page_id) {
+  bool added = false;
+  for (int row = 0; row < DEPTH; ++row) {
+    size_t index = this->IndexOf(page_id, row);
+    uint64_t &word = this->table_[index / COUNTERS_PER_WORD];
+    int shift = static_cast<int>(index % COUNTERS_PER_WORD) * 4;
+    if (((word >> shift) & 0xF) != 0xF) {
+      word += 1ULL << shift;
+      added = true;
+    }
+  }
+  if (added && ++this->additions_ >= this->sample_size_) {
+    this->Reset();
+  }
+}
+
+auto FrequencySketch::Estimate(page_id_t page_id) const -> uint32_t {
+  uint32_t estimate = 0xF;
+  for (int row = 0; row < DEPTH; ++row) {
+    size_t index = this->IndexOf(page_id, row);
+    uint64_t word = this->table_[index / COUNTERS_PER_WORD];
+    int shift = static_cast<int>(index % COUNTERS_PER_WORD) * 4;
+    estimate = std::min(estimate, static_cast<uint32_t>((word >> shift) & 0xF));
+  }
+  return estimate;
+}
+
+auto FrequencySketch::IndexOf(page_id_t page_id, int row) const -> size_t {
+  uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) + 1) * ROW_SEEDS[row];
+  h ^= h >> 32;
+  return static_cast<size_t>(row) * this->width_ + (h & (this->width_ - 1));
+}
+
+void FrequencySketch::Reset() {
+  for (uint64_t &word : this->table_) {
+    word = (word >> 1) & 0x7777777777777777ULL;
+  }
+  this->additions_ /= 2;
+}
+
+TinyLFUReplacer::TinyLFUReplacer(size_t num_pages, Replacer *main)
+    : window_capacity_(std::max<size_t>(1, num_pages / 100)),
+      window_(num_pages),
+      main_(main),
+      sketch_(num_pages),
+      regions_(num_pages, Region::NONE),
+      page_ids_(num_pages, INVALID_PAGE_ID) {}
+
+TinyLFUReplacer::~TinyLFUReplacer() { delete this->main_; }
+
+auto TinyLFUReplacer::Victim(frame_id_t *frame_id) -> bool {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+
+  // Pages loaded from the free list all started in the window. The overflow moves to main without competing, as
+  // main had room for it.
+  frame_id_t candidate;
+  while (this->window_size_ > this->window_capacity_ && this->window_.Victim(&candidate)) {
+    this->Admit(candidate);
+  }
+
+  frame_id_t main_victim;
+  bool has_main_victim = this->PeekMainVictim(&main_victim);
+
+  // The page about to be loaded goes to the window. While the window has room, it grows at the expense of main.
+  if (this->window_size_ < this->window_capacity_ && has_main_victim) {
+    this->Evict(main_victim, frame_id);
+    return true;
+  }
+
+  if (!this->window_.Victim(&candidate)) {
+    if (!has_main_victim) {
+      return false;
+    }
+    this->Evict(main_victim, frame_id);
+    return true;
+  }
+
+  // Admission: the window's LRU page only replaces the main victim if it is more popular.
+  if (has_main_victim &&
+      this->sketch_.Estimate(this->page_ids_[candidate]) > this->sketch_.Estimate(this->page_ids_[main_victim])) {
+    this->Evict(main_victim, frame_id);
+    this->Admit(candidate);
+    return true;
+  }
+
+  this->Evict(candidate, frame_id);
+  return true;
+}
+
+void TinyLFUReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  if (frame_id == this->main_candidate_) {
+    // Already out of main_, it goes back in on the next Unpin.
+    this->main_candidate_ = -1;
+    return;
+  }
+  if (this->regions_[frame_id] == Region::WINDOW) {
+    this->window_.Pin(frame_id);
+  } else if (this->regions_[frame_id] == Region::MAIN) {
+    this->main_->Pin(frame_id);
+  }
+}
+
+void TinyLFUReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  if (frame_id == this->main_candidate_) {
+    return;
+  }
+  if (this->regions_[frame_id] == Region::NONE) {
+    this->regions_[frame_id] = Region::WINDOW;
+    ++this->window_size_;
+  }
+  if (this->regions_[frame_id] == Region::WINDOW) {
+    this->window_.Unpin(frame_id);
+  } else {
+    this->main_->Unpin(frame_id);
+  }
+}
+
+auto TinyLFUReplacer::Size() -> size_t {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  return this->window_.Size() + this->main_->Size() + (this->main_candidate_ != -1 ? 1 : 0);
+}
+
+void TinyLFUReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->sketch_.Increment(page_id);
+
+  if (this->page_ids_[frame_id] == page_id && this->regions_[frame_id] != Region::NONE) {
+    if (this->regions_[frame_id] == Region::MAIN) {
+      this->main_->RecordAccess(frame_id, page_id);
+      if (frame_id == this->main_candidate_) {
+        // A hit saves the pending victim, hand it back to main_ where the hit was just recorded.
+        this->main_candidate_ = -1;
+        this->main_->Unpin(frame_id);
+      }
+    }
+    return;
+  }
+
+  // A new page in this frame. The frame normally comes from Victim or the free list; after a delete it may still
+  // belong to a region.
+  if (frame_id == this->main_candidate_) {
+    this->main_candidate_ = -1;
+  }
+  if (this->regions_[frame_id] == Region::WINDOW) {
+    this->window_.Pin(frame_id);
+    --this->window_size_;
+  } else if (this->regions_[frame_id] == Region::MAIN) {
+    this->main_->Pin(frame_id);
+  }
+  this->regions_[frame_id] = Region::WINDOW;
+  this->page_ids_[frame_id] = page_id;
+  ++this->window_size_;
+}
+
+void TinyLFUReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->Drop(frame_id);
+}
+
+void TinyLFUReplacer::SetCapacity(size_t num_pages) {
+  std::lock_guard<std::mutex> lg(this->mutex_);
+  this->window_.SetCapacity(num_pages);
+  this->main_->SetCapacity(num_pages);
+  if (this->regions_.size() < num_pages) {
+    this->regions_.resize(num_pages, Region::NONE);
+    this->page_ids_.resize(num_pages, INVALID_PAGE_ID);
+  }
+  // Frames retired by a shrink no longer count toward the window.
+  for (size_t i = num_pages; i < this->regions_.size(); ++i) {
+    this->Drop(static_cast<frame_id_t>(i));
+  }
+  // An oversized window is moved to main by the next Victim.
+  this->window_capacity_ = std::max<size_t>(1, num_pages / 100);
+}
+
+auto TinyLFUReplacer::PeekMainVictim(frame_id_t *frame_id) -> bool {
+  if (this->main_candidate_ == -1 && !this->main_->Victim(&this->main_candidate_)) {
+    this->main_candidate_ = -1;
+    return false;
+  }
+  *frame_id = this->main_candidate_;
+  return true;
+}
+
+void TinyLFUReplacer::Admit(frame_id_t frame_id) {
+  --this->window_size_;
+  this->regions_[frame_id] = Region::MAIN;
+  this->main_->RecordAccess(frame_id, this->page_ids_[frame_id]);
+  this->main_->Unpin(frame_id);
+}
+
+void TinyLFUReplacer::Evict(frame_id_t frame_id, frame_id_t *victim) {
+  if (frame_id == this->main_candidate_) {
+    this->main_candidate_ = -1;
+  } else if (this->regions_[frame_id] == Region::WINDOW) {
+    --this->window_size_;
+  }
+  this->regions_[frame_id] = Region::NONE;
+  *victim = frame_id;
+}
+
+void TinyLFUReplacer::Drop(frame_id_t frame_id) {
+  if (frame_id == this->main_candidate_) {
+    this->main_candidate_ = -1;
+  } else if (this->regions_[frame_id] == Region::WINDOW) {
+    this->window_.Pin(frame_id);
+    --this->window_size_;
+  } else if (this->regions_[frame_id] == Region::MAIN) {
+    this->main_->Remove(frame_id);
+  }
+  this->regions_[frame_id] = Region::NONE;
+}
+
+}  // namespace bustub
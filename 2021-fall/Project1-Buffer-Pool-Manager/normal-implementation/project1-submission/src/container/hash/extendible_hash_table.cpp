@@ -0,0 +1,245 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/extendible_hash_table.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+
+namespace {
+
+std::atomic<size_t> next_directory_stripe{0};
+
+}  // namespace
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::ExtendibleHashTable(std::string name, BufferPoolManagerInstance *buffer_pool_manager,
+                                     const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                     page_id_t directory_page_id)
+    : name_(std::move(name)),
+      directory_page_id_(directory_page_id),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)) {
+  if (this->directory_page_id_ == INVALID_PAGE_ID) {
+    WritePageGuard directory_guard = this->buffer_pool_manager_->NewPageGuarded(&this->directory_page_id_);
+    page_id_t bucket_page_id;
+    // A new page is zeroed, which is an empty bucket.
+    WritePageGuard bucket_guard = this->buffer_pool_manager_->NewPageGuarded(&bucket_page_id);
+    if (!directory_guard.IsValid() || !bucket_guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to create hash table " + this->name_);
+    }
+    auto *directory = directory_guard.AsMut<HashTableDirectoryPage>();
+    directory->SetPageId(this->directory_page_id_);
+    directory->SetLSN(INVALID_LSN);
+    directory->SetGlobalDepth(0);
+    directory->SetLocalDepth(0, 0);
+    directory->SetBucketPageId(0, bucket_page_id);
+    bucket_guard.AsMut<BucketPage>();
+  }
+  for (DirectoryHandle &directory_handle : this->directory_handles_) {
+    directory_handle.handle_.page_id_ = this->directory_page_id_;
+  }
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+/**
+ * Hash - simple helper to downcast MurmurHash's 64-bit hash to 32-bit
+ * for extendible hashing.
+ *
+ * @param key the key to hash
+ * @return the downcasted 32-bit hash
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::Hash(const KeyType &key) -> uint32_t {
+  return static_cast<uint32_t>(this->hash_fn_.GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::KeyToPageId(uint32_t hash, uint32_t *local_depth) -> page_id_t {
+  thread_local const size_t stripe = next_directory_stripe.fetch_add(1);
+  DirectoryHandle &directory_handle = this->directory_handles_[stripe % DIRECTORY_HANDLE_STRIPES];
+  bool owned = !directory_handle.in_use_.test_and_set(std::memory_order_acquire);
+  OptimisticPageHandle fresh_handle(this->directory_page_id_);
+  OptimisticPageHandle *handle = owned ? &directory_handle.handle_ : &fresh_handle;
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  uint32_t depth = 0;
+  bool ok = this->buffer_pool_manager_->ReadPageOptimistic(handle, [&](const char *data) {
+    const auto *directory = reinterpret_cast<const HashTableDirectoryPage *>(data);
+    // A torn global depth must not index past the directory.
+    uint32_t index = hash & directory->GetGlobalDepthMask() & (DIRECTORY_ARRAY_SIZE - 1);
+    bucket_page_id = directory->GetBucketPageId(index);
+    depth = directory->GetLocalDepth(index);
+  });
+  if (owned) {
+    directory_handle.in_use_.clear(std::memory_order_release);
+  }
+  if (!ok) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to read the directory of hash table " + this->name_);
+  }
+  if (local_depth != nullptr) {
+    *local_depth = depth;
+  }
+  return bucket_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <class Guard, class GuardFn>
+auto HASH_TABLE_TYPE::FetchBucket(uint32_t hash, GuardFn &&guard_fn) -> Guard {
+  while (true) {
+    page_id_t bucket_page_id = this->KeyToPageId(hash);
+    Guard guard = guard_fn(bucket_page_id);
+    // The bucket split between the two reads; its pairs for this hash moved to the split image.
+    if (this->KeyToPageId(hash) == bucket_page_id) {
+      return guard;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FetchRead(page_id_t page_id) -> ReadPageGuard {
+  ReadPageGuard guard = this->buffer_pool_manager_->FetchPageRead(page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to fetch a page of hash table " + this->name_);
+  }
+  return guard;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FetchWrite(page_id_t page_id) -> WritePageGuard {
+  WritePageGuard guard = this->buffer_pool_manager_->FetchPageWrite(page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to fetch a page of hash table " + this->name_);
+  }
+  return guard;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result) -> bool {
+  ReadPageGuard guard = this->FetchBucket<ReadPageGuard>(
+      this->Hash(key), [this](page_id_t page_id) { return this->FetchRead(page_id); });
+  return guard.As<BucketPage>()->GetValue(key, this->comparator_, result);
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::Insert(const KeyType &key, const ValueType &value) -> bool {
+  uint32_t hash = this->Hash(key);
+  while (true) {
+    WritePageGuard guard =
+        this->FetchBucket<WritePageGuard>(hash, [this](page_id_t page_id) { return this->FetchWrite(page_id); });
+    const auto *bucket = guard.As<BucketPage>();
+    if (bucket->Contains(key, value, this->comparator_)) {
+      return false;
+    }
+    if (!bucket->IsFull()) {
+      return guard.AsMut<BucketPage>()->Insert(key, value, this->comparator_);
+    }
+    // All the pairs may still land on the same side; the loop splits again until there is room.
+    if (!this->SplitBucket(&guard, hash)) {
+      return false;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::SplitBucket(WritePageGuard *bucket_guard, uint32_t hash) -> bool {
+  // Only a split of this bucket changes its local depth, and that needs the latch held here.
+  uint32_t local_depth;
+  this->KeyToPageId(hash, &local_depth);
+  if (local_depth == HashTableDirectoryPage::MAX_DEPTH) {
+    return false;
+  }
+
+  page_id_t image_page_id;
+  WritePageGuard image_guard = this->buffer_pool_manager_->NewPageGuarded(&image_page_id);
+  if (!image_guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to split a bucket of hash table " + this->name_);
+  }
+  auto *bucket = bucket_guard->AsMut<BucketPage>();
+  auto *image = image_guard.AsMut<BucketPage>();
+  std::vector<MappingType> items;
+  bucket->GetAllItems(&items);
+  bucket->Clear();
+  for (const MappingType &item : items) {
+    BucketPage *target = ((this->Hash(item.first) >> local_depth) & 1) != 0 ? image : bucket;
+    target->Insert(item.first, item.second, this->comparator_);
+  }
+
+  WritePageGuard directory_guard = this->FetchWrite(this->directory_page_id_);
+  auto *directory = directory_guard.AsMut<HashTableDirectoryPage>();
+  if (directory->GetGlobalDepth() == local_depth) {
+    directory->IncrGlobalDepth();
+  }
+  uint32_t stride = 1U << local_depth;
+  for (uint32_t index = hash & (stride - 1); index < directory->Size(); index += stride) {
+    directory->SetLocalDepth(index, local_depth + 1);
+    if ((index & stride) != 0) {
+      directory->SetBucketPageId(index, image_page_id);
+    }
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::Remove(const KeyType &key, const ValueType &value) -> bool {
+  WritePageGuard guard = this->FetchBucket<WritePageGuard>(
+      this->Hash(key), [this](page_id_t page_id) { return this->FetchWrite(page_id); });
+  if (!guard.As<BucketPage>()->Contains(key, value, this->comparator_)) {
+    return false;
+  }
+  return guard.AsMut<BucketPage>()->Remove(key, value, this->comparator_);
+}
+
+/*****************************************************************************
+ * GETGLOBALDEPTH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
+  ReadPageGuard guard = this->FetchRead(this->directory_page_id_);
+  return guard.As<HashTableDirectoryPage>()->GetGlobalDepth();
+}
+
+/*****************************************************************************
+ * VERIFY INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::VerifyIntegrity() {
+  ReadPageGuard guard = this->FetchRead(this->directory_page_id_);
+  guard.As<HashTableDirectoryPage>()->VerifyIntegrity();
+}
+
+/*****************************************************************************
+ * TEMPLATE DEFINITIONS
+ *****************************************************************************/
+template class ExtendibleHashTable<int32_t, int64_t, IntComparator<int32_t>>;
+template class ExtendibleHashTable<int64_t, int64_t, IntComparator<int64_t>>;
+
+}  // namespace bustub
@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// columnar_scan_operator.cpp
+//
+// Identification: src/execution/vector/columnar_scan_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/columnar_scan_operator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+auto OutputTypes(const ColumnarTable *table, const std::vector<uint32_t> &column_ids) -> std::vector<ColumnType> {
+  std::vector<ColumnType> types;
+  for (uint32_t column : column_ids) {
+    BUSTUB_ASSERT(column < table->column_types_.size(), "No such column.");
+    types.push_back(table->column_types_[column]);
+  }
+  return types;
+}
+
+}  // namespace
+
+ColumnarScanOperator::ColumnarScanOperator(BufferPoolManagerInstance *buffer_pool_manager,
+                                           const ColumnarTable *table, std::vector<uint32_t> column_ids,
+                                           std::vector<ColumnPredicate> predicates)
+    : VectorOperator(OutputTypes(table, column_ids)),
+      buffer_pool_manager_(buffer_pool_manager),
+      table_(table),
+      column_ids_(std::move(column_ids)),
+      predicates_(std::move(predicates)),
+      cursors_(table->column_types_.size()),
+      match_(VECTOR_SIZE),
+      scratch_(VECTOR_SIZE),
+      sel_(VECTOR_SIZE) {
+  for (const auto &predicate : this->predicates_) {
+    BUSTUB_ASSERT(predicate.column_ < table->column_types_.size(), "No such column.");
+    BUSTUB_ASSERT(table->column_types_[predicate.column_] != ColumnType::REAL, "REAL columns are not compared.");
+  }
+}
+
+void ColumnarScanOperator::Init() {
+  for (auto &cursor : this->cursors_) {
+    cursor.segment_ = 0;
+    cursor.guard_.Drop();
+  }
+  this->next_row_ = 0;
+  this->pages_fetched_ = 0;
+
+  this->segment_may_match_.assign(this->predicates_.size(), {});
+  std::vector<ZoneEntry> entries;
+  for (size_t i = 0; i < this->predicates_.size(); ++i) {
+    const ColumnPredicate &predicate = this->predicates_[i];
+    if (this->table_->column_types_[predicate.column_] != ColumnType::INTEGER ||
+        predicate.column_ >= this->table_->zone_maps_.size() ||
+        this->table_->zone_maps_[predicate.column_].IsEmpty()) {
+      continue;
+    }
+    this->table_->zone_maps_[predicate.column_].ReadEntries(this->buffer_pool_manager_, &entries);
+    BUSTUB_ASSERT(entries.size() == this->table_->segments_[predicate.column_].size(), "One zone per segment.");
+    for (const auto &entry : entries) {
+      this->segment_may_match_[i].push_back(
+          static_cast<uint8_t>(ZoneMayMatch(entry, predicate.type_, predicate.integer_)));
+    }
+  }
+}
+
+auto ColumnarScanOperator::Next(DataChunk *chunk) -> bool {
+  chunk->Initialize(this->output_types_);
+  while (chunk->Size() < VECTOR_SIZE && this->next_row_ < this->table_->row_count_) {
+    uint64_t begin = this->next_row_;
+    auto count =
+        static_cast<uint32_t>(std::min<uint64_t>(VECTOR_SIZE - chunk->Size(), this->table_->row_count_ - begin));
+    this->next_row_ += count;
+
+    size_t selected = 0;
+    if (this->predicates_.empty()) {
+      for (uint32_t i = 0; i < count; ++i) {
+        this->sel_[i] = i;
+      }
+      selected = count;
+    } else {
+      bool any = true;
+      for (size_t i = 0; i < this->predicates_.size() && any; ++i) {
+        if (i == 0) {
+          this->Match(i, begin, count, this->match_.data());
+        } else {
+          this->Match(i, begin, count, this->scratch_.data());
+          for (uint32_t row = 0; row < count; ++row) {
+            this->match_[row] &= this->scratch_[row];
+          }
+        }
+        any = memchr(this->match_.data(), 1, count) != nullptr;
+      }
+      if (!any) {
+        continue;
+      }
+      for (uint32_t row = 0; row < count; ++row) {
+        this->sel_[selected] = row;
+        selected += this->match_[row];
+      }
+    }
+
+    for (size_t i = 0; i < this->column_ids_.size(); ++i) {
+      this->Gather(this->column_ids_[i], begin, this->sel_.data(), selected, &chunk->GetColumn(i));
+    }
+  }
+  return chunk->Size() > 0;
+}
+
+auto ColumnarScanOperator::Seek(uint32_t column, uint64_t row) -> size_t {
+  const auto &segments = this->table_->segments_[column];
+  SegmentCursor &cursor = this->cursors_[column];
+  const ColumnSegment &segment = segments[cursor.segment_];
+  if (row < segment.start_row_ || row >= segment.start_row_ + segment.row_count_) {
+    auto it = std::upper_bound(segments.begin(), segments.end(), row,
+                               [](uint64_t row, const ColumnSegment &segment) { return row < segment.start_row_; });
+    cursor.segment_ = it - segments.begin() - 1;
+    cursor.guard_.Drop();
+  }
+  return cursor.segment_;
+}
+
+auto ColumnarScanOperator::Fetch(uint32_t column) -> const ColumnSegmentPage * {
+  SegmentCursor &cursor = this->cursors_[column];
+  if (!cursor.guard_.IsValid()) {
+    page_id_t page_id = this->table_->segments_[column][cursor.segment_].page_id_;
+    cursor.guard_ = this->buffer_pool_manager_->FetchPageRead(page_id);
+    if (!cursor.guard_.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to scan a column segment");
+    }
+    ++this->pages_fetched_;
+  }
+  return cursor.guard_.As<ColumnSegmentPage>();
+}
+
+void ColumnarScanOperator::Match(size_t predicate_index, uint64_t begin, uint32_t count, uint8_t *match) {
+  const ColumnPredicate &predicate = this->predicates_[predicate_index];
+  const std::vector<uint8_t> &may_match = this->segment_may_match_[predicate_index];
+  bool is_text = this->table_->column_types_[predicate.column_] == ColumnType::TEXT;
+  uint64_t row = begin;
+  while (row < begin + count) {
+    size_t index = this->Seek(predicate.column_, row);
+    const ColumnSegment &segment = this->table_->segments_[predicate.column_][index];
+    auto first = static_cast<uint32_t>(row - segment.start_row_);
+    uint32_t n = std::min<uint64_t>(segment.row_count_ - first, begin + count - row);
+    if (!may_match.empty() && may_match[index] == 0) {
+      memset(match + (row - begin), 0, n);
+      row += n;
+      continue;
+    }
+    const ColumnSegmentPage *page = this->Fetch(predicate.column_);
+    if (is_text) {
+      page->Match(predicate.type_, predicate.text_, first, n, match + (row - begin));
+    } else {
+      page->Match(predicate.type_, predicate.integer_, first, n, match + (row - begin));
+    }
+    row += n;
+  }
+}
+
+void ColumnarScanOperator::Gather(uint32_t column, uint64_t begin, const uint32_t *sel, size_t count,
+                                  ColumnVector *out) {
+  size_t i = 0;
+  while (i < count) {
+    this->Seek(column, begin + sel[i]);
+    const ColumnSegmentPage *page = this->Fetch(column);
+    uint64_t end = page->GetStartRow() + page->GetRowCount();
+    this->rows_.clear();
+    for (; i < count && begin + sel[i] < end; ++i) {
+      this->rows_.push_back(static_cast<uint32_t>(begin + sel[i] - page->GetStartRow()));
+    }
+    page->Gather(this->rows_.data(), this->rows_.size(), out);
+  }
+}
+
+}  // namespace bustub
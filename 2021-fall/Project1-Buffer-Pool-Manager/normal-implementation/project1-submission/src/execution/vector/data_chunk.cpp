@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// data_chunk.cpp
+//
+// Identification: src/execution/vector/data_chunk.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/data_chunk.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bustub {
+
+auto StringHeap::Add(std::string_view str) -> std::string_view {
+  if (str.empty()) {
+    return {};
+  }
+  if (str.size() > BLOCK_SIZE / 4) {
+    // A long string gets a block of its own, so that the free space of the current block is kept.
+    this->large_blocks_.push_back(std::make_unique<char[]>(str.size()));
+    memcpy(this->large_blocks_.back().get(), str.data(), str.size());
+    return {this->large_blocks_.back().get(), str.size()};
+  }
+  if (this->used_ + str.size() > BLOCK_SIZE) {
+    this->blocks_.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+    this->used_ = 0;
+  }
+  char *dest = this->blocks_.back().get() + this->used_;
+  memcpy(dest, str.data(), str.size());
+  this->used_ += str.size();
+  return {dest, str.size()};
+}
+
+void StringHeap::Clear() {
+  this->large_blocks_.clear();
+  if (this->blocks_.empty()) {
+    return;
+  }
+  this->blocks_.resize(1);
+  this->used_ = 0;
+}
+
+void ColumnVector::Clear() {
+  this->nulls_.clear();
+  this->integers_.clear();
+  this->reals_.clear();
+  this->texts_.clear();
+  this->heap_.Clear();
+}
+
+void ColumnVector::AppendNull() {
+  this->nulls_.push_back(1);
+  switch (this->type_) {
+    case ColumnType::INTEGER:
+      this->integers_.push_back(0);
+      break;
+    case ColumnType::REAL:
+      this->reals_.push_back(0);
+      break;
+    case ColumnType::TEXT:
+      this->texts_.emplace_back();
+      break;
+  }
+}
+
+void ColumnVector::Gather(const ColumnVector &other, const uint32_t *sel, size_t count) {
+  BUSTUB_ASSERT(this->type_ == other.type_, "Columns of different types.");
+  size_t base = this->nulls_.size();
+  this->nulls_.resize(base + count);
+  for (size_t i = 0; i < count; ++i) {
+    this->nulls_[base + i] = other.nulls_[sel[i]];
+  }
+  switch (this->type_) {
+    case ColumnType::INTEGER:
+      this->integers_.resize(base + count);
+      for (size_t i = 0; i < count; ++i) {
+        this->integers_[base + i] = other.integers_[sel[i]];
+      }
+      break;
+    case ColumnType::REAL:
+      this->reals_.resize(base + count);
+      for (size_t i = 0; i < count; ++i) {
+        this->reals_[base + i] = other.reals_[sel[i]];
+      }
+      break;
+    case ColumnType::TEXT:
+      this->texts_.reserve(base + count);
+      for (size_t i = 0; i < count; ++i) {
+        this->texts_.push_back(this->heap_.Add(other.texts_[sel[i]]));
+      }
+      break;
+  }
+}
+
+void ColumnVector::Append(const ColumnVector &other) {
+  BUSTUB_ASSERT(this->type_ == other.type_, "Columns of different types.");
+  this->nulls_.insert(this->nulls_.end(), other.nulls_.begin(), other.nulls_.end());
+  switch (this->type_) {
+    case ColumnType::INTEGER:
+      this->integers_.insert(this->integers_.end(), other.integers_.begin(), other.integers_.end());
+      break;
+    case ColumnType::REAL:
+      this->reals_.insert(this->reals_.end(), other.reals_.begin(), other.reals_.end());
+      break;
+    case ColumnType::TEXT:
+      this->texts_.reserve(this->texts_.size() + other.texts_.size());
+      for (std::string_view text : other.texts_) {
+        this->texts_.push_back(this->heap_.Add(text));
+      }
+      break;
+  }
+}
+
+void DataChunk::Initialize(const std::vector<ColumnType> &types) {
+  if (std::equal(types.begin(), types.end(), this->columns_.begin(), this->columns_.end(),
+                 [](ColumnType type, const ColumnVector &column) { return type == column.GetType(); })) {
+    // Keep the buffers of the columns for the next rows.
+    this->Reset();
+    return;
+  }
+  this->columns_.clear();
+  this->columns_.reserve(types.size());
+  for (ColumnType type : types) {
+    this->columns_.emplace_back(type);
+  }
+}
+
+void DataChunk::Reset() {
+  for (ColumnVector &column : this->columns_) {
+    column.Clear();
+  }
+}
+
+void DataChunk::Append(const DataChunk &other) {
+  BUSTUB_ASSERT(this->columns_.size() == other.columns_.size(), "Chunks of different shapes.");
+  for (size_t i = 0; i < this->columns_.size(); ++i) {
+    this->columns_[i].Append(other.columns_[i]);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,466 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sort_operator.cpp
+//
+// Identification: src/execution/vector/external_sort_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/external_sort_operator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "common/exception.h"
+#include "storage/page/heap_page.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr uint64_t SIGN_BIT = 1ULL << 63;
+
+/** Bytes a row takes in a heap page: the column count, a type byte per value, the values and the slot. */
+auto RowSize(const DataChunk &chunk, size_t row) -> size_t {
+  size_t size = sizeof(uint16_t) + sizeof(HeapPage::Slot);
+  for (size_t i = 0; i < chunk.ColumnCount(); ++i) {
+    const ColumnVector &column = chunk.GetColumn(i);
+    size += 1;
+    if (column.IsNull(row)) {
+      continue;
+    }
+    size += column.GetType() == ColumnType::TEXT ? sizeof(uint32_t) + column.GetText(row).size() : sizeof(int64_t);
+  }
+  return size;
+}
+
+void EncodeRow(const DataChunk &chunk, size_t row, HeapRowBuilder *builder) {
+  builder->Reset();
+  for (size_t i = 0; i < chunk.ColumnCount(); ++i) {
+    const ColumnVector &column = chunk.GetColumn(i);
+    if (column.IsNull(row)) {
+      builder->AppendNull();
+      continue;
+    }
+    switch (column.GetType()) {
+      case ColumnType::INTEGER:
+        builder->AppendInteger(column.GetInteger(row));
+        break;
+      case ColumnType::REAL:
+        builder->AppendReal(column.GetReal(row));
+        break;
+      case ColumnType::TEXT: {
+        std::string_view text = column.GetText(row);
+        builder->AppendBytes(HeapValueType::TEXT, text.data(), static_cast<uint32_t>(text.size()));
+        break;
+      }
+    }
+  }
+}
+
+/** Decode a row written by EncodeRow into columns of the same types. */
+void DecodeRow(const char *data, uint32_t size, DataChunk *chunk) {
+  HeapRowReader reader(data, size);
+  for (size_t i = 0; i < chunk->ColumnCount(); ++i) {
+    ColumnVector &column = chunk->GetColumn(i);
+    switch (reader.Next()) {
+      case HeapValueType::INTEGER:
+        column.AppendInteger(reader.GetInteger());
+        break;
+      case HeapValueType::REAL:
+        column.AppendReal(reader.GetReal());
+        break;
+      case HeapValueType::TEXT:
+        column.AppendText(reader.GetBytes());
+        break;
+      case HeapValueType::NULL_VALUE:
+      case HeapValueType::BLOB:
+        column.AppendNull();
+        break;
+    }
+  }
+}
+
+/**
+ * @return the first 8 bytes of a key as an unsigned number in key order: a smaller prefix means a smaller key, and
+ * only equal prefixes need the keys compared. NULL and the smallest INTEGER share prefix 0.
+ */
+auto KeyPrefix(const ColumnVector &column, size_t row, bool ascending) -> uint64_t {
+  uint64_t prefix = 0;
+  if (!column.IsNull(row)) {
+    switch (column.GetType()) {
+      case ColumnType::INTEGER:
+        prefix = static_cast<uint64_t>(column.GetInteger(row)) ^ SIGN_BIT;
+        break;
+      case ColumnType::REAL: {
+        // + 0.0 turns -0.0, which compares equal to 0.0, into 0.0.
+        double value = column.GetReal(row) + 0.0;
+        memcpy(&prefix, &value, sizeof(prefix));
+        prefix = (prefix & SIGN_BIT) != 0 ? ~prefix : prefix | SIGN_BIT;
+        break;
+      }
+      case ColumnType::TEXT: {
+        // Strings compare as unsigned bytes, which a big-endian prefix padded with zeros keeps.
+        std::string_view text = column.GetText(row);
+        for (size_t i = 0; i < sizeof(prefix); ++i) {
+          prefix = (prefix << 8) | (i < text.size() ? static_cast<uint8_t>(text[i]) : 0);
+        }
+        break;
+      }
+    }
+  }
+  return ascending ? prefix : ~prefix;
+}
+
+}  // namespace
+
+/*****************************************************************************
+ * RUN WRITER
+ *****************************************************************************/
+
+ExternalSortOperator::RunWriter::~RunWriter() {
+  if (this->pending_write_.valid()) {
+    this->pending_write_.wait();
+  }
+  if (this->page_.IsValid()) {
+    // Finish() was not reached: the run is dropped.
+    this->page_.Drop();
+    this->sort_->DeleteRun(this->run_);
+  }
+}
+
+void ExternalSortOperator::RunWriter::Append(const DataChunk &chunk, size_t row) {
+  EncodeRow(chunk, row, &this->row_);
+  if (this->row_.GetSize() > HeapPage::MAX_TUPLE_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "A row to sort takes more than a page");
+  }
+  if (this->page_.IsValid() && this->page_.AsMut<HeapPage>()->InsertTuple(this->row_.GetData(), this->row_.GetSize())) {
+    return;
+  }
+  this->NextPage();
+  this->page_.AsMut<HeapPage>()->InsertTuple(this->row_.GetData(), this->row_.GetSize());
+}
+
+auto ExternalSortOperator::RunWriter::Finish() -> Run {
+  if (this->page_.IsValid()) {
+    page_id_t page_id = this->page_.PageId();
+    this->page_.Drop();
+    this->WriteBack(page_id);
+  }
+  if (this->pending_write_.valid()) {
+    this->pending_write_.wait();
+  }
+  ++this->sort_->runs_written_;
+  return std::move(this->run_);
+}
+
+void ExternalSortOperator::RunWriter::NextPage() {
+  page_id_t prev_page_id = this->page_.IsValid() ? this->page_.PageId() : INVALID_PAGE_ID;
+  page_id_t page_id;
+  WritePageGuard page = this->sort_->buffer_pool_manager_->NewPageGuarded(&page_id);
+  if (!page.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to write a sorted run");
+  }
+  this->run_.page_ids_.push_back(page_id);
+  page.AsMut<HeapPage>()->Init(page_id, prev_page_id);
+  if (prev_page_id != INVALID_PAGE_ID) {
+    this->page_.AsMut<HeapPage>()->SetNextPageId(page_id);
+    this->page_.Drop();
+    this->WriteBack(prev_page_id);
+  }
+  this->page_ = std::move(page);
+}
+
+void ExternalSortOperator::RunWriter::WriteBack(page_id_t page_id) {
+  // Written back clean, the page is evicted for free if the pool needs its frame before the merge reads it.
+  ++this->sort_->pages_written_;
+  BufferPoolManagerInstance *bpm = this->sort_->buffer_pool_manager_;
+  if (this->sort_->io_executor_ == nullptr) {
+    bpm->CheckpointPage(page_id);
+    return;
+  }
+  if (this->pending_write_.valid()) {
+    this->pending_write_.wait();
+  }
+  auto done = std::make_shared<std::promise<void>>();
+  this->pending_write_ = done->get_future();
+  this->sort_->io_executor_->Submit(page_id, [bpm, page_id, done] {
+    bpm->CheckpointPage(page_id);
+    done->set_value();
+  });
+}
+
+/*****************************************************************************
+ * RUN READER
+ *****************************************************************************/
+
+ExternalSortOperator::RunReader::RunReader(ExternalSortOperator *sort, Run run) : sort_(sort), run_(std::move(run)) {
+  this->ReadPage();
+}
+
+ExternalSortOperator::RunReader::~RunReader() {
+  if (this->read_ahead_.valid()) {
+    this->read_ahead_.wait();
+  }
+  this->run_.page_ids_.erase(this->run_.page_ids_.begin(), this->run_.page_ids_.begin() + this->next_page_);
+  this->sort_->DeleteRun(this->run_);
+}
+
+void ExternalSortOperator::RunReader::ReadPage() {
+  this->rows_.Initialize(this->sort_->output_types_);
+  this->row_ = 0;
+  if (this->next_page_ == this->run_.page_ids_.size()) {
+    return;
+  }
+  BufferPoolManagerInstance *bpm = this->sort_->buffer_pool_manager_;
+  page_id_t page_id = this->run_.page_ids_[this->next_page_++];
+  // The read-ahead of the page has to give its pin back before the page can be deleted.
+  if (this->read_ahead_.valid()) {
+    this->read_ahead_.wait();
+  }
+  ReadPageGuard page = bpm->FetchPageRead(page_id);
+  if (!page.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to read a sorted run");
+  }
+  if (this->sort_->io_executor_ != nullptr && this->next_page_ < this->run_.page_ids_.size()) {
+    auto done = std::make_shared<std::promise<void>>();
+    this->read_ahead_ = done->get_future();
+    bpm->FetchPageAsync(this->run_.page_ids_[this->next_page_], this->sort_->io_executor_, [bpm, done](Page *next) {
+      if (next != nullptr) {
+        bpm->UnpinPage(next->GetPageId(), false);
+      }
+      done->set_value();
+    });
+  }
+
+  const auto *heap_page = page.As<HeapPage>();
+  for (uint32_t slot = 0; slot < heap_page->GetTupleCount(); ++slot) {
+    uint32_t size;
+    const char *data = heap_page->GetTuple(slot, &size);
+    DecodeRow(data, size, &this->rows_);
+  }
+  page.Drop();
+  bpm->DeletePage(page_id);
+}
+
+/*****************************************************************************
+ * SORT
+ *****************************************************************************/
+
+ExternalSortOperator::ExternalSortOperator(BufferPoolManagerInstance *buffer_pool_manager,
+                                           std::unique_ptr<VectorOperator> child, std::vector<SortKey> keys,
+                                           size_t memory_pages, IoExecutor *io_executor)
+    : VectorOperator(child->GetOutputTypes()),
+      buffer_pool_manager_(buffer_pool_manager),
+      child_(std::move(child)),
+      keys_(std::move(keys)),
+      memory_pages_(memory_pages),
+      io_executor_(io_executor) {
+  BUSTUB_ASSERT(memory_pages >= MIN_MEMORY_PAGES, "Too little memory to merge runs.");
+}
+
+ExternalSortOperator::~ExternalSortOperator() { this->Reset(); }
+
+void ExternalSortOperator::Init() {
+  this->Reset();
+  this->runs_written_ = 0;
+  this->pages_written_ = 0;
+  this->merge_passes_ = 0;
+  this->child_->Init();
+  this->buffer_.Initialize(this->output_types_);
+  this->buffer_bytes_ = 0;
+  size_t budget = this->memory_pages_ * (PAGE_SIZE - HeapPage::HEADER_SIZE);
+
+  DataChunk chunk;
+  while (this->child_->Next(&chunk)) {
+    for (size_t row = 0; row < chunk.Size(); ++row) {
+      this->buffer_bytes_ += RowSize(chunk, row);
+    }
+    // A run may go over the budget by the one chunk that crosses it.
+    this->buffer_.Append(chunk);
+    if (this->buffer_bytes_ >= budget) {
+      this->SpillBuffer();
+    }
+  }
+
+  this->emitted_ = 0;
+  if (this->runs_.empty()) {
+    this->SortBuffer();
+    return;
+  }
+  if (this->buffer_.Size() > 0) {
+    this->SpillBuffer();
+  }
+  this->buffer_.Initialize(this->output_types_);
+  this->order_.clear();
+  this->order_.shrink_to_fit();
+
+  // Merge groups of consecutive runs until one merge takes the rest.
+  size_t fan_in = this->GetFanIn();
+  while (this->runs_.size() > fan_in) {
+    std::vector<Run> runs = std::move(this->runs_);
+    this->runs_.clear();
+    for (size_t first = 0; first < runs.size(); first += fan_in) {
+      size_t count = std::min(fan_in, runs.size() - first);
+      if (count == 1) {
+        this->runs_.push_back(std::move(runs[first]));
+        continue;
+      }
+      this->StartMerge({std::make_move_iterator(runs.begin() + first),
+                        std::make_move_iterator(runs.begin() + first + count)});
+      RunWriter writer(this);
+      for (RunReader *reader = this->Winner(); !reader->IsDone(); reader = this->Winner()) {
+        writer.Append(reader->GetRows(), reader->GetRow());
+        this->AdvanceWinner();
+      }
+      this->runs_.push_back(writer.Finish());
+      this->readers_.clear();
+    }
+    ++this->merge_passes_;
+  }
+  this->StartMerge(std::move(this->runs_));
+  this->runs_.clear();
+  ++this->merge_passes_;
+}
+
+auto ExternalSortOperator::Next(DataChunk *chunk) -> bool {
+  chunk->Initialize(this->output_types_);
+  if (this->readers_.empty()) {
+    size_t count = std::min(VECTOR_SIZE, this->order_.size() - this->emitted_);
+    for (size_t i = 0; i < chunk->ColumnCount(); ++i) {
+      chunk->GetColumn(i).Gather(this->buffer_.GetColumn(i), this->order_.data() + this->emitted_, count);
+    }
+    this->emitted_ += count;
+    return count > 0;
+  }
+  for (RunReader *reader = this->Winner(); chunk->Size() < VECTOR_SIZE && !reader->IsDone();
+       reader = this->Winner()) {
+    auto row = static_cast<uint32_t>(reader->GetRow());
+    for (size_t i = 0; i < chunk->ColumnCount(); ++i) {
+      chunk->GetColumn(i).Gather(reader->GetRows().GetColumn(i), &row, 1);
+    }
+    this->AdvanceWinner();
+  }
+  return chunk->Size() > 0;
+}
+
+void ExternalSortOperator::SortBuffer() {
+  struct Entry {
+    uint64_t prefix_;
+    uint32_t row_;
+  };
+  size_t count = this->buffer_.Size();
+  std::vector<Entry> entries(count);
+  std::vector<SortKey> tie_keys = this->keys_;
+  // The prefix of a numeric value is the whole value: equal prefixes leave only the other keys to compare, except for
+  // the prefix NULL shares with the smallest INTEGER.
+  uint64_t inexact_prefix = 0;
+  if (!this->keys_.empty()) {
+    const SortKey &first = this->keys_[0];
+    const ColumnVector &column = this->buffer_.GetColumn(first.column_);
+    for (size_t row = 0; row < count; ++row) {
+      entries[row] = {KeyPrefix(column, row, first.ascending_), static_cast<uint32_t>(row)};
+    }
+    if (column.GetType() != ColumnType::TEXT) {
+      tie_keys.erase(tie_keys.begin());
+      inexact_prefix = first.ascending_ ? 0 : ~static_cast<uint64_t>(0);
+    }
+  } else {
+    for (size_t row = 0; row < count; ++row) {
+      entries[row] = {0, static_cast<uint32_t>(row)};
+    }
+  }
+  // The row number breaks ties, which makes the sort stable.
+  std::sort(entries.begin(), entries.end(), [&](const Entry &a, const Entry &b) {
+    if (a.prefix_ != b.prefix_) {
+      return a.prefix_ < b.prefix_;
+    }
+    const std::vector<SortKey> &keys = a.prefix_ == inexact_prefix ? this->keys_ : tie_keys;
+    int cmp = CompareRows(keys, this->buffer_, a.row_, this->buffer_, b.row_);
+    return cmp != 0 ? cmp < 0 : a.row_ < b.row_;
+  });
+  this->order_.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    this->order_[i] = entries[i].row_;
+  }
+}
+
+void ExternalSortOperator::SpillBuffer() {
+  this->SortBuffer();
+  RunWriter writer(this);
+  for (uint32_t row : this->order_) {
+    writer.Append(this->buffer_, row);
+  }
+  this->runs_.push_back(writer.Finish());
+  this->buffer_.Reset();
+  this->buffer_bytes_ = 0;
+}
+
+void ExternalSortOperator::StartMerge(std::vector<Run> runs) {
+  size_t count = runs.size();
+  this->readers_.clear();
+  for (Run &run : runs) {
+    this->readers_.push_back(std::make_unique<RunReader>(this, std::move(run)));
+  }
+  // Leaf i is node count + i and the parent of node n is n / 2, which makes a tree of any number of leaves. Play the
+  // matches bottom up, keeping the loser at each node and sending the winner up.
+  this->tree_.assign(count, 0);
+  std::vector<size_t> winners(2 * count);
+  for (size_t i = 0; i < count; ++i) {
+    winners[count + i] = i;
+  }
+  for (size_t node = count - 1; node > 0; --node) {
+    size_t left = winners[2 * node];
+    size_t right = winners[2 * node + 1];
+    bool left_wins = this->Before(left, right);
+    winners[node] = left_wins ? left : right;
+    this->tree_[node] = left_wins ? right : left;
+  }
+  this->tree_[0] = count == 1 ? 0 : winners[1];
+}
+
+void ExternalSortOperator::AdvanceWinner() {
+  size_t winner = this->tree_[0];
+  this->readers_[winner]->Advance();
+
+  size_t count = this->readers_.size();
+  for (size_t node = (count + winner) / 2; node > 0; node /= 2) {
+    if (this->Before(this->tree_[node], winner)) {
+      std::swap(this->tree_[node], winner);
+    }
+  }
+  this->tree_[0] = winner;
+}
+
+auto ExternalSortOperator::Before(size_t a, size_t b) const -> bool {
+  const RunReader &reader_a = *this->readers_[a];
+  const RunReader &reader_b = *this->readers_[b];
+  if (reader_a.IsDone() || reader_b.IsDone()) {
+    return !reader_a.IsDone();
+  }
+  int cmp = CompareRows(this->keys_, reader_a.GetRows(), reader_a.GetRow(), reader_b.GetRows(), reader_b.GetRow());
+  // The runs are in input order, so on equal keys the earlier run goes first.
+  return cmp != 0 ? cmp < 0 : a < b;
+}
+
+void ExternalSortOperator::Reset() {
+  this->readers_.clear();
+  this->tree_.clear();
+  for (const Run &run : this->runs_) {
+    this->DeleteRun(run);
+  }
+  this->runs_.clear();
+}
+
+void ExternalSortOperator::DeleteRun(const Run &run) {
+  for (page_id_t page_id : run.page_ids_) {
+    this->buffer_pool_manager_->DeletePage(page_id);
+  }
+}
+
+}  // namespace bustub
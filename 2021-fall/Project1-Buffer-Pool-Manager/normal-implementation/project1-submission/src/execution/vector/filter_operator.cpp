@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_operator.cpp
+//
+// Identification: src/execution/vector/filter_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/filter_operator.h"
+
+#include <numeric>
+#include <utility>
+
+namespace bustub {
+
+FilterOperator::FilterOperator(std::unique_ptr<VectorOperator> child, std::unique_ptr<VectorPredicate> predicate)
+    : VectorOperator(child->GetOutputTypes()), child_(std::move(child)), predicate_(std::move(predicate)) {}
+
+void FilterOperator::Init() { this->child_->Init(); }
+
+auto FilterOperator::Next(DataChunk *chunk) -> bool {
+  while (this->child_->Next(&this->input_)) {
+    size_t size = this->input_.Size();
+    this->sel_.resize(size);
+    std::iota(this->sel_.begin(), this->sel_.end(), 0);
+    size_t count = this->predicate_->Select(this->input_, this->sel_.data(), size, this->sel_.data());
+    if (count == 0) {
+      continue;
+    }
+    if (count == size) {
+      std::swap(*chunk, this->input_);
+      return true;
+    }
+    chunk->Initialize(this->output_types_);
+    for (size_t i = 0; i < chunk->ColumnCount(); ++i) {
+      chunk->GetColumn(i).Gather(this->input_.GetColumn(i), this->sel_.data(), count);
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,300 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_aggregate_operator.cpp
+//
+// Identification: src/execution/vector/hash_aggregate_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/hash_aggregate_operator.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace bustub {
+
+namespace {
+
+/** Hashed in place of a NULL key; a NULL and this value still differ by their null flag. */
+constexpr int64_t NULL_KEY_HASH_INPUT = INT64_MIN;
+
+auto AggregateOutputTypes(const VectorOperator &child, const std::vector<size_t> &group_columns,
+                          const std::vector<AggregateSpec> &aggregates) -> std::vector<ColumnType> {
+  std::vector<ColumnType> types;
+  for (size_t column : group_columns) {
+    BUSTUB_ASSERT(child.GetOutputTypes()[column] == ColumnType::INTEGER, "Group columns are INTEGER.");
+    types.push_back(ColumnType::INTEGER);
+  }
+  for (const AggregateSpec &aggregate : aggregates) {
+    switch (aggregate.type_) {
+      case AggregateType::COUNT_STAR:
+      case AggregateType::COUNT:
+        types.push_back(ColumnType::INTEGER);
+        break;
+      case AggregateType::COUNT_DISTINCT:
+        BUSTUB_ASSERT(child.GetOutputTypes()[aggregate.column_] == ColumnType::INTEGER, "COUNT DISTINCT of INTEGER.");
+        types.push_back(ColumnType::INTEGER);
+        break;
+      case AggregateType::SUM:
+      case AggregateType::MIN:
+      case AggregateType::MAX:
+        BUSTUB_ASSERT(child.GetOutputTypes()[aggregate.column_] != ColumnType::TEXT, "Aggregate of a number column.");
+        types.push_back(child.GetOutputTypes()[aggregate.column_]);
+        break;
+    }
+  }
+  return types;
+}
+
+}  // namespace
+
+HashAggregateOperator::HashAggregateOperator(std::unique_ptr<VectorOperator> child, std::vector<size_t> group_columns,
+                                             std::vector<AggregateSpec> aggregates)
+    : VectorOperator(AggregateOutputTypes(*child, group_columns, aggregates)),
+      child_(std::move(child)),
+      group_columns_(std::move(group_columns)),
+      aggregates_(std::move(aggregates)) {}
+
+void HashAggregateOperator::Init() {
+  this->group_keys_.Initialize(std::vector<ColumnType>(this->group_columns_.size(), ColumnType::INTEGER));
+  this->group_hashes_.clear();
+  this->slots_.assign(64, 0);
+  this->states_.assign(this->aggregates_.size(), AggregateState());
+  this->distinct_sets_.assign(this->aggregates_.size(), DistinctSet());
+  for (size_t i = 0; i < this->aggregates_.size(); ++i) {
+    if (this->aggregates_[i].type_ == AggregateType::COUNT_DISTINCT) {
+      this->distinct_sets_[i].entries_.assign(1024, {DistinctSet::EMPTY, 0});
+    }
+  }
+  if (this->group_columns_.empty()) {
+    this->NewGroup(this->group_keys_, 0, 0);
+  }
+  this->emitted_ = 0;
+
+  this->child_->Init();
+  DataChunk chunk;
+  while (this->child_->Next(&chunk)) {
+    this->FindGroups(chunk);
+    for (size_t i = 0; i < this->aggregates_.size(); ++i) {
+      const AggregateSpec &aggregate = this->aggregates_[i];
+      this->Update(i, chunk.GetColumn(aggregate.type_ == AggregateType::COUNT_STAR ? 0 : aggregate.column_));
+    }
+  }
+}
+
+void HashAggregateOperator::FindGroups(const DataChunk &chunk) {
+  size_t size = chunk.Size();
+  this->group_ids_.resize(size);
+  if (this->group_columns_.empty()) {
+    std::fill(this->group_ids_.begin(), this->group_ids_.end(), 0);
+    return;
+  }
+
+  // The hashes of the whole chunk first, one key column at a time.
+  this->hashes_.assign(size, 0);
+  for (size_t column : this->group_columns_) {
+    const ColumnVector &keys = chunk.GetColumn(column);
+    for (size_t row = 0; row < size; ++row) {
+      int64_t key = keys.IsNull(row) ? NULL_KEY_HASH_INPUT : keys.GetInteger(row);
+      auto seed = static_cast<int64_t>(this->hashes_[row] * 0x9e3779b97f4a7c15ULL);
+      this->hashes_[row] = this->hash_fn_.GetHash(key ^ seed);
+    }
+  }
+
+  for (size_t row = 0; row < size; ++row) {
+    uint64_t hash = this->hashes_[row];
+    uint64_t mask = this->slots_.size() - 1;
+    uint32_t group = 0;
+    for (uint64_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      if (this->slots_[slot] == 0) {
+        group = this->NewGroup(chunk, row, hash);
+        break;
+      }
+      uint32_t candidate = this->slots_[slot] - 1;
+      if (this->group_hashes_[candidate] != hash) {
+        continue;
+      }
+      bool equal = true;
+      for (size_t i = 0; i < this->group_columns_.size() && equal; ++i) {
+        const ColumnVector &keys = chunk.GetColumn(this->group_columns_[i]);
+        const ColumnVector &group_keys = this->group_keys_.GetColumn(i);
+        equal = keys.IsNull(row) == group_keys.IsNull(candidate) &&
+                keys.GetInteger(row) == group_keys.GetInteger(candidate);
+      }
+      if (equal) {
+        group = candidate;
+        break;
+      }
+    }
+    this->group_ids_[row] = group;
+  }
+}
+
+auto HashAggregateOperator::NewGroup(const DataChunk &chunk, size_t row, uint64_t hash) -> uint32_t {
+  auto group = static_cast<uint32_t>(this->group_hashes_.size());
+  for (size_t i = 0; i < this->group_columns_.size(); ++i) {
+    const ColumnVector &keys = chunk.GetColumn(this->group_columns_[i]);
+    if (keys.IsNull(row)) {
+      this->group_keys_.GetColumn(i).AppendNull();
+    } else {
+      this->group_keys_.GetColumn(i).AppendInteger(keys.GetInteger(row));
+    }
+  }
+  this->group_hashes_.push_back(hash);
+  for (AggregateState &state : this->states_) {
+    state.integers_.push_back(0);
+    state.reals_.push_back(0);
+    state.has_value_.push_back(0);
+  }
+
+  if (this->group_hashes_.size() * 2 > this->slots_.size()) {
+    this->GrowGroupTable();
+  } else {
+    uint64_t mask = this->slots_.size() - 1;
+    uint64_t slot = hash & mask;
+    while (this->slots_[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    this->slots_[slot] = group + 1;
+  }
+  return group;
+}
+
+void HashAggregateOperator::GrowGroupTable() {
+  this->slots_.assign(this->slots_.size() * 2, 0);
+  uint64_t mask = this->slots_.size() - 1;
+  for (size_t group = 0; group < this->group_hashes_.size(); ++group) {
+    uint64_t slot = this->group_hashes_[group] & mask;
+    while (this->slots_[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    this->slots_[slot] = static_cast<uint32_t>(group + 1);
+  }
+}
+
+void HashAggregateOperator::Update(size_t index, const ColumnVector &column) {
+  const AggregateSpec &aggregate = this->aggregates_[index];
+  AggregateState *state = &this->states_[index];
+  size_t size = this->group_ids_.size();
+  const uint32_t *groups = this->group_ids_.data();
+  const uint8_t *nulls = column.Nulls();
+  switch (aggregate.type_) {
+    case AggregateType::COUNT_STAR:
+      for (size_t row = 0; row < size; ++row) {
+        state->integers_[groups[row]]++;
+      }
+      break;
+    case AggregateType::COUNT:
+      for (size_t row = 0; row < size; ++row) {
+        state->integers_[groups[row]] += static_cast<int64_t>(nulls[row] == 0);
+      }
+      break;
+    case AggregateType::COUNT_DISTINCT: {
+      DistinctSet *set = &this->distinct_sets_[index];
+      const int64_t *values = column.Integers();
+      for (size_t row = 0; row < size; ++row) {
+        if (nulls[row] == 0 && this->InsertDistinct(set, groups[row], values[row])) {
+          state->integers_[groups[row]]++;
+        }
+      }
+      break;
+    }
+    case AggregateType::SUM:
+    case AggregateType::MIN:
+    case AggregateType::MAX: {
+      bool is_real = column.GetType() == ColumnType::REAL;
+      for (size_t row = 0; row < size; ++row) {
+        if (nulls[row] != 0) {
+          continue;
+        }
+        uint32_t group = groups[row];
+        bool first = state->has_value_[group] == 0;
+        state->has_value_[group] = 1;
+        if (is_real) {
+          double value = column.GetReal(row);
+          double &acc = state->reals_[group];
+          if (aggregate.type_ == AggregateType::SUM) {
+            acc += value;
+          } else if (first || (aggregate.type_ == AggregateType::MIN ? value < acc : value > acc)) {
+            acc = value;
+          }
+        } else {
+          int64_t value = column.GetInteger(row);
+          int64_t &acc = state->integers_[group];
+          if (aggregate.type_ == AggregateType::SUM) {
+            acc += value;
+          } else if (first || (aggregate.type_ == AggregateType::MIN ? value < acc : value > acc)) {
+            acc = value;
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+
+auto HashAggregateOperator::InsertDistinct(DistinctSet *set, uint32_t group, int64_t value) -> bool {
+  if ((set->size_ + 1) * 2 > set->entries_.size()) {
+    std::vector<DistinctSet::Entry> old(set->entries_.size() * 2, {DistinctSet::EMPTY, 0});
+    old.swap(set->entries_);
+    set->size_ = 0;
+    for (const DistinctSet::Entry &entry : old) {
+      if (entry.group_ != DistinctSet::EMPTY) {
+        this->InsertDistinct(set, entry.group_, entry.value_);
+      }
+    }
+  }
+  uint64_t mask = set->entries_.size() - 1;
+  uint64_t hash = this->hash_fn_.GetHash(value ^ static_cast<int64_t>(group * 0x9e3779b97f4a7c15ULL));
+  for (uint64_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    DistinctSet::Entry &entry = set->entries_[slot];
+    if (entry.group_ == DistinctSet::EMPTY) {
+      entry = {group, value};
+      set->size_++;
+      return true;
+    }
+    if (entry.group_ == group && entry.value_ == value) {
+      return false;
+    }
+  }
+}
+
+auto HashAggregateOperator::Next(DataChunk *chunk) -> bool {
+  size_t num_groups = this->group_hashes_.size();
+  if (this->emitted_ == num_groups) {
+    return false;
+  }
+  size_t count = std::min(VECTOR_SIZE, num_groups - this->emitted_);
+  std::vector<uint32_t> sel(count);
+  std::iota(sel.begin(), sel.end(), static_cast<uint32_t>(this->emitted_));
+
+  chunk->Initialize(this->output_types_);
+  size_t num_group_columns = this->group_columns_.size();
+  for (size_t i = 0; i < num_group_columns; ++i) {
+    chunk->GetColumn(i).Gather(this->group_keys_.GetColumn(i), sel.data(), count);
+  }
+  for (size_t i = 0; i < this->aggregates_.size(); ++i) {
+    ColumnVector &column = chunk->GetColumn(num_group_columns + i);
+    const AggregateState &state = this->states_[i];
+    AggregateType type = this->aggregates_[i].type_;
+    bool nullable = type == AggregateType::SUM || type == AggregateType::MIN || type == AggregateType::MAX;
+    for (uint32_t group : sel) {
+      if (nullable && state.has_value_[group] == 0) {
+        column.AppendNull();
+      } else if (column.GetType() == ColumnType::REAL) {
+        column.AppendReal(state.reals_[group]);
+      } else {
+        column.AppendInteger(state.integers_[group]);
+      }
+    }
+  }
+  this->emitted_ += count;
+  return true;
+}
+
+}  // namespace bustub
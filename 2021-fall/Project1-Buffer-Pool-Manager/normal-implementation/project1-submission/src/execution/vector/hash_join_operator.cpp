@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_operator.cpp
+//
+// Identification: src/execution/vector/hash_join_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/hash_join_operator.h"
+
+#include <utility>
+
+namespace bustub {
+
+namespace {
+
+auto JoinOutputTypes(const VectorOperator &build, const VectorOperator &probe, JoinType join_type)
+    -> std::vector<ColumnType> {
+  std::vector<ColumnType> types = probe.GetOutputTypes();
+  if (join_type == JoinType::INNER) {
+    types.insert(types.end(), build.GetOutputTypes().begin(), build.GetOutputTypes().end());
+  }
+  return types;
+}
+
+}  // namespace
+
+HashJoinOperator::HashJoinOperator(std::unique_ptr<VectorOperator> build, std::unique_ptr<VectorOperator> probe,
+                                   size_t build_key, size_t probe_key, JoinType join_type)
+    : VectorOperator(JoinOutputTypes(*build, *probe, join_type)),
+      build_(std::move(build)),
+      probe_(std::move(probe)),
+      build_key_(build_key),
+      probe_key_(probe_key),
+      join_type_(join_type) {
+  BUSTUB_ASSERT(this->build_->GetOutputTypes()[build_key] == ColumnType::INTEGER, "Join keys are INTEGER.");
+  BUSTUB_ASSERT(this->probe_->GetOutputTypes()[probe_key] == ColumnType::INTEGER, "Join keys are INTEGER.");
+}
+
+void HashJoinOperator::Init() {
+  this->Build();
+  this->probe_->Init();
+  this->probe_chunk_.Initialize(this->probe_->GetOutputTypes());
+  this->probe_row_ = 0;
+  this->candidates_.clear();
+  this->probe_done_ = false;
+}
+
+void HashJoinOperator::Build() {
+  this->build_->Init();
+  this->build_rows_.Initialize(this->build_->GetOutputTypes());
+  DataChunk chunk;
+  while (this->build_->Next(&chunk)) {
+    this->build_rows_.Append(chunk);
+  }
+
+  size_t num_rows = this->build_rows_.Size();
+  size_t num_buckets = 1;
+  while (num_buckets < 2 * num_rows) {
+    num_buckets <<= 1;
+  }
+  this->mask_ = num_buckets - 1;
+  this->heads_.assign(num_buckets, 0);
+  this->next_.assign(num_rows, 0);
+  const ColumnVector &keys = this->build_rows_.GetColumn(this->build_key_);
+  for (size_t row = 0; row < num_rows; ++row) {
+    if (keys.IsNull(row)) {
+      continue;
+    }
+    uint32_t &head = this->heads_[this->Bucket(keys.GetInteger(row))];
+    this->next_[row] = head;
+    head = static_cast<uint32_t>(row + 1);
+  }
+}
+
+void HashJoinOperator::StartProbeChunk() {
+  const ColumnVector &keys = this->probe_chunk_.GetColumn(this->probe_key_);
+  size_t size = this->probe_chunk_.Size();
+  this->candidates_.resize(size);
+  // Hashing and the bucket loads have no dependency between rows, so the loop overlaps their cache misses.
+  for (size_t row = 0; row < size; ++row) {
+    this->candidates_[row] = keys.IsNull(row) ? 0 : this->heads_[this->Bucket(keys.GetInteger(row))];
+  }
+  this->probe_row_ = 0;
+}
+
+auto HashJoinOperator::Next(DataChunk *chunk) -> bool {
+  this->probe_sel_.clear();
+  this->build_sel_.clear();
+  const int64_t *build_keys = this->build_rows_.GetColumn(this->build_key_).Integers();
+  while (this->probe_sel_.empty()) {
+    if (this->probe_row_ == this->probe_chunk_.Size()) {
+      if (this->probe_done_ || !this->probe_->Next(&this->probe_chunk_)) {
+        this->probe_done_ = true;
+        return false;
+      }
+      this->StartProbeChunk();
+    }
+    const int64_t *probe_keys = this->probe_chunk_.GetColumn(this->probe_key_).Integers();
+    size_t size = this->probe_chunk_.Size();
+    while (this->probe_row_ < size && this->probe_sel_.size() < VECTOR_SIZE) {
+      uint32_t &candidate = this->candidates_[this->probe_row_];
+      int64_t key = probe_keys[this->probe_row_];
+      while (candidate != 0 && this->probe_sel_.size() < VECTOR_SIZE) {
+        uint32_t build_row = candidate - 1;
+        candidate = this->next_[build_row];
+        if (build_keys[build_row] != key) {
+          continue;
+        }
+        this->probe_sel_.push_back(static_cast<uint32_t>(this->probe_row_));
+        this->build_sel_.push_back(build_row);
+        if (this->join_type_ == JoinType::SEMI) {
+          candidate = 0;
+        }
+      }
+      // A probe row whose matches did not all fit is resumed from its candidate by the next call.
+      if (candidate == 0) {
+        this->probe_row_++;
+      }
+    }
+  }
+
+  chunk->Initialize(this->output_types_);
+  size_t count = this->probe_sel_.size();
+  size_t num_probe_columns = this->probe_chunk_.ColumnCount();
+  for (size_t i = 0; i < num_probe_columns; ++i) {
+    chunk->GetColumn(i).Gather(this->probe_chunk_.GetColumn(i), this->probe_sel_.data(), count);
+  }
+  if (this->join_type_ == JoinType::INNER) {
+    for (size_t i = 0; i < this->build_rows_.ColumnCount(); ++i) {
+      chunk->GetColumn(num_probe_columns + i).Gather(this->build_rows_.GetColumn(i), this->build_sel_.data(), count);
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// heap_scan_operator.cpp
+//
+// Identification: src/execution/vector/heap_scan_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/heap_scan_operator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/exception.h"
+#include "storage/page/heap_page.h"
+#include "storage/table/heap_row.h"
+
+namespace bustub {
+
+HeapScanOperator::HeapScanOperator(BufferPoolManagerInstance *buffer_pool_manager, page_id_t first_page_id,
+                                   std::vector<uint32_t> column_ids, std::vector<ColumnType> types)
+    : VectorOperator(std::move(types)),
+      buffer_pool_manager_(buffer_pool_manager),
+      first_page_id_(first_page_id),
+      column_ids_(std::move(column_ids)) {
+  BUSTUB_ASSERT(this->column_ids_.size() == this->output_types_.size(), "One type per scanned column.");
+  BUSTUB_ASSERT(!this->column_ids_.empty(), "A scan produces at least one column.");
+  this->output_of_column_.assign(*std::max_element(this->column_ids_.begin(), this->column_ids_.end()) + 1, -1);
+  for (size_t i = 0; i < this->column_ids_.size(); ++i) {
+    BUSTUB_ASSERT(this->output_of_column_[this->column_ids_[i]] == -1, "A column is scanned once.");
+    this->output_of_column_[this->column_ids_[i]] = static_cast<int>(i);
+  }
+}
+
+void HeapScanOperator::AddZoneFilter(const ZoneMap *zone_map, int64_t lo, int64_t hi) {
+  BUSTUB_ASSERT(this->pages_ == nullptr, "Explicit pages and zone filters do not mix.");
+  if (!zone_map->IsEmpty()) {
+    this->zone_filters_.push_back({zone_map, lo, hi});
+  }
+}
+
+void HeapScanOperator::SetPages(const page_id_t *page_ids, size_t count) {
+  BUSTUB_ASSERT(this->zone_filters_.empty(), "Explicit pages and zone filters do not mix.");
+  this->pages_ = page_ids;
+  this->page_count_ = count;
+}
+
+void HeapScanOperator::Init() {
+  this->page_guard_.Drop();
+  this->next_page_id_ = this->first_page_id_;
+  this->next_slot_ = 0;
+  this->pages_fetched_ = 0;
+  this->candidates_.clear();
+  this->next_candidate_ = 0;
+  this->use_candidates_ = this->pages_ != nullptr || !this->zone_filters_.empty();
+  if (this->pages_ != nullptr) {
+    this->candidates_.assign(this->pages_, this->pages_ + this->page_count_);
+    return;
+  }
+  if (this->zone_filters_.empty()) {
+    return;
+  }
+
+  std::vector<ZoneEntry> entries;
+  std::vector<bool> keep;
+  for (const auto &filter : this->zone_filters_) {
+    filter.zone_map_->ReadEntries(this->buffer_pool_manager_, &entries);
+    if (keep.empty()) {
+      keep.assign(entries.size(), true);
+      BUSTUB_ASSERT(!entries.empty() && entries[0].page_id_ == this->first_page_id_, "A zone map of another heap.");
+      for (const auto &entry : entries) {
+        this->candidates_.push_back(entry.page_id_);
+      }
+    }
+    BUSTUB_ASSERT(entries.size() == keep.size(), "Zone maps of different heaps.");
+    for (size_t i = 0; i < entries.size(); ++i) {
+      keep[i] = keep[i] && entries[i].Overlaps(filter.lo_, filter.hi_);
+    }
+  }
+  size_t kept = 0;
+  for (size_t i = 0; i < keep.size(); ++i) {
+    this->candidates_[kept] = this->candidates_[i];
+    kept += static_cast<size_t>(keep[i]);
+  }
+  this->candidates_.resize(kept);
+}
+
+auto HeapScanOperator::NextPageId() -> page_id_t {
+  if (!this->use_candidates_) {
+    return this->next_page_id_;
+  }
+  return this->next_candidate_ < this->candidates_.size() ? this->candidates_[this->next_candidate_++]
+                                                          : INVALID_PAGE_ID;
+}
+
+auto HeapScanOperator::Next(DataChunk *chunk) -> bool {
+  chunk->Initialize(this->output_types_);
+  while (chunk->Size() < VECTOR_SIZE) {
+    if (!this->page_guard_.IsValid()) {
+      page_id_t page_id = this->NextPageId();
+      if (page_id == INVALID_PAGE_ID) {
+        break;
+      }
+      this->page_guard_ = this->buffer_pool_manager_->FetchPageRead(page_id);
+      if (!this->page_guard_.IsValid()) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to scan a heap page");
+      }
+      ++this->pages_fetched_;
+      this->next_slot_ = 0;
+    }
+    const auto *page = this->page_guard_.As<HeapPage>();
+    uint32_t end = std::min<uint32_t>(page->GetTupleCount(), this->next_slot_ + VECTOR_SIZE - chunk->Size());
+    for (; this->next_slot_ < end; ++this->next_slot_) {
+      uint32_t size;
+      const char *data = page->GetTuple(this->next_slot_, &size);
+      this->DecodeRow(data, size, chunk);
+    }
+    if (this->next_slot_ == page->GetTupleCount()) {
+      this->next_page_id_ = page->GetNextPageId();
+      this->page_guard_.Drop();
+    }
+  }
+  return chunk->Size() > 0;
+}
+
+void HeapScanOperator::DecodeRow(const char *data, uint32_t size, DataChunk *chunk) {
+  HeapRowReader reader(data, size);
+  size_t num_columns = std::min<size_t>(reader.GetColumnCount(), this->output_of_column_.size());
+  size_t appended = 0;
+  for (size_t i = 0; i < num_columns; ++i) {
+    HeapValueType type = reader.Next();
+    int output = this->output_of_column_[i];
+    if (output < 0) {
+      continue;
+    }
+    ColumnVector &column = chunk->GetColumn(output);
+    ++appended;
+    switch (column.GetType()) {
+      case ColumnType::INTEGER:
+        if (type == HeapValueType::INTEGER) {
+          column.AppendInteger(reader.GetInteger());
+        } else if (type == HeapValueType::REAL) {
+          column.AppendInteger(static_cast<int64_t>(reader.GetReal()));
+        } else {
+          column.AppendNull();
+        }
+        break;
+      case ColumnType::REAL:
+        if (type == HeapValueType::REAL) {
+          column.AppendReal(reader.GetReal());
+        } else if (type == HeapValueType::INTEGER) {
+          column.AppendReal(static_cast<double>(reader.GetInteger()));
+        } else {
+          column.AppendNull();
+        }
+        break;
+      case ColumnType::TEXT:
+        if (type == HeapValueType::TEXT) {
+          column.AppendText(reader.GetBytes());
+        } else {
+          column.AppendNull();
+        }
+        break;
+    }
+  }
+  if (appended < this->column_ids_.size()) {
+    // A short row: the columns past its end read as NULL.
+    for (size_t i = num_columns; i < this->output_of_column_.size(); ++i) {
+      if (this->output_of_column_[i] >= 0) {
+        chunk->GetColumn(this->output_of_column_[i]).AppendNull();
+      }
+    }
+  }
+}
+
+}  // namespace bustub
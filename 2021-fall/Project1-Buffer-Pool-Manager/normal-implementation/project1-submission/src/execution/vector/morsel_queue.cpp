@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.cpp
+//
+// Identification: src/execution/vector/morsel_queue.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/morsel_queue.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+MorselQueue::MorselQueue(const std::vector<page_id_t> &page_ids, size_t num_instances, size_t num_workers,
+                         size_t morsel_pages)
+    : num_workers_(num_workers) {
+  BUSTUB_ASSERT(num_instances > 0 && num_workers > 0 && morsel_pages > 0, "Empty scan configuration.");
+  for (size_t i = 0; i < num_instances; ++i) {
+    this->queues_.push_back(std::make_unique<InstanceQueue>());
+  }
+  for (page_id_t page_id : page_ids) {
+    this->queues_[page_id % num_instances]->page_ids_.push_back(page_id);
+  }
+  // The page ids are in place before the morsels point into them.
+  for (size_t i = 0; i < num_instances; ++i) {
+    InstanceQueue &queue = *this->queues_[i];
+    for (size_t begin = 0; begin < queue.page_ids_.size(); begin += morsel_pages) {
+      size_t count = std::min(morsel_pages, queue.page_ids_.size() - begin);
+      queue.morsels_.push_back({i, queue.page_ids_.data() + begin, count});
+    }
+    queue.back_ = queue.morsels_.size();
+  }
+}
+
+auto MorselQueue::Take(InstanceQueue *queue, bool from_back, Morsel *morsel) -> bool {
+  std::lock_guard<std::mutex> lg(queue->latch_);
+  if (queue->front_ == queue->back_) {
+    return false;
+  }
+  *morsel = from_back ? queue->morsels_[--queue->back_] : queue->morsels_[queue->front_++];
+  return true;
+}
+
+auto MorselQueue::Next(size_t worker, Morsel *morsel) -> bool {
+  size_t num_instances = this->queues_.size();
+  for (size_t i = worker % num_instances; i < num_instances; i += this->num_workers_) {
+    if (Take(this->queues_[i].get(), false, morsel)) {
+      this->local_count_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  while (true) {
+    // Another worker may empty the victim between the search and the take; the search then starts over.
+    size_t victim = num_instances;
+    size_t most = 0;
+    for (size_t i = 0; i < num_instances; ++i) {
+      InstanceQueue &queue = *this->queues_[i];
+      std::lock_guard<std::mutex> lg(queue.latch_);
+      if (queue.back_ - queue.front_ > most) {
+        most = queue.back_ - queue.front_;
+        victim = i;
+      }
+    }
+    if (victim == num_instances) {
+      return false;
+    }
+    if (Take(this->queues_[victim].get(), true, morsel)) {
+      this->stolen_count_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+}
+
+}  // namespace bustub
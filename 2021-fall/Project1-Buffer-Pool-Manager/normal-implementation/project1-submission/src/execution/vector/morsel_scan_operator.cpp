@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_scan_operator.cpp
+//
+// Identification: src/execution/vector/morsel_scan_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/morsel_scan_operator.h"
+
+#include <utility>
+
+namespace bustub {
+
+MorselScanOperator::MorselScanOperator(ParallelBufferPoolManager *buffer_pool_manager, MorselQueue *queue,
+                                       size_t worker, std::vector<uint32_t> column_ids, std::vector<ColumnType> types)
+    : VectorOperator(std::move(types)),
+      buffer_pool_manager_(buffer_pool_manager),
+      queue_(queue),
+      worker_(worker),
+      column_ids_(std::move(column_ids)),
+      scans_(buffer_pool_manager->GetNumInstances()) {}
+
+void MorselScanOperator::Init() {
+  this->current_ = nullptr;
+  this->pages_fetched_ = 0;
+}
+
+auto MorselScanOperator::Next(DataChunk *chunk) -> bool {
+  while (this->current_ == nullptr || !this->current_->Next(chunk)) {
+    if (this->current_ != nullptr) {
+      this->pages_fetched_ += this->current_->GetPagesFetched();
+    }
+    Morsel morsel;
+    if (!this->queue_->Next(this->worker_, &morsel)) {
+      this->current_ = nullptr;
+      return false;
+    }
+    auto &scan = this->scans_[morsel.instance_];
+    if (scan == nullptr) {
+      scan = std::make_unique<HeapScanOperator>(this->buffer_pool_manager_->GetInstance(morsel.instance_),
+                                                morsel.page_ids_[0], this->column_ids_, this->output_types_);
+    }
+    scan->SetPages(morsel.page_ids_, morsel.count_);
+    scan->Init();
+    this->current_ = scan.get();
+  }
+  return true;
+}
+
+auto MorselScanOperator::GetPagesFetched() const -> uint64_t {
+  return this->pages_fetched_ + (this->current_ != nullptr ? this->current_->GetPagesFetched() : 0);
+}
+
+}  // namespace bustub
@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// musicbrainz_queries.cpp
+//
+// Identification: src/execution/vector/musicbrainz_queries.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/musicbrainz_queries.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/vector/filter_operator.h"
+#include "execution/vector/hash_aggregate_operator.h"
+#include "execution/vector/hash_join_operator.h"
+#include "execution/vector/heap_scan_operator.h"
+#include "execution/vector/sort_operator.h"
+
+namespace bustub {
+
+namespace {
+
+/** round(value, digits) of SQLite, which rounds the decimal string rather than the binary value. */
+auto SqliteRound(double value, int digits) -> double {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return strtod(buffer, nullptr);
+}
+
+/** A REAL the way sqlite3 prints it: 15 significant digits, and a ".0" on integral values. */
+auto FormatReal(double value) -> std::string {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.15g", value);
+  std::string text = buffer;
+  if (text.find_first_of(".en") == std::string::npos) {
+    text += ".0";
+  }
+  return text;
+}
+
+auto Comparison(size_t column, ComparisonType type, int64_t constant) -> std::unique_ptr<VectorPredicate> {
+  return MakeComparison(column, type, constant);
+}
+
+template <class... Predicates>
+auto And(Predicates... predicates) -> std::unique_ptr<VectorPredicate> {
+  std::vector<std::unique_ptr<VectorPredicate>> children;
+  (children.push_back(std::move(predicates)), ...);
+  return MakeAnd(std::move(children));
+}
+
+template <class... Predicates>
+auto Or(Predicates... predicates) -> std::unique_ptr<VectorPredicate> {
+  std::vector<std::unique_ptr<VectorPredicate>> children;
+  (children.push_back(std::move(predicates)), ...);
+  return MakeOr(std::move(children));
+}
+
+}  // namespace
+
+auto ColumnIndex(const LoadedTable &table, const std::string &name) -> uint32_t {
+  for (size_t i = 0; i < table.column_names_.size(); ++i) {
+    if (table.column_names_[i] == name) {
+      return static_cast<uint32_t>(i);
+    }
+  }
+  throw Exception(ExceptionType::INVALID, "Table " + table.name_ + " has no column " + name);
+}
+
+auto RunReleasePercentageQuery(BufferPoolManagerInstance *buffer_pool_manager, const LoadedTable &release,
+                               const LoadedTable &release_info, const ZoneMap *date_year_zones)
+    -> std::vector<std::string> {
+  // release_info: (release, date_year, date_month)
+  auto info_scan = std::make_unique<HeapScanOperator>(
+      buffer_pool_manager, release_info.first_page_id_,
+      std::vector<uint32_t>{ColumnIndex(release_info, "release"), ColumnIndex(release_info, "date_year"),
+                            ColumnIndex(release_info, "date_month")},
+      std::vector<ColumnType>(3, ColumnType::INTEGER));
+  if (date_year_zones != nullptr) {
+    info_scan->AddZoneFilter(date_year_zones, 2019, 2020);
+  }
+  auto past_year = std::make_unique<FilterOperator>(
+      std::move(info_scan),
+      Or(And(Comparison(1, ComparisonType::EQUAL, 2019), Comparison(2, ComparisonType::GREATER_THAN_OR_EQUAL, 7)),
+         And(Comparison(1, ComparisonType::EQUAL, 2020), Comparison(2, ComparisonType::LESS_THAN_OR_EQUAL, 7))));
+  auto release_scan = std::make_unique<HeapScanOperator>(buffer_pool_manager, release.first_page_id_,
+                                                         std::vector<uint32_t>{ColumnIndex(release, "id")},
+                                                         std::vector<ColumnType>{ColumnType::INTEGER});
+  // The filtered release_info is a few percent of release, so it is the side kept in memory.
+  // (id, release, date_year, date_month)
+  auto join = std::make_unique<HashJoinOperator>(std::move(past_year), std::move(release_scan), 0, 0, JoinType::INNER);
+  // (date_year, date_month, count)
+  auto per_month = std::make_unique<HashAggregateOperator>(
+      std::move(join), std::vector<size_t>{2, 3}, std::vector<AggregateSpec>{{AggregateType::COUNT_STAR, 0}});
+  SortOperator plan(std::move(per_month), {{0}, {1}});
+
+  plan.Init();
+  std::vector<std::pair<std::string, int64_t>> months;
+  int64_t total = 0;
+  DataChunk chunk;
+  while (plan.Next(&chunk)) {
+    for (size_t row = 0; row < chunk.Size(); ++row) {
+      int64_t year = chunk.GetColumn(0).GetInteger(row);
+      int64_t month = chunk.GetColumn(1).GetInteger(row);
+      int64_t count = chunk.GetColumn(2).GetInteger(row);
+      months.emplace_back(std::to_string(year) + (month < 10 ? ".0" : ".") + std::to_string(month), count);
+      total += count;
+    }
+  }
+
+  std::vector<std::string> rows;
+  for (const auto &[date, count] : months) {
+    rows.push_back(date + "|" + FormatReal(SqliteRound(count * 100.0 / total, 2)));
+  }
+  return rows;
+}
+
+auto RunCollaborateArtistQuery(BufferPoolManagerInstance *buffer_pool_manager, const LoadedTable &artist_credit_name,
+                               const std::string &artist_name) -> std::vector<std::string> {
+  uint32_t artist_credit = ColumnIndex(artist_credit_name, "artist_credit");
+  // (artist_credit, name)
+  auto credits_scan = std::make_unique<HeapScanOperator>(
+      buffer_pool_manager, artist_credit_name.first_page_id_,
+      std::vector<uint32_t>{artist_credit, ColumnIndex(artist_credit_name, "name")},
+      std::vector<ColumnType>{ColumnType::INTEGER, ColumnType::TEXT});
+  auto credits_of_artist = std::make_unique<FilterOperator>(
+      std::move(credits_scan), MakeComparison(1, ComparisonType::EQUAL, artist_name));
+  // (artist_credit, artist)
+  auto names_scan = std::make_unique<HeapScanOperator>(
+      buffer_pool_manager, artist_credit_name.first_page_id_,
+      std::vector<uint32_t>{artist_credit, ColumnIndex(artist_credit_name, "artist")},
+      std::vector<ColumnType>(2, ColumnType::INTEGER));
+  auto collaborations =
+      std::make_unique<HashJoinOperator>(std::move(credits_of_artist), std::move(names_scan), 0, 0, JoinType::SEMI);
+  HashAggregateOperator plan(std::move(collaborations), {}, {{AggregateType::COUNT_DISTINCT, 1}});
+
+  plan.Init();
+  DataChunk chunk;
+  plan.Next(&chunk);
+  return {std::to_string(chunk.GetColumn(0).GetInteger(0))};
+}
+
+}  // namespace bustub
@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_aggregate_operator.cpp
+//
+// Identification: src/execution/vector/parallel_aggregate_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/parallel_aggregate_operator.h"
+
+#include <exception>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "execution/vector/morsel_scan_operator.h"
+
+namespace bustub {
+
+/**
+ * PartialSource hands out the partial groups of all the workers to the merging aggregation.
+ */
+class ParallelAggregateOperator::PartialSource : public VectorOperator {
+ public:
+  PartialSource(std::vector<ColumnType> types, const std::vector<std::vector<DataChunk>> *partials)
+      : VectorOperator(std::move(types)), partials_(partials) {}
+
+  void Init() override {
+    this->worker_ = 0;
+    this->chunk_ = 0;
+  }
+
+  auto Next(DataChunk *chunk) -> bool override {
+    while (this->worker_ < this->partials_->size()) {
+      const auto &chunks = (*this->partials_)[this->worker_];
+      if (this->chunk_ < chunks.size()) {
+        chunk->Initialize(this->output_types_);
+        chunk->Append(chunks[this->chunk_++]);
+        return true;
+      }
+      ++this->worker_;
+      this->chunk_ = 0;
+    }
+    return false;
+  }
+
+ private:
+  const std::vector<std::vector<DataChunk>> *partials_;
+  size_t worker_{0};
+  size_t chunk_{0};
+};
+
+namespace {
+
+/** @return the pipeline of a worker up to its partial aggregation */
+auto BuildWorkerPlan(ParallelBufferPoolManager *buffer_pool_manager, MorselQueue *queue, size_t worker,
+                     const std::vector<uint32_t> &column_ids, const std::vector<ColumnType> &types,
+                     const PipelineFactory &pipeline, const std::vector<size_t> &group_columns,
+                     const std::vector<AggregateSpec> &aggregates, MorselScanOperator **scan)
+    -> std::unique_ptr<HashAggregateOperator> {
+  auto morsel_scan = std::make_unique<MorselScanOperator>(buffer_pool_manager, queue, worker, column_ids, types);
+  *scan = morsel_scan.get();
+  std::unique_ptr<VectorOperator> child = std::move(morsel_scan);
+  if (pipeline) {
+    child = pipeline(std::move(child));
+  }
+  for (const auto &aggregate : aggregates) {
+    BUSTUB_ASSERT(aggregate.type_ != AggregateType::COUNT_DISTINCT, "COUNT_DISTINCT cannot be merged.");
+  }
+  return std::make_unique<HashAggregateOperator>(std::move(child), group_columns, aggregates);
+}
+
+/** @return the aggregates that merge partial groups laid out as (groups..., aggregates...) */
+auto MergeAggregates(size_t num_groups, const std::vector<AggregateSpec> &aggregates) -> std::vector<AggregateSpec> {
+  std::vector<AggregateSpec> merged;
+  for (size_t i = 0; i < aggregates.size(); ++i) {
+    AggregateType type = aggregates[i].type_;
+    if (type == AggregateType::COUNT_STAR || type == AggregateType::COUNT) {
+      type = AggregateType::SUM;
+    }
+    merged.push_back({type, num_groups + i});
+  }
+  return merged;
+}
+
+auto Iota(size_t count) -> std::vector<size_t> {
+  std::vector<size_t> columns(count);
+  for (size_t i = 0; i < count; ++i) {
+    columns[i] = i;
+  }
+  return columns;
+}
+
+/** @return the output types of the merging aggregation, from a worker plan that is never run */
+auto MergedTypes(ParallelBufferPoolManager *buffer_pool_manager, const std::vector<uint32_t> &column_ids,
+                 const std::vector<ColumnType> &types, const PipelineFactory &pipeline,
+                 const std::vector<size_t> &group_columns, const std::vector<AggregateSpec> &aggregates)
+    -> std::vector<ColumnType> {
+  MorselScanOperator *scan;
+  auto partial = BuildWorkerPlan(buffer_pool_manager, nullptr, 0, column_ids, types, pipeline, group_columns,
+                                 aggregates, &scan);
+  // COUNT and COUNT_STAR become a SUM of INTEGER, which is INTEGER as well: the merge keeps the partial types.
+  return partial->GetOutputTypes();
+}
+
+}  // namespace
+
+ParallelAggregateOperator::ParallelAggregateOperator(ParallelBufferPoolManager *buffer_pool_manager,
+                                                     const LoadedTable *table, std::vector<uint32_t> column_ids,
+                                                     std::vector<ColumnType> types, PipelineFactory pipeline,
+                                                     std::vector<size_t> group_columns,
+                                                     std::vector<AggregateSpec> aggregates, size_t num_workers,
+                                                     size_t morsel_pages)
+    : VectorOperator(MergedTypes(buffer_pool_manager, column_ids, types, pipeline, group_columns, aggregates)),
+      buffer_pool_manager_(buffer_pool_manager),
+      table_(table),
+      column_ids_(std::move(column_ids)),
+      types_(std::move(types)),
+      pipeline_(std::move(pipeline)),
+      group_columns_(std::move(group_columns)),
+      aggregates_(std::move(aggregates)),
+      num_workers_(num_workers),
+      morsel_pages_(morsel_pages) {
+  BUSTUB_ASSERT(num_workers > 0, "A parallel aggregation has at least one worker.");
+}
+
+ParallelAggregateOperator::~ParallelAggregateOperator() = default;
+
+void ParallelAggregateOperator::Init() {
+  MorselQueue queue(this->table_->page_ids_, this->buffer_pool_manager_->GetNumInstances(), this->num_workers_,
+                    this->morsel_pages_);
+  this->partials_.clear();
+  this->partials_.resize(this->num_workers_);
+  this->pages_per_worker_.assign(this->num_workers_, 0);
+  std::vector<std::exception_ptr> errors(this->num_workers_);
+  std::vector<std::thread> workers;
+  for (size_t worker = 0; worker < this->num_workers_; ++worker) {
+    workers.emplace_back([this, &queue, &errors, worker] {
+      try {
+        this->RunWorker(&queue, worker);
+      } catch (...) {
+        errors[worker] = std::current_exception();
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  for (const auto &error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+  this->local_morsels_ = queue.GetLocalCount();
+  this->stolen_morsels_ = queue.GetStolenCount();
+
+  std::vector<ColumnType> partial_types = this->output_types_;
+  this->merge_ = std::make_unique<HashAggregateOperator>(
+      std::make_unique<PartialSource>(std::move(partial_types), &this->partials_), Iota(this->group_columns_.size()),
+      MergeAggregates(this->group_columns_.size(), this->aggregates_));
+  this->merge_->Init();
+}
+
+auto ParallelAggregateOperator::Next(DataChunk *chunk) -> bool { return this->merge_->Next(chunk); }
+
+void ParallelAggregateOperator::RunWorker(MorselQueue *queue, size_t worker) {
+  MorselScanOperator *scan;
+  auto plan = BuildWorkerPlan(this->buffer_pool_manager_, queue, worker, this->column_ids_, this->types_,
+                              this->pipeline_, this->group_columns_, this->aggregates_, &scan);
+  plan->Init();
+  DataChunk chunk;
+  while (plan->Next(&chunk)) {
+    this->partials_[worker].push_back(std::move(chunk));
+    chunk = DataChunk();
+  }
+  this->pages_per_worker_[worker] = scan->GetPagesFetched();
+}
+
+}  // namespace bustub
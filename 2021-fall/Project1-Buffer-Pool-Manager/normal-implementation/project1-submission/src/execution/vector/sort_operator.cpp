@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_operator.cpp
+//
+// Identification: src/execution/vector/sort_operator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/sort_operator.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace bustub {
+
+namespace {
+
+/** @return <0, 0 or >0 as row_a of a sorts before, with or after row_b of b, ascending */
+auto CompareValues(const ColumnVector &a, size_t row_a, const ColumnVector &b, size_t row_b) -> int {
+  bool a_null = a.IsNull(row_a);
+  bool b_null = b.IsNull(row_b);
+  if (a_null || b_null) {
+    return static_cast<int>(b_null) - static_cast<int>(a_null);
+  }
+  switch (a.GetType()) {
+    case ColumnType::INTEGER:
+      return (a.GetInteger(row_a) > b.GetInteger(row_b)) - (a.GetInteger(row_a) < b.GetInteger(row_b));
+    case ColumnType::REAL:
+      return (a.GetReal(row_a) > b.GetReal(row_b)) - (a.GetReal(row_a) < b.GetReal(row_b));
+    case ColumnType::TEXT:
+      return a.GetText(row_a).compare(b.GetText(row_b));
+  }
+  UNREACHABLE("Unknown column type.");
+}
+
+}  // namespace
+
+auto CompareRows(const std::vector<SortKey> &keys, const DataChunk &a, size_t row_a, const DataChunk &b, size_t row_b)
+    -> int {
+  for (const SortKey &key : keys) {
+    int cmp = CompareValues(a.GetColumn(key.column_), row_a, b.GetColumn(key.column_), row_b);
+    if (cmp != 0) {
+      return key.ascending_ ? cmp : -cmp;
+    }
+  }
+  return 0;
+}
+
+SortOperator::SortOperator(std::unique_ptr<VectorOperator> child, std::vector<SortKey> keys)
+    : VectorOperator(child->GetOutputTypes()), child_(std::move(child)), keys_(std::move(keys)) {}
+
+void SortOperator::Init() {
+  this->child_->Init();
+  this->rows_.Initialize(this->output_types_);
+  DataChunk chunk;
+  while (this->child_->Next(&chunk)) {
+    this->rows_.Append(chunk);
+  }
+  this->order_.resize(this->rows_.Size());
+  std::iota(this->order_.begin(), this->order_.end(), 0);
+  std::stable_sort(this->order_.begin(), this->order_.end(), [this](uint32_t a, uint32_t b) {
+    return CompareRows(this->keys_, this->rows_, a, this->rows_, b) < 0;
+  });
+  this->emitted_ = 0;
+}
+
+auto SortOperator::Next(DataChunk *chunk) -> bool {
+  if (this->emitted_ == this->order_.size()) {
+    return false;
+  }
+  size_t count = std::min(VECTOR_SIZE, this->order_.size() - this->emitted_);
+  chunk->Initialize(this->output_types_);
+  for (size_t i = 0; i < chunk->ColumnCount(); ++i) {
+    chunk->GetColumn(i).Gather(this->rows_.GetColumn(i), this->order_.data() + this->emitted_, count);
+  }
+  this->emitted_ += count;
+  return true;
+}
+
+}  // namespace bustub
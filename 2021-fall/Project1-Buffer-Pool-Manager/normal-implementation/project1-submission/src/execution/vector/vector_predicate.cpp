@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_predicate.cpp
+//
+// Identification: src/execution/vector/vector_predicate.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vector/vector_predicate.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Keep the rows of sel whose value satisfies op against the constant. The loop has no branch on the outcome: every
+ * row is written and only the ones that pass move the output forward, so it runs at the same speed whatever the
+ * selectivity.
+ */
+template <class T, class Op>
+auto SelectComparison(const T *values, const uint8_t *nulls, T constant, Op op, const uint32_t *sel, size_t count,
+                      uint32_t *out) -> size_t {
+  size_t n = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t row = sel[i];
+    out[n] = row;
+    n += static_cast<size_t>(op(values[row], constant) & (nulls[row] == 0));
+  }
+  return n;
+}
+
+template <class T>
+auto SelectComparison(ComparisonType type, const T *values, const uint8_t *nulls, T constant, const uint32_t *sel,
+                      size_t count, uint32_t *out) -> size_t {
+  switch (type) {
+    case ComparisonType::EQUAL:
+      return SelectComparison(values, nulls, constant, std::equal_to<T>(), sel, count, out);
+    case ComparisonType::NOT_EQUAL:
+      return SelectComparison(values, nulls, constant, std::not_equal_to<T>(), sel, count, out);
+    case ComparisonType::LESS_THAN:
+      return SelectComparison(values, nulls, constant, std::less<T>(), sel, count, out);
+    case ComparisonType::LESS_THAN_OR_EQUAL:
+      return SelectComparison(values, nulls, constant, std::less_equal<T>(), sel, count, out);
+    case ComparisonType::GREATER_THAN:
+      return SelectComparison(values, nulls, constant, std::greater<T>(), sel, count, out);
+    case ComparisonType::GREATER_THAN_OR_EQUAL:
+      return SelectComparison(values, nulls, constant, std::greater_equal<T>(), sel, count, out);
+  }
+  UNREACHABLE("Unknown comparison.");
+}
+
+class IntegerComparison : public VectorPredicate {
+ public:
+  IntegerComparison(size_t column, ComparisonType type, int64_t constant)
+      : column_(column), type_(type), constant_(constant) {}
+
+  auto Select(const DataChunk &chunk, const uint32_t *sel, size_t count, uint32_t *out) const -> size_t override {
+    const ColumnVector &column = chunk.GetColumn(this->column_);
+    if (column.GetType() == ColumnType::REAL) {
+      return SelectComparison(this->type_, column.Reals(), column.Nulls(), static_cast<double>(this->constant_), sel,
+                              count, out);
+    }
+    BUSTUB_ASSERT(column.GetType() == ColumnType::INTEGER, "Comparing a TEXT column with a number.");
+    return SelectComparison(this->type_, column.Integers(), column.Nulls(), this->constant_, sel, count, out);
+  }
+
+ private:
+  size_t column_;
+  ComparisonType type_;
+  int64_t constant_;
+};
+
+class TextComparison : public VectorPredicate {
+ public:
+  TextComparison(size_t column, ComparisonType type, std::string constant)
+      : column_(column), type_(type), constant_(std::move(constant)) {}
+
+  auto Select(const DataChunk &chunk, const uint32_t *sel, size_t count, uint32_t *out) const -> size_t override {
+    const ColumnVector &column = chunk.GetColumn(this->column_);
+    BUSTUB_ASSERT(column.GetType() == ColumnType::TEXT, "Comparing a number column with a string.");
+    return SelectComparison(this->type_, column.Texts(), column.Nulls(), std::string_view(this->constant_), sel,
+                            count, out);
+  }
+
+ private:
+  size_t column_;
+  ComparisonType type_;
+  std::string constant_;
+};
+
+class AndPredicate : public VectorPredicate {
+ public:
+  explicit AndPredicate(std::vector<std::unique_ptr<VectorPredicate>> children) : children_(std::move(children)) {}
+
+  auto Select(const DataChunk &chunk, const uint32_t *sel, size_t count, uint32_t *out) const -> size_t override {
+    // Each child only tests the rows the ones before it kept.
+    for (const auto &child : this->children_) {
+      count = child->Select(chunk, sel, count, out);
+      sel = out;
+    }
+    if (sel != out) {
+      std::copy(sel, sel + count, out);
+    }
+    return count;
+  }
+
+ private:
+  std::vector<std::unique_ptr<VectorPredicate>> children_;
+};
+
+class OrPredicate : public VectorPredicate {
+ public:
+  explicit OrPredicate(std::vector<std::unique_ptr<VectorPredicate>> children) : children_(std::move(children)) {}
+
+  auto Select(const DataChunk &chunk, const uint32_t *sel, size_t count, uint32_t *out) const -> size_t override {
+    // Each child only tests the rows no child before it kept; the rows it keeps are merged into the result.
+    std::vector<uint32_t> remaining(sel, sel + count);
+    std::vector<uint32_t> result;
+    std::vector<uint32_t> selected(count);
+    std::vector<uint32_t> merged;
+    for (const auto &child : this->children_) {
+      size_t n = child->Select(chunk, remaining.data(), remaining.size(), selected.data());
+      merged.clear();
+      std::merge(result.begin(), result.end(), selected.begin(), selected.begin() + n, std::back_inserter(merged));
+      result.swap(merged);
+      auto end = std::set_difference(remaining.begin(), remaining.end(), selected.begin(), selected.begin() + n,
+                                     remaining.begin());
+      remaining.erase(end, remaining.end());
+    }
+    std::copy(result.begin(), result.end(), out);
+    return result.size();
+  }
+
+ private:
+  std::vector<std::unique_ptr<VectorPredicate>> children_;
+};
+
+}  // namespace
+
+auto MakeComparison(size_t column, ComparisonType type, int64_t constant) -> std::unique_ptr<VectorPredicate> {
+  return std::make_unique<IntegerComparison>(column, type, constant);
+}
+
+auto MakeComparison(size_t column, ComparisonType type, std::string constant) -> std::unique_ptr<VectorPredicate> {
+  return std::make_unique<TextComparison>(column, type, std::move(constant));
+}
+
+auto MakeAnd(std::vector<std::unique_ptr<VectorPredicate>> children) -> std::unique_ptr<VectorPredicate> {
+  return std::make_unique<AndPredicate>(std::move(children));
+}
+
+auto MakeOr(std::vector<std::unique_ptr<VectorPredicate>> children) -> std::unique_ptr<VectorPredicate> {
+  return std::make_unique<OrPredicate>(std::move(children));
+}
+
+}  // namespace bustub
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST '03).
+ *
+ * Resident frames are split between T1 (pages seen once recently) and T2 (pages seen at least twice). The ghost
+ * lists B1 and B2 remember the ids of pages recently evicted from T1 and T2. A miss on a page found in B1 means
+ * recency was undervalued, so the target size of T1 grows; a miss found in B2 shrinks it. The split therefore follows
+ * the workload, from scan-heavy (recency) to lookup-heavy (frequency).
+ *
+ * Pinned frames stay in their list but are skipped by Victim. Frames whose page is deleted or that are retired leave
+ * the lists through Remove, so that they do not count toward |T1| and |T2|.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_pages the maximum number of pages the ARCReplacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_pages);
+
+  /**
+   * Destroys the ARCReplacer.
+   */
+  ~ARCReplacer() override;
+
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  void SetCapacity(size_t num_pages) override;
+
+  /** @return the current target size of T1, the adaptation parameter p of ARC */
+  auto GetTargetRecencySize() -> size_t;
+
+ private:
+  enum class ListType { NONE, T1, T2 };
+
+  struct FrameInfo {
+    ListType list_{ListType::NONE};
+    bool evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  struct GhostList {
+    /** Front is the most recently evicted page. */
+    std::list<page_id_t> list_;
+    std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+
+    inline auto Contains(page_id_t page_id) -> bool { return index_.count(page_id) != 0; }
+
+    inline void PushFront(page_id_t page_id) {
+      list_.push_front(page_id);
+      index_[page_id] = list_.begin();
+    }
+
+    inline void Erase(page_id_t page_id) {
+      auto itr = index_.find(page_id);
+      list_.erase(itr->second);
+      index_.erase(itr);
+    }
+
+    inline void PopBack() {
+      index_.erase(list_.back());
+      list_.pop_back();
+    }
+
+    inline auto Size() -> size_t { return list_.size(); }
+  };
+
+  /** Put a frame at the MRU end of T1 or T2. */
+  void Insert(frame_id_t frame_id, ListType list, page_id_t page_id, bool evictable);
+
+  /** Take a frame out of its list without remembering it in a ghost list. */
+  void Unlink(frame_id_t frame_id);
+
+  /** Evict the least recently used unpinned frame of list, remembering its page in ghost. */
+  auto EvictFrom(std::list<frame_id_t> *list, GhostList *ghost, frame_id_t *frame_id) -> bool;
+
+  /** Keep |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. */
+  void TrimGhosts();
+
+  /** c, the number of frames */
+  size_t capacity_;
+  /** p, the target size of T1 */
+  size_t target_t1_{0};
+  /** Front is the most recently used frame. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  GhostList b1_;
+  GhostList b2_;
+  std::vector<FrameInfo> frames_;
+  size_t num_evictable_{0};
+
+  std::mutex mutex_;
+};
+
+}  // namespace bustub
@@ -12,18 +12,48 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <functional>
 #include <list>
+#include <deque>
 #include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "buffer/arc_replacer.h"
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/buffered_replacer.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/free_space_map.h"
+#include "buffer/io_executor.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/tinylfu_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
+/**
+ * OptimisticPageHandle remembers the frame a page was last seen in, so that repeated optimistic reads of a hot page
+ * go straight to the frame. A stale frame is detected and looked up again.
+ */
+struct OptimisticPageHandle {
+  explicit OptimisticPageHandle(page_id_t page_id) : page_id_(page_id) {}
+
+  page_id_t page_id_;
+  Page *page_{nullptr};
+  /** Frame epoch page_ was seen in. A shrink that frees frames moves the epoch on and page_ is looked up again. */
+  uint64_t frame_epoch_{0};
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -34,8 +64,10 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
    */
-  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU);
   /**
    * Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
@@ -43,9 +75,11 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param instance_index index of this BPI in the parallel BPM
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
    */
   BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                            DiskManager *disk_manager, LogManager *log_manager = nullptr);
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU);
 
   /**
    * Destroys an existing BufferPoolManagerInstance.
@@ -55,10 +89,203 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @return size of the buffer pool */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
-  /** @return pointer to all the pages in the buffer pool */
-  auto GetPages() -> Page * { return pages_; }
+  /** @return pointer to the frames allocated by the constructor; a resize never frees them */
+  auto GetPages() -> Page * { return chunks_.front().pages_; }
+
+  /**
+   * Change the number of frames while the pool is in use.
+   *
+   * Growing allocates a new chunk of frames and adds them to the free list. Shrinking stops handing out the frames
+   * past the new size and retires them: free frames at once, the others once they are unpinned, by a background
+   * thread that evicts their pages. A chunk is freed once all of its frames are retired and no optimistic read can
+   * still be looking at it. Frames are retired from the highest id down, so the frames of the constructor stay.
+   *
+   * @param pool_size the new number of frames, at least 1
+   */
+  void Resize(size_t pool_size);
+
+  /**
+   * Wait until the frames retired by the last shrink are gone. A frame that stays pinned keeps this waiting.
+   */
+  void WaitForResize();
+
+  /**
+   * Attach a compressed second-level cache. Evicted pages go there before they go to disk, and misses look there
+   * before they read from disk. Must be called before the instance is used.
+   * @param compressed_cache the cache, not owned; nullptr detaches it
+   */
+  void SetCompressedPageCache(CompressedPageCache *compressed_cache) { compressed_cache_ = compressed_cache; }
+
+  /**
+   * Track allocated pages in an on-disk free-space map, so that deleted pages are handed out again by NewPage instead
+   * of the file growing forever. Must be called before the first page of the file is allocated, and again on every
+   * restart: the map pages sit at fixed page ids that the plain page counter would also hand out.
+   */
+  void EnableFreeSpaceMap();
+
+  /**
+   * Create count new pages with consecutive ids among the ones of this instance, so that a scan over them reads the
+   * file in order. Requires the free-space map.
+   * @param count number of pages, less than FreeSpaceMapPage::NUM_BITS
+   * @param[out] page_ids receives the ids of the created pages, in increasing order
+   * @param[out] pages array of count entries receiving the pinned pages
+   * @return false if there were not enough frames; no page is created in that case
+   */
+  auto NewPageExtent(size_t count, std::vector<page_id_t> *page_ids, Page **pages) -> bool;
+
+  /**
+   * @return the dirty-page table: id and recovery LSN of every page, in the pool or in the compressed cache, whose
+   * changes are not on disk yet
+   */
+  auto GetDirtyPages() -> std::vector<std::pair<page_id_t, lsn_t>>;
+
+  /**
+   * Write a page back if it is dirty, for fuzzy checkpoints, whether it is in the pool or in the compressed cache.
+   * @param page_id id of the page
+   */
+  void CheckpointPage(page_id_t page_id);
+
+  /** @return hit-rate and latency counters of the pool, the compressed cache and the disk */
+  auto GetStats() -> const BufferPoolStats & { return stats_; }
+
+  /**
+   * Fetch a page and take its read latch.
+   * @param page_id id of page to be fetched
+   * @return a guard releasing the latch and the pin on destruction; empty if no frame was available
+   */
+  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
+
+  /**
+   * Fetch a page and take its write latch.
+   * @param page_id id of page to be fetched
+   * @return a guard releasing the latch and the pin on destruction; empty if no frame was available
+   */
+  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+
+  /**
+   * Create a new page and take its write latch.
+   * @param[out] page_id id of created page
+   * @return a guard releasing the latch and the pin on destruction; empty if no frame was available
+   */
+  auto NewPageGuarded(page_id_t *page_id) -> WritePageGuard;
+
+  /**
+   * Read a page without pinning it. The frame's version is read before and validated after read_fn runs; on a
+   * conflict the read is retried, and after MAX_OPTIMISTIC_RETRIES it falls back to a pinned read under the read
+   * latch. Pages that are not resident are always read pinned, which brings them in.
+   *
+   * read_fn may observe a torn page while a writer is active. It must only copy out what it needs, never follow
+   * offsets from the page without bounds checks, and have no side effects beyond its output: it may run several times.
+   *
+   * @param handle id of the page to read and the frame it was last seen in, updated on return
+   * @param read_fn callable taking a const char * to the page data
+   * @return false if the page is not resident and could not be brought in
+   */
+  template <class ReadFn>
+  auto ReadPageOptimistic(OptimisticPageHandle *handle, ReadFn &&read_fn) -> bool {
+    // While this thread is counted, no chunk of frames unlinked by a shrink is freed.
+    std::atomic<int64_t> &readers = this->LocalReaderCount();
+    readers.fetch_add(1);
+    uint64_t frame_epoch = this->frame_epoch_.load();
+    if (handle->frame_epoch_ != frame_epoch) {
+      handle->page_ = nullptr;
+      handle->frame_epoch_ = frame_epoch;
+    }
+
+    for (int attempt = 0; attempt < MAX_OPTIMISTIC_RETRIES; ++attempt) {
+      if (handle->page_ == nullptr) {
+        handle->page_ = this->LookupPage(handle->page_id_);
+        if (handle->page_ == nullptr) {
+          break;
+        }
+      }
+      Page *page = handle->page_;
+      uint64_t version = page->version_.load(std::memory_order_acquire);
+      if ((version & 1) != 0) {
+        continue;
+      }
+      // The frame may have been given to another page since the handle was filled in.
+      bool same_page = page->page_id_ == handle->page_id_;
+      if (same_page) {
+        read_fn(static_cast<const char *>(page->data_));
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (page->version_.load(std::memory_order_relaxed) != version) {
+        continue;
+      }
+      if (same_page) {
+        readers.fetch_sub(1);
+        return true;
+      }
+      handle->page_ = nullptr;
+    }
+    readers.fetch_sub(1);
+
+    ReadPageGuard guard = this->FetchPageRead(handle->page_id_);
+    if (!guard.IsValid()) {
+      return false;
+    }
+    read_fn(guard.GetData());
+    handle->page_ = guard.guard_.page_;
+    return true;
+  }
+
+  /**
+   * Fetch a batch of pages, taking latch_ only once to pin the hits and reserve a frame for every miss. The misses are
+   * then read without latch_, in page id order, so that other fetches go on meanwhile. Every returned page is pinned
+   * once per occurrence of its id and must be unpinned as usual.
+   * @param page_ids ids of the pages to fetch, all owned by this instance; duplicates are allowed
+   * @param[out] pages array of page_ids.size() entries receiving the pages in the same order
+   * @param executor runs the reads concurrently, not owned; nullptr to read them one by one on the calling thread
+   * @return false if there were not enough frames for the whole batch; nothing stays pinned in that case
+   */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, Page **pages, IoExecutor *executor = nullptr) -> bool;
+
+  /**
+   * Fetch a page without blocking on the read. On a miss, a frame is reserved and pinned under latch_ as usual, but
+   * the read is issued from the executor through DiskManager::ReadPageAsync and the calling thread returns right away.
+   * A device that completes reads on its own holds no worker while a read is in flight; the database file still reads
+   * synchronously on the worker. Fetches of the page that come in while the read is in flight wait for it:
+   * asynchronous ones are queued behind it, synchronous ones block.
+   *
+   * The callback runs exactly once, on the calling thread for a hit, a compressed cache hit or if no frame is free,
+   * and otherwise on the executor. It gets the pinned page, which must be unpinned as usual, or nullptr if no frame
+   * was available.
+   * @param page_id id of page to be fetched
+   * @param executor issues the read and runs the callback, not owned; must outlive the instance
+   * @param callback called with the page
+   */
+  void FetchPageAsync(page_id_t page_id, IoExecutor *executor, std::function<void(Page *)> callback);
+
+  /** @return whether page ids route to this instance; a dump taken with a different number of instances has others */
+  auto IsOwnPage(page_id_t page_id) const -> bool { return page_id % num_instances_ == instance_index_; }
+
+  /**
+   * @return ids of the resident pages, most recently used first
+   */
+  auto GetHotPages() -> std::vector<page_id_t>;
+
+  /**
+   * Bring pages in ahead of use, for warming up the pool. Only free frames are used, so nothing that is already in
+   * the pool is evicted. Prefetched pages are left unpinned. Pages that are already resident are skipped. The frames
+   * are reserved under latch_ and read without it, so the workload is not held up by the warm-up.
+   * @param page_ids ids of the pages, all owned by this instance
+   * @param[out] loaded incremented by the number of pages read
+   * @return false if the free list ran out before every page was resident
+   */
+  auto PrefetchPages(const std::vector<page_id_t> &page_ids, size_t *loaded) -> bool;
 
  protected:
+  friend class BasicPageGuard;
+  friend class ParallelBufferPoolManager;
+
+  /** A frame reserved for a page that is read outside latch_. */
+  struct FrameLoad {
+    page_id_t page_id_;
+    frame_id_t frame_id_;
+    Page *page_;
+  };
+
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
@@ -75,7 +302,7 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
 
   /**
-   * Flushes the target page to disk.
+   * Flushes the target page to disk. The page is clean afterwards and leaves the dirty page table.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
@@ -96,23 +323,236 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
   /**
-   * Flushes all the pages in the buffer pool to disk.
+   * Flushes all the pages in the buffer pool, and the dirty pages of the compressed cache, to disk.
    */
   void FlushAllPgsImp() override;
 
   /**
-   * Allocate a page on disk.∂
+   * FetchPgImp, also returning the frame.
+   * @param page_id id of page to be fetched
+   * @param[out] frame_id frame holding the page
+   * @return the requested page, nullptr if no frame was available
+   */
+  auto FetchFrame(page_id_t page_id, frame_id_t *frame_id) -> Page *;
+
+  /**
+   * NewPgImp, also returning the frame.
+   * @param[out] page_id id of created page
+   * @param[out] frame_id frame holding the page
+   * @return the new page, nullptr if no frame was available
+   */
+  auto NewFrame(page_id_t *page_id, frame_id_t *frame_id) -> Page *;
+
+  /**
+   * First step of FetchPages: pin the hits and reserve a frame for every miss, under latch_. A miss served by the
+   * compressed cache is done at once; the others are registered in pending_loads_ and returned in loads.
+   *
+   * latch_ is never released in between. Waiting here for a page that another fetch is reading could deadlock with
+   * that fetch waiting for one of ours, so such a page is pinned right away and waited for by WaitForLoads.
+   * @param page_ids ids of the pages to fetch, all owned by this instance; duplicates are allowed
+   * @param[out] pages array of page_ids.size() entries receiving the pages in the same order
+   * @param[out] frame_ids receives the frames of the pages in the same order
+   * @param[out] loads receives the misses to read, in page id order
+   * @return false if there were not enough frames for the whole batch; nothing stays pinned in that case
+   */
+  auto PinPages(const std::vector<page_id_t> &page_ids, Page **pages, std::vector<frame_id_t> *frame_ids,
+                std::vector<FrameLoad> *loads) -> bool;
+
+  /**
+   * Second step of FetchPages: read the misses reserved by PinPages into their frames and publish them.
+   * @param loads the reserved frames
+   * @param executor issues the reads through StartRead, not owned; nullptr to read them on the calling thread before
+   * returning
+   */
+  void StartLoads(const std::vector<FrameLoad> &loads, IoExecutor *executor);
+
+  /**
+   * Issue the read of a frame registered in pending_loads_ and publish it with FinishLoad when the device calls back.
+   * Caller does not hold latch_.
+   * @param load the reserved frame
+   * @param executor runs the callbacks of the asynchronous fetches waiting for the page
+   */
+  void StartRead(const FrameLoad &load, IoExecutor *executor);
+
+  /** Wait until no read is pending, before the instance or the executor that reads for it goes away. */
+  void DrainLoads();
+
+  /**
+   * Last step of FetchPages: wait until none of the frames is being read any more.
+   * @param frame_ids pinned frames
+   */
+  void WaitForLoads(const std::vector<frame_id_t> &frame_ids);
+
+  /**
+   * Pin a page for a fetch if it is loaded in an active frame. Caller holds latch_, shared is enough.
+   * @param page_id id of the page
+   * @param[out] frame_id frame holding the page
+   * @return the page, nullptr if it is not resident, still being read, or in a frame a shrink is retiring
+   */
+  auto PinIfLoaded(page_id_t page_id, frame_id_t *frame_id) -> Page *;
+
+  /**
+   * Pin a resident page for a fetch and record the access. Caller holds latch_, shared is enough.
+   * @param frame_id frame holding the page
+   * @param page_id id of the page
+   * @return the page
+   */
+  auto PinFrame(frame_id_t frame_id, page_id_t page_id) -> Page *;
+
+  /**
+   * Pick a frame for a page that is not resident, map the page to it and pin it. The frame stays in the middle of an
+   * update until its content is loaded. Caller holds latch_.
+   * @param page_id id of the page
+   * @param[out] frame_id the frame
+   * @return the frame, nullptr if all the pages in the buffer pool are pinned
+   */
+  auto ReserveFrame(page_id_t page_id, frame_id_t *frame_id) -> Page *;
+
+  /**
+   * Publish a frame registered in pending_loads_ once its content is in: end the update, wake up the synchronous
+   * fetches waiting for it and run the callbacks of the asynchronous ones. Caller does not hold latch_.
+   * @param frame_id the frame
+   * @param page the page in it
+   * @param executor runs the callbacks; nullptr to run them on the calling thread
+   */
+  void FinishLoad(frame_id_t frame_id, Page *page, IoExecutor *executor);
+
+  /**
+   * Look a page up in the page table, first waiting for a pending read of it to finish. Caller holds latch_.
+   * @param lk lock on latch_, released while waiting
+   * @param page_id id of the page
+   * @return the page table entry, or the end of the page table if the page is not resident
+   */
+  auto FindLoadedPage(std::unique_lock<std::shared_mutex> *lk, page_id_t page_id)
+      -> std::unordered_map<page_id_t, frame_id_t>::iterator;
+
+  /**
+   * Look a page up to pin it. A page in a frame that a shrink is retiring is first moved to an active frame, so that
+   * hits do not keep the frame in use forever. While other threads hold the page it cannot move: new pins are held
+   * back for up to RETIRE_WAIT_LIMIT, then the page is pinned where it is. Caller holds latch_.
+   * @param lk lock on latch_, released while waiting
+   * @param page_id id of the page
+   * @return the page table entry, or the end of the page table if the page is not resident
+   */
+  auto FindPageToPin(std::unique_lock<std::shared_mutex> *lk, page_id_t page_id)
+      -> std::unordered_map<page_id_t, frame_id_t>::iterator;
+
+  /**
+   * Copy the page of an unpinned, retiring frame into an active frame and retire the old one; no I/O is needed.
+   * Caller holds latch_.
+   * @param frame_id the frame
+   * @return false if the frame is not retiring, is pinned or loading, or no active frame is available
+   */
+  auto MoveRetiringPage(frame_id_t frame_id) -> bool;
+
+  /**
+   * Find the frame of a resident page without pinning it.
+   * @param page_id id of the page
+   * @return the frame, or nullptr if the page is not resident
+   */
+  auto LookupPage(page_id_t page_id) -> Page *;
+
+  /**
+   * Give back a pin taken by a page guard. This does not take latch_: the pin count is decremented atomically and
+   * only the replacer is told when the page becomes evictable. A frame reaching the replacer after it was pinned
+   * again is filtered out by AcquireFrame.
+   * @param page the pinned page
+   * @param frame_id frame holding the page
+   * @param is_dirty true if the page should be marked as dirty
+   */
+  void ReleasePage(Page *page, frame_id_t frame_id, bool is_dirty);
+
+  /**
+   * Pick a frame to hold a new page, always from the free list first and then from the replacer.
+   * A victim page is handed to EvictPage and removed from the page table. The frame is returned in the middle of an
+   * update (odd version), the caller calls EndUpdate once the new page is installed. Caller holds latch_.
+   * @param[out] frame_id id of the frame that can be reused
+   * @return false if all the pages in the buffer pool are pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id) -> bool;
+
+  /**
+   * Move a page out of its frame: hand it to the compressed cache if there is one, otherwise write it back if dirty.
+   * Caller holds latch_.
+   * @param page the victim page
+   */
+  void EvictPage(Page *page);
+
+  /**
+   * Write a resident page to disk and mark it clean. latch_ is only held to pin the page: the page is copied under its
+   * read latch, its recovery LSN reset, the log forced up to its page LSN, and the copy written, so fetches go on
+   * during the write and changes made after the copy are not lost.
+   * @param page_id id of the page
+   * @param only_dirty skip the write if the page is clean
+   * @return false if the page is not in the pool
+   */
+  auto WritePageBack(page_id_t page_id, bool only_dirty) -> bool;
+
+  /**
+   * Write-ahead logging: make the log records of a page durable before the page itself leaves the pool. Only the log
+   * up to the page LSN is forced. Caller holds latch_.
+   * @param page the page about to be written back or handed to the compressed cache
+   */
+  void ForceLogForPage(Page *page);
+
+  /** @return the LSN the next log record will get, INVALID_LSN without a log manager */
+  auto GetEndOfLog() -> lsn_t {
+    return this->log_manager_ == nullptr ? INVALID_LSN : this->log_manager_->GetNextLSN();
+  }
+
+  /**
+   * Move a page from the compressed cache into its frame, with its dirty state. Caller holds latch_, so that the
+   * page is in the cache or dirty in the pool for GetDirtyPages, never in neither.
+   * @param page_id id of the page to load
+   * @param page the frame, its page_id_ must already be set
+   * @return false if the page is not in the compressed cache
+   */
+  auto LoadFromCompressedCache(page_id_t page_id, Page *page) -> bool;
+
+  /**
+   * Read the content of a page from disk into its frame. The caller either holds latch_ or has the frame to itself,
+   * pinned and registered in pending_loads_.
+   * @param page_id id of the page to read
+   * @param page the frame, its page_id_ must already be set
+   */
+  void ReadFromDisk(page_id_t page_id, Page *page);
+
+  /**
+   * Allocate a chunk of count frames and add them to the free list. Caller holds latch_.
+   */
+  void AddFrames(size_t count);
+
+  /**
+   * Take an unpinned frame past pool_size_ out of use: evict its page and remove it from the replacer.
+   * Caller holds latch_.
+   * @return false if the frame is pinned
+   */
+  auto TryRetireFrame(frame_id_t frame_id) -> bool;
+
+  /**
+   * Retire what can be retired after a shrink and free the chunks that became unused. Caller holds latch_.
+   * @return true if the shrink is complete
+   */
+  auto RetireFrames() -> bool;
+
+  /** Body of the thread finishing a shrink in the background. */
+  void RunResizeWorker();
+
+  /** @return the optimistic reader count of the calling thread's stripe */
+  auto LocalReaderCount() -> std::atomic<int64_t> &;
+
+  /**
+   * Allocate a page on disk. Caller holds latch_.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk, so that the free-space map can hand it out again. Without the map this is a no-op.
+   * Caller must not hold latch_: the map pages are fetched through this pool.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
 
   /**
    * Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
@@ -121,8 +561,31 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   void ValidatePageId(page_id_t page_id) const;
 
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
+  /** Optimistic attempts before ReadPageOptimistic falls back to a pinned read. */
+  static constexpr int MAX_OPTIMISTIC_RETRIES = 8;
+
+  /** Optimistic reader counts are striped to keep readers on different threads off each other's cache lines. */
+  static constexpr size_t READER_STRIPES = 16;
+  /** How often the resize worker looks for frames that got unpinned. */
+  static constexpr std::chrono::milliseconds RESIZE_POLL_INTERVAL{1};
+  /** How long a fetch holds back from pinning a page in a retiring frame that other threads still hold. */
+  static constexpr std::chrono::milliseconds RETIRE_WAIT_LIMIT{10};
+
+  enum class FrameStatus : uint8_t { ACTIVE, RETIRING, RETIRED };
+
+  /** Frames allocated together by the constructor or a grow. */
+  struct FrameChunk {
+    Page *pages_;
+    frame_id_t first_frame_;
+    size_t size_;
+  };
+
+  struct alignas(64) ReaderCount {
+    std::atomic<int64_t> count_{0};
+  };
+
+  /** Number of pages in the buffer pool. Frames below it are active, the ones above are being retired. */
+  std::atomic<size_t> pool_size_;
   /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
   const uint32_t num_instances_ = 1;
   /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
@@ -130,19 +593,47 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** Each BPI maintains its own counter for page_ids to hand out, must ensure they mod back to its instance_index_ */
   std::atomic<page_id_t> next_page_id_ = instance_index_;
 
-  /** Array of buffer pool pages. */
-  Page *pages_;
+  /** Chunks of buffer pool pages, in frame id order. */
+  std::vector<FrameChunk> chunks_;
+  /** Page of every frame id. */
+  std::vector<Page *> frames_;
+  std::vector<FrameStatus> frame_status_;
+  /** Value of access_clock_ at the last access of every frame. Hits stamp it under a shared latch_. */
+  std::deque<std::atomic<uint64_t>> last_access_;
+  std::atomic<uint64_t> access_clock_{0};
+  /** Unlinked chunks waiting for the optimistic reads that may still look at them. */
+  std::vector<Page *> retired_chunks_;
+  /** Moves on whenever chunks are unlinked. */
+  std::atomic<uint64_t> frame_epoch_{0};
+  ReaderCount optimistic_readers_[READER_STRIPES];
+  std::thread resize_worker_;
+  bool resize_worker_running_{false};
+  std::atomic<bool> shutdown_{false};
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
-  LogManager *log_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
   /** Page table for keeping track of buffer pool pages. */
   std::unordered_map<page_id_t, frame_id_t> page_table_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  /** Optional compressed second-level cache, not owned. */
+  CompressedPageCache *compressed_cache_{nullptr};
+  /** Frames whose page is being read without latch_, with the callbacks of the asynchronous fetches waiting on them. */
+  std::unordered_map<frame_id_t, std::vector<std::function<void(Page *)>>> pending_loads_;
+  /** Signalled with latch_ whenever a pending read finishes. */
+  std::condition_variable_any load_cv_;
+  /** Optional free-space map; nullptr means page ids come from next_page_id_ and are never reused. */
+  FreeSpaceMap *free_space_map_{nullptr};
+  /** Per-tier hit-rate and latency counters. */
+  BufferPoolStats stats_;
+  /**
+   * Protects the page table, the free list, the frame vectors and pending_loads_. Hits on loaded pages and unpins
+   * take it shared and only touch atomics and the replacer, which has a latch of its own; everything that changes
+   * what a frame holds takes it exclusively.
+   */
+  std::shared_mutex latch_;
 };
 }  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * CacheTierStats counts the lookups served by one level of the page hierarchy and the time spent serving them.
+ */
+struct CacheTierStats {
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  /** Total time spent serving the hits, in nanoseconds */
+  std::atomic<uint64_t> hit_latency_ns_{0};
+
+  inline void RecordHit(uint64_t latency_ns) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    hit_latency_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+  }
+
+  inline void RecordMiss() { misses_.fetch_add(1, std::memory_order_relaxed); }
+
+  inline auto HitRate() const -> double {
+    uint64_t hits = hits_.load(std::memory_order_relaxed);
+    uint64_t total = hits + misses_.load(std::memory_order_relaxed);
+    return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+  }
+
+  inline auto AvgHitLatencyNs() const -> double {
+    uint64_t hits = hits_.load(std::memory_order_relaxed);
+    return hits == 0 ? 0.0 : static_cast<double>(hit_latency_ns_.load(std::memory_order_relaxed)) / hits;
+  }
+};
+
+/**
+ * LatencyHistogram counts latencies in power-of-two buckets of nanoseconds: bucket b holds [2^(b-1), 2^b). It is
+ * cheap enough to record every fetch, and two snapshots give the distribution over the time between them.
+ */
+struct LatencyHistogram {
+  static constexpr size_t NUM_BUCKETS = 64;
+
+  std::atomic<uint64_t> buckets_[NUM_BUCKETS]{};
+
+  inline void Record(uint64_t latency_ns) { buckets_[Bucket(latency_ns)].fetch_add(1, std::memory_order_relaxed); }
+
+  /** @param[out] counts NUM_BUCKETS entries receiving the current counts */
+  inline void Snapshot(uint64_t *counts) const {
+    for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+      counts[b] = buckets_[b].load(std::memory_order_relaxed);
+    }
+  }
+
+  /** @return bucket of a latency */
+  static inline auto Bucket(uint64_t latency_ns) -> size_t {
+    return latency_ns == 0 ? 0 : std::min<size_t>(NUM_BUCKETS - 1, 64 - __builtin_clzll(latency_ns));
+  }
+
+  /**
+   * @param counts NUM_BUCKETS bucket counts, e.g. the difference of two snapshots
+   * @param q quantile in [0, 1]
+   * @return upper bound in nanoseconds of the bucket holding the q-quantile, 0 if there is no sample
+   */
+  static inline auto Percentile(const uint64_t *counts, double q) -> uint64_t {
+    uint64_t total = 0;
+    for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+      total += counts[b];
+    }
+    if (total == 0) {
+      return 0;
+    }
+    auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+      seen += counts[b];
+      if (seen > rank) {
+        return b == NUM_BUCKETS - 1 ? UINT64_MAX : (uint64_t{1} << b);
+      }
+    }
+    return UINT64_MAX;
+  }
+};
+
+/**
+ * BufferPoolStats groups the counters of every tier a FetchPage may go through:
+ * the buffer pool itself, the optional compressed page cache, and the disk.
+ */
+struct BufferPoolStats {
+  /** Page table lookups */
+  CacheTierStats pool_;
+  /** Pool misses served (hit) or not served (miss) by the compressed page cache */
+  CacheTierStats compressed_;
+  /** Page reads issued to the disk manager; every disk read counts as a hit */
+  CacheTierStats disk_;
+  /** End-to-end latency of every FetchPage, including the wait for the pool latch */
+  LatencyHistogram fetch_latency_;
+};
+
+/** @return nanoseconds elapsed since start */
+inline auto ElapsedNs(std::chrono::steady_clock::time_point start) -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace bustub
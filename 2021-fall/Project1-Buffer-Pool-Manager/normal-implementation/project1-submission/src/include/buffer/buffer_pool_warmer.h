@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_warmer.h
+//
+// Identification: src/include/buffer/buffer_pool_warmer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+
+namespace bustub {
+
+/**
+ * BufferPoolWarmer saves the list of hot pages of a buffer pool and loads it back after a restart, like the buffer
+ * pool dump/load of InnoDB.
+ *
+ * Every BufferPoolManagerInstance gets its own file, <path_prefix>.<instance index>, holding one resident page id per
+ * line with the most recently used page first. Dumps are written to a temporary file that is then renamed into place,
+ * so a crash in the middle of a dump leaves the previous one intact.
+ *
+ * Loading runs in the background while the pool serves traffic. The hottest pages go first, in batches that are
+ * sorted by page id so that the reads sweep the file. Prefetching only uses free frames, so once the workload has
+ * filled the pool the load stops instead of evicting pages in use.
+ */
+class BufferPoolWarmer {
+ public:
+  /**
+   * Creates a new BufferPoolWarmer for a single instance.
+   * @param bpm the instance, not owned
+   * @param path_prefix prefix of the dump files
+   */
+  BufferPoolWarmer(BufferPoolManagerInstance *bpm, std::string path_prefix);
+
+  /**
+   * Creates a new BufferPoolWarmer for every instance of a parallel buffer pool.
+   * @param bpm the buffer pool, not owned
+   * @param path_prefix prefix of the dump files
+   */
+  BufferPoolWarmer(ParallelBufferPoolManager *bpm, std::string path_prefix);
+
+  /**
+   * Stops the background threads. A periodic dump writes one last dump before it stops.
+   */
+  ~BufferPoolWarmer();
+
+  /**
+   * Write the hot page list of every instance now.
+   * @return false if a file could not be written
+   */
+  auto Dump() -> bool;
+
+  /**
+   * Dump every interval in the background, until the warmer is destroyed.
+   * @param interval time between two dumps
+   */
+  void StartPeriodicDump(std::chrono::milliseconds interval);
+
+  /**
+   * Prefetch the pages of the last dump in the background. Missing dump files are skipped.
+   * @param batch_size number of pages read under one latch acquisition
+   */
+  void StartLoad(size_t batch_size = DEFAULT_BATCH_SIZE);
+
+  /** Wait for the background load to finish. */
+  void WaitForLoad();
+
+  /** @return number of pages read by the load so far */
+  auto GetLoadedPages() -> size_t { return loaded_pages_; }
+
+  static constexpr size_t DEFAULT_BATCH_SIZE = 64;
+
+ private:
+  /** @return the dump file of an instance */
+  auto GetPath(size_t instance_index) -> std::string;
+
+  /** Write the hot page list of one instance. */
+  auto DumpInstance(size_t instance_index) -> bool;
+
+  /** Prefetch the dumped pages of one instance. */
+  void LoadInstance(size_t instance_index, size_t batch_size);
+
+  std::vector<BufferPoolManagerInstance *> instances_;
+  std::string path_prefix_;
+  std::atomic<size_t> loaded_pages_{0};
+
+  std::thread dump_thread_;
+  std::thread load_thread_;
+  /** Set on destruction, wakes up the periodic dump. */
+  bool stop_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffered_replacer.h
+//
+// Identification: src/include/buffer/buffered_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * BufferedReplacer keeps the bookkeeping of another replacer off the hot path.
+ *
+ * Pin, Unpin and RecordAccess only store the wanted state of the frame in per-frame atomics and append the frame id to
+ * a striped ring buffer. Each thread appends to its own stripe with a single compare-and-swap, so no mutex is taken.
+ * The buffered frames are replayed into the policy in batches: by Victim and Size, which must see an exact state, and
+ * by the thread that fills a stripe past half, if the policy lock is free. A frame is buffered at most once until it
+ * is replayed, so only its latest state is applied and the rings never hold more entries than there are frames.
+ *
+ * Replaying a frame instead of each event keeps the final pinned/evictable state exact but merges repeated accesses of
+ * one frame into one, the same trade-off the read buffers of Caffeine make.
+ */
+class BufferedReplacer : public Replacer {
+ public:
+  /**
+   * Create a new BufferedReplacer.
+   * @param num_pages the maximum number of pages the BufferedReplacer will be required to store
+   * @param policy the replacer making the decisions, owned by the BufferedReplacer
+   */
+  BufferedReplacer(size_t num_pages, Replacer *policy);
+
+  /**
+   * Destroys the BufferedReplacer and its policy.
+   */
+  ~BufferedReplacer() override;
+
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  /** Takes mutex_: pages are rarely deleted, and the buffered events of the frame must be replayed first. */
+  void Remove(frame_id_t frame_id) override;
+
+  void SetCapacity(size_t num_pages) override;
+
+ private:
+  static constexpr size_t STRIPE_CAPACITY = 128;
+  /** Frame states are allocated in segments, so that growing never moves a state another thread is writing. */
+  static constexpr size_t SEGMENT_SIZE = 1024;
+  static constexpr size_t MAX_SEGMENTS = 16384;
+
+  /** The state a frame should have in the policy once it is replayed. */
+  struct FrameState {
+    std::atomic<bool> evictable_{false};
+    std::atomic<bool> accessed_{false};
+    std::atomic<page_id_t> page_id_{INVALID_PAGE_ID};
+    /** Whether the frame sits in a ring and waits to be replayed. */
+    std::atomic<bool> queued_{false};
+  };
+
+  /** Bounded multi-producer ring, consumed only under mutex_. Empty slots hold -1. */
+  struct Stripe {
+    Stripe() {
+      for (auto &slot : slots_) {
+        slot.store(-1, std::memory_order_relaxed);
+      }
+    }
+
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    alignas(64) std::atomic<uint64_t> head_{0};
+    std::atomic<frame_id_t> slots_[STRIPE_CAPACITY];
+  };
+
+  /** Make sure the frame gets replayed, appending it to the caller's stripe unless it is already queued. */
+  void Enqueue(frame_id_t frame_id);
+
+  /** @return whether the frame was appended, false if the stripe is full or was appended to concurrently */
+  auto TryAppend(Stripe *stripe, frame_id_t frame_id) -> bool;
+
+  /** Replay every buffered frame into the policy. The caller holds mutex_. */
+  void DrainAll();
+
+  void Drain(Stripe *stripe);
+
+  /** Apply the latest state of a frame to the policy. The caller holds mutex_. */
+  void Replay(frame_id_t frame_id);
+
+  /** @return the stripe of the calling thread */
+  auto LocalStripe() -> Stripe *;
+
+  /** Allocate the segments holding frames below num_pages. The caller holds mutex_ or is the constructor. */
+  void AllocateSegments(size_t num_pages);
+
+  inline auto GetFrameState(frame_id_t frame_id) -> FrameState & {
+    return this->segments_[frame_id / SEGMENT_SIZE].load(std::memory_order_acquire)[frame_id % SEGMENT_SIZE];
+  }
+
+  Replacer *policy_;
+  std::unique_ptr<std::atomic<FrameState *>[]> segments_;
+  std::vector<std::unique_ptr<Stripe>> stripes_;
+  /** Guards policy_ and the consumer side of the stripes. */
+  std::mutex mutex_;
+};
+
+}  // namespace bustub
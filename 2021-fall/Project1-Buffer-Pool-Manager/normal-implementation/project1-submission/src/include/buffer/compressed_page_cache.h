@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/page_compressor.h"
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * CompressedPageCache is the second level below a BufferPoolManagerInstance. Pages evicted from the pool are kept
+ * here in compressed form so that a later miss can be served by decompression instead of a disk read.
+ *
+ * The cache is exclusive: a page lives either in the pool or in this cache, never in both. Dirty pages stay dirty
+ * while compressed and are written back to disk only when they fall out of this cache (or on FlushAll).
+ */
+class CompressedPageCache {
+ public:
+  /**
+   * Creates a new CompressedPageCache.
+   * @param capacity_bytes budget for the compressed page images
+   * @param compressor codec used for the page images, not owned
+   * @param disk_manager where dirty pages go when they are evicted from this cache
+   */
+  CompressedPageCache(size_t capacity_bytes, PageCompressor *compressor, DiskManager *disk_manager);
+
+  ~CompressedPageCache() = default;
+
+  /**
+   * Stores a page evicted from the pool.
+   * @param page_id id of the page
+   * @param page_data PAGE_SIZE bytes of page content
+   * @param is_dirty whether the page still has to be written back
+   * @param rec_lsn recovery LSN of the page if it is dirty
+   * @return false if the page did not compress well enough to be kept; the caller must then write it out itself
+   */
+  auto Insert(page_id_t page_id, const char *page_data, bool is_dirty, lsn_t rec_lsn = INVALID_LSN) -> bool;
+
+  /**
+   * Removes a page from the cache and decompresses it.
+   * @param page_id id of the page
+   * @param[out] page_data PAGE_SIZE bytes buffer for the page content
+   * @param[out] is_dirty whether the page has not been written back yet
+   * @param[out] rec_lsn recovery LSN of the page if it is dirty, may be nullptr
+   * @return false if the page is not cached
+   */
+  auto Lookup(page_id_t page_id, char *page_data, bool *is_dirty, lsn_t *rec_lsn = nullptr) -> bool;
+
+  /** Drops a page without writing it back, used when the page is deleted. */
+  void Erase(page_id_t page_id);
+
+  /** Writes every dirty cached page to disk. The pages stay cached, now clean. */
+  void FlushAll();
+
+  /**
+   * Writes one cached page to disk if it is dirty. The latch is held during the write, so that a newer image of the
+   * page cannot reach the disk first.
+   * @param page_id id of the page
+   */
+  void FlushPage(page_id_t page_id);
+
+  /** @param[out] dirty_pages receives the id and recovery LSN of every dirty cached page */
+  void GetDirtyPages(std::vector<std::pair<page_id_t, lsn_t>> *dirty_pages);
+
+  /** @return bytes currently used by compressed page images */
+  auto GetUsedBytes() -> size_t;
+
+  /** @return number of cached pages */
+  auto Size() -> size_t;
+
+ private:
+  struct Entry {
+    page_id_t page_id_;
+    bool is_dirty_;
+    lsn_t rec_lsn_;
+    std::vector<char> data_;
+  };
+
+  /** Pages compressing worse than this are not worth caching. */
+  static constexpr size_t MAX_COMPRESSED_SIZE = PAGE_SIZE * 3 / 4;
+
+  /** Evicts the least recently inserted page, writing it back if dirty. Caller holds latch_. */
+  void EvictOne();
+
+  /** Decompresses and writes out one entry. Caller holds latch_. */
+  void WriteBack(const Entry &entry);
+
+  const size_t capacity_bytes_;
+  size_t used_bytes_{0};
+  PageCompressor *compressor_;
+  DiskManager *disk_manager_;
+  /** Front is the most recently inserted page. */
+  std::list<Entry> lru_list_;
+  std::unordered_map<page_id_t, std::list<Entry>::iterator> index_;
+  /** Protects lru_list_, index_ and used_bytes_. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
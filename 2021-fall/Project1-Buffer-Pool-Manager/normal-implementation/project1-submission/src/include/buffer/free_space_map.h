@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/buffer/free_space_map.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks which page ids of one BufferPoolManagerInstance are in use, so that deleted pages are reused
+ * instead of growing the file.
+ *
+ * An instance owns the page ids instance_index + k * num_instances; k is the local index of the page. Local indices
+ * are split into groups of FreeSpaceMapPage::NUM_BITS + 1 pages. The second page of each group is the map page of
+ * the group and the other ones are the pages it tracks. Keeping page 0 out of the map leaves HEADER_PAGE_ID to the
+ * header page. Map pages are ordinary pages of the instance, fetched through its buffer pool and written back like
+ * any other page; the map is therefore persistent without any extra file.
+ *
+ * Allocation takes the lowest free page, starting from the first group that may have one, so the file stays dense.
+ * The map pages are latched while they are searched and updated. Callers must not hold the buffer pool latch.
+ */
+class FreeSpaceMap {
+ public:
+  /**
+   * Creates a new FreeSpaceMap.
+   * @param bpm the buffer pool the map pages are fetched through, not owned
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of the BPI whose pages are tracked
+   */
+  FreeSpaceMap(BufferPoolManager *bpm, uint32_t num_instances, uint32_t instance_index);
+
+  /**
+   * Allocate a page.
+   * @return the page id, or INVALID_PAGE_ID if a map page could not be brought into the buffer pool
+   */
+  auto AllocatePage() -> page_id_t;
+
+  /**
+   * Allocate count pages with consecutive local indices. With a single instance they are contiguous in the file;
+   * otherwise they are the closest the instance's pages can be.
+   * @param count number of pages, at most FreeSpaceMapPage::NUM_BITS - 1
+   * @param[out] page_ids receives the page ids in file order
+   * @return false if a map page could not be brought into the buffer pool
+   */
+  auto AllocateExtent(size_t count, std::vector<page_id_t> *page_ids) -> bool;
+
+  /**
+   * Give a page back. Map pages and pages that are not allocated are ignored.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return whether page_id is one of the map pages */
+  auto IsMapPage(page_id_t page_id) const -> bool;
+
+ private:
+  /** Pages per group: the tracked pages and the map page. */
+  static constexpr uint32_t GROUP_SPAN = FreeSpaceMapPage::NUM_BITS + 1;
+
+  /** @return the id of the map page of a group */
+  auto GetMapPageId(uint32_t group) const -> page_id_t;
+
+  /** @return the id of the page tracked by a bit of a group */
+  auto ToPageId(uint32_t group, uint32_t bit) const -> page_id_t;
+
+  /** Look for a free run in one group and allocate it. */
+  auto AllocateInGroup(uint32_t group, uint32_t start, uint32_t count, uint32_t *bit) -> bool;
+
+  /** Lower the first group that may have free pages. */
+  void LowerFirstGroup(uint32_t group);
+
+  BufferPoolManager *bpm_;
+  const uint32_t num_instances_;
+  const uint32_t instance_index_;
+  /** Every group before this one is full. Only a hint: it never skips a group with free pages. */
+  std::atomic<uint32_t> first_group_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_executor.h
+//
+// Identification: src/include/buffer/io_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace bustub {
+
+/**
+ * IoExecutor runs the page reads of asynchronous fetches on a small pool of threads, by default one per core. Every
+ * thread has its own queue and a task goes to the queue picked by its key, so tasks with the same key run in order
+ * and threads do not contend on a shared queue.
+ */
+class IoExecutor {
+ public:
+  /**
+   * Creates a new IoExecutor.
+   * @param num_threads number of threads, 0 for one per hardware thread
+   */
+  explicit IoExecutor(size_t num_threads = 0);
+
+  /**
+   * Runs the tasks that are still queued, then stops the threads.
+   */
+  ~IoExecutor();
+
+  /**
+   * Queue a task.
+   * @param key picks the thread, e.g. the page id
+   * @param task the task
+   */
+  void Submit(size_t key, std::function<void()> task);
+
+  /** @return the number of threads */
+  auto GetNumThreads() -> size_t { return workers_.size(); }
+
+ private:
+  struct Worker {
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stop_{false};
+    std::thread thread_;
+  };
+
+  /** Body of a worker thread. */
+  static void Run(Worker *worker);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+}  // namespace bustub
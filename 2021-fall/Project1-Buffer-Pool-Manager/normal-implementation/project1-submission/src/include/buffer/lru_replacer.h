@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <deque>
 #include <list>
 #include <mutex>  // NOLINT
 #include <vector>
@@ -44,6 +45,8 @@ class LRUReplacer : public Replacer {
 
   auto Size() -> size_t override;
 
+  void SetCapacity(size_t num_pages) override;
+
  private:
   // TODO(student): implement me!
 
@@ -100,12 +103,18 @@ class LRUReplacer : public Replacer {
 
     inline auto Size() -> size_t { return this->node_buffer_.Size(); }
 
+    inline void Grow(size_t n) { this->node_buffer_.Grow(n); }
+
    private:
     class NodeBuffer {
      public:
-      inline explicit NodeBuffer(size_t n) : node_buf_size_(0), node_buf_(n), node_ptrs_(n) {
-        for (size_t i = 0; i < n; ++i) {
-          node_ptrs_[i] = &node_buf_[i];
+      inline explicit NodeBuffer(size_t n) : node_buf_size_(0) { this->Grow(n); }
+
+      /** Make room for n nodes. Nodes live in a deque so that the ones in use never move. */
+      inline void Grow(size_t n) {
+        while (this->node_buf_.size() < n) {
+          this->node_buf_.emplace_back();
+          this->node_ptrs_.push_back(&this->node_buf_.back());
         }
       }
 
@@ -117,7 +126,7 @@ class LRUReplacer : public Replacer {
 
      private:
       size_t node_buf_size_;
-      std::vector<Node> node_buf_;
+      std::deque<Node> node_buf_;
       std::vector<Node *> node_ptrs_;
     };
 
@@ -138,6 +147,12 @@ class LRUReplacer : public Replacer {
 
     inline void Set(frame_id_t frame_id, Node *p) { this->v_[frame_id] = p; }
 
+    inline void Grow(size_t n) {
+      if (this->v_.size() < n) {
+        this->v_.resize(n, nullptr);
+      }
+    }
+
    private:
     std::vector<Node *> v_;
   };
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.h
+//
+// Identification: src/include/buffer/page_compressor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * PageCompressor is the codec interface used by the compressed page cache.
+ * Implementations must be stateless (or internally synchronized): one compressor is shared by every instance.
+ */
+class PageCompressor {
+ public:
+  PageCompressor() = default;
+  virtual ~PageCompressor() = default;
+
+  /**
+   * Compress a block of bytes.
+   * @param src the bytes to compress
+   * @param src_size number of bytes in src
+   * @param[out] dst buffer for the compressed bytes
+   * @param dst_capacity size of dst
+   * @return size of the compressed block, or 0 if it does not fit into dst_capacity
+   */
+  virtual auto Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t = 0;
+
+  /**
+   * Decompress a block produced by Compress.
+   * @param src the compressed bytes
+   * @param src_size number of bytes in src
+   * @param[out] dst buffer for the original bytes
+   * @param dst_size expected size of the original block
+   * @return false if the block is corrupted or does not decompress to exactly dst_size bytes
+   */
+  virtual auto Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool = 0;
+
+  /** @return a short name of the codec, used in stats output */
+  virtual auto GetName() const -> const char * = 0;
+};
+
+/**
+ * LZPageCompressor is a byte-oriented LZ77 codec using the LZ4 block layout
+ * (token, literals, 16-bit offset, extended lengths). It trades ratio for speed like LZ4 does.
+ */
+class LZPageCompressor : public PageCompressor {
+ public:
+  auto Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t override;
+
+  auto Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool override;
+
+  auto GetName() const -> const char * override { return "lz"; }
+
+ private:
+  static constexpr size_t MIN_MATCH = 4;
+  static constexpr size_t LAST_LITERALS = 5;
+  static constexpr size_t MAX_OFFSET = 65535;
+  static constexpr int HASH_LOG = 12;
+};
+
+}  // namespace bustub
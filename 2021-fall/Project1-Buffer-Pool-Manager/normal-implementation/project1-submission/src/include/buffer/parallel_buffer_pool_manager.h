@@ -12,9 +12,14 @@
 
 #pragma once
 
+#include <functional>
+#include <future>  // NOLINT
+#include <utility>
 #include <vector>
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/compressed_page_cache.h"
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/io_executor.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -29,9 +34,10 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    * @param pool_size the pool size of each BufferPoolManagerInstance
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every BufferPoolManagerInstance
    */
   ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU);
 
   /**
    * Destroys an existing ParallelBufferPoolManager.
@@ -41,12 +47,118 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   /** @return size of the buffer pool */
   auto GetPoolSize() -> size_t override;
 
+  /**
+   * Resize every BufferPoolManagerInstance, see BufferPoolManagerInstance::Resize. The number of instances is fixed:
+   * page ids are routed by page_id % num_instances, so an instance cannot go away while its pages exist.
+   * @param pool_size the new pool size of each BufferPoolManagerInstance
+   */
+  void Resize(size_t pool_size);
+
+  /** Wait until every instance has finished its last shrink. */
+  void WaitForResize();
+
+  /** @return the number of BufferPoolManagerInstances */
+  auto GetNumInstances() -> size_t { return buffer_pool_managers_.size(); }
+
+  /**
+   * @param instance_index index of the instance
+   * @return the BufferPoolManagerInstance owning the page ids equal to instance_index modulo the number of instances
+   */
+  auto GetInstance(size_t instance_index) -> BufferPoolManagerInstance * {
+    return buffer_pool_managers_[instance_index];
+  }
+
+  /**
+   * Give every BufferPoolManagerInstance its own compressed second-level cache. Must be called before the pool is used.
+   * @param capacity_bytes total budget for compressed pages, split evenly between the instances
+   * @param compressor codec shared by all the caches, not owned
+   */
+  void EnableCompressedPageCache(size_t capacity_bytes, PageCompressor *compressor);
+
+  /**
+   * Give every BufferPoolManagerInstance a free-space map over its own page ids, see
+   * BufferPoolManagerInstance::EnableFreeSpaceMap. A reused id still routes to the instance that handed it out.
+   */
+  void EnableFreeSpaceMap();
+
+  /**
+   * Sum up the per-tier counters of all the BufferPoolManagerInstances.
+   * @param[out] stats zero-initialized stats to add into
+   */
+  void CollectStats(BufferPoolStats *stats);
+
+  /**
+   * Fetch a page and take its read latch.
+   * @param page_id id of page to be fetched
+   * @return a guard releasing the latch and the pin on destruction; empty if no frame was available
+   */
+  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
+
+  /**
+   * Fetch a page and take its write latch.
+   * @param page_id id of page to be fetched
+   * @return a guard releasing the latch and the pin on destruction; empty if no frame was available
+   */
+  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+
+  /**
+   * Create a new page, allocated round robin like NewPage, and take its write latch.
+   * @param[out] page_id id of created page
+   * @return a guard releasing the latch and the pin on destruction; empty if no frame was available
+   */
+  auto NewPageGuarded(page_id_t *page_id) -> WritePageGuard;
+
+  /**
+   * Read a page without pinning it, see BufferPoolManagerInstance::ReadPageOptimistic.
+   * @param handle id of the page to read and the frame it was last seen in, updated on return
+   * @param read_fn callable taking a const char * to the page data; it may run several times on torn data
+   * @return false if the page is not resident and could not be brought in
+   */
+  template <class ReadFn>
+  auto ReadPageOptimistic(OptimisticPageHandle *handle, ReadFn &&read_fn) -> bool {
+    return this->GetBufferPoolManager(handle->page_id_)->ReadPageOptimistic(handle, std::forward<ReadFn>(read_fn));
+  }
+
+  /**
+   * Start the executor that runs the reads of FetchPageAsync. Must be called before FetchPageAsync is used.
+   * @param num_threads number of I/O threads, 0 for one per hardware thread
+   */
+  void EnableAsyncFetch(size_t num_threads = 0);
+
+  /** @return whether EnableAsyncFetch has been called */
+  auto IsAsyncFetchEnabled() const -> bool { return io_executor_ != nullptr; }
+
+  /**
+   * Fetch a page without blocking the calling thread on a miss, see BufferPoolManagerInstance::FetchPageAsync.
+   * @param page_id id of page to be fetched
+   * @param callback called once with the pinned page, or nullptr if no frame was available
+   */
+  void FetchPageAsync(page_id_t page_id, std::function<void(Page *)> callback);
+
+  /**
+   * Fetch a page without blocking the calling thread on a miss.
+   * @param page_id id of page to be fetched
+   * @return a future for the pinned page, or nullptr if no frame was available
+   */
+  auto FetchPageAsync(page_id_t page_id) -> std::future<Page *>;
+
+  /**
+   * Fetch a batch of pages. The ids are grouped by instance and every instance takes its latch once, to pin the hits
+   * of its group and reserve frames for the misses. The misses of all the groups are then read without any latch:
+   * concurrently on the async-fetch executor if EnableAsyncFetch was called, one after the other on the calling
+   * thread otherwise. Returns once the whole set is resident and pinned.
+   * @param page_ids ids of the pages to fetch; duplicates are allowed and pinned once per occurrence
+   * @param[out] pages receives the pages in the order of page_ids
+   * @return false if some instance did not have enough frames for its group; nothing stays pinned in that case
+   */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, std::vector<Page *> *pages) -> bool;
+
  protected:
   /**
    * @param page_id id of page
-   * @return pointer to the BufferPoolManager responsible for handling given page id
+   * @return pointer to the BufferPoolManagerInstance responsible for handling given page id
    */
-  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager *;
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
 
   /**
    * Fetch the requested page from the buffer pool.
@@ -90,8 +202,12 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   void FlushAllPgsImp() override;
 
  private:
-  std::vector<BufferPoolManager *> buffer_pool_managers_;
+  std::vector<BufferPoolManagerInstance *> buffer_pool_managers_;
   size_t buffer_pool_manager_index_;
+  DiskManager *disk_manager_;
+  std::vector<CompressedPageCache *> compressed_caches_;
+  /** Runs the reads of FetchPageAsync; nullptr until EnableAsyncFetch. */
+  IoExecutor *io_executor_{nullptr};
   std::mutex latch_;
 };
 }  // namespace bustub
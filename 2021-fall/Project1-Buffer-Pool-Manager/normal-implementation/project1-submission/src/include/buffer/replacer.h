@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.h
+//
+// Identification: src/include/buffer/replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** The replacement policies a BufferPoolManagerInstance can be built with. */
+enum class ReplacerType { LRU, ARC, TINY_LFU, BUFFERED_LRU };
+
+/**
+ * Replacer is an abstract class that tracks page usage.
+ */
+class Replacer {
+ public:
+  Replacer() = default;
+  virtual ~Replacer() = default;
+
+  /**
+   * Remove the victim frame as defined by the replacement policy.
+   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
+   * @return true if a victim frame was found, false otherwise
+   */
+  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * Pins a frame, indicating that it should not be victimized until it is unpinned.
+   * @param frame_id the id of the frame to pin
+   */
+  virtual void Pin(frame_id_t frame_id) = 0;
+
+  /**
+   * Unpins a frame, indicating that it can now be victimized.
+   * @param frame_id the id of the frame to unpin
+   */
+  virtual void Unpin(frame_id_t frame_id) = 0;
+
+  /** @return the number of elements in the replacer that can be victimized */
+  virtual auto Size() -> size_t = 0;
+
+  /**
+   * Records an access to a page through a frame. It is called on every fetch and new page, before the pin is taken.
+   * Policies that keep history across evictions need to know which page a frame holds; the others ignore it.
+   * @param frame_id the id of the frame holding the page
+   * @param page_id the id of the accessed page
+   */
+  virtual void RecordAccess(__attribute__((unused)) frame_id_t frame_id, __attribute__((unused)) page_id_t page_id) {}
+
+  /**
+   * Forget a frame that no longer holds a page, because its page was deleted or the frame was retired by a shrink.
+   * The frame is not evictable until it is used for a page again. Policies that keep frames they cannot evict, or
+   * count them, drop them here; the default just pins the frame.
+   * @param frame_id the id of the frame
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Tells the replacer that the buffer pool was resized. Frame ids below num_pages become valid. When the pool
+   * shrinks, the frames at or above num_pages have been pinned out of the replacer already; their storage is kept, so
+   * a late Pin or Unpin of such a frame is still harmless.
+   * @param num_pages the new number of frames
+   */
+  virtual void SetCapacity(size_t num_pages) = 0;
+};
+
+}  // namespace bustub
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tinylfu_replacer.h
+//
+// Identification: src/include/buffer/tinylfu_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/lru_replacer.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FrequencySketch is a count-min sketch of 4-bit counters estimating how often each page was accessed recently.
+ * Once the number of recorded accesses reaches the sample size, every counter is halved so that old popularity fades.
+ * Each of the four rows has four counters per frame, so the sketch costs 8 bytes per frame.
+ */
+class FrequencySketch {
+ public:
+  /**
+   * Create a new FrequencySketch.
+   * @param num_pages the number of frames of the pool the sketch is sized for
+   */
+  explicit FrequencySketch(size_t num_pages);
+
+  /** Record one access to page_id. */
+  void Increment(page_id_t page_id);
+
+  /** @return the estimated number of recent accesses to page_id, at most 15 */
+  auto Estimate(page_id_t page_id) const -> uint32_t;
+
+ private:
+  static constexpr int DEPTH = 4;
+  static constexpr int COUNTERS_PER_WORD = 16;
+
+  /** @return index of the counter of page_id in the given row */
+  auto IndexOf(page_id_t page_id, int row) const -> size_t;
+
+  /** Halve every counter. */
+  void Reset();
+
+  /** Counters per row, a power of two. */
+  size_t width_;
+  size_t sample_size_;
+  size_t additions_{0};
+  /** DEPTH rows of width_ 4-bit counters, packed 16 to a word. */
+  std::vector<uint64_t> table_;
+};
+
+/**
+ * TinyLFUReplacer is a W-TinyLFU admission layer in front of another replacer.
+ *
+ * Newly loaded pages go to a small LRU window (1% of the frames). When the window is full, its least recently used
+ * page competes with the victim of the main replacer: the one the FrequencySketch estimates as less popular is
+ * evicted, the other one stays (a window page that wins is admitted to the main region). One-hit wonders therefore
+ * pass through the window without displacing the hot set.
+ */
+class TinyLFUReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TinyLFUReplacer.
+   * @param num_pages the maximum number of pages the TinyLFUReplacer will be required to store
+   * @param main the replacer managing the main region, owned by the TinyLFUReplacer
+   */
+  TinyLFUReplacer(size_t num_pages, Replacer *main);
+
+  /**
+   * Destroys the TinyLFUReplacer and its main replacer.
+   */
+  ~TinyLFUReplacer() override;
+
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  /** The sketch keeps the width it was created with, a resize does not lose the frequencies gathered so far. */
+  void SetCapacity(size_t num_pages) override;
+
+ private:
+  enum class Region : uint8_t { NONE, WINDOW, MAIN };
+
+  /**
+   * Look at the next victim of the main region without giving it up. The frame is taken out of main_ and kept in
+   * main_candidate_ until it is evicted or pinned.
+   */
+  auto PeekMainVictim(frame_id_t *frame_id) -> bool;
+
+  /** Move an unpinned frame taken out of the window to the main region. */
+  void Admit(frame_id_t frame_id);
+
+  /** Give a frame up as victim. */
+  void Evict(frame_id_t frame_id, frame_id_t *victim);
+
+  /** Take a frame that no longer holds a page out of its region. */
+  void Drop(frame_id_t frame_id);
+
+  size_t window_capacity_;
+  size_t window_size_{0};
+  /** Frames of the window region that are not pinned, in LRU order. */
+  LRUReplacer window_;
+  Replacer *main_;
+  /** Victim taken out of main_ by PeekMainVictim and not evicted yet, -1 if none. */
+  frame_id_t main_candidate_{-1};
+  FrequencySketch sketch_;
+  std::vector<Region> regions_;
+  std::vector<page_id_t> page_ids_;
+
+  std::mutex mutex_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/hash/hash_function.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+
+namespace bustub {
+
+#define HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool manager. Non-unique keys are supported.
+ * Supports insert and delete. The table grows dynamically as buckets become full.
+ *
+ * The directory is read optimistically, without latching or pinning its page, so lookups never wait on a split.
+ * A bucket is latched after its page id has been read from the directory, and the directory is read once more to
+ * check that the hash still maps to it: a bucket only splits under its own write latch, so once the check passes
+ * the mapping holds for as long as the latch is kept.
+ *
+ * A split write-latches only the full bucket and its new split image while it moves the pairs, then takes the
+ * directory write latch just to repoint the entries of the split image. Latches are always taken bucket first,
+ * directory second, and nothing waits on a bucket while holding the directory.
+ *
+ * Buckets are not merged and the directory does not shrink: an emptied bucket keeps its page. In exchange a bucket
+ * page id read from the directory always names a bucket, even if the read was stale.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable {
+  using BucketPage = HashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /**
+   * Creates a new ExtendibleHashTable, or opens an existing one.
+   *
+   * @param name the name of the table
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   * @param directory_page_id directory of an existing table, INVALID_PAGE_ID to create a new one
+   */
+  explicit ExtendibleHashTable(std::string name, BufferPoolManagerInstance *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                               page_id_t directory_page_id = INVALID_PAGE_ID);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   *
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair is already present or the directory is full
+   */
+  auto Insert(const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Deletes the associated value for the given key.
+   *
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  auto Remove(const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Performs a point query on the hash table.
+   *
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /**
+   * Returns the global depth.
+   */
+  auto GetGlobalDepth() -> uint32_t;
+
+  /**
+   * Helper function to verify the integrity of the extendible hash table's directory.
+   */
+  void VerifyIntegrity();
+
+  /** @return the page to pass to the constructor to open this table again */
+  auto GetDirectoryPageId() const -> page_id_t { return directory_page_id_; }
+
+ private:
+  /** Directory handles are striped by thread, like the optimistic reader counts of the buffer pool. */
+  static constexpr size_t DIRECTORY_HANDLE_STRIPES = 16;
+
+  /**
+   * A handle remembers the frame of the directory, so that optimistic reads do not look the page up under the
+   * buffer pool latch. A thread that finds its stripe in use reads with a fresh handle instead.
+   */
+  struct alignas(64) DirectoryHandle {
+    std::atomic_flag in_use_ = ATOMIC_FLAG_INIT;
+    OptimisticPageHandle handle_{INVALID_PAGE_ID};
+  };
+
+  /**
+   * Hash - simple helper to downcast MurmurHash's 64-bit hash to 32-bit
+   * for extendible hashing.
+   *
+   * @param key the key to hash
+   * @return the downcasted 32-bit hash
+   */
+  inline auto Hash(const KeyType &key) -> uint32_t;
+
+  /**
+   * Read the directory optimistically.
+   * @param hash hash of the key
+   * @param[out] local_depth receives the local depth of the bucket, if not nullptr
+   * @return the page id of the bucket the hash maps to
+   */
+  auto KeyToPageId(uint32_t hash, uint32_t *local_depth = nullptr) -> page_id_t;
+
+  /**
+   * Fetch the bucket a hash maps to with guard_fn and check that it still does once latched.
+   * @return the latched bucket
+   */
+  template <class Guard, class GuardFn>
+  auto FetchBucket(uint32_t hash, GuardFn &&guard_fn) -> Guard;
+
+  /**
+   * Split a full bucket and point the directory entries of its split image to the new page.
+   * @param bucket_guard the full bucket, write latched
+   * @param hash a hash that maps to the bucket
+   * @return false if the directory cannot grow any more
+   */
+  auto SplitBucket(WritePageGuard *bucket_guard, uint32_t hash) -> bool;
+
+  auto FetchRead(page_id_t page_id) -> ReadPageGuard;
+  auto FetchWrite(page_id_t page_id) -> WritePageGuard;
+
+  // member variables
+  std::string name_;
+  page_id_t directory_page_id_;
+  BufferPoolManagerInstance *buffer_pool_manager_;
+  KeyComparator comparator_;
+  HashFunction<KeyType> hash_fn_;
+  DirectoryHandle directory_handles_[DIRECTORY_HANDLE_STRIPES];
+};
+
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_function.h
+//
+// Identification: src/include/container/hash/hash_function.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace bustub {
+
+/**
+ * HashFunction hashes the bytes of a fixed-size key. Every 8-byte word is folded in with the 64-bit finalizer of
+ * MurmurHash3, so that the low bits the extendible hash directory is indexed by depend on the whole key.
+ */
+template <typename KeyType>
+class HashFunction {
+  static_assert(std::is_trivially_copyable<KeyType>::value, "Keys are hashed by their bytes.");
+
+ public:
+  /**
+   * @param key the key to be hashed
+   * @return the hashed value
+   */
+  virtual auto GetHash(KeyType key) -> uint64_t {
+    const auto *bytes = reinterpret_cast<const char *>(&key);
+    uint64_t hash = sizeof(KeyType);
+    for (size_t offset = 0; offset < sizeof(KeyType); offset += sizeof(uint64_t)) {
+      uint64_t word = 0;
+      memcpy(&word, bytes + offset, std::min(sizeof(uint64_t), sizeof(KeyType) - offset));
+      hash = Fmix64(hash ^ (word * 0x9e3779b97f4a7c15ULL));
+    }
+    return hash;
+  }
+
+  virtual ~HashFunction() = default;
+
+ private:
+  static auto Fmix64(uint64_t k) -> uint64_t {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// columnar_scan_operator.h
+//
+// Identification: src/include/execution/vector/columnar_scan_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "execution/vector/vector_operator.h"
+#include "execution/vector/vector_predicate.h"
+#include "storage/page/page_guard.h"
+#include "storage/table/columnar_table.h"
+
+namespace bustub {
+
+/**
+ * ColumnPredicate compares a column of a columnar table with a constant.
+ */
+struct ColumnPredicate {
+  uint32_t column_;
+  ComparisonType type_;
+  /** Constant of an INTEGER column */
+  int64_t integer_{0};
+  /** Constant of a TEXT column */
+  std::string text_;
+};
+
+/**
+ * ColumnarScanOperator reads some columns of a ColumnarTable, keeping the rows every predicate holds for.
+ *
+ * The scan moves over the table VECTOR_SIZE rows at a time. The predicates are evaluated on the compressed segments of
+ * their columns, one after the other, and the scan stops at the first one that leaves no row. Only then are the
+ * selected rows gathered from the output columns. The pages of a column that is neither compared nor output are never
+ * fetched, and neither are the segments of an output column that hold no selected row.
+ *
+ * A predicate on an INTEGER column is first checked against the zone map of the column, read when the scan starts: a
+ * segment whose range rules the predicate out matches no row and is not fetched.
+ */
+class ColumnarScanOperator : public VectorOperator {
+ public:
+  /**
+   * @param buffer_pool_manager pool of the table
+   * @param table table to scan
+   * @param column_ids columns to output
+   * @param predicates comparisons of INTEGER or TEXT columns that all have to hold
+   */
+  ColumnarScanOperator(BufferPoolManagerInstance *buffer_pool_manager, const ColumnarTable *table,
+                       std::vector<uint32_t> column_ids, std::vector<ColumnPredicate> predicates);
+
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+  /** @return the segment pages fetched since Init() */
+  auto GetPagesFetched() const -> uint64_t { return pages_fetched_; }
+
+ private:
+  /** The segment of a column the scan is on, pinned while the scan stays on it. */
+  struct SegmentCursor {
+    size_t segment_{0};
+    ReadPageGuard guard_;
+  };
+
+  /** Move the cursor of a column to the segment that holds a row. @return the index of the segment */
+  auto Seek(uint32_t column, uint64_t row) -> size_t;
+
+  /** @return the page of the segment the cursor of a column is on, fetched if it is not yet */
+  auto Fetch(uint32_t column) -> const ColumnSegmentPage *;
+
+  /** Evaluate a predicate on count rows from begin. */
+  void Match(size_t predicate, uint64_t begin, uint32_t count, uint8_t *match);
+
+  /** Append the rows begin + sel[i] of a column to out. */
+  void Gather(uint32_t column, uint64_t begin, const uint32_t *sel, size_t count, ColumnVector *out);
+
+  BufferPoolManagerInstance *buffer_pool_manager_;
+  const ColumnarTable *table_;
+  std::vector<uint32_t> column_ids_;
+  std::vector<ColumnPredicate> predicates_;
+  /** Per predicate, whether each segment of its column may match; empty without a zone map */
+  std::vector<std::vector<uint8_t>> segment_may_match_;
+
+  /** One per column of the table */
+  std::vector<SegmentCursor> cursors_;
+  uint64_t next_row_{0};
+  uint64_t pages_fetched_{0};
+  std::vector<uint8_t> match_;
+  std::vector<uint8_t> scratch_;
+  std::vector<uint32_t> sel_;
+  std::vector<uint32_t> rows_;
+};
+
+}  // namespace bustub
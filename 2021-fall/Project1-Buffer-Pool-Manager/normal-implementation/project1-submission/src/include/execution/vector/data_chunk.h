@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// data_chunk.h
+//
+// Identification: src/include/execution/vector/data_chunk.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/** How many rows an operator hands to the next one at a time. */
+static constexpr size_t VECTOR_SIZE = 1024;
+
+/** Type of a column of a data chunk. */
+enum class ColumnType : uint8_t { INTEGER, REAL, TEXT };
+
+/**
+ * StringHeap owns the bytes of the TEXT values of a column, so that they outlive the page they were read from.
+ * Strings are copied into blocks that never move; the views into them stay valid until Clear().
+ */
+class StringHeap {
+ public:
+  StringHeap() = default;
+  DISALLOW_COPY(StringHeap);
+  StringHeap(StringHeap &&other) = default;
+  auto operator=(StringHeap &&other) -> StringHeap & = default;
+
+  /** @return a copy of str owned by the heap */
+  auto Add(std::string_view str) -> std::string_view;
+
+  /** Drop every string, keeping the first block for the next ones. */
+  void Clear();
+
+ private:
+  static constexpr size_t BLOCK_SIZE = 16384;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  std::vector<std::unique_ptr<char[]>> large_blocks_;
+  /** Bytes used in the last block */
+  size_t used_{BLOCK_SIZE};
+};
+
+/**
+ * ColumnVector holds the values of one column of a data chunk, in a plain array of its type so that operators work on
+ * a whole column in one loop. NULLs are flagged separately and hold 0 or an empty string.
+ */
+class ColumnVector {
+ public:
+  explicit ColumnVector(ColumnType type) : type_(type) {}
+  DISALLOW_COPY(ColumnVector);
+  ColumnVector(ColumnVector &&other) = default;
+  auto operator=(ColumnVector &&other) -> ColumnVector & = default;
+
+  auto GetType() const -> ColumnType { return type_; }
+  auto Size() const -> size_t { return nulls_.size(); }
+  void Clear();
+
+  void AppendNull();
+  void AppendInteger(int64_t value) {
+    BUSTUB_ASSERT(type_ == ColumnType::INTEGER, "Not an INTEGER column.");
+    nulls_.push_back(0);
+    integers_.push_back(value);
+  }
+  void AppendReal(double value) {
+    BUSTUB_ASSERT(type_ == ColumnType::REAL, "Not a REAL column.");
+    nulls_.push_back(0);
+    reals_.push_back(value);
+  }
+  /** The bytes are copied into the column. */
+  void AppendText(std::string_view value) {
+    BUSTUB_ASSERT(type_ == ColumnType::TEXT, "Not a TEXT column.");
+    nulls_.push_back(0);
+    texts_.push_back(heap_.Add(value));
+  }
+
+  /**
+   * Append the values of other at the given rows.
+   * @param other column of the same type
+   * @param sel rows of other
+   * @param count number of rows
+   */
+  void Gather(const ColumnVector &other, const uint32_t *sel, size_t count);
+
+  /** Append every value of other. */
+  void Append(const ColumnVector &other);
+
+  auto IsNull(size_t row) const -> bool { return nulls_[row] != 0; }
+  auto GetInteger(size_t row) const -> int64_t { return integers_[row]; }
+  auto GetReal(size_t row) const -> double { return reals_[row]; }
+  auto GetText(size_t row) const -> std::string_view { return texts_[row]; }
+
+  auto Nulls() const -> const uint8_t * { return nulls_.data(); }
+  auto Integers() const -> const int64_t * { return integers_.data(); }
+  auto Reals() const -> const double * { return reals_.data(); }
+  auto Texts() const -> const std::string_view * { return texts_.data(); }
+
+ private:
+  ColumnType type_;
+  std::vector<uint8_t> nulls_;
+  std::vector<int64_t> integers_;
+  std::vector<double> reals_;
+  std::vector<std::string_view> texts_;
+  StringHeap heap_;
+};
+
+/**
+ * DataChunk is a batch of rows stored column by column. Operators pass chunks of at most VECTOR_SIZE rows; the ones
+ * that materialize their input, such as the build side of a hash join, keep it in one unbounded chunk.
+ */
+class DataChunk {
+ public:
+  DataChunk() = default;
+  explicit DataChunk(const std::vector<ColumnType> &types) { Initialize(types); }
+
+  /** Replace the columns by empty ones of the given types; columns of the same types are only emptied. */
+  void Initialize(const std::vector<ColumnType> &types);
+
+  /** Remove every row, keeping the columns. */
+  void Reset();
+
+  auto ColumnCount() const -> size_t { return columns_.size(); }
+  auto Size() const -> size_t { return columns_.empty() ? 0 : columns_[0].Size(); }
+  auto GetColumn(size_t column) -> ColumnVector & { return columns_[column]; }
+  auto GetColumn(size_t column) const -> const ColumnVector & { return columns_[column]; }
+
+  /** Append every row of other, whose columns must have the same types. */
+  void Append(const DataChunk &other);
+
+ private:
+  std::vector<ColumnVector> columns_;
+};
+
+}  // namespace bustub
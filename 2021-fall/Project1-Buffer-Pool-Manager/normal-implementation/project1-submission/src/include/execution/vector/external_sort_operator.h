@@ -0,0 +1,205 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sort_operator.h
+//
+// Identification: src/include/execution/vector/external_sort_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/io_executor.h"
+#include "execution/vector/sort_operator.h"
+#include "storage/page/page_guard.h"
+#include "storage/table/heap_row.h"
+
+namespace bustub {
+
+/**
+ * ExternalSortOperator orders the rows of its child in a bounded amount of memory, spilling to the buffer pool the
+ * rows that do not fit: a multi-way external merge sort.
+ *
+ * Run generation buffers rows until they would fill memory_pages heap pages, sorts them and writes them out as a
+ * run, a chain of HeapPages holding the rows in order. The sort compares a 64-bit prefix of the first key, normalized
+ * so that unsigned order is key order, and only looks at the columns when the prefixes are equal.
+ *
+ * The runs are then merged through a loser tree: after a run hands out its row, only the matches on the path from its
+ * leaf to the root are replayed, one comparison per level. A merge takes GetFanIn() runs; while more are left, the
+ * merges write their output as new runs, and the last merge feeds Next().
+ *
+ * Every run is read and written through the buffer pool, and a merge pins at most memory_pages frames: two per input
+ * run and two for the output. With an IoExecutor the run I/O is double buffered: a reader asks for the next page of
+ * its run as soon as it starts on the current one, and a writer has the page it just filled written back while it
+ * fills the next one. A run page is deleted as soon as it has been read.
+ *
+ * If the input fits in memory nothing is written. As in SortOperator, NULLs come first in ascending order and rows
+ * with equal keys keep their input order.
+ */
+class ExternalSortOperator : public VectorOperator {
+ public:
+  static constexpr size_t DEFAULT_MEMORY_PAGES = 256;
+  /** A merge of two runs with a double-buffered output */
+  static constexpr size_t MIN_MEMORY_PAGES = 6;
+
+  /**
+   * @param buffer_pool_manager pool the runs are written to
+   * @param child input
+   * @param keys sort keys, the most significant first
+   * @param memory_pages pages of rows sorted in memory, and frames a merge may pin; at least MIN_MEMORY_PAGES
+   * @param io_executor runs the run I/O in the background, not owned; nullptr to do it on the calling thread
+   */
+  ExternalSortOperator(BufferPoolManagerInstance *buffer_pool_manager, std::unique_ptr<VectorOperator> child,
+                       std::vector<SortKey> keys, size_t memory_pages = DEFAULT_MEMORY_PAGES,
+                       IoExecutor *io_executor = nullptr);
+
+  ~ExternalSortOperator() override;
+
+  DISALLOW_COPY_AND_MOVE(ExternalSortOperator);
+
+  /**
+   * Read and sort the whole input; the merges of all but the last pass happen here too.
+   * @throws Exception if the pool has no frame for a run page, or a row takes more than a page
+   */
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+  /** @return how many runs are merged at once */
+  auto GetFanIn() const -> size_t { return (memory_pages_ - 2) / 2; }
+
+  /** @return runs written by the last Init(), the initial ones and those of the intermediate merges */
+  auto GetRunsWritten() const -> size_t { return runs_written_; }
+
+  /** @return run pages written by the last Init() */
+  auto GetPagesWritten() const -> size_t { return pages_written_; }
+
+  /** @return merge passes over the data, the last one included; 0 if the input was sorted in memory */
+  auto GetMergePasses() const -> size_t { return merge_passes_; }
+
+ private:
+  /** A sorted run: a chain of heap pages, in order. */
+  struct Run {
+    std::vector<page_id_t> page_ids_;
+  };
+
+  /** RunWriter appends rows to a new run. */
+  class RunWriter {
+   public:
+    explicit RunWriter(ExternalSortOperator *sort) : sort_(sort) {}
+    DISALLOW_COPY_AND_MOVE(RunWriter);
+
+    /** Waits for the last write, and deletes the pages of a run that was not finished. */
+    ~RunWriter();
+
+    /** Append row i of a chunk. */
+    void Append(const DataChunk &chunk, size_t row);
+
+    /** @return the run, once all of its pages are written back */
+    auto Finish() -> Run;
+
+   private:
+    /** Start a new page, linked from the current one, and write the current one back. */
+    void NextPage();
+
+    /** Write back a page that is not pinned any more, after the previous write is done. */
+    void WriteBack(page_id_t page_id);
+
+    ExternalSortOperator *sort_;
+    Run run_;
+    WritePageGuard page_;
+    HeapRowBuilder row_;
+    std::future<void> pending_write_;
+  };
+
+  /** RunReader walks the rows of a run, a page at a time. */
+  class RunReader {
+   public:
+    /** Reads the first page. */
+    RunReader(ExternalSortOperator *sort, Run run);
+    DISALLOW_COPY_AND_MOVE(RunReader);
+
+    /** Waits for the read-ahead, and deletes the pages that were not read. */
+    ~RunReader();
+
+    auto IsDone() const -> bool { return row_ == rows_.Size(); }
+    auto GetRows() const -> const DataChunk & { return rows_; }
+    auto GetRow() const -> size_t { return row_; }
+
+    /** Move to the next row, reading the next page once this one is done. */
+    void Advance() {
+      if (++row_ == rows_.Size()) {
+        ReadPage();
+      }
+    }
+
+   private:
+    /** Decode the next page into rows_ and delete it; leaves rows_ empty at the end of the run. */
+    void ReadPage();
+
+    ExternalSortOperator *sort_;
+    Run run_;
+    size_t next_page_{0};
+    DataChunk rows_;
+    size_t row_{0};
+    std::future<void> read_ahead_;
+  };
+
+  /** Sort buffer_ in order_. */
+  void SortBuffer();
+
+  /** Sort buffer_ and write it out as a run. */
+  void SpillBuffer();
+
+  /**
+   * Set up a merge of some runs in readers_ and tree_.
+   * @param runs the runs, consecutive in input order so that equal keys keep it
+   */
+  void StartMerge(std::vector<Run> runs);
+
+  /** @return the reader with the smallest row of the merge; done once every reader is */
+  auto Winner() -> RunReader * { return readers_[tree_[0]].get(); }
+
+  /** Move the winner past its row and replay the matches on the path from its leaf. */
+  void AdvanceWinner();
+
+  /** @return whether reader a's row goes before reader b's; a finished reader goes after every row */
+  auto Before(size_t a, size_t b) const -> bool;
+
+  /** Drop the runs and the merge, deleting their pages. */
+  void Reset();
+
+  void DeleteRun(const Run &run);
+
+  BufferPoolManagerInstance *buffer_pool_manager_;
+  std::unique_ptr<VectorOperator> child_;
+  std::vector<SortKey> keys_;
+  const size_t memory_pages_;
+  IoExecutor *io_executor_;
+
+  /** Rows of the run being generated, or all of them when they fit in memory */
+  DataChunk buffer_;
+  /** Bytes the rows of buffer_ take in heap pages, slots included */
+  size_t buffer_bytes_{0};
+  std::vector<uint32_t> order_;
+  size_t emitted_{0};
+
+  std::vector<Run> runs_;
+  std::vector<std::unique_ptr<RunReader>> readers_;
+  /** tree_[0] is the reader with the smallest row, tree_[i] for i > 0 the loser of the match at node i */
+  std::vector<size_t> tree_;
+
+  size_t runs_written_{0};
+  size_t pages_written_{0};
+  size_t merge_passes_{0};
+};
+
+}  // namespace bustub
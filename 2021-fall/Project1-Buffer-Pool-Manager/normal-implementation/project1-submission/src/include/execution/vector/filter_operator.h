@@ -0,0 +1,42 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_operator.h
+//
+// Identification: src/include/execution/vector/filter_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/vector/vector_operator.h"
+#include "execution/vector/vector_predicate.h"
+
+namespace bustub {
+
+/**
+ * FilterOperator keeps the rows of its child a predicate holds for. Chunks are passed on as they are when every row
+ * passes, and compacted otherwise.
+ */
+class FilterOperator : public VectorOperator {
+ public:
+  FilterOperator(std::unique_ptr<VectorOperator> child, std::unique_ptr<VectorPredicate> predicate);
+
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+ private:
+  std::unique_ptr<VectorOperator> child_;
+  std::unique_ptr<VectorPredicate> predicate_;
+  DataChunk input_;
+  std::vector<uint32_t> sel_;
+};
+
+}  // namespace bustub
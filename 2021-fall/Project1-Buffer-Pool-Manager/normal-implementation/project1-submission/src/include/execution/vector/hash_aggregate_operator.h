@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_aggregate_operator.h
+//
+// Identification: src/include/execution/vector/hash_aggregate_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "container/hash/hash_function.h"
+#include "execution/vector/vector_operator.h"
+
+namespace bustub {
+
+/** Aggregate functions; COUNT_STAR ignores its column. */
+enum class AggregateType { COUNT_STAR, COUNT, COUNT_DISTINCT, SUM, MIN, MAX };
+
+struct AggregateSpec {
+  AggregateType type_;
+  /** Column of the input the aggregate is computed over */
+  size_t column_;
+};
+
+/**
+ * HashAggregateOperator groups its input on INTEGER columns and computes aggregates per group. NULL keys form a group
+ * of their own; aggregates other than the counts skip NULL values and are NULL for a group that had none. Without
+ * group columns there is exactly one group, even for an empty input.
+ *
+ * Init consumes the whole input a chunk at a time: the groups of all the rows of a chunk are looked up first, then
+ * each aggregate is updated in one loop over the chunk. COUNT_DISTINCT, over an INTEGER column, keeps one hash set
+ * of (group, value) pairs for all the groups.
+ *
+ * Output columns are the group columns followed by the aggregates. COUNT_STAR, COUNT and COUNT_DISTINCT are INTEGER;
+ * SUM, MIN and MAX have the type of their INTEGER or REAL column. Groups come out in the order they were first seen.
+ */
+class HashAggregateOperator : public VectorOperator {
+ public:
+  HashAggregateOperator(std::unique_ptr<VectorOperator> child, std::vector<size_t> group_columns,
+                        std::vector<AggregateSpec> aggregates);
+
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+ private:
+  /** Value of one aggregate for every group. */
+  struct AggregateState {
+    std::vector<int64_t> integers_;
+    std::vector<double> reals_;
+    std::vector<uint8_t> has_value_;
+  };
+
+  /** Set of (group, value) pairs of a COUNT_DISTINCT, open addressing with linear probing. */
+  struct DistinctSet {
+    struct Entry {
+      uint32_t group_;
+      int64_t value_;
+    };
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    std::vector<Entry> entries_;
+    size_t size_{0};
+  };
+
+  /** Find or create the group of every row of a chunk, into group_ids_. */
+  void FindGroups(const DataChunk &chunk);
+
+  auto NewGroup(const DataChunk &chunk, size_t row, uint64_t hash) -> uint32_t;
+
+  void GrowGroupTable();
+
+  /** Fold a column of the chunk into the index-th aggregate of the groups in group_ids_. */
+  void Update(size_t index, const ColumnVector &column);
+
+  /** @return whether the pair was not in the set yet */
+  auto InsertDistinct(DistinctSet *set, uint32_t group, int64_t value) -> bool;
+
+  std::unique_ptr<VectorOperator> child_;
+  std::vector<size_t> group_columns_;
+  std::vector<AggregateSpec> aggregates_;
+  HashFunction<int64_t> hash_fn_;
+
+  /** Key columns of the groups */
+  DataChunk group_keys_;
+  std::vector<uint64_t> group_hashes_;
+  /** One more than the group in each slot, 0 for an empty slot */
+  std::vector<uint32_t> slots_;
+  std::vector<AggregateState> states_;
+  std::vector<DistinctSet> distinct_sets_;
+
+  std::vector<uint64_t> hashes_;
+  std::vector<uint32_t> group_ids_;
+  /** Groups already produced by Next */
+  size_t emitted_{0};
+};
+
+}  // namespace bustub
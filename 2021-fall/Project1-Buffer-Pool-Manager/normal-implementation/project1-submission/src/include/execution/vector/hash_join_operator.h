@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_operator.h
+//
+// Identification: src/include/execution/vector/hash_join_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "container/hash/hash_function.h"
+#include "execution/vector/vector_operator.h"
+
+namespace bustub {
+
+/** INNER produces every matching pair; SEMI produces each probe row that has a match once, as IN (subquery) does. */
+enum class JoinType { INNER, SEMI };
+
+/**
+ * HashJoinOperator equi-joins two inputs on an INTEGER column of each. Init reads the whole build side into one chunk
+ * and chains its rows by key hash; Next then streams the probe side through it. A row with a NULL key matches nothing.
+ *
+ * Output columns are the ones of the probe side, followed for an INNER join by the ones of the build side.
+ */
+class HashJoinOperator : public VectorOperator {
+ public:
+  /**
+   * @param build side kept in memory, the smaller input
+   * @param probe side streamed through the hash table
+   * @param build_key join column of the build side
+   * @param probe_key join column of the probe side
+   * @param join_type INNER or SEMI
+   */
+  HashJoinOperator(std::unique_ptr<VectorOperator> build, std::unique_ptr<VectorOperator> probe, size_t build_key,
+                   size_t probe_key, JoinType join_type);
+
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+ private:
+  /** Read the build side and chain its rows. */
+  void Build();
+
+  /** Look up the first candidate build row of every row of the probe chunk. */
+  void StartProbeChunk();
+
+  auto Bucket(int64_t key) -> uint32_t { return static_cast<uint32_t>(hash_fn_.GetHash(key) & mask_); }
+
+  std::unique_ptr<VectorOperator> build_;
+  std::unique_ptr<VectorOperator> probe_;
+  size_t build_key_;
+  size_t probe_key_;
+  JoinType join_type_;
+  HashFunction<int64_t> hash_fn_;
+
+  DataChunk build_rows_;
+  /** One more than the first build row of each bucket, 0 for an empty bucket */
+  std::vector<uint32_t> heads_;
+  /** One more than the next build row in the same bucket, 0 at the end of the chain */
+  std::vector<uint32_t> next_;
+  uint64_t mask_{0};
+
+  DataChunk probe_chunk_;
+  /** Probe row being matched */
+  size_t probe_row_{0};
+  /** One more than the next candidate build row of each probe row, 0 once it has none left */
+  std::vector<uint32_t> candidates_;
+  bool probe_done_{false};
+  std::vector<uint32_t> probe_sel_;
+  std::vector<uint32_t> build_sel_;
+};
+
+}  // namespace bustub
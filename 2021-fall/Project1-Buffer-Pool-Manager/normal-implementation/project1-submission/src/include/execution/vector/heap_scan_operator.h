@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// heap_scan_operator.h
+//
+// Identification: src/include/execution/vector/heap_scan_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "execution/vector/vector_operator.h"
+#include "storage/page/page_guard.h"
+#include "storage/table/zone_map.h"
+
+namespace bustub {
+
+/**
+ * HeapScanOperator reads the rows of a heap of HeapPage, such as one written by SqliteBulkLoader, through the buffer
+ * pool, and decodes the columns it is asked for into chunks.
+ *
+ * Values are converted to the type of their output column: an INTEGER is widened for a REAL column and a REAL
+ * truncated for an INTEGER one. Any other mismatch, a TEXT in a number column or the reverse, reads as NULL, like a
+ * column missing from a short row.
+ *
+ * With zone filters the scan does not follow the chain of the heap: it reads the zone maps when it starts and only
+ * fetches the pages whose zones overlap every filter.
+ */
+class HeapScanOperator : public VectorOperator {
+ public:
+  /**
+   * @param buffer_pool_manager pool the heap is in
+   * @param first_page_id first page of the heap
+   * @param column_ids columns of the rows to produce, in output order
+   * @param types type of each output column
+   */
+  HeapScanOperator(BufferPoolManagerInstance *buffer_pool_manager, page_id_t first_page_id,
+                   std::vector<uint32_t> column_ids, std::vector<ColumnType> types);
+
+  /**
+   * Skip the pages that hold no value of a column in [lo, hi]. The rows of the pages scanned are not filtered: a
+   * predicate that implies the range still has to be evaluated above the scan.
+   * @param zone_map zone map of a column of the heap, built by BuildHeapZoneMap; an empty one skips nothing
+   * @param lo smallest value of the range
+   * @param hi largest value of the range
+   */
+  void AddZoneFilter(const ZoneMap *zone_map, int64_t lo, int64_t hi);
+
+  /**
+   * Scan some pages of the heap, in the order given, instead of following the chain from the first page. Takes effect
+   * at the next Init(), and cannot be combined with zone filters.
+   * @param page_ids pages to scan, which must stay valid until the scan is done with them
+   * @param count number of pages
+   */
+  void SetPages(const page_id_t *page_ids, size_t count);
+
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+  /** @return the heap pages fetched since Init() */
+  auto GetPagesFetched() const -> uint64_t { return pages_fetched_; }
+
+ private:
+  struct ZoneFilter {
+    const ZoneMap *zone_map_;
+    int64_t lo_;
+    int64_t hi_;
+  };
+
+  /** @return the next page to scan, or INVALID_PAGE_ID at the end of the heap */
+  auto NextPageId() -> page_id_t;
+
+  /** Decode one row into the output columns. */
+  void DecodeRow(const char *data, uint32_t size, DataChunk *chunk);
+
+  BufferPoolManagerInstance *buffer_pool_manager_;
+  page_id_t first_page_id_;
+  std::vector<uint32_t> column_ids_;
+  /** Output column of each row column up to the last one needed, -1 for the ones skipped */
+  std::vector<int> output_of_column_;
+
+  /** Page being read, held across calls until all its rows are out */
+  std::vector<ZoneFilter> zone_filters_;
+  /** Pages given to SetPages, nullptr to follow the chain */
+  const page_id_t *pages_{nullptr};
+  size_t page_count_{0};
+  /** Whether the scan walks candidates_ rather than the chain */
+  bool use_candidates_{false};
+  /** Pages left after the zone filters, in heap order */
+  std::vector<page_id_t> candidates_;
+  size_t next_candidate_{0};
+
+  ReadPageGuard page_guard_;
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  uint32_t next_slot_{0};
+  uint64_t pages_fetched_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.h
+//
+// Identification: src/include/execution/vector/morsel_queue.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Morsel is a unit of work of a parallel scan: a few pages of a heap, all owned by the same buffer pool instance.
+ */
+struct Morsel {
+  /** Instance the pages belong to */
+  size_t instance_;
+  const page_id_t *page_ids_;
+  size_t count_;
+};
+
+/**
+ * MorselQueue hands out the pages of a heap to the workers of a parallel scan.
+ *
+ * The pages are split by the ParallelBufferPoolManager instance that owns them, page_id % num_instances, and each
+ * instance's pages are cut into morsels of at most morsel_pages, in heap order. Every worker has home instances: the
+ * ones whose index is the worker's modulo the number of workers, or with more workers than instances, the instance of
+ * the worker's index modulo the number of instances. A worker takes morsels from the front of its home queues first,
+ * so the instances are mostly used by one thread each and their latches are not fought over. Once those are empty it
+ * steals from the back of the queue with the most morsels left, which evens out skew between the instances and
+ * between the workers.
+ */
+class MorselQueue {
+ public:
+  static constexpr size_t DEFAULT_MORSEL_PAGES = 16;
+
+  /**
+   * @param page_ids pages of the heap, in heap order
+   * @param num_instances instances of the pool the heap is in
+   * @param num_workers workers that will take morsels
+   * @param morsel_pages pages of a morsel at most
+   */
+  MorselQueue(const std::vector<page_id_t> &page_ids, size_t num_instances, size_t num_workers,
+              size_t morsel_pages = DEFAULT_MORSEL_PAGES);
+
+  /**
+   * Take the next morsel of a worker.
+   * @param worker index of the worker, less than the number of workers
+   * @param[out] morsel receives the morsel
+   * @return false once every morsel has been taken
+   */
+  auto Next(size_t worker, Morsel *morsel) -> bool;
+
+  /** @return the morsels taken from a home queue so far */
+  auto GetLocalCount() const -> uint64_t { return local_count_.load(); }
+
+  /** @return the morsels stolen from another worker's queue so far */
+  auto GetStolenCount() const -> uint64_t { return stolen_count_.load(); }
+
+ private:
+  /** Morsels of one instance. The front is taken by the instance's workers and the back by thieves. */
+  struct InstanceQueue {
+    std::mutex latch_;
+    std::vector<page_id_t> page_ids_;
+    std::vector<Morsel> morsels_;
+    size_t front_{0};
+    size_t back_{0};
+  };
+
+  /** Take a morsel from the front, or the back, of a queue. @return false if it is empty */
+  static auto Take(InstanceQueue *queue, bool from_back, Morsel *morsel) -> bool;
+
+  const size_t num_workers_;
+  std::vector<std::unique_ptr<InstanceQueue>> queues_;
+  std::atomic<uint64_t> local_count_{0};
+  std::atomic<uint64_t> stolen_count_{0};
+};
+
+}  // namespace bustub
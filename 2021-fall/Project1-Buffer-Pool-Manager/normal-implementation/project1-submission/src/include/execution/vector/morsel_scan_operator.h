@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_scan_operator.h
+//
+// Identification: src/include/execution/vector/morsel_scan_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "execution/vector/heap_scan_operator.h"
+#include "execution/vector/morsel_queue.h"
+#include "execution/vector/vector_operator.h"
+
+namespace bustub {
+
+/**
+ * MorselScanOperator is the scan of one worker of a parallel scan: it reads the morsels the worker takes from a shared
+ * MorselQueue until the queue runs dry. The pages of a morsel are fetched from the instance that owns them directly,
+ * and decoded like HeapScanOperator does.
+ *
+ * The queue is shared by all the workers and is only consumed once: Init() does not hand out the morsels again.
+ */
+class MorselScanOperator : public VectorOperator {
+ public:
+  /**
+   * @param buffer_pool_manager pool the heap is in
+   * @param queue morsels of the heap
+   * @param worker index of the worker running this scan
+   * @param column_ids columns of the rows to produce, in output order
+   * @param types type of each output column
+   */
+  MorselScanOperator(ParallelBufferPoolManager *buffer_pool_manager, MorselQueue *queue, size_t worker,
+                     std::vector<uint32_t> column_ids, std::vector<ColumnType> types);
+
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+  /** @return the pages this worker fetched since Init() */
+  auto GetPagesFetched() const -> uint64_t;
+
+ private:
+  ParallelBufferPoolManager *buffer_pool_manager_;
+  MorselQueue *queue_;
+  const size_t worker_;
+  std::vector<uint32_t> column_ids_;
+
+  /** One scan per instance, created when the worker first takes a morsel of it */
+  std::vector<std::unique_ptr<HeapScanOperator>> scans_;
+  HeapScanOperator *current_{nullptr};
+  uint64_t pages_fetched_{0};
+};
+
+}  // namespace bustub
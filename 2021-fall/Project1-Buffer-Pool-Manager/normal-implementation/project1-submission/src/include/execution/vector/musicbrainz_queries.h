@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// musicbrainz_queries.h
+//
+// Identification: src/include/execution/vector/musicbrainz_queries.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/table/sqlite_bulk_loader.h"
+#include "storage/table/zone_map.h"
+
+namespace bustub {
+
+/**
+ * Vectorized plans of the MusicBrainz queries of the SQL homework, over heaps loaded by SqliteBulkLoader. Each returns
+ * its rows formatted the way sqlite3 prints them, values separated by '|', so that they can be compared with the
+ * expected output files.
+ */
+
+/**
+ * @return the position of a column in the rows of a loaded table
+ * @throws Exception if the table has no column of that name
+ */
+auto ColumnIndex(const LoadedTable &table, const std::string &name) -> uint32_t;
+
+/**
+ * q7_release_percentage: the share of the releases of each month from July 2019 to July 2020.
+ *
+ * Plan: filter release_info on the date range, join release with it on the release id, group on (year, month) with
+ * COUNT(*) and sort on the same columns. The total the shares are taken of is the sum of the group counts.
+ *
+ * @param date_year_zones zone map of release_info.date_year; if given, the scan of release_info only fetches the
+ * pages with a year in 2019 or 2020
+ */
+auto RunReleasePercentageQuery(BufferPoolManagerInstance *buffer_pool_manager, const LoadedTable &release,
+                               const LoadedTable &release_info, const ZoneMap *date_year_zones = nullptr)
+    -> std::vector<std::string>;
+
+/**
+ * q8_collaborate_artist: the number of artists credited together with an artist.
+ *
+ * Plan: a semi join of artist_credit_name with the artist credits naming the artist, then COUNT(DISTINCT artist).
+ */
+auto RunCollaborateArtistQuery(BufferPoolManagerInstance *buffer_pool_manager, const LoadedTable &artist_credit_name,
+                               const std::string &artist_name = "Ariana Grande") -> std::vector<std::string>;
+
+}  // namespace bustub
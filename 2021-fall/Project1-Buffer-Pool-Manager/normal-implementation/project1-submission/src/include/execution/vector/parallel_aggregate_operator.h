@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_aggregate_operator.h
+//
+// Identification: src/include/execution/vector/parallel_aggregate_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "execution/vector/hash_aggregate_operator.h"
+#include "execution/vector/morsel_queue.h"
+#include "execution/vector/vector_operator.h"
+#include "storage/table/sqlite_bulk_loader.h"
+
+namespace bustub {
+
+/** Builds the operators a worker runs between its scan and the aggregation, such as a filter. */
+using PipelineFactory = std::function<auto(std::unique_ptr<VectorOperator> scan)->std::unique_ptr<VectorOperator>>;
+
+/**
+ * ParallelAggregateOperator scans a heap with a pool of worker threads and aggregates what the scan produces.
+ *
+ * Each worker runs its own pipeline, a MorselScanOperator feeding the operators of the pipeline factory and a
+ * HashAggregateOperator, over the morsels it takes from a shared MorselQueue, and so pre-aggregates its share of the
+ * rows with no synchronization but the queue. Once every worker is done, the partial groups are merged by a final
+ * aggregation on the group columns: the counts and sums are summed, the minimums and maximums folded again.
+ * COUNT_DISTINCT cannot be merged from partial counts and is not supported.
+ *
+ * Init() runs the whole parallel phase, and Next() hands out the merged groups. Groups come out in no particular
+ * order.
+ */
+class ParallelAggregateOperator : public VectorOperator {
+ public:
+  /**
+   * @param buffer_pool_manager pool the heap is in
+   * @param table heap to scan, with its page ids
+   * @param column_ids columns the scan produces
+   * @param types type of each column the scan produces
+   * @param pipeline operators between the scan and the aggregation; nullptr for none
+   * @param group_columns group columns, in the output of the pipeline
+   * @param aggregates aggregates, over columns of the output of the pipeline
+   * @param num_workers worker threads
+   * @param morsel_pages pages of a morsel at most
+   */
+  ParallelAggregateOperator(ParallelBufferPoolManager *buffer_pool_manager, const LoadedTable *table,
+                            std::vector<uint32_t> column_ids, std::vector<ColumnType> types, PipelineFactory pipeline,
+                            std::vector<size_t> group_columns, std::vector<AggregateSpec> aggregates,
+                            size_t num_workers, size_t morsel_pages = MorselQueue::DEFAULT_MORSEL_PAGES);
+
+  ~ParallelAggregateOperator() override;
+
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+  /** @return the morsels the workers took from their home queues during the last Init() */
+  auto GetLocalMorsels() const -> uint64_t { return local_morsels_; }
+
+  /** @return the morsels the workers stole during the last Init() */
+  auto GetStolenMorsels() const -> uint64_t { return stolen_morsels_; }
+
+  /** @return the pages each worker fetched during the last Init() */
+  auto GetPagesPerWorker() const -> const std::vector<uint64_t> & { return pages_per_worker_; }
+
+ private:
+  class PartialSource;
+
+  /** Run the pipeline of one worker, into its partial groups. */
+  void RunWorker(MorselQueue *queue, size_t worker);
+
+  ParallelBufferPoolManager *buffer_pool_manager_;
+  const LoadedTable *table_;
+  std::vector<uint32_t> column_ids_;
+  std::vector<ColumnType> types_;
+  PipelineFactory pipeline_;
+  std::vector<size_t> group_columns_;
+  std::vector<AggregateSpec> aggregates_;
+  const size_t num_workers_;
+  const size_t morsel_pages_;
+
+  /** Partial groups of each worker */
+  std::vector<std::vector<DataChunk>> partials_;
+  std::unique_ptr<HashAggregateOperator> merge_;
+  uint64_t local_morsels_{0};
+  uint64_t stolen_morsels_{0};
+  std::vector<uint64_t> pages_per_worker_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_operator.h
+//
+// Identification: src/include/execution/vector/sort_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/vector/vector_operator.h"
+
+namespace bustub {
+
+struct SortKey {
+  size_t column_;
+  bool ascending_{true};
+};
+
+/**
+ * Compare two rows on some sort keys. NULLs sort before every value, before the direction of the key applies.
+ * @return <0, 0 or >0 as row_a of a sorts before, with or after row_b of b
+ */
+auto CompareRows(const std::vector<SortKey> &keys, const DataChunk &a, size_t row_a, const DataChunk &b, size_t row_b)
+    -> int;
+
+/**
+ * SortOperator orders the rows of its child. Init reads the whole input into one chunk and sorts the row numbers;
+ * Next gathers the rows in that order. NULLs come first in ascending order, as in SQLite, and rows with equal keys
+ * keep their input order.
+ */
+class SortOperator : public VectorOperator {
+ public:
+  SortOperator(std::unique_ptr<VectorOperator> child, std::vector<SortKey> keys);
+
+  void Init() override;
+
+  auto Next(DataChunk *chunk) -> bool override;
+
+ private:
+  std::unique_ptr<VectorOperator> child_;
+  std::vector<SortKey> keys_;
+  DataChunk rows_;
+  std::vector<uint32_t> order_;
+  size_t emitted_{0};
+};
+
+}  // namespace bustub
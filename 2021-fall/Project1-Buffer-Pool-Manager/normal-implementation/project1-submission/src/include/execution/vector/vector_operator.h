@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_operator.h
+//
+// Identification: src/include/execution/vector/vector_operator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/vector/data_chunk.h"
+
+namespace bustub {
+
+/**
+ * VectorOperator is a node of a vectorized query plan. Like an executor it is pulled by its parent, but it hands over
+ * a chunk of up to VECTOR_SIZE rows per call instead of a single tuple, so the cost of the call, and of every branch
+ * on the plan shape, is paid once per chunk.
+ */
+class VectorOperator {
+ public:
+  explicit VectorOperator(std::vector<ColumnType> output_types) : output_types_(std::move(output_types)) {}
+
+  virtual ~VectorOperator() = default;
+
+  /** Initialize the operator and its children; may be called again to rerun the plan. */
+  virtual void Init() = 0;
+
+  /**
+   * Produce the next rows.
+   * @param[out] chunk reset and filled with at least one row, in the columns of GetOutputTypes()
+   * @return false when there are no more rows
+   */
+  virtual auto Next(DataChunk *chunk) -> bool = 0;
+
+  /** @return the types of the columns the operator produces */
+  auto GetOutputTypes() const -> const std::vector<ColumnType> & { return output_types_; }
+
+ protected:
+  std::vector<ColumnType> output_types_;
+};
+
+}  // namespace bustub
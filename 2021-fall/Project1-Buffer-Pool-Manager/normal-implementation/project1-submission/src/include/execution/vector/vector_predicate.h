@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_predicate.h
+//
+// Identification: src/include/execution/vector/vector_predicate.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/vector/data_chunk.h"
+
+namespace bustub {
+
+/** Comparison of a column with a constant. */
+enum class ComparisonType { EQUAL, NOT_EQUAL, LESS_THAN, LESS_THAN_OR_EQUAL, GREATER_THAN, GREATER_THAN_OR_EQUAL };
+
+/**
+ * VectorPredicate is a filter condition evaluated over a whole chunk at a time. A selection vector lists, in
+ * increasing order, the rows of the chunk that are still candidates; a predicate narrows it down to the rows it
+ * holds for. NULL compares as false, as in SQL.
+ */
+class VectorPredicate {
+ public:
+  virtual ~VectorPredicate() = default;
+
+  /**
+   * @param chunk rows to test
+   * @param sel candidate rows, in increasing order
+   * @param count number of candidate rows
+   * @param[out] out receives the candidate rows the predicate holds for, in increasing order; may alias sel
+   * @return number of rows written to out
+   */
+  virtual auto Select(const DataChunk &chunk, const uint32_t *sel, size_t count, uint32_t *out) const -> size_t = 0;
+};
+
+/** column op constant, for an INTEGER or a REAL column. */
+auto MakeComparison(size_t column, ComparisonType type, int64_t constant) -> std::unique_ptr<VectorPredicate>;
+
+/** column op constant, for a TEXT column; strings compare by their bytes, like BINARY collation. */
+auto MakeComparison(size_t column, ComparisonType type, std::string constant) -> std::unique_ptr<VectorPredicate>;
+
+/** Holds for the rows all of the predicates hold for. */
+auto MakeAnd(std::vector<std::unique_ptr<VectorPredicate>> children) -> std::unique_ptr<VectorPredicate>;
+
+/** Holds for the rows any of the predicates holds for. */
+auto MakeOr(std::vector<std::unique_ptr<VectorPredicate>> children) -> std::unique_ptr<VectorPredicate>;
+
+}  // namespace bustub
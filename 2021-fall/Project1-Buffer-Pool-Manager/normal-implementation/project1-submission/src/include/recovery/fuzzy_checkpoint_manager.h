@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// fuzzy_checkpoint_manager.h
+//
+// Identification: src/include/recovery/fuzzy_checkpoint_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "recovery/log_manager.h"
+
+namespace bustub {
+
+/**
+ * FuzzyCheckpointManager takes checkpoints while the buffer pool keeps serving fetches, in the style of ARIES.
+ *
+ * A checkpoint snapshots the dirty-page table (DPT) of every instance, writes those pages back one at a time with
+ * BufferPoolManagerInstance::CheckpointPage, then records the DPT left at the end in the master record together with
+ * the redo LSN: the oldest recovery LSN in that table, or the end of the log when the checkpoint started if no page is
+ * older. Recovery only has to replay the log from the redo LSN.
+ *
+ * Writes are paced. Every control interval the p99 fetch latency measured since the previous interval is compared
+ * with the budget; the write rate is halved when it is over and raised by a fixed step when it is not (AIMD), between
+ * the configured minimum and maximum rate.
+ *
+ * The master record is a text file: the redo LSN on the first line, then one "page_id rec_lsn" line per dirty page.
+ * It is written to a temporary file that is renamed into place.
+ */
+class FuzzyCheckpointManager {
+ public:
+  /**
+   * Creates a new FuzzyCheckpointManager for a single instance.
+   * @param bpm the instance, not owned
+   * @param log_manager the log manager, not owned; nullptr if logging is disabled
+   * @param master_record_path where the master record is written
+   */
+  FuzzyCheckpointManager(BufferPoolManagerInstance *bpm, LogManager *log_manager, std::string master_record_path);
+
+  /**
+   * Creates a new FuzzyCheckpointManager for every instance of a parallel buffer pool.
+   * @param bpm the buffer pool, not owned
+   * @param log_manager the log manager, not owned; nullptr if logging is disabled
+   * @param master_record_path where the master record is written
+   */
+  FuzzyCheckpointManager(ParallelBufferPoolManager *bpm, LogManager *log_manager, std::string master_record_path);
+
+  /**
+   * Stops the periodic checkpoints. A checkpoint in progress is abandoned and leaves the previous master record.
+   */
+  ~FuzzyCheckpointManager();
+
+  /** @param p99_budget p99 fetch latency the checkpoint writes may not push foreground traffic past */
+  void SetLatencyBudget(std::chrono::microseconds p99_budget) { latency_budget_ = p99_budget; }
+
+  /**
+   * @param min_pages_per_sec rate kept even over the latency budget, so that a checkpoint always finishes
+   * @param max_pages_per_sec rate a checkpoint never goes above
+   */
+  void SetWriteRate(double min_pages_per_sec, double max_pages_per_sec);
+
+  /** @return the current write rate in pages per second */
+  auto GetWriteRate() -> double { return write_rate_; }
+
+  /**
+   * Take a checkpoint in the calling thread.
+   * @return the redo LSN written to the master record, INVALID_LSN without a log manager or if it was abandoned
+   */
+  auto Checkpoint() -> lsn_t;
+
+  /**
+   * Take a checkpoint every interval in the background, until the manager is destroyed.
+   * @param interval time between the end of a checkpoint and the start of the next one
+   */
+  void StartPeriodicCheckpoint(std::chrono::milliseconds interval);
+
+  /**
+   * Read a master record.
+   * @param path the master record
+   * @param[out] redo_lsn where recovery starts replaying the log
+   * @param[out] dirty_pages receives the dirty-page table
+   * @return false if there is no valid master record
+   */
+  static auto ReadMasterRecord(const std::string &path, lsn_t *redo_lsn,
+                               std::vector<std::pair<page_id_t, lsn_t>> *dirty_pages) -> bool;
+
+  static constexpr std::chrono::microseconds DEFAULT_LATENCY_BUDGET{1000};
+  static constexpr double DEFAULT_MIN_WRITE_RATE = 100;
+  static constexpr double DEFAULT_MAX_WRITE_RATE = 10000;
+
+ private:
+  /** How often the write rate is adjusted. */
+  static constexpr std::chrono::milliseconds CONTROL_INTERVAL{10};
+  /** Fewer fetches than this in an interval say nothing about the latency; the rate is left alone. */
+  static constexpr uint64_t MIN_LATENCY_SAMPLES = 16;
+  /** Additive increase, as a fraction of the maximum rate. */
+  static constexpr double RATE_STEP = 1.0 / 32;
+
+  /** @return the DPT of every instance */
+  auto CollectDirtyPages() -> std::vector<std::pair<page_id_t, lsn_t>>;
+
+  /** @param[out] counts receives the summed fetch latency histograms of all the instances */
+  void SnapshotLatency(uint64_t *counts);
+
+  /** Compare the p99 latency since the last call with the budget and adjust the write rate. */
+  void AdjustWriteRate(uint64_t *last_counts);
+
+  /** Write the master record through a synced temporary file, then sync its directory after the rename. */
+  auto WriteMasterRecord(lsn_t redo_lsn, const std::vector<std::pair<page_id_t, lsn_t>> &dirty_pages) -> bool;
+
+  /**
+   * Sleep until deadline unless the manager is being destroyed.
+   * @return false if it is
+   */
+  auto WaitUntil(std::chrono::steady_clock::time_point deadline) -> bool;
+
+  std::vector<BufferPoolManagerInstance *> instances_;
+  LogManager *log_manager_;
+  std::string master_record_path_;
+
+  std::chrono::microseconds latency_budget_{DEFAULT_LATENCY_BUDGET};
+  double min_write_rate_{DEFAULT_MIN_WRITE_RATE};
+  double max_write_rate_{DEFAULT_MAX_WRITE_RATE};
+  std::atomic<double> write_rate_{DEFAULT_MAX_WRITE_RATE};
+
+  std::thread checkpoint_thread_;
+  /** Set on destruction, wakes up the periodic checkpoint and abandons the one in progress. */
+  bool stop_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_manager.h
+//
+// Identification: src/include/recovery/log_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <future>  // NOLINT
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+
+#include "recovery/log_record.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * LogManager maintains a separate thread that is awakened whenever the log buffer is full or whenever a timeout
+ * happens. When the thread is awakened, the log buffer's content is written into the disk log file.
+ *
+ * Records are appended to log_buffer_ while the flush thread writes flush_buffer_, and the two are swapped at every
+ * flush. Threads waiting for their records to be durable (commits, or the buffer pool before writing back a page) do
+ * not write the log themselves: they wake the flush thread and wait. Everything appended while one write is in
+ * progress goes out with the next one, so a single write and sync covers all the waiters of a batch and the number of
+ * syncs does not grow with the number of committing threads.
+ */
+class LogManager {
+ public:
+  explicit LogManager(DiskManager *disk_manager)
+      : next_lsn_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
+    log_buffer_ = new char[LOG_BUFFER_SIZE];
+    flush_buffer_ = new char[LOG_BUFFER_SIZE];
+  }
+
+  ~LogManager() {
+    StopFlushThread();
+    delete[] log_buffer_;
+    delete[] flush_buffer_;
+    log_buffer_ = nullptr;
+    flush_buffer_ = nullptr;
+  }
+
+  /** Turn logging on and start the flush thread. */
+  void RunFlushThread();
+
+  /** Write out what is left in the log buffer, stop the flush thread and turn logging off. */
+  void StopFlushThread();
+
+  /**
+   * Append a record to the log buffer, waiting for a flush if it is full. The record is not durable on return.
+   * @param log_record the record; its LSN is set
+   * @return the LSN of the record
+   */
+  auto AppendLogRecord(LogRecord *log_record) -> lsn_t;
+
+  /**
+   * Block until every record up to and including lsn is on disk. LSNs that were never handed out are treated as
+   * the last one that was, so a page with a stale or zero LSN never blocks forever. Without the flush thread the
+   * calling thread writes the log itself.
+   * @param lsn the LSN that must be durable
+   */
+  void FlushToLSN(lsn_t lsn);
+
+  inline auto GetNextLSN() -> lsn_t { return next_lsn_; }
+  inline auto GetPersistentLSN() -> lsn_t { return persistent_lsn_; }
+  inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
+  inline auto GetLogBuffer() -> char * { return log_buffer_; }
+
+  /** @return number of log writes so far; each one covers every record appended since the previous one */
+  inline auto GetNumFlushes() -> uint64_t { return num_flushes_; }
+
+ private:
+  /**
+   * Swap the buffers and write out the records appended so far. latch_ is released during the write.
+   * @param lk lock on latch_, held on entry and on return
+   */
+  void FlushBuffer(std::unique_lock<std::mutex> *lk);
+
+  /** Body of the flush thread. */
+  void RunFlush();
+
+  /** The atomic counter which records the next log sequence number. */
+  std::atomic<lsn_t> next_lsn_;
+  /** The log records before and including the persistent lsn have been written to disk. */
+  std::atomic<lsn_t> persistent_lsn_;
+
+  /** Records are appended here. */
+  char *log_buffer_;
+  /** Records being written out. */
+  char *flush_buffer_;
+  /** Bytes used in log_buffer_. */
+  int log_buffer_offset_{0};
+  /** LSN of the last record in log_buffer_. */
+  lsn_t last_buffered_lsn_{INVALID_LSN};
+  /** A write of flush_buffer_ is in progress. */
+  bool flushing_{false};
+  /** Somebody is waiting for records in log_buffer_. */
+  bool flush_requested_{false};
+  std::atomic<uint64_t> num_flushes_{0};
+
+  /** Protects everything above except the atomics. */
+  std::mutex latch_;
+
+  std::thread *flush_thread_{nullptr};
+
+  /** Wakes up the flush thread. */
+  std::condition_variable cv_;
+  /** Signalled after every write; wakes up appenders waiting for room and threads waiting for durability. */
+  std::condition_variable flushed_cv_;
+
+  DiskManager *disk_manager_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,230 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// simulated_disk_manager.h
+//
+// Identification: src/include/storage/disk/simulated_disk_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <mutex>  // NOLINT
+#include <queue>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer/buffer_pool_stats.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DeviceProfile describes how long a simulated device takes to serve a page I/O.
+ *
+ * The service time of an I/O is log-normal around the median latency. Rotating media add a seek and a uniformly
+ * distributed rotational delay. The seek grows with the square root of the distance the head travels, from a 16th of
+ * full_seek_ for the next track up to full_seek_. An I/O on the page right after the previous one pays neither. On top
+ * of that, every transfer goes through one shared channel of limited bandwidth, and at most queue_depth_ I/Os are
+ * served at once.
+ */
+struct DeviceProfile {
+  /** Median service time of a page read */
+  std::chrono::microseconds read_latency_{0};
+  /** Median service time of a page write */
+  std::chrono::microseconds write_latency_{0};
+  /** Standard deviation of the log of the service time; 0 makes every I/O take exactly the median */
+  double latency_sigma_{0};
+  /** Seek across the whole device; 0 for flash */
+  std::chrono::microseconds full_seek_{0};
+  /** One rotation of the platters; 0 for flash */
+  std::chrono::microseconds rotation_{0};
+  /** Pages the seek distance is measured against */
+  page_id_t num_pages_{1 << 20};
+  /** I/Os served at once; the others queue */
+  size_t queue_depth_{1};
+  /** Bytes per second through the shared channel; 0 for unlimited */
+  uint64_t bandwidth_{0};
+
+  /** @return a datacenter NVMe drive */
+  static auto NVMe() -> DeviceProfile;
+  /** @return a SATA flash drive */
+  static auto SataSsd() -> DeviceProfile;
+  /** @return a 7200 rpm hard disk */
+  static auto Hdd() -> DeviceProfile;
+};
+
+/**
+ * FaultProfile describes the faults injected into the I/Os of a simulated device.
+ *
+ * A failed write is dropped and a failed read returns a zeroed page, which is what DiskManager does when the file
+ * reports an error; both are logged and counted.
+ */
+struct FaultProfile {
+  /** Fraction of the I/Os that are slow */
+  double slow_io_rate_{0};
+  /** How many times longer a slow I/O takes */
+  double slow_io_factor_{10};
+  /** Fraction of the page reads that fail */
+  double failed_read_rate_{0};
+  /** Fraction of the page writes that fail */
+  double failed_write_rate_{0};
+};
+
+/**
+ * SimulatedDiskStats counts what a simulated device has served.
+ */
+struct SimulatedDiskStats {
+  std::atomic<uint64_t> reads_{0};
+  std::atomic<uint64_t> writes_{0};
+  std::atomic<uint64_t> log_writes_{0};
+  std::atomic<uint64_t> failed_reads_{0};
+  std::atomic<uint64_t> failed_writes_{0};
+  std::atomic<uint64_t> slow_ios_{0};
+  /** Time spent waiting for a free queue slot or for the channel, in nanoseconds */
+  std::atomic<uint64_t> queue_wait_ns_{0};
+  /** Service time of every I/O, waits excluded */
+  LatencyHistogram service_time_;
+};
+
+/**
+ * SimulatedDiskManager is a DiskManager that keeps the pages in memory and makes every I/O take as long as a real
+ * device would, so that benchmarks and stress tests behave the same on any machine.
+ *
+ * Random draws are a hash of the seed, the page id and how many I/Os that page has had, not a shared generator: the
+ * latency and faults of a page's n-th I/O do not depend on how the threads interleave. Only the head position of a
+ * rotating device depends on the order of the I/Os.
+ *
+ * With virtual time, I/Os complete at once and their service times are only added up, which makes a run fast and
+ * fully repeatable; queue depth and bandwidth need real concurrency and only apply in real time.
+ *
+ * ReadPageAsync does not hold a thread per read: the read takes its queue slot and completion time when issued, and a
+ * completion thread copies the data and runs the callbacks in completion order. Keep the callbacks short.
+ */
+class SimulatedDiskManager : public DiskManager {
+ public:
+  /**
+   * Creates a new SimulatedDiskManager.
+   * @param device latency model
+   * @param seed seed of the latency and fault draws
+   * @param virtual_time if true, do not sleep, only account the service times
+   */
+  explicit SimulatedDiskManager(const DeviceProfile &device, uint64_t seed = 0, bool virtual_time = false);
+
+  /**
+   * Delivers the asynchronous reads still in flight, then stops the completion thread.
+   */
+  ~SimulatedDiskManager() override;
+
+  /** @param faults faults to inject from now on */
+  void SetFaults(const FaultProfile &faults);
+
+  /**
+   * Make every I/O on one page fail, or stop doing so.
+   * @param page_id id of the page
+   * @param failing whether I/Os on the page fail
+   */
+  void SetFailingPage(page_id_t page_id, bool failing);
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void ReadPageAsync(page_id_t page_id, char *page_data, std::function<void()> callback) override;
+
+  void WriteLog(char *log_data, int size) override;
+
+  auto ReadLog(char *log_data, int size, int offset) -> bool override;
+
+  /** @return what the device has served so far */
+  auto GetStats() -> const SimulatedDiskStats & { return stats_; }
+
+  /** @return the sum of all the service times; with virtual time, how long the run would have kept the device busy */
+  auto GetBusyTime() -> std::chrono::nanoseconds { return std::chrono::nanoseconds(busy_ns_.load()); }
+
+ private:
+  /** Key of the log in the per-page I/O counts. */
+  static constexpr page_id_t LOG_KEY = INVALID_PAGE_ID;
+
+  /**
+   * Draw the outcome of the next I/O on a page.
+   * @param page_id id of the page, LOG_KEY for the log
+   * @param is_write whether it is a write
+   * @param[out] failed whether the I/O fails
+   * @return service time of the I/O
+   */
+  auto Plan(page_id_t page_id, bool is_write, bool *failed) -> std::chrono::nanoseconds;
+
+  /**
+   * Take an I/O through the queue and the channel.
+   * @return when the I/O completes; now with virtual time
+   */
+  auto Schedule(std::chrono::nanoseconds service_time, size_t bytes) -> std::chrono::steady_clock::time_point;
+
+  /** Take the I/O through the queue and the channel, and wait for it to complete. */
+  void Serve(std::chrono::nanoseconds service_time, size_t bytes);
+
+  /** Copy a page out once its read completes; a failed read or a page never written reads as zeroes. */
+  void FinishRead(page_id_t page_id, char *page_data, bool failed);
+
+  /** Body of the completion thread. */
+  void RunCompletions();
+
+  /** An asynchronous read waiting for its completion time. */
+  struct Completion {
+    std::chrono::steady_clock::time_point done_;
+    page_id_t page_id_;
+    char *page_data_;
+    bool failed_;
+    std::function<void()> callback_;
+
+    auto operator>(const Completion &other) const -> bool { return done_ > other.done_; }
+  };
+
+  const DeviceProfile device_;
+  const uint64_t seed_;
+  const bool virtual_time_;
+
+  /** Protects faults_, failing_pages_, io_counts_ and head_. */
+  std::mutex plan_latch_;
+  FaultProfile faults_;
+  std::unordered_set<page_id_t> failing_pages_;
+  std::unordered_map<page_id_t, uint64_t> io_counts_;
+  /** Page the head of a rotating device is over. */
+  page_id_t head_{0};
+
+  /** Protects slot_free_at_ and channel_free_at_. */
+  std::mutex queue_latch_;
+  /** When each of the queue_depth_ slots is free again, earliest first. */
+  std::priority_queue<std::chrono::steady_clock::time_point, std::vector<std::chrono::steady_clock::time_point>,
+                      std::greater<>>
+      slot_free_at_;
+  std::chrono::steady_clock::time_point channel_free_at_{};
+
+  /** Protects completions_ and stop_. */
+  std::mutex completion_latch_;
+  std::condition_variable completion_cv_;
+  std::priority_queue<Completion, std::vector<Completion>, std::greater<>> completions_;
+  bool stop_{false};
+  /** Only started in real time; with virtual time an asynchronous read completes before ReadPageAsync returns. */
+  std::thread completion_thread_;
+
+  /** Protects pages_ and log_. */
+  std::mutex data_latch_;
+  std::unordered_map<page_id_t, std::vector<char>> pages_;
+  std::vector<char> log_;
+
+  std::atomic<uint64_t> busy_ns_{0};
+  SimulatedDiskStats stats_;
+};
+
+}  // namespace bustub
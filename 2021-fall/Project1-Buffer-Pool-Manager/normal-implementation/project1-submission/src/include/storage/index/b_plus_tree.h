@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree.h
+//
+// Identification: src/include/storage/index/b_plus_tree.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "storage/index/index_iterator.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Main class providing the API for the Interactive B+ Tree.
+ *
+ * Implementation of simple b+ tree data structure where internal pages direct the search and leaf pages contain
+ * actual data.
+ * (1) We only support unique key
+ * (2) support insert & remove
+ * (3) The structure grows dynamically, removes do not shrink it (see below)
+ * (4) Implement index iterator for range scan
+ *
+ * Every node is a page of the buffer pool, latched through page guards. Concurrency follows optimistic latch crabbing:
+ * an insert or remove first descends with read latches and write-latches only the leaf. If the leaf could split, it
+ * lets go and descends again with write latches, releasing the ancestors as soon as a node is safe, that is cannot
+ * split. The root is changed under the write latch of the header page.
+ *
+ * Leaves are not merged or redistributed on underflow: a remove only takes the entry out of its leaf, and a leaf left
+ * empty stays in place and is skipped by scans. In exchange the optimistic path never has to restart for a remove,
+ * and a node once reached through its parent or left sibling stays where it is.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree {
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /**
+   * Creates a new BPlusTree, or opens an existing one.
+   * @param name name of the index
+   * @param buffer_pool_manager buffer pool the nodes live in
+   * @param comparator three-way comparison of keys
+   * @param leaf_max_size a leaf splits when it reaches this size
+   * @param internal_max_size an internal page splits when it goes past this size
+   * @param header_page_id header page of an existing tree, INVALID_PAGE_ID to create a new one
+   */
+  explicit BPlusTree(std::string name, ParallelBufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                     int leaf_max_size = LeafPage::Capacity(), int internal_max_size = InternalPage::Capacity() - 1,
+                     page_id_t header_page_id = INVALID_PAGE_ID);
+
+  // Returns true if this B+ tree has no keys and values.
+  auto IsEmpty() -> bool;
+
+  // Insert a key-value pair into this B+ tree.
+  auto Insert(const KeyType &key, const ValueType &value) -> bool;
+
+  // Remove a key and its value from this B+ tree.
+  void Remove(const KeyType &key);
+
+  // return the value associated with a given key
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /**
+   * Build the tree bottom-up from sorted input: the leaves are filled left to right, then each level of internal
+   * pages is built over the one below. Every page is written once and no split happens. The header page stays
+   * write-latched during the load.
+   * @param items entries in strictly increasing key order
+   * @param fill_factor fraction of each node to fill, leaving room for later inserts
+   * @return false if the tree is not empty or items are not sorted
+   */
+  auto BulkLoad(const std::vector<MappingType> &items, double fill_factor = 1.0) -> bool;
+
+  /**
+   * Make range scans keep the leaves ahead of them loading. Needs ParallelBufferPoolManager::EnableAsyncFetch.
+   * @param num_pages leaves to keep ahead of a scan, 0 to turn read-ahead off
+   */
+  void SetReadAhead(int num_pages);
+
+  // index iterator
+  auto Begin() -> INDEXITERATOR_TYPE;
+  auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
+  auto End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+
+  auto GetRootPageId() -> page_id_t;
+
+  /** @return the page to pass to the constructor to open this tree again */
+  auto GetHeaderPageId() const -> page_id_t { return header_page_id_; }
+
+ private:
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
+
+  // Fetch helpers, throwing OUT_OF_MEMORY when no frame is available.
+  auto FetchRead(page_id_t page_id) -> ReadPageGuard;
+  auto FetchWrite(page_id_t page_id) -> WritePageGuard;
+  auto NewNode(page_id_t *page_id) -> WritePageGuard;
+
+  /** @return whether an insert below node cannot make it split */
+  static auto IsSafeForInsert(const BPlusTreePage *node) -> bool;
+
+  /**
+   * Descend with read latches and write-latch the leaf that holds key.
+   * @return the leaf, empty if the tree is empty
+   */
+  auto FindLeafOptimistic(const KeyType &key) -> WritePageGuard;
+
+  /** Insert with write latches down from the header page, splitting as needed. */
+  auto InsertPessimistic(const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Insert the separator of a split node into its parent, splitting upwards as long as needed.
+   * @param path write latched ancestors of the split node, the parent last
+   * @param header the latched header page, used if the root splits
+   */
+  void InsertIntoParent(std::deque<WritePageGuard> *path, WritePageGuard *header, page_id_t left_id,
+                        const KeyType &key, page_id_t right_id, int level);
+
+  auto BeginAt(const KeyType *key) -> INDEXITERATOR_TYPE;
+
+  /**
+   * Take the leaves of node from child index first on as the next read-ahead window of iterator.
+   * @param high_key key bounding the subtree of node from above, if has_high_key
+   * @param[out] leaves the leaves to load
+   */
+  void FillReadAhead(const InternalPage *node, int first, const KeyType &high_key, bool has_high_key,
+                     INDEXITERATOR_TYPE *iterator, std::vector<page_id_t> *leaves);
+
+  /** Look up the next read-ahead window of iterator and start loading it. No latch may be held. */
+  void ReadAhead(INDEXITERATOR_TYPE *iterator);
+
+  /** Start loading leaves in the background, they are unpinned once resident. */
+  void DispatchReadAhead(const std::vector<page_id_t> &leaves);
+
+  // member variable
+  std::string index_name_;
+  ParallelBufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+  page_id_t header_page_id_;
+  int read_ahead_pages_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_iterator.h
+//
+// Identification: src/include/storage/index/index_iterator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * index_iterator.h
+ * For range scan of b+ tree
+ */
+#pragma once
+
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+#define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * IndexIterator walks the leaves from left to right, holding the read latch of the leaf it is on. It lets go of a
+ * leaf before latching the next one: a leaf is never merged away, so the next pointer read under the latch stays
+ * valid, and a scan never waits on a latch while holding one.
+ *
+ * When the tree has read-ahead enabled, the iterator keeps a window of the leaves ahead of it loading. The window is
+ * the run of siblings under one parent; once the scan reaches its middle, the tree looks up the next run with
+ * optimistic reads of the internal pages, which is done between two leaves so that no latch is held.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class IndexIterator {
+  using LeafPage = B_PLUS_TREE_LEAF_PAGE_TYPE;
+
+ public:
+  /** Creates the end iterator. */
+  IndexIterator() = default;
+
+  IndexIterator(const IndexIterator &) = delete;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+
+  IndexIterator(IndexIterator &&that) noexcept = default;
+  auto operator=(IndexIterator &&that) noexcept -> IndexIterator & = default;
+
+  ~IndexIterator() = default;
+
+  auto IsEnd() const -> bool { return !guard_.IsValid(); }
+
+  auto operator*() -> const MappingType &;
+
+  auto operator++() -> IndexIterator &;
+
+  auto operator==(const IndexIterator &itr) const -> bool {
+    return IsEnd() ? itr.IsEnd() : (!itr.IsEnd() && page_id_ == itr.page_id_ && index_ == itr.index_);
+  }
+
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
+
+ private:
+  friend class BPlusTree<KeyType, ValueType, KeyComparator>;
+
+  explicit IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree) : tree_(tree) {}
+
+  /** Move on to the next leaf while the current position is past the end of a leaf. */
+  void Advance();
+
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
+  ReadPageGuard guard_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  int index_{0};
+
+  /** Whether there are leaves right of the read-ahead window */
+  bool has_read_ahead_key_{false};
+  /** A key in the first leaf right of the read-ahead window */
+  KeyType read_ahead_key_{};
+  /** Reaching this leaf looks up the next window; INVALID_PAGE_ID to do so on the next leaf */
+  page_id_t read_ahead_trigger_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// int_comparator.h
+//
+// Identification: src/include/storage/index/int_comparator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+namespace bustub {
+
+/**
+ * IntComparator orders integer keys for the indexes.
+ * @return -1 if lhs < rhs, 0 if they are equal, 1 if lhs > rhs
+ */
+template <typename IntType>
+class IntComparator {
+ public:
+  inline auto operator()(const IntType &lhs, const IntType &rhs) const -> int {
+    return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+  }
+};
+
+}  // namespace bustub
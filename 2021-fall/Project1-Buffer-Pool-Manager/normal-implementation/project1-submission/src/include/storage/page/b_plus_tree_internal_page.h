@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_internal_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_internal_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
+
+/**
+ * Store n indexed keys and n+1 child pointers (page_id) within internal page.
+ * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
+ * K(i) <= K < K(i+1).
+ * NOTE: since the number of keys does not equal to number of child pointers, the first key always remains invalid.
+ * That is to say, any search/lookup should ignore the first key.
+ *
+ * Internal page format (keys are stored in increasing order):
+ *  --------------------------------------------------------------------------
+ * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ *  --------------------------------------------------------------------------
+ *
+ * An internal page splits once it goes past its max size, so it needs room for max size + 1 children.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeInternalPage : public BPlusTreePage {
+ public:
+  /** @return how many children fit in a page */
+  static constexpr auto Capacity() -> int {
+    return static_cast<int>((PAGE_SIZE - sizeof(BPlusTreeInternalPage)) / sizeof(MappingType) + 1);
+  }
+
+  // must call initialize method after "create" a new node
+  void Init(page_id_t page_id, int level, int max_size = Capacity() - 1);
+
+  auto KeyAt(int index) const -> KeyType { return array_[index].first; }
+  void SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+  auto ValueAt(int index) const -> ValueType { return array_[index].second; }
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  /** @return the index of the child whose subtree holds key */
+  auto ChildIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+    return ValueAt(ChildIndex(key, comparator));
+  }
+
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  /** @return the size after the insert */
+  auto InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value) -> int;
+
+  /** Move the upper half to recipient. Its first key, invalid in recipient, is the separator to push up. */
+  void MoveHalfTo(BPlusTreeInternalPage *recipient);
+  /** Append size children; the first key is kept, for the caller to push up. */
+  void CopyNFrom(const MappingType *items, int size);
+
+ private:
+  MappingType array_[1];
+};
+
+}  // namespace bustub
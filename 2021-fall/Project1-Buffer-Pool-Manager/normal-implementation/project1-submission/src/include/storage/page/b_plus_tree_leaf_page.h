@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_leaf_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_leaf_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
+
+/**
+ * Store indexed key and value (usually a record id) together within leaf page. Only support unique key.
+ *
+ * Leaf page format (keys are stored in order):
+ *  ----------------------------------------------------------------------
+ * | HEADER | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------------
+ *
+ * Header format (size in bytes, 28 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  -----------------------------------------------
+ * | Level (4) | PageId (4) | NextPageId (4)
+ *  -----------------------------------------------
+ *
+ * A leaf splits as soon as it reaches its max size, so it holds at most max size - 1 entries between operations.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeLeafPage : public BPlusTreePage {
+ public:
+  /** @return how many entries fit in a page */
+  static constexpr auto Capacity() -> int {
+    return static_cast<int>((PAGE_SIZE - sizeof(BPlusTreeLeafPage)) / sizeof(MappingType) + 1);
+  }
+
+  // After creating a new leaf page from buffer pool, must call initialize method to set default values
+  void Init(page_id_t page_id, int max_size = Capacity());
+
+  // helper methods
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  auto KeyAt(int index) const -> KeyType { return array_[index].first; }
+  auto ValueAt(int index) const -> ValueType { return array_[index].second; }
+  auto GetItem(int index) const -> const MappingType & { return array_[index]; }
+
+  /** @return the index of the first key not less than key, GetSize() if there is none */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  // insert and delete methods
+  /** @return the size after the insert; unchanged if key was already present */
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> int;
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+  /** @return the size after the delete; unchanged if key was not present */
+  auto RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> int;
+
+  // Split and Merge utility methods
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  /** Append size sorted entries, all greater than the ones already in the page. */
+  void CopyNFrom(const MappingType *items, int size);
+
+ private:
+  page_id_t next_page_id_;
+  MappingType array_[1];
+};
+
+}  // namespace bustub
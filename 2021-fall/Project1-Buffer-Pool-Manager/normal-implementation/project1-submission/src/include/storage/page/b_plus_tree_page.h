@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "common/config.h"
+
+namespace bustub {
+
+#define MappingType std::pair<KeyType, ValueType>
+
+#define INDEX_TEMPLATE_ARGUMENTS template <typename KeyType, typename ValueType, typename KeyComparator>
+
+// define page type enum
+enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
+
+/**
+ * Both internal and leaf page are inherited from this page.
+ *
+ * It actually serves as a header part for each B+ tree page and contains information shared by both leaf page and
+ * internal page. Nodes keep no parent pointer: writers remember the path they latched on the way down instead, so a
+ * split never has to touch the children it moves. The level tells a reader on the way down whether the children of a
+ * node are leaves before it latches them.
+ *
+ * Header format (size in bytes, 24 bytes in total):
+ * ----------------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | Level (4) | PageId (4) |
+ * ----------------------------------------------------------------------------
+ */
+class BPlusTreePage {
+ public:
+  auto IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
+  void SetPageType(IndexPageType page_type) { page_type_ = page_type; }
+
+  auto GetSize() const -> int { return size_; }
+  void SetSize(int size) { size_ = size; }
+  void IncreaseSize(int amount) { size_ += amount; }
+
+  auto GetMaxSize() const -> int { return max_size_; }
+  void SetMaxSize(int max_size) { max_size_ = max_size; }
+
+  /** @return 0 for a leaf, one more than the level of its children for an internal page */
+  auto GetLevel() const -> int { return level_; }
+  void SetLevel(int level) { level_ = level; }
+
+  auto GetPageId() const -> page_id_t { return page_id_; }
+  void SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+  auto GetLSN() const -> lsn_t { return lsn_; }
+  void SetLSN(lsn_t lsn = INVALID_LSN) { lsn_ = lsn; }
+
+ private:
+  // member variable, attributes that both internal and leaf page need
+  IndexPageType page_type_;
+  lsn_t lsn_;
+  int size_;
+  int max_size_;
+  int level_;
+  page_id_t page_id_;
+};
+
+/**
+ * BPlusTreeHeaderPage is the entry point of a B+ tree. Changing the root takes its write latch, so that a reader
+ * holding its read latch sees a root that stays the root until it has latched it.
+ */
+class BPlusTreeHeaderPage {
+ public:
+  page_id_t root_page_id_;
+  /** Level of the root, 0 while the root is a leaf */
+  int root_level_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_segment_page.h
+//
+// Identification: src/include/storage/page/column_segment_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "common/config.h"
+#include "execution/vector/data_chunk.h"
+#include "execution/vector/vector_predicate.h"
+
+namespace bustub {
+
+/** How the values of a column segment are stored. */
+enum class SegmentEncoding : uint8_t {
+  /** INTEGER: value - base, packed in bit_width bits */
+  BITPACK,
+  /** INTEGER: runs of equal values, each a value and the row its run ends at */
+  RLE,
+  /** INTEGER or TEXT: the sorted distinct values, and one code per row packed in bit_width bits */
+  DICTIONARY,
+  /** TEXT: the strings one after the other; REAL: the values */
+  PLAIN,
+};
+
+/**
+ * ColumnSegmentPage holds the values of one column for a range of consecutive rows of a columnar table, compressed
+ * with the encoding that takes the least space for them. A scan only fetches the segments of the columns it needs,
+ * and compares the codes to a constant without decoding them: a comparison becomes a range of codes, since both the
+ * frame of reference and the sorted dictionary keep the order of the values.
+ *
+ * Bit widths are 0, 1, 2, 4, 8, 16, 32 or 64, so that the codes of a width of 8 or more are a plain array that the
+ * compiler vectorizes the comparison loops over, and the narrower ones never straddle a byte.
+ *
+ * Page format (size in bytes):
+ *  --------------------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | NextPageId (4) | RowCount (4) | StartRow (8) | Base (8) | EntryCount (4) |
+ *  --------------------------------------------------------------------------------------------------
+ *  -------------------------------------------------------------------------------------------
+ * | Type (1) | Encoding (1) | BitWidth (1) | HasNulls (1) | NullBitmap | encoding regions ... |
+ *  -------------------------------------------------------------------------------------------
+ *
+ * Each region starts on an 8-byte boundary. The null bitmap, with a set bit per NULL row, is only there if a row is
+ * NULL; a NULL row holds code 0. EntryCount is the number of runs of RLE and of values of DICTIONARY. The regions are:
+ *  BITPACK:         codes
+ *  RLE:             run values (8 each) | run ends (4 each)
+ *  DICTIONARY:      INTEGER: values (8 each) | codes; TEXT: offsets (4 each, EntryCount + 1) | codes | bytes
+ *  PLAIN:           TEXT: offsets (4 each, RowCount + 1) | bytes; REAL: values (8 each)
+ */
+class ColumnSegmentPage {
+ public:
+  static constexpr size_t HEADER_SIZE = 40;
+  /** Bytes for the regions */
+  static constexpr size_t DATA_SIZE = PAGE_SIZE - HEADER_SIZE;
+
+  static constexpr auto Align8(size_t size) -> size_t { return (size + 7) & ~static_cast<size_t>(7); }
+
+  /** @return the smallest supported bit width that holds max_code */
+  static constexpr auto BitWidth(uint64_t max_code) -> uint8_t {
+    uint8_t width = 0;
+    while (width < 64 && (max_code >> width) != 0) {
+      width = width == 0 ? 1 : width * 2;
+    }
+    return width;
+  }
+
+  /** @return the size of the region of count codes of a width */
+  static constexpr auto PackedSize(size_t count, uint8_t width) -> size_t { return Align8((count * width + 7) / 8); }
+
+  /** @return the size of the null bitmap of count rows */
+  static constexpr auto NullBitmapSize(size_t count, bool has_nulls) -> size_t {
+    return has_nulls ? Align8((count + 7) / 8) : 0;
+  }
+
+  /**
+   * @return the bytes the regions of an INTEGER segment take
+   * @param range max - min of the values, as unsigned
+   * @param num_runs runs of equal values, NULL rows extending the run before them
+   * @param num_distinct distinct values
+   */
+  static constexpr auto IntegerSize(SegmentEncoding encoding, size_t count, bool has_nulls, uint64_t range,
+                                    size_t num_runs, size_t num_distinct) -> size_t {
+    size_t size = NullBitmapSize(count, has_nulls);
+    switch (encoding) {
+      case SegmentEncoding::BITPACK:
+        return size + PackedSize(count, BitWidth(range));
+      case SegmentEncoding::RLE:
+        return size + Align8(num_runs * sizeof(int64_t)) + Align8(num_runs * sizeof(uint32_t));
+      case SegmentEncoding::DICTIONARY:
+        return size + num_distinct * sizeof(int64_t) + PackedSize(count, CodeWidth(num_distinct));
+      case SegmentEncoding::PLAIN:
+        break;
+    }
+    return SIZE_MAX;
+  }
+
+  /**
+   * @return the bytes the regions of a TEXT segment take
+   * @param num_distinct distinct values
+   * @param distinct_bytes bytes of the distinct values
+   * @param total_bytes bytes of all the values
+   */
+  static constexpr auto TextSize(SegmentEncoding encoding, size_t count, bool has_nulls, size_t num_distinct,
+                                 size_t distinct_bytes, size_t total_bytes) -> size_t {
+    size_t size = NullBitmapSize(count, has_nulls);
+    switch (encoding) {
+      case SegmentEncoding::DICTIONARY:
+        return size + Align8((num_distinct + 1) * sizeof(uint32_t)) + PackedSize(count, CodeWidth(num_distinct)) +
+               distinct_bytes;
+      case SegmentEncoding::PLAIN:
+        return size + Align8((count + 1) * sizeof(uint32_t)) + total_bytes;
+      case SegmentEncoding::BITPACK:
+      case SegmentEncoding::RLE:
+        break;
+    }
+    return SIZE_MAX;
+  }
+
+  /** @return the bytes the regions of a REAL segment take */
+  static constexpr auto RealSize(size_t count, bool has_nulls) -> size_t {
+    return NullBitmapSize(count, has_nulls) + count * sizeof(double);
+  }
+
+  /** @return the bit width of the codes of a dictionary */
+  static constexpr auto CodeWidth(size_t num_distinct) -> uint8_t {
+    return num_distinct <= 1 ? 0 : BitWidth(num_distinct - 1);
+  }
+
+  /**
+   * Encode INTEGER values into the page.
+   * @param page_id id of the page
+   * @param start_row row of the table the first value belongs to
+   * @param values values of the rows, anything for a NULL row
+   * @param nulls non-zero for the NULL rows
+   * @param count number of rows
+   * @param encoding BITPACK, RLE or DICTIONARY; the caller checked that it fits
+   */
+  void WriteIntegers(page_id_t page_id, uint64_t start_row, const int64_t *values, const uint8_t *nulls,
+                     uint32_t count, SegmentEncoding encoding);
+
+  /** Encode TEXT values into the page, with DICTIONARY or PLAIN encoding. */
+  void WriteTexts(page_id_t page_id, uint64_t start_row, const std::string_view *values, const uint8_t *nulls,
+                  uint32_t count, SegmentEncoding encoding);
+
+  /** Store REAL values into the page, with PLAIN encoding. */
+  void WriteReals(page_id_t page_id, uint64_t start_row, const double *values, const uint8_t *nulls, uint32_t count);
+
+  auto GetPageId() const -> page_id_t { return page_id_; }
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  auto GetRowCount() const -> uint32_t { return row_count_; }
+  auto GetStartRow() const -> uint64_t { return start_row_; }
+  auto GetType() const -> ColumnType { return type_; }
+  auto GetEncoding() const -> SegmentEncoding { return encoding_; }
+  auto GetBitWidth() const -> uint8_t { return bit_width_; }
+
+  auto IsNull(uint32_t row) const -> bool {
+    return has_nulls_ != 0 && (reinterpret_cast<const uint8_t *>(data_)[row / 8] & (1U << (row % 8))) != 0;
+  }
+
+  /**
+   * Append the values of some rows to a column.
+   * @param rows rows of the segment, in increasing order
+   * @param count number of rows
+   * @param[out] out column of the type of the segment
+   */
+  void Gather(const uint32_t *rows, size_t count, ColumnVector *out) const;
+
+  /**
+   * Compare a range of rows with a constant, on the compressed values. NULL rows never match.
+   * @param type comparison
+   * @param constant constant of an INTEGER segment
+   * @param begin first row of the segment to compare
+   * @param count number of rows
+   * @param[out] match receives 1 for the rows that match and 0 for the others
+   */
+  void Match(ComparisonType type, int64_t constant, uint32_t begin, uint32_t count, uint8_t *match) const;
+
+  /** Compare a range of rows of a TEXT segment with a string. REAL segments are not compared. */
+  void Match(ComparisonType type, std::string_view constant, uint32_t begin, uint32_t count, uint8_t *match) const;
+
+ private:
+  void Init(page_id_t page_id, uint64_t start_row, uint32_t count, ColumnType type, SegmentEncoding encoding,
+            const uint8_t *nulls);
+
+  /** @return the first region after the null bitmap */
+  auto Regions() -> char * { return data_ + NullBitmapSize(row_count_, has_nulls_ != 0); }
+  auto Regions() const -> const char * { return data_ + NullBitmapSize(row_count_, has_nulls_ != 0); }
+
+  /** Clear the matches of the NULL rows, and flip the others if negate. */
+  void FinishMatch(bool negate, uint32_t begin, uint32_t count, uint8_t *match) const;
+
+  /** Match the rows whose code is in [lo, hi]. */
+  void MatchCodes(const char *codes, uint64_t lo, uint64_t hi, uint32_t begin, uint32_t count, uint8_t *match) const;
+
+  page_id_t page_id_;
+  lsn_t lsn_;
+  page_id_t next_page_id_;
+  uint32_t row_count_;
+  uint64_t start_row_;
+  int64_t base_;
+  uint32_t entry_count_;
+  ColumnType type_;
+  SegmentEncoding encoding_;
+  uint8_t bit_width_;
+  uint8_t has_nulls_;
+  char data_[DATA_SIZE];
+};
+
+}  // namespace bustub
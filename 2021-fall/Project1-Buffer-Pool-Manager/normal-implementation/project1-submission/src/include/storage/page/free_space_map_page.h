@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMapPage is a bitmap of allocated pages, one bit per page of its group. It is laid over the data of a
+ * buffer pool page with reinterpret_cast. An all-zero page, which is what a read past the end of the file returns,
+ * is a valid empty map.
+ *
+ * Page format:
+ *  -------------------------------------------------------
+ * | NumAllocated (4) |    LSN (4)   | Bits (PAGE_SIZE - 8) |
+ *  -------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  static constexpr size_t HEADER_SIZE = 8;
+  /** Pages tracked by one map page */
+  static constexpr uint32_t NUM_BITS = (PAGE_SIZE - HEADER_SIZE) * 8;
+
+  /** @return whether page number bit of the group is allocated */
+  auto IsAllocated(uint32_t bit) const -> bool { return (bits_[bit / 8] & (1U << (bit % 8))) != 0; }
+
+  /** Mark page number bit of the group allocated or free. */
+  void SetAllocated(uint32_t bit, bool allocated) {
+    if (IsAllocated(bit) == allocated) {
+      return;
+    }
+    if (allocated) {
+      bits_[bit / 8] |= static_cast<uint8_t>(1U << (bit % 8));
+      ++num_allocated_;
+    } else {
+      bits_[bit / 8] &= static_cast<uint8_t>(~(1U << (bit % 8)));
+      --num_allocated_;
+    }
+  }
+
+  /** @return whether every page of the group is allocated */
+  auto IsFull() const -> bool { return num_allocated_ == NUM_BITS; }
+
+  /**
+   * @param start first bit to look at
+   * @return the lowest free bit at or after start, or NUM_BITS if there is none
+   */
+  auto FindFree(uint32_t start) const -> uint32_t {
+    for (uint32_t byte = start / 8; byte < sizeof(bits_); ++byte) {
+      if (bits_[byte] == 0xFF) {
+        continue;
+      }
+      for (uint32_t bit = byte * 8; bit < byte * 8 + 8; ++bit) {
+        if (bit >= start && !IsAllocated(bit)) {
+          return bit;
+        }
+      }
+    }
+    return NUM_BITS;
+  }
+
+  /**
+   * @param start first bit to look at
+   * @param count length of the run
+   * @return the first bit of the lowest run of count free bits at or after start, or NUM_BITS if there is none
+   */
+  auto FindFreeRun(uint32_t start, uint32_t count) const -> uint32_t {
+    uint32_t run = 0;
+    for (uint32_t bit = FindFree(start); bit < NUM_BITS; ++bit) {
+      if (IsAllocated(bit)) {
+        run = 0;
+        bit = FindFree(bit) - 1;
+        continue;
+      }
+      if (++run == count) {
+        return bit + 1 - count;
+      }
+    }
+    return NUM_BITS;
+  }
+
+ private:
+  uint32_t num_allocated_;
+  /** Page LSN, at the offset Page::GetLSN reads it from. */
+  lsn_t lsn_;
+  uint8_t bits_[PAGE_SIZE - HEADER_SIZE];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) == PAGE_SIZE, "FreeSpaceMapPage must fill a page exactly.");
+
+}  // namespace bustub
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/hash_table_bucket_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ * Store indexed key and value together within bucket page. Supports non-unique keys.
+ *
+ * Bucket page format (keys are stored in no particular order):
+ *  ----------------------------------------------------------------
+ * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------
+ *
+ *  Here '+' means concatenation.
+ *  The above format omits the space required for the occupied_ and readable_ arrays. More information is in
+ *  storage/page/hash_table_page_defs.h.
+ *
+ * A slot is occupied once it has held a pair and readable while it holds one, so a lookup stops at the first slot
+ * that was never occupied. An all-zero page is an empty bucket.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBucketPage() = delete;
+
+  /**
+   * Scan the bucket and collect values that have the matching key
+   * @return true if at least one key matched
+   */
+  auto GetValue(const KeyType &key, const KeyComparator &cmp, std::vector<ValueType> *result) const -> bool;
+
+  /**
+   * Attempts to insert a key and value in the bucket. Uses the occupied_ and readable_ arrays to keep track of each
+   * slot's availability.
+   * @return true if inserted, false if duplicate KV pair or bucket is full
+   */
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &cmp) -> bool;
+
+  /**
+   * Removes a key and value.
+   * @return true if removed, false if not found
+   */
+  auto Remove(const KeyType &key, const ValueType &value, const KeyComparator &cmp) -> bool;
+
+  /** @return whether the bucket holds this exact pair */
+  auto Contains(const KeyType &key, const ValueType &value, const KeyComparator &cmp) const -> bool;
+
+  auto KeyAt(uint32_t bucket_idx) const -> KeyType { return array_[bucket_idx].first; }
+  auto ValueAt(uint32_t bucket_idx) const -> ValueType { return array_[bucket_idx].second; }
+
+  /** Remove the KV pair at bucket_idx */
+  void RemoveAt(uint32_t bucket_idx) { readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8))); }
+
+  /**
+   * Returns whether or not an index is occupied (key/value pair or tombstone)
+   */
+  auto IsOccupied(uint32_t bucket_idx) const -> bool { return (occupied_[bucket_idx / 8] >> (bucket_idx % 8)) & 1; }
+  void SetOccupied(uint32_t bucket_idx) { occupied_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8)); }
+
+  /**
+   * Returns whether or not an index is readable (valid key/value pair)
+   */
+  auto IsReadable(uint32_t bucket_idx) const -> bool { return (readable_[bucket_idx / 8] >> (bucket_idx % 8)) & 1; }
+  void SetReadable(uint32_t bucket_idx) { readable_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8)); }
+
+  /** @return the number of readable elements, i.e. current size */
+  auto NumReadable() const -> uint32_t;
+
+  /** @return whether the bucket is full */
+  auto IsFull() const -> bool { return NumReadable() == BUCKET_ARRAY_SIZE; }
+
+  /** @return whether the bucket is empty */
+  auto IsEmpty() const -> bool { return NumReadable() == 0; }
+
+  /** Copy out every readable pair. */
+  void GetAllItems(std::vector<MappingType> *items) const;
+
+  /** Empty the bucket, tombstones included. */
+  void Clear();
+
+ private:
+  //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
+  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  // 0 if tombstone/brand new (never occupied), 1 otherwise.
+  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  MappingType array_[BUCKET_ARRAY_SIZE];
+};
+
+}  // namespace bustub
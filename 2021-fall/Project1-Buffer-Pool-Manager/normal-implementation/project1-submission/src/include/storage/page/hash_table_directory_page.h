@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ * Directory Page for extendible hash table.
+ *
+ * Directory format (size in bytes):
+ * --------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Free(1524)
+ * --------------------------------------------------------------------------------------------
+ *
+ * An all-zero page is not a valid directory, ExtendibleHashTable initializes it when it creates the table.
+ */
+class HashTableDirectoryPage {
+ public:
+  /** Largest global depth the directory can hold. */
+  static constexpr uint32_t MAX_DEPTH = 9;
+  static_assert((1U << MAX_DEPTH) == DIRECTORY_ARRAY_SIZE, "The directory holds 2^MAX_DEPTH buckets.");
+
+  auto GetPageId() const -> page_id_t { return page_id_; }
+  void SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+  auto GetLSN() const -> lsn_t { return lsn_; }
+  void SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+  /** @return the page id of the bucket at bucket_idx */
+  auto GetBucketPageId(uint32_t bucket_idx) const -> page_id_t { return bucket_page_ids_[bucket_idx]; }
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) { bucket_page_ids_[bucket_idx] = bucket_page_id; }
+
+  /** @return the directory index of the split image of the bucket at bucket_idx, whose local depth is not 0 */
+  auto GetSplitImageIndex(uint32_t bucket_idx) const -> uint32_t {
+    return bucket_idx ^ (1U << (local_depths_[bucket_idx] - 1));
+  }
+
+  /** @return the mask of global_depth 1's and the rest 0's, which maps a hash to its directory index */
+  auto GetGlobalDepthMask() const -> uint32_t { return (1U << global_depth_) - 1; }
+  /** @return the mask of the bits of the hash the bucket at bucket_idx is selected by */
+  auto GetLocalDepthMask(uint32_t bucket_idx) const -> uint32_t { return (1U << local_depths_[bucket_idx]) - 1; }
+
+  auto GetGlobalDepth() const -> uint32_t { return global_depth_; }
+  void SetGlobalDepth(uint32_t global_depth) { global_depth_ = global_depth; }
+
+  /** Double the directory, the upper half pointing to the same buckets as the lower half. */
+  void IncrGlobalDepth();
+
+  /** @return the current directory size */
+  auto Size() const -> uint32_t { return 1U << global_depth_; }
+
+  auto GetLocalDepth(uint32_t bucket_idx) const -> uint32_t { return local_depths_[bucket_idx]; }
+  void SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) { local_depths_[bucket_idx] = local_depth; }
+
+  /** @return the bit that tells the bucket at bucket_idx from its split image */
+  auto GetLocalHighBit(uint32_t bucket_idx) const -> uint32_t { return 1U << local_depths_[bucket_idx]; }
+
+  /**
+   * Verify the following invariants:
+   * (1) All LD <= GD.
+   * (2) Each bucket has precisely 2^(GD - LD) pointers pointing to it.
+   * (3) The LD is the same at each index with the same bucket_page_id
+   */
+  void VerifyIntegrity() const;
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t global_depth_{0};
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
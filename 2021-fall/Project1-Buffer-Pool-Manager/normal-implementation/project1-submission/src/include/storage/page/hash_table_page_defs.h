@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_page_defs.h
+//
+// Identification: src/include/storage/page/hash_table_page_defs.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#define MappingType std::pair<KeyType, ValueType>
+
+/**
+ * Extendible Hashing Definitions
+ */
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
+
+/**
+ * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
+ * It is an approximate calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType).
+ * For each key/value pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof
+ * (MappingType) + 1) = PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to
+ * maintain the occupied and readable flags for a key value pair.
+ */
+#define BUCKET_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+
+/**
+ * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
+ * This is 512 because the directory array must grow in powers of 2, and 1024 page_ids leaves zero room for
+ * storage of the other member variables: page_id_, lsn_, global_depth_, and the array local_depths_.
+ * Extending the directory implementation to span multiple pages would be a meaningful improvement to the
+ * implementation.
+ */
+#define DIRECTORY_ARRAY_SIZE 512
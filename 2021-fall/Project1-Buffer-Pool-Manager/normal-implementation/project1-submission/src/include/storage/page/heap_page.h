@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// heap_page.h
+//
+// Identification: src/include/storage/page/heap_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * HeapPage is a slotted page of variable-length tuples, laid out like TablePage. Tuples are packed from the end of the
+ * page towards the slot array; a page of a heap links to the previous and the next one.
+ *
+ * Slotted page format:
+ *  ---------------------------------------------------------
+ *  | HEADER | ... FREE SPACE ... | ... INSERTED TUPLES ... |
+ *  ---------------------------------------------------------
+ *                                ^
+ *                                free space pointer
+ *
+ * Header format (size in bytes, 24 bytes plus 8 per slot):
+ *  ----------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
+ *  ----------------------------------------------------------------------------
+ *  ----------------------------------------------------------------
+ *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  ----------------------------------------------------------------
+ *
+ * Tuples are only appended: the bulk loader fills the pages of a heap once and never updates them.
+ */
+class HeapPage {
+ public:
+  struct Slot {
+    uint32_t offset_;
+    uint32_t size_;
+  };
+
+  static constexpr uint32_t HEADER_SIZE = 24;
+  /** The largest tuple that fits in an empty page. */
+  static constexpr uint32_t MAX_TUPLE_SIZE = PAGE_SIZE - HEADER_SIZE - sizeof(Slot);
+
+  /** Initialize a new page as the empty page of a heap that follows prev_page_id. */
+  void Init(page_id_t page_id, page_id_t prev_page_id);
+
+  auto GetPageId() const -> page_id_t { return page_id_; }
+  auto GetLSN() const -> lsn_t { return lsn_; }
+  void SetLSN(lsn_t lsn) { lsn_ = lsn; }
+  auto GetPrevPageId() const -> page_id_t { return prev_page_id_; }
+  void SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  auto GetTupleCount() const -> uint32_t { return tuple_count_; }
+
+  /** @return the bytes left for tuples and their slots */
+  auto GetFreeSpaceRemaining() const -> uint32_t {
+    return free_space_pointer_ - HEADER_SIZE - tuple_count_ * static_cast<uint32_t>(sizeof(Slot));
+  }
+
+  /**
+   * Append a tuple. It gets slot GetTupleCount() - 1.
+   * @param data bytes of the tuple
+   * @param size size of the tuple, not 0
+   * @return false if the page has no room for it
+   */
+  auto InsertTuple(const char *data, uint32_t size) -> bool;
+
+  /**
+   * @param slot slot of the tuple, less than GetTupleCount()
+   * @param[out] size size of the tuple
+   * @return the bytes of the tuple
+   */
+  auto GetTuple(uint32_t slot, uint32_t *size) const -> const char * {
+    *size = slots_[slot].size_;
+    return reinterpret_cast<const char *>(this) + slots_[slot].offset_;
+  }
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  page_id_t prev_page_id_;
+  page_id_t next_page_id_;
+  uint32_t free_space_pointer_;
+  uint32_t tuple_count_;
+  Slot slots_[1];
+};
+
+}  // namespace bustub
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page.h
+//
+// Identification: src/include/storage/page/page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "common/config.h"
+#include "common/rwlatch.h"
+
+namespace bustub {
+
+/**
+ * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
+ * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
+ * pin count, dirty flag, page id, etc.
+ */
+class Page {
+  // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
+  friend class BufferPoolManagerInstance;
+
+ public:
+  /** Constructor. Zeros out the page data. */
+  Page() { ResetMemory(); }
+
+  /** Default destructor. */
+  ~Page() = default;
+
+  /** @return the actual data contained within this page */
+  inline auto GetData() -> char * { return data_; }
+
+  /** @return the page id of this page */
+  inline auto GetPageId() -> page_id_t { return page_id_; }
+
+  /** @return the pin count of this page */
+  inline auto GetPinCount() -> int { return pin_count_; }
+
+  /** @return true if the page in memory has been modified from the page on disk, false otherwise */
+  inline auto IsDirty() -> bool { return is_dirty_; }
+
+  /** Acquire the page write latch. Optimistic readers fail validation until WUnlatch. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    BeginUpdate();
+  }
+
+  /** Release the page write latch. */
+  inline void WUnlatch() {
+    EndUpdate();
+    rwlatch_.WUnlock();
+  }
+
+  /** Acquire the page read latch. */
+  inline void RLatch() { rwlatch_.RLock(); }
+
+  /** Release the page read latch. */
+  inline void RUnlatch() { rwlatch_.RUnlock(); }
+
+  /** @return the page LSN. */
+  inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
+
+  /** Sets the page LSN. */
+  inline void SetLSN(lsn_t lsn) { memcpy(GetData() + OFFSET_LSN, &lsn, sizeof(lsn_t)); }
+
+ protected:
+  static_assert(sizeof(page_id_t) == 4);
+  static_assert(sizeof(lsn_t) == 4);
+
+  static constexpr size_t SIZE_PAGE_HEADER = 8;
+  static constexpr size_t OFFSET_PAGE_START = 0;
+  static constexpr size_t OFFSET_LSN = 4;
+
+ private:
+  /** Zeroes out the data that is held within the page. */
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
+
+  /** Make the version odd: the content or identity of the frame is about to change. */
+  inline void BeginUpdate() {
+    version_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /** Make the version even again, publishing the change. */
+  inline void EndUpdate() { version_.fetch_add(1, std::memory_order_release); }
+
+  /** The actual data that is stored within a page. */
+  char data_[PAGE_SIZE]{};
+  /** The ID of this page. */
+  page_id_t page_id_ = INVALID_PAGE_ID;
+  /**
+   * The pin count of this page. Pins are taken under the BPI latch, but page guards release them with a plain
+   * atomic decrement, so the count must be atomic.
+   */
+  std::atomic<int> pin_count_ = 0;
+  /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
+  std::atomic<bool> is_dirty_ = false;
+  /**
+   * End of the log when the frame last matched the disk. Every record that dirtied the page since has an LSN at or
+   * past it, which makes it the recovery LSN of the page while the page is dirty.
+   */
+  std::atomic<lsn_t> rec_lsn_ = INVALID_LSN;
+  /** Page latch. */
+  ReaderWriterLatch rwlatch_;
+  /**
+   * Seqlock version of the frame, odd while a writer holds the write latch or the buffer pool is replacing the page
+   * in this frame. Optimistic readers validate against it instead of pinning.
+   */
+  std::atomic<uint64_t> version_ = 0;
+};
+
+}  // namespace bustub
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.h
+//
+// Identification: src/include/storage/page/page_guard.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "common/config.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+class BufferPoolManagerInstance;
+
+/**
+ * BasicPageGuard owns one pin on a page and gives it back when it goes out of scope, so callers no longer pair
+ * FetchPage with UnpinPage by hand. It is move-only; a moved-from or dropped guard is empty.
+ */
+class BasicPageGuard {
+ public:
+  BasicPageGuard() = default;
+
+  BasicPageGuard(BufferPoolManagerInstance *bpm, Page *page, frame_id_t frame_id)
+      : bpm_(bpm), page_(page), frame_id_(frame_id) {}
+
+  BasicPageGuard(const BasicPageGuard &) = delete;
+  auto operator=(const BasicPageGuard &) -> BasicPageGuard & = delete;
+
+  BasicPageGuard(BasicPageGuard &&that) noexcept;
+  auto operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard &;
+
+  ~BasicPageGuard();
+
+  /** Unpin the page now. The guard is empty afterwards. */
+  void Drop();
+
+  /** @return false if the guard does not hold a page (fetch failed, moved-from or dropped) */
+  auto IsValid() const -> bool { return page_ != nullptr; }
+
+  auto PageId() -> page_id_t { return page_->GetPageId(); }
+
+  auto GetData() -> const char * { return page_->GetData(); }
+
+  template <class T>
+  auto As() -> const T * {
+    return reinterpret_cast<const T *>(GetData());
+  }
+
+  /** Mutable access marks the page dirty, it will be written back when evicted. */
+  auto GetDataMut() -> char * {
+    is_dirty_ = true;
+    return page_->GetData();
+  }
+
+  template <class T>
+  auto AsMut() -> T * {
+    return reinterpret_cast<T *>(GetDataMut());
+  }
+
+ protected:
+  friend class BufferPoolManagerInstance;
+  friend class ReadPageGuard;
+  friend class WritePageGuard;
+
+  BufferPoolManagerInstance *bpm_{nullptr};
+  Page *page_{nullptr};
+  frame_id_t frame_id_{-1};
+  bool is_dirty_{false};
+};
+
+/**
+ * ReadPageGuard holds a pin and the read latch of a page. Both are released in that order on destruction.
+ */
+class ReadPageGuard {
+ public:
+  ReadPageGuard() = default;
+
+  /** Takes over the pin of guard; the read latch must already be held. */
+  explicit ReadPageGuard(BasicPageGuard &&guard) : guard_(std::move(guard)) {}
+
+  ReadPageGuard(const ReadPageGuard &) = delete;
+  auto operator=(const ReadPageGuard &) -> ReadPageGuard & = delete;
+
+  ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+  auto operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard &;
+
+  ~ReadPageGuard();
+
+  /** Release the read latch and unpin the page now. The guard is empty afterwards. */
+  void Drop();
+
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
+  auto PageId() -> page_id_t { return guard_.PageId(); }
+
+  auto GetData() -> const char * { return guard_.GetData(); }
+
+  template <class T>
+  auto As() -> const T * {
+    return guard_.As<T>();
+  }
+
+ private:
+  friend class BufferPoolManagerInstance;
+
+  BasicPageGuard guard_;
+};
+
+/**
+ * WritePageGuard holds a pin and the write latch of a page. The page is marked dirty as soon as its data is accessed
+ * mutably, and the latch and pin are released in that order on destruction.
+ */
+class WritePageGuard {
+ public:
+  WritePageGuard() = default;
+
+  /** Takes over the pin of guard; the write latch must already be held. */
+  explicit WritePageGuard(BasicPageGuard &&guard) : guard_(std::move(guard)) {}
+
+  WritePageGuard(const WritePageGuard &) = delete;
+  auto operator=(const WritePageGuard &) -> WritePageGuard & = delete;
+
+  WritePageGuard(WritePageGuard &&that) noexcept = default;
+  auto operator=(WritePageGuard &&that) noexcept -> WritePageGuard &;
+
+  ~WritePageGuard();
+
+  /** Release the write latch and unpin the page now. The guard is empty afterwards. */
+  void Drop();
+
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
+  auto PageId() -> page_id_t { return guard_.PageId(); }
+
+  auto GetData() -> const char * { return guard_.GetData(); }
+
+  template <class T>
+  auto As() -> const T * {
+    return guard_.As<T>();
+  }
+
+  auto GetDataMut() -> char * { return guard_.GetDataMut(); }
+
+  template <class T>
+  auto AsMut() -> T * {
+    return guard_.AsMut<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+}  // namespace bustub
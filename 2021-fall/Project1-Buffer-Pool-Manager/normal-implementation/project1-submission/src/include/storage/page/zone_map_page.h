@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map_page.h
+//
+// Identification: src/include/storage/page/zone_map_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ZoneEntry summarizes the values of one column on one page: the smallest and the largest of them. A page with no
+ * value in the column, only NULLs, has min_ > max_ and matches no comparison.
+ */
+struct ZoneEntry {
+  /** The page summarized */
+  page_id_t page_id_;
+  uint32_t row_count_;
+  int64_t min_;
+  int64_t max_;
+
+  /** @return whether a value of the page may be in [lo, hi] */
+  auto Overlaps(int64_t lo, int64_t hi) const -> bool { return min_ <= hi && lo <= max_ && min_ <= max_; }
+};
+
+/**
+ * ZoneMapPage holds the zone entries of consecutive pages of a table, in the order of the table. The pages of a zone
+ * map are chained.
+ *
+ * Page format (size in bytes):
+ *  ------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | NextPageId (4) | EntryCount (4) | Entry_1 (24) | Entry_2 ... |
+ *  ------------------------------------------------------------------------------------
+ */
+class ZoneMapPage {
+ public:
+  static constexpr size_t HEADER_SIZE = 16;
+  /** Entries of one page */
+  static constexpr uint32_t CAPACITY = (PAGE_SIZE - HEADER_SIZE) / sizeof(ZoneEntry);
+
+  void Init(page_id_t page_id) {
+    page_id_ = page_id;
+    lsn_ = INVALID_LSN;
+    next_page_id_ = INVALID_PAGE_ID;
+    entry_count_ = 0;
+  }
+
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  auto GetEntryCount() const -> uint32_t { return entry_count_; }
+  auto IsFull() const -> bool { return entry_count_ == CAPACITY; }
+
+  auto GetEntry(uint32_t index) const -> const ZoneEntry & { return entries_[index]; }
+
+  /** Append an entry to a page that is not full. */
+  void Append(const ZoneEntry &entry) { entries_[entry_count_++] = entry; }
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  page_id_t next_page_id_;
+  uint32_t entry_count_;
+  ZoneEntry entries_[CAPACITY];
+};
+
+static_assert(sizeof(ZoneEntry) == 24, "ZoneEntry is stored as is.");
+static_assert(sizeof(ZoneMapPage) <= PAGE_SIZE, "ZoneMapPage must fit in a page.");
+
+}  // namespace bustub
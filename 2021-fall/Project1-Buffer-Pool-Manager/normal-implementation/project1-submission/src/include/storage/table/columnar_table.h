@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// columnar_table.h
+//
+// Identification: src/include/storage/table/columnar_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "execution/vector/data_chunk.h"
+#include "storage/page/column_segment_page.h"
+#include "storage/table/sqlite_bulk_loader.h"
+#include "storage/table/zone_map.h"
+
+namespace bustub {
+
+/**
+ * ColumnSegment is the entry of a ColumnSegmentPage in the directory of its column.
+ */
+struct ColumnSegment {
+  page_id_t page_id_{INVALID_PAGE_ID};
+  uint64_t start_row_{0};
+  uint32_t row_count_{0};
+  SegmentEncoding encoding_{SegmentEncoding::PLAIN};
+};
+
+/**
+ * ColumnarTable describes a table stored one column at a time, each column in its own chain of ColumnSegmentPage.
+ * The segments of the columns do not line up: each holds as many rows as its encoding fits in a page.
+ */
+struct ColumnarTable {
+  std::string name_;
+  std::vector<std::string> column_names_;
+  std::vector<ColumnType> column_types_;
+  uint64_t row_count_{0};
+  /** Per column, its segments in row order */
+  std::vector<std::vector<ColumnSegment>> segments_;
+  /** Per column, the zone of each of its segments; empty for the columns that are not INTEGER */
+  std::vector<ZoneMap> zone_maps_;
+
+  /** @return the bytes of all the segment and zone map pages */
+  auto GetSize() const -> uint64_t;
+};
+
+/**
+ * ColumnarTableWriter builds a ColumnarTable from chunks of rows.
+ *
+ * The rows of a column gather in a segment builder, which keeps the statistics every encoding's size follows from as
+ * values arrive: the range, the runs and the distinct values. A segment is written when the next value would make even
+ * the smallest encoding overflow a page, with the encoding that takes the least space, so a page is always filled.
+ * The range of an INTEGER segment goes to the zone map of its column at the same time.
+ */
+class ColumnarTableWriter {
+ public:
+  /** Rows of a segment at most, so that segments of long constant runs stay a useful unit to skip. */
+  static constexpr uint32_t MAX_SEGMENT_ROWS = 1 << 16;
+
+  /**
+   * @param buffer_pool_manager pool the segment pages are created in
+   * @param name name of the table
+   * @param column_names names of the columns
+   * @param column_types types of the columns
+   */
+  ColumnarTableWriter(BufferPoolManagerInstance *buffer_pool_manager, std::string name,
+                      std::vector<std::string> column_names, std::vector<ColumnType> column_types);
+
+  ~ColumnarTableWriter();
+
+  /**
+   * Append rows to the table.
+   * @param chunk rows, one column per column of the table
+   */
+  void Append(const DataChunk &chunk);
+
+  /**
+   * Write the last segments and hand the table over. The writer is empty afterwards.
+   * @param[out] table receives the table
+   */
+  void Finish(ColumnarTable *table);
+
+ private:
+  class SegmentBuilder;
+
+  ColumnarTable table_;
+  std::vector<std::unique_ptr<SegmentBuilder>> builders_;
+};
+
+/**
+ * Copy a heap written by the bulk loader into a columnar table.
+ * @param buffer_pool_manager pool of the heap, and of the table
+ * @param heap heap to copy
+ * @param column_types type of every column of the heap; values of other types read as NULL
+ * @param[out] table receives the table
+ */
+void BuildColumnarTable(BufferPoolManagerInstance *buffer_pool_manager, const LoadedTable &heap,
+                        const std::vector<ColumnType> &column_types, ColumnarTable *table);
+
+}  // namespace bustub
@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// heap_row.h
+//
+// Identification: src/include/storage/table/heap_row.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/** Type of a value in a heap row; the storage classes of SQLite. */
+enum class HeapValueType : uint8_t { NULL_VALUE = 0, INTEGER, REAL, TEXT, BLOB };
+
+/**
+ * A heap row is self-describing, since the tables it is loaded from are dynamically typed: every value carries its
+ * type, and the row its column count.
+ *
+ * Row format (size in bytes):
+ *  ------------------------------------------------------------------
+ *  | ColumnCount (2) | Type (1) | Value | Type (1) | Value | ... |
+ *  ------------------------------------------------------------------
+ *
+ * An INTEGER or a REAL takes 8 bytes, a TEXT or a BLOB a 4-byte length and its bytes, and a NULL nothing. Nothing is
+ * aligned; values are copied in and out with memcpy.
+ */
+class HeapRowBuilder {
+ public:
+  /** Start a new row, keeping the buffer of the previous one. */
+  void Reset() {
+    buffer_.assign(sizeof(uint16_t), '\0');
+    column_count_ = 0;
+  }
+
+  void AppendNull() { AppendType(HeapValueType::NULL_VALUE); }
+
+  void AppendInteger(int64_t value) {
+    AppendType(HeapValueType::INTEGER);
+    buffer_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void AppendReal(double value) {
+    AppendType(HeapValueType::REAL);
+    buffer_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  /** @param type TEXT or BLOB */
+  void AppendBytes(HeapValueType type, const char *data, uint32_t size) {
+    AppendType(type);
+    buffer_.append(reinterpret_cast<const char *>(&size), sizeof(size));
+    buffer_.append(data, size);
+  }
+
+  auto GetData() const -> const char * { return buffer_.data(); }
+  auto GetSize() const -> uint32_t { return static_cast<uint32_t>(buffer_.size()); }
+
+ private:
+  void AppendType(HeapValueType type) {
+    BUSTUB_ASSERT(column_count_ < UINT16_MAX, "Too many columns.");
+    column_count_++;
+    memcpy(&buffer_[0], &column_count_, sizeof(column_count_));
+    buffer_.push_back(static_cast<char>(type));
+  }
+
+  std::string buffer_ = std::string(sizeof(uint16_t), '\0');
+  uint16_t column_count_{0};
+};
+
+/**
+ * HeapRowReader walks the values of a heap row in column order.
+ */
+class HeapRowReader {
+ public:
+  HeapRowReader(const char *data, uint32_t size) : cursor_(data + sizeof(uint16_t)), end_(data + size) {
+    memcpy(&column_count_, data, sizeof(column_count_));
+  }
+
+  auto GetColumnCount() const -> uint32_t { return column_count_; }
+
+  /** @return whether there is a value left */
+  auto HasNext() const -> bool { return cursor_ < end_; }
+
+  /**
+   * Move to the next value.
+   * @return its type
+   */
+  auto Next() -> HeapValueType {
+    value_ = cursor_ + 1;
+    type_ = static_cast<HeapValueType>(*cursor_);
+    size_t size = 0;
+    switch (type_) {
+      case HeapValueType::INTEGER:
+      case HeapValueType::REAL:
+        size = sizeof(int64_t);
+        break;
+      case HeapValueType::TEXT:
+      case HeapValueType::BLOB: {
+        uint32_t length;
+        memcpy(&length, value_, sizeof(length));
+        size = sizeof(length) + length;
+        break;
+      }
+      case HeapValueType::NULL_VALUE:
+        break;
+    }
+    cursor_ = value_ + size;
+    BUSTUB_ASSERT(cursor_ <= end_, "Heap row overruns its tuple.");
+    return type_;
+  }
+
+  auto GetType() const -> HeapValueType { return type_; }
+
+  auto GetInteger() const -> int64_t {
+    int64_t value;
+    memcpy(&value, value_, sizeof(value));
+    return value;
+  }
+
+  auto GetReal() const -> double {
+    double value;
+    memcpy(&value, value_, sizeof(value));
+    return value;
+  }
+
+  /** @return the bytes of a TEXT or a BLOB, valid as long as the page is pinned */
+  auto GetBytes() const -> std::string_view {
+    uint32_t length;
+    memcpy(&length, value_, sizeof(length));
+    return {value_ + sizeof(length), length};
+  }
+
+ private:
+  const char *cursor_;
+  const char *end_;
+  const char *value_{nullptr};
+  HeapValueType type_{HeapValueType::NULL_VALUE};
+  uint16_t column_count_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sqlite_bulk_loader.h
+//
+// Identification: src/include/storage/table/sqlite_bulk_loader.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "storage/page/heap_page.h"
+#include "storage/table/heap_row.h"
+
+struct sqlite3;
+
+namespace bustub {
+
+/**
+ * BulkLoadStats counts what a bulk load has written.
+ */
+struct BulkLoadStats {
+  uint64_t rows_{0};
+  /** Bytes of the encoded rows */
+  uint64_t bytes_{0};
+  uint64_t pages_{0};
+  std::chrono::nanoseconds elapsed_{0};
+
+  auto RowsPerSecond() const -> double { return rows_ / std::chrono::duration<double>(elapsed_).count(); }
+  auto MegabytesPerSecond() const -> double {
+    return bytes_ / 1e6 / std::chrono::duration<double>(elapsed_).count();
+  }
+};
+
+/**
+ * LoadedTable describes a table written to heap pages by the bulk loader.
+ */
+struct LoadedTable {
+  std::string name_;
+  std::vector<std::string> column_names_;
+  /** First page of the heap; the others follow through GetNextPageId() */
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  /** Every page of the heap, in heap order, so that the pages can be handed out without walking the chain */
+  std::vector<page_id_t> page_ids_;
+  BulkLoadStats stats_;
+};
+
+/**
+ * SqliteBulkLoader streams the tables of an SQLite database, such as the MusicBrainz dataset of the SQL homework, into
+ * heaps of HeapPage, one row per tuple encoded with HeapRowBuilder.
+ *
+ * Rows are appended straight into pinned pages: the pages are created batch_pages at a time with NewPageExtent, so
+ * that a heap has consecutive page ids, and a page is only let go of when the whole batch is full. A full batch is
+ * then written back in page id order and unpinned clean, so the disk sees one sequential run per batch and eviction
+ * never has to write a loaded page.
+ *
+ * Requires the free-space map of the pool, and 2 * batch_pages free frames while a table loads. In a
+ * ParallelBufferPoolManager the batches go round robin to the instances, each of which needs the frames: a heap is
+ * spread over all the instances in runs of batch_pages pages.
+ */
+class SqliteBulkLoader {
+ public:
+  static constexpr size_t DEFAULT_BATCH_PAGES = 32;
+
+  /**
+   * @param buffer_pool_manager pool the heaps are created in
+   * @param batch_pages pages created and written back together
+   */
+  explicit SqliteBulkLoader(BufferPoolManagerInstance *buffer_pool_manager,
+                            size_t batch_pages = DEFAULT_BATCH_PAGES);
+
+  /**
+   * @param buffer_pool_manager pool whose instances the batches of a heap are spread over
+   * @param batch_pages pages created and written back together
+   */
+  explicit SqliteBulkLoader(ParallelBufferPoolManager *buffer_pool_manager, size_t batch_pages = DEFAULT_BATCH_PAGES);
+
+  ~SqliteBulkLoader();
+
+  /**
+   * Open an SQLite database read-only, closing the previous one.
+   * @param db_file path of the database file
+   * @return false if it could not be opened
+   */
+  auto Open(const std::string &db_file) -> bool;
+
+  /**
+   * @param[out] tables names of the tables of the database, in the order they were created
+   * @return false on an SQLite error
+   */
+  auto ListTables(std::vector<std::string> *tables) -> bool;
+
+  /**
+   * Load every row of a table into a new heap.
+   * @param table name of the table
+   * @param[out] loaded the heap and what loading it took
+   * @return false on an SQLite error, or if a row does not fit in a page; the pages of the heap are deleted then
+   */
+  auto LoadTable(const std::string &table, LoadedTable *loaded) -> bool;
+
+  /**
+   * Load every table of the database.
+   * @param[out] loaded receives one heap per table, in the order of ListTables()
+   * @return false if a table failed to load; the ones loaded before it stay
+   */
+  auto LoadAll(std::vector<LoadedTable> *loaded) -> bool;
+
+  /** @return what all the loads so far have written */
+  auto GetStats() const -> const BulkLoadStats & { return stats_; }
+
+ private:
+  /** Pages of a heap created by one NewPageExtent, pinned until they are written back. */
+  struct PageBatch {
+    BufferPoolManagerInstance *instance_{nullptr};
+    std::vector<page_id_t> page_ids_;
+    std::vector<Page *> pages_;
+    /** Index of the page being filled */
+    size_t current_{0};
+  };
+
+  /**
+   * Create the next batch of pages of a heap in the next instance that has the frames for it, and initialize its
+   * first page.
+   * @param prev_page_id last page of the heap so far
+   * @return false if no instance had enough frames
+   */
+  auto AllocateBatch(page_id_t prev_page_id, PageBatch *batch) -> bool;
+
+  /**
+   * Append a row to the heap, moving on to the next page, or to a new batch, when the current page is full.
+   * @return false if a new batch could not be created
+   */
+  auto AppendRow(const HeapRowBuilder &row, PageBatch *batch, std::vector<page_id_t> *heap_pages) -> bool;
+
+  /** Write back the pages filled so far in page id order, and unpin them. The pages left empty are deleted. */
+  void FinishBatch(PageBatch *batch);
+
+  /** Unpin and delete every page of a heap whose load failed. */
+  void DropHeap(PageBatch *batch, const std::vector<page_id_t> &heap_pages);
+
+  static auto AsHeapPage(Page *page) -> HeapPage * { return reinterpret_cast<HeapPage *>(page->GetData()); }
+
+  /** @return the instance a page id belongs to */
+  auto InstanceOf(page_id_t page_id) -> BufferPoolManagerInstance * { return instances_[page_id % instances_.size()]; }
+
+  /** The instances of the pool, in the order the page ids are routed to */
+  std::vector<BufferPoolManagerInstance *> instances_;
+  /** Instance the next batch is tried in first */
+  size_t next_instance_{0};
+  const size_t batch_pages_;
+  sqlite3 *db_{nullptr};
+  BulkLoadStats stats_;
+};
+
+}  // namespace bustub
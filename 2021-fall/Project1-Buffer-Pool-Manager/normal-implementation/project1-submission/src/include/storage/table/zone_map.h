@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "execution/vector/vector_predicate.h"
+#include "storage/page/page_guard.h"
+#include "storage/page/zone_map_page.h"
+#include "storage/table/sqlite_bulk_loader.h"
+
+namespace bustub {
+
+/**
+ * ZoneMap is the min/max summary of one INTEGER column of a table, one ZoneEntry per page of the table, so that a scan
+ * with a predicate on the column can leave out the pages that cannot hold a matching row without fetching them.
+ *
+ * The entries are stored in ZoneMapPage pages of the buffer pool, 170 to a page, and are cached and evicted like any
+ * other page; only the ids of those pages are kept here. A scan reads them all when it starts, which for a heap of
+ * thousands of pages is a few dozen page fetches that stay hot in the pool.
+ *
+ * A default ZoneMap summarizes nothing, and a scan given one skips no page.
+ */
+class ZoneMap {
+ public:
+  /** @return whether the map has any entry */
+  auto IsEmpty() const -> bool { return entry_count_ == 0; }
+  auto GetEntryCount() const -> size_t { return entry_count_; }
+  /** @return the pages the entries are stored in */
+  auto GetPageIds() const -> const std::vector<page_id_t> & { return page_ids_; }
+
+  /**
+   * Read every entry, in the order of the table.
+   * @param buffer_pool_manager pool the map was built in
+   * @param[out] entries receives the entries
+   * @throws Exception if the pool has no frame to read a page of the map in
+   */
+  void ReadEntries(BufferPoolManagerInstance *buffer_pool_manager, std::vector<ZoneEntry> *entries) const;
+
+ private:
+  friend class ZoneMapBuilder;
+
+  std::vector<page_id_t> page_ids_;
+  size_t entry_count_{0};
+};
+
+/**
+ * ZoneMapBuilder writes the entries of a ZoneMap as the pages of the table are filled.
+ */
+class ZoneMapBuilder {
+ public:
+  explicit ZoneMapBuilder(BufferPoolManagerInstance *buffer_pool_manager)
+      : buffer_pool_manager_(buffer_pool_manager) {}
+
+  /**
+   * Append the entry of the next page of the table.
+   * @throws Exception if the pool has no frame for a new page of the map
+   */
+  void Append(const ZoneEntry &entry);
+
+  /** Hand the map over. The builder is empty afterwards. */
+  void Finish(ZoneMap *zone_map);
+
+ private:
+  BufferPoolManagerInstance *buffer_pool_manager_;
+  /** Page being filled */
+  WritePageGuard guard_;
+  ZoneMap zone_map_;
+};
+
+/**
+ * @return whether a page may hold a value for which "value type constant" holds; false if none of its values can
+ */
+auto ZoneMayMatch(const ZoneEntry &entry, ComparisonType type, int64_t constant) -> bool;
+
+/**
+ * Summarize one column of a heap written by the bulk loader, reading it once. Values are taken the way
+ * HeapScanOperator reads them into an INTEGER column: a REAL is truncated, and other values are NULL.
+ * @param buffer_pool_manager pool of the heap, and of the map
+ * @param table heap to summarize
+ * @param column position of the column in the rows
+ * @param[out] zone_map receives the map
+ */
+void BuildHeapZoneMap(BufferPoolManagerInstance *buffer_pool_manager, const LoadedTable &table, uint32_t column,
+                      ZoneMap *zone_map);
+
+}  // namespace bustub
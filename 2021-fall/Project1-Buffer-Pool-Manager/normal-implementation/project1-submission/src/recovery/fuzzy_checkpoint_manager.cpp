@@ -0,0 +1,227 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// fuzzy_checkpoint_manager.cpp
+//
+// Identification: src/recovery/fuzzy_checkpoint_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/fuzzy_checkpoint_manager.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+FuzzyCheckpointManager::FuzzyCheckpointManager(BufferPoolManagerInstance *bpm, LogManager *log_manager,
+                                               std::string master_record_path)
+    : instances_{bpm}, log_manager_(log_manager), master_record_path_(std::move(master_record_path)) {}
+
+FuzzyCheckpointManager::FuzzyCheckpointManager(ParallelBufferPoolManager *bpm, LogManager *log_manager,
+                                               std::string master_record_path)
+    : log_manager_(log_manager), master_record_path_(std::move(master_record_path)) {
+  for (size_t i = 0; i < bpm->GetNumInstances(); ++i) {
+    this->instances_.push_back(bpm->GetInstance(i));
+  }
+}
+
+FuzzyCheckpointManager::~FuzzyCheckpointManager() {
+  {
+    std::lock_guard<std::mutex> lg(this->mutex_);
+    this->stop_ = true;
+  }
+  this->cv_.notify_all();
+  if (this->checkpoint_thread_.joinable()) {
+    this->checkpoint_thread_.join();
+  }
+}
+
+void FuzzyCheckpointManager::SetWriteRate(double min_pages_per_sec, double max_pages_per_sec) {
+  BUSTUB_ASSERT(min_pages_per_sec > 0 && min_pages_per_sec <= max_pages_per_sec, "Invalid checkpoint write rate.");
+  this->min_write_rate_ = min_pages_per_sec;
+  this->max_write_rate_ = max_pages_per_sec;
+  this->write_rate_ = std::clamp(this->write_rate_.load(), min_pages_per_sec, max_pages_per_sec);
+}
+
+auto FuzzyCheckpointManager::Checkpoint() -> lsn_t {
+  const lsn_t begin_lsn = this->log_manager_ == nullptr ? INVALID_LSN : this->log_manager_->GetNextLSN();
+
+  uint64_t latency_counts[LatencyHistogram::NUM_BUCKETS];
+  this->SnapshotLatency(latency_counts);
+  auto now = std::chrono::steady_clock::now();
+  auto next_control = now + CONTROL_INTERVAL;
+  auto next_write = now;
+
+  for (BufferPoolManagerInstance *bpm : this->instances_) {
+    // Written in page id order, as one sweep over the file.
+    std::vector<std::pair<page_id_t, lsn_t>> dirty_pages = bpm->GetDirtyPages();
+    std::sort(dirty_pages.begin(), dirty_pages.end());
+    for (const auto &[page_id, rec_lsn] : dirty_pages) {
+      // Pages first dirtied after the checkpoint started do not hold the redo LSN back.
+      if (begin_lsn != INVALID_LSN && rec_lsn >= begin_lsn) {
+        continue;
+      }
+      if (!this->WaitUntil(next_write)) {
+        return INVALID_LSN;
+      }
+      bpm->CheckpointPage(page_id);
+
+      now = std::chrono::steady_clock::now();
+      if (now >= next_control) {
+        this->AdjustWriteRate(latency_counts);
+        next_control = now + CONTROL_INTERVAL;
+      }
+      // A write that took longer than its slot is not made up for with a burst.
+      auto slot = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / this->write_rate_));
+      next_write = std::max(next_write + slot, now);
+    }
+  }
+
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_pages = this->CollectDirtyPages();
+  lsn_t redo_lsn = begin_lsn;
+  if (begin_lsn != INVALID_LSN) {
+    for (const auto &[page_id, rec_lsn] : dirty_pages) {
+      if (rec_lsn != INVALID_LSN) {
+        redo_lsn = std::min(redo_lsn, rec_lsn);
+      }
+    }
+  }
+  if (!this->WriteMasterRecord(redo_lsn, dirty_pages)) {
+    return INVALID_LSN;
+  }
+  return redo_lsn;
+}
+
+void FuzzyCheckpointManager::StartPeriodicCheckpoint(std::chrono::milliseconds interval) {
+  BUSTUB_ASSERT(!this->checkpoint_thread_.joinable(), "Periodic checkpoint is already running.");
+  this->checkpoint_thread_ = std::thread([this, interval] {
+    std::unique_lock<std::mutex> lk(this->mutex_);
+    while (!this->cv_.wait_for(lk, interval, [this] { return this->stop_; })) {
+      lk.unlock();
+      this->Checkpoint();
+      lk.lock();
+    }
+  });
+}
+
+auto FuzzyCheckpointManager::ReadMasterRecord(const std::string &path, lsn_t *redo_lsn,
+                                              std::vector<std::pair<page_id_t, lsn_t>> *dirty_pages) -> bool {
+  std::ifstream in(path);
+  if (!(in >> *redo_lsn)) {
+    return false;
+  }
+  page_id_t page_id;
+  lsn_t rec_lsn;
+  while (in >> page_id >> rec_lsn) {
+    dirty_pages->emplace_back(page_id, rec_lsn);
+  }
+  return true;
+}
+
+auto FuzzyCheckpointManager::CollectDirtyPages() -> std::vector<std::pair<page_id_t, lsn_t>> {
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_pages;
+  for (BufferPoolManagerInstance *bpm : this->instances_) {
+    std::vector<std::pair<page_id_t, lsn_t>> instance_pages = bpm->GetDirtyPages();
+    dirty_pages.insert(dirty_pages.end(), instance_pages.begin(), instance_pages.end());
+  }
+  return dirty_pages;
+}
+
+void FuzzyCheckpointManager::SnapshotLatency(uint64_t *counts) {
+  std::fill(counts, counts + LatencyHistogram::NUM_BUCKETS, 0);
+  uint64_t instance_counts[LatencyHistogram::NUM_BUCKETS];
+  for (BufferPoolManagerInstance *bpm : this->instances_) {
+    bpm->GetStats().fetch_latency_.Snapshot(instance_counts);
+    for (size_t b = 0; b < LatencyHistogram::NUM_BUCKETS; ++b) {
+      counts[b] += instance_counts[b];
+    }
+  }
+}
+
+void FuzzyCheckpointManager::AdjustWriteRate(uint64_t *last_counts) {
+  uint64_t counts[LatencyHistogram::NUM_BUCKETS];
+  this->SnapshotLatency(counts);
+  uint64_t delta[LatencyHistogram::NUM_BUCKETS];
+  uint64_t samples = 0;
+  for (size_t b = 0; b < LatencyHistogram::NUM_BUCKETS; ++b) {
+    delta[b] = counts[b] - last_counts[b];
+    samples += delta[b];
+    last_counts[b] = counts[b];
+  }
+  if (samples < MIN_LATENCY_SAMPLES) {
+    return;
+  }
+
+  auto budget_ns = static_cast<uint64_t>(std::chrono::nanoseconds(this->latency_budget_).count());
+  double rate = this->write_rate_;
+  if (LatencyHistogram::Percentile(delta, 0.99) > budget_ns) {
+    rate /= 2;
+  } else {
+    rate += this->max_write_rate_ * RATE_STEP;
+  }
+  this->write_rate_ = std::clamp(rate, this->min_write_rate_, this->max_write_rate_);
+}
+
+auto FuzzyCheckpointManager::WriteMasterRecord(lsn_t redo_lsn,
+                                               const std::vector<std::pair<page_id_t, lsn_t>> &dirty_pages) -> bool {
+  std::string tmp_path = this->master_record_path_ + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::out | std::ios::trunc);
+    out << redo_lsn << '\n';
+    for (const auto &[page_id, rec_lsn] : dirty_pages) {
+      out << page_id << ' ' << rec_lsn << '\n';
+    }
+    if (!out.good()) {
+      LOG_WARN("could not write master record %s", tmp_path.c_str());
+      return false;
+    }
+  }
+  // The record must be on disk before the rename replaces the previous one, or a crash can lose the redo point.
+  int fd = open(tmp_path.c_str(), O_RDONLY);
+  if (fd < 0 || fsync(fd) != 0) {
+    LOG_WARN("could not sync master record %s: %s", tmp_path.c_str(), std::strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  close(fd);
+  if (std::rename(tmp_path.c_str(), this->master_record_path_.c_str()) != 0) {
+    LOG_WARN("could not replace master record %s: %s", this->master_record_path_.c_str(), std::strerror(errno));
+    return false;
+  }
+  // The rename itself is durable only once the directory entry is.
+  size_t slash = this->master_record_path_.find_last_of('/');
+  std::string dir = slash == std::string::npos ? "." : this->master_record_path_.substr(0, std::max<size_t>(slash, 1));
+  fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0 || fsync(fd) != 0) {
+    LOG_WARN("could not sync directory %s: %s", dir.c_str(), std::strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  close(fd);
+  return true;
+}
+
+auto FuzzyCheckpointManager::WaitUntil(std::chrono::steady_clock::time_point deadline) -> bool {
+  std::unique_lock<std::mutex> lk(this->mutex_);
+  return !this->cv_.wait_until(lk, deadline, [this] { return this->stop_; });
+}
+
+}  // namespace bustub
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_manager.cpp
+//
+// Identification: src/recovery/log_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/log_manager.h"
+
+#include <cstring>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void LogManager::RunFlushThread() {
+  std::lock_guard<std::mutex> lg(this->latch_);
+  if (this->flush_thread_ != nullptr) {
+    return;
+  }
+  enable_logging = true;
+  this->flush_thread_ = new std::thread(&LogManager::RunFlush, this);
+}
+
+void LogManager::StopFlushThread() {
+  std::thread *flush_thread;
+  {
+    std::lock_guard<std::mutex> lg(this->latch_);
+    if (this->flush_thread_ == nullptr) {
+      return;
+    }
+    enable_logging = false;
+    flush_thread = this->flush_thread_;
+    this->flush_thread_ = nullptr;
+  }
+  this->cv_.notify_one();
+  flush_thread->join();
+  delete flush_thread;
+}
+
+auto LogManager::AppendLogRecord(LogRecord *log_record) -> lsn_t {
+  std::unique_lock<std::mutex> lk(this->latch_);
+
+  BUSTUB_ASSERT(log_record->size_ <= LOG_BUFFER_SIZE, "Log record does not fit in the log buffer.");
+  while (this->log_buffer_offset_ + log_record->size_ > LOG_BUFFER_SIZE) {
+    if (this->flush_thread_ != nullptr) {
+      this->flush_requested_ = true;
+      this->cv_.notify_one();
+      this->flushed_cv_.wait(lk);
+    } else {
+      this->FlushBuffer(&lk);
+    }
+  }
+
+  log_record->lsn_ = this->next_lsn_++;
+  char *pos = this->log_buffer_ + this->log_buffer_offset_;
+  memcpy(pos, log_record, LogRecord::HEADER_SIZE);
+  pos += LogRecord::HEADER_SIZE;
+
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      memcpy(pos, &log_record->insert_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->insert_tuple_.SerializeTo(pos);
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(pos, &log_record->delete_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->delete_tuple_.SerializeTo(pos);
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(pos, &log_record->update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->old_tuple_.SerializeTo(pos);
+      pos += sizeof(int32_t) + log_record->old_tuple_.GetLength();
+      log_record->new_tuple_.SerializeTo(pos);
+      break;
+    case LogRecordType::NEWPAGE:
+      memcpy(pos, &log_record->prev_page_id_, sizeof(page_id_t));
+      pos += sizeof(page_id_t);
+      memcpy(pos, &log_record->page_id_, sizeof(page_id_t));
+      break;
+    default:
+      // BEGIN, COMMIT and ABORT are header only.
+      break;
+  }
+
+  this->log_buffer_offset_ += log_record->size_;
+  this->last_buffered_lsn_ = log_record->lsn_;
+  return log_record->lsn_;
+}
+
+void LogManager::FlushToLSN(lsn_t lsn) {
+  std::unique_lock<std::mutex> lk(this->latch_);
+
+  lsn = std::min(lsn, this->next_lsn_ - 1);
+  while (this->persistent_lsn_ < lsn) {
+    if (this->flush_thread_ != nullptr) {
+      this->flush_requested_ = true;
+      this->cv_.notify_one();
+      this->flushed_cv_.wait(lk);
+    } else {
+      this->FlushBuffer(&lk);
+    }
+  }
+}
+
+void LogManager::FlushBuffer(std::unique_lock<std::mutex> *lk) {
+  // flush_buffer_ belongs to the write in progress, if any.
+  while (this->flushing_) {
+    this->flushed_cv_.wait(*lk);
+  }
+  this->flush_requested_ = false;
+  if (this->log_buffer_offset_ == 0) {
+    return;
+  }
+
+  std::swap(this->log_buffer_, this->flush_buffer_);
+  int size = this->log_buffer_offset_;
+  lsn_t lsn = this->last_buffered_lsn_;
+  this->log_buffer_offset_ = 0;
+  this->flushing_ = true;
+
+  // Appenders fill the other buffer while this one is written, they are the next batch.
+  lk->unlock();
+  this->disk_manager_->WriteLog(this->flush_buffer_, size);
+  lk->lock();
+
+  this->flushing_ = false;
+  this->persistent_lsn_ = lsn;
+  ++this->num_flushes_;
+  this->flushed_cv_.notify_all();
+}
+
+void LogManager::RunFlush() {
+  std::unique_lock<std::mutex> lk(this->latch_);
+  while (enable_logging) {
+    this->cv_.wait_for(lk, log_timeout, [this] { return this->flush_requested_ || !enable_logging; });
+    this->FlushBuffer(&lk);
+  }
+  // Records appended before the stop still go out.
+  this->FlushBuffer(&lk);
+}
+
+}  // namespace bustub
@@ -0,0 +1,303 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// simulated_disk_manager.cpp
+//
+// Identification: src/storage/disk/simulated_disk_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/simulated_disk_manager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>  // NOLINT
+
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15ULL;
+
+/** SplitMix64 finalizer. */
+auto Mix(uint64_t x) -> uint64_t {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/** @return the i-th uniform draw in [0, 1) of an I/O */
+auto Draw(uint64_t key, uint64_t i) -> double {
+  return static_cast<double>(Mix(key + i * GOLDEN_GAMMA) >> 11) * 0x1.0p-53;
+}
+
+/** The shortest seek, as a fraction of a seek across the whole device. */
+constexpr double MIN_SEEK_FRACTION = 1.0 / 16;
+
+}  // namespace
+
+auto DeviceProfile::NVMe() -> DeviceProfile {
+  DeviceProfile device;
+  device.read_latency_ = std::chrono::microseconds(80);
+  device.write_latency_ = std::chrono::microseconds(20);
+  device.latency_sigma_ = 0.3;
+  device.queue_depth_ = 64;
+  device.bandwidth_ = 3000000000ULL;
+  return device;
+}
+
+auto DeviceProfile::SataSsd() -> DeviceProfile {
+  DeviceProfile device;
+  device.read_latency_ = std::chrono::microseconds(150);
+  device.write_latency_ = std::chrono::microseconds(60);
+  device.latency_sigma_ = 0.5;
+  device.queue_depth_ = 32;
+  device.bandwidth_ = 500000000ULL;
+  return device;
+}
+
+auto DeviceProfile::Hdd() -> DeviceProfile {
+  DeviceProfile device;
+  device.read_latency_ = std::chrono::microseconds(100);
+  device.write_latency_ = std::chrono::microseconds(100);
+  device.latency_sigma_ = 0.1;
+  device.full_seek_ = std::chrono::microseconds(8000);
+  device.rotation_ = std::chrono::microseconds(8333);
+  device.queue_depth_ = 1;
+  device.bandwidth_ = 150000000ULL;
+  return device;
+}
+
+SimulatedDiskManager::SimulatedDiskManager(const DeviceProfile &device, uint64_t seed, bool virtual_time)
+    : device_(device), seed_(seed), virtual_time_(virtual_time) {
+  BUSTUB_ASSERT(device.queue_depth_ > 0, "A device serves at least one I/O at a time.");
+  for (size_t i = 0; i < device.queue_depth_; ++i) {
+    this->slot_free_at_.push(std::chrono::steady_clock::time_point{});
+  }
+  if (!virtual_time) {
+    this->completion_thread_ = std::thread(&SimulatedDiskManager::RunCompletions, this);
+  }
+}
+
+SimulatedDiskManager::~SimulatedDiskManager() {
+  {
+    std::lock_guard<std::mutex> lg(this->completion_latch_);
+    this->stop_ = true;
+  }
+  this->completion_cv_.notify_one();
+  if (this->completion_thread_.joinable()) {
+    this->completion_thread_.join();
+  }
+}
+
+void SimulatedDiskManager::SetFaults(const FaultProfile &faults) {
+  std::lock_guard<std::mutex> lg(this->plan_latch_);
+  this->faults_ = faults;
+}
+
+void SimulatedDiskManager::SetFailingPage(page_id_t page_id, bool failing) {
+  std::lock_guard<std::mutex> lg(this->plan_latch_);
+  if (failing) {
+    this->failing_pages_.insert(page_id);
+  } else {
+    this->failing_pages_.erase(page_id);
+  }
+}
+
+void SimulatedDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  bool failed;
+  this->Serve(this->Plan(page_id, true, &failed), PAGE_SIZE);
+  this->stats_.writes_.fetch_add(1, std::memory_order_relaxed);
+  if (failed) {
+    this->stats_.failed_writes_.fetch_add(1, std::memory_order_relaxed);
+    LOG_DEBUG("I/O error while writing page %d", page_id);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lg(this->data_latch_);
+  this->pages_[page_id].assign(page_data, page_data + PAGE_SIZE);
+  this->num_writes_ += 1;
+}
+
+void SimulatedDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  bool failed;
+  this->Serve(this->Plan(page_id, false, &failed), PAGE_SIZE);
+  this->stats_.reads_.fetch_add(1, std::memory_order_relaxed);
+  this->FinishRead(page_id, page_data, failed);
+}
+
+void SimulatedDiskManager::ReadPageAsync(page_id_t page_id, char *page_data, std::function<void()> callback) {
+  bool failed;
+  auto done = this->Schedule(this->Plan(page_id, false, &failed), PAGE_SIZE);
+  this->stats_.reads_.fetch_add(1, std::memory_order_relaxed);
+  if (this->virtual_time_) {
+    this->FinishRead(page_id, page_data, failed);
+    callback();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lg(this->completion_latch_);
+    this->completions_.push({done, page_id, page_data, failed, std::move(callback)});
+  }
+  this->completion_cv_.notify_one();
+}
+
+void SimulatedDiskManager::FinishRead(page_id_t page_id, char *page_data, bool failed) {
+  if (failed) {
+    this->stats_.failed_reads_.fetch_add(1, std::memory_order_relaxed);
+    LOG_DEBUG("I/O error while reading page %d", page_id);
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lg(this->data_latch_);
+  auto it = this->pages_.find(page_id);
+  if (it == this->pages_.end()) {
+    // Never written, like reading past the end of the file.
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  memcpy(page_data, it->second.data(), PAGE_SIZE);
+}
+
+void SimulatedDiskManager::WriteLog(char *log_data, int size) {
+  if (size == 0) {
+    return;
+  }
+  bool failed;
+  this->Serve(this->Plan(LOG_KEY, true, &failed), size);
+  this->stats_.log_writes_.fetch_add(1, std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lg(this->data_latch_);
+  this->log_.insert(this->log_.end(), log_data, log_data + size);
+  this->num_flushes_ += 1;
+}
+
+auto SimulatedDiskManager::ReadLog(char *log_data, int size, int offset) -> bool {
+  std::lock_guard<std::mutex> lg(this->data_latch_);
+  if (offset >= static_cast<int>(this->log_.size())) {
+    return false;
+  }
+  int read_count = std::min(size, static_cast<int>(this->log_.size()) - offset);
+  memcpy(log_data, this->log_.data() + offset, read_count);
+  if (read_count < size) {
+    memset(log_data + read_count, 0, size - read_count);
+  }
+  return true;
+}
+
+auto SimulatedDiskManager::Plan(page_id_t page_id, bool is_write, bool *failed) -> std::chrono::nanoseconds {
+  std::lock_guard<std::mutex> lg(this->plan_latch_);
+  uint64_t n = this->io_counts_[page_id]++;
+  uint64_t key = Mix(this->seed_ ^ Mix((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 1) | is_write)) +
+                 n * GOLDEN_GAMMA;
+
+  auto median = is_write ? this->device_.write_latency_ : this->device_.read_latency_;
+  double ns = std::chrono::duration<double, std::nano>(median).count();
+  if (this->device_.latency_sigma_ > 0) {
+    // Box-Muller; 1 - u keeps the logarithm finite.
+    double z = std::sqrt(-2 * std::log(1 - Draw(key, 0))) * std::cos(2 * M_PI * Draw(key, 1));
+    ns *= std::exp(this->device_.latency_sigma_ * z);
+  }
+
+  // The log is written sequentially in a region of its own and never moves the head over the pages.
+  if (this->device_.full_seek_.count() > 0 && page_id != LOG_KEY) {
+    if (page_id != this->head_ + 1) {
+      double distance = std::min(1.0, std::abs(static_cast<double>(page_id) - this->head_) / this->device_.num_pages_);
+      double full_seek = std::chrono::duration<double, std::nano>(this->device_.full_seek_).count();
+      ns += full_seek * (MIN_SEEK_FRACTION + (1 - MIN_SEEK_FRACTION) * std::sqrt(distance));
+      ns += std::chrono::duration<double, std::nano>(this->device_.rotation_).count() * Draw(key, 2);
+    }
+    this->head_ = page_id;
+  }
+
+  if (Draw(key, 3) < this->faults_.slow_io_rate_) {
+    ns *= this->faults_.slow_io_factor_;
+    this->stats_.slow_ios_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Log writes are only ever slow: dropping one would break write-ahead logging rather than test it.
+  *failed = false;
+  if (page_id != LOG_KEY) {
+    double failure_rate = is_write ? this->faults_.failed_write_rate_ : this->faults_.failed_read_rate_;
+    *failed = this->failing_pages_.count(page_id) > 0 || Draw(key, 4) < failure_rate;
+  }
+  return std::chrono::nanoseconds(static_cast<int64_t>(ns));
+}
+
+auto SimulatedDiskManager::Schedule(std::chrono::nanoseconds service_time, size_t bytes)
+    -> std::chrono::steady_clock::time_point {
+  std::chrono::nanoseconds transfer_time(0);
+  if (this->device_.bandwidth_ > 0) {
+    transfer_time = std::chrono::nanoseconds(bytes * 1000000000ULL / this->device_.bandwidth_);
+  }
+  this->stats_.service_time_.Record(service_time.count());
+  this->busy_ns_.fetch_add((service_time + transfer_time).count(), std::memory_order_relaxed);
+  auto arrival = std::chrono::steady_clock::now();
+  if (this->virtual_time_) {
+    return arrival;
+  }
+
+  // The I/O takes the slot that frees up first, in arrival order, and keeps it until it completes.
+  std::unique_lock<std::mutex> lk(this->queue_latch_);
+  auto start = std::max(arrival, this->slot_free_at_.top());
+  this->slot_free_at_.pop();
+  auto done = start + service_time;
+  if (transfer_time.count() > 0) {
+    // The channel moves one transfer at a time, in the order the I/Os got a queue slot.
+    this->channel_free_at_ = std::max(start, this->channel_free_at_) + transfer_time;
+    done = std::max(done, this->channel_free_at_);
+  }
+  this->slot_free_at_.push(done);
+  lk.unlock();
+
+  auto wait = (done - arrival) - service_time;
+  if (wait.count() > 0) {
+    this->stats_.queue_wait_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count(),
+                                          std::memory_order_relaxed);
+  }
+  return done;
+}
+
+void SimulatedDiskManager::Serve(std::chrono::nanoseconds service_time, size_t bytes) {
+  auto done = this->Schedule(service_time, bytes);
+  if (!this->virtual_time_) {
+    std::this_thread::sleep_until(done);
+  }
+}
+
+void SimulatedDiskManager::RunCompletions() {
+  std::unique_lock<std::mutex> lk(this->completion_latch_);
+  while (true) {
+    if (this->completions_.empty()) {
+      if (this->stop_) {
+        return;
+      }
+      this->completion_cv_.wait(lk);
+      continue;
+    }
+    // A copy: the queue may grow while this waits. A read issued meanwhile may complete earlier, its notify cuts the
+    // wait short.
+    auto done = this->completions_.top().done_;
+    if (std::chrono::steady_clock::now() < done) {
+      this->completion_cv_.wait_until(lk, done);
+      continue;
+    }
+    Completion completion = this->completions_.top();
+    this->completions_.pop();
+    lk.unlock();
+    this->FinishRead(completion.page_id_, completion.page_data_, completion.failed_);
+    completion.callback_();
+    lk.lock();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,504 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree.cpp
+//
+// Identification: src/storage/index/b_plus_tree.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/b_plus_tree.h"
+
+#include <algorithm>
+#include <string>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::BPlusTree(std::string name, ParallelBufferPoolManager *buffer_pool_manager,
+                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size,
+                          page_id_t header_page_id)
+    : index_name_(std::move(name)),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size),
+      header_page_id_(header_page_id) {
+  BUSTUB_ASSERT(leaf_max_size >= 2 && leaf_max_size <= LeafPage::Capacity(), "Leaf max size out of range.");
+  BUSTUB_ASSERT(internal_max_size >= 3 && internal_max_size < InternalPage::Capacity(),
+                "Internal max size out of range.");
+  if (this->header_page_id_ != INVALID_PAGE_ID) {
+    return;
+  }
+  WritePageGuard guard = this->NewNode(&this->header_page_id_);
+  auto *header = guard.AsMut<BPlusTreeHeaderPage>();
+  header->root_page_id_ = INVALID_PAGE_ID;
+  header->root_level_ = 0;
+}
+
+/*
+ * Helper function to decide whether current b+tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsEmpty() -> bool { return this->GetRootPageId() == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = this->FetchRead(this->header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the only value that associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result) -> bool {
+  ReadPageGuard guard = this->FetchRead(this->header_page_id_);
+  page_id_t root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  // Latch the child before the assignment lets go of the parent.
+  guard = this->FetchRead(root_page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    guard = this->FetchRead(guard.As<InternalPage>()->Lookup(key, this->comparator_));
+  }
+
+  ValueType value;
+  if (!guard.As<LeafPage>()->Lookup(key, &value, this->comparator_)) {
+    return false;
+  }
+  result->push_back(value);
+  return true;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert constant key & value pair into b+ tree
+ * if current tree is empty, start new tree, update root page id and insert entry, otherwise insert into leaf page.
+ * @return: since we only support unique key, if user try to insert duplicate keys return false, otherwise return true.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value) -> bool {
+  WritePageGuard guard = this->FindLeafOptimistic(key);
+  if (guard.IsValid() && IsSafeForInsert(guard.As<BPlusTreePage>())) {
+    ValueType existing;
+    if (guard.As<LeafPage>()->Lookup(key, &existing, this->comparator_)) {
+      return false;
+    }
+    guard.AsMut<LeafPage>()->Insert(key, value, this->comparator_);
+    return true;
+  }
+  guard.Drop();
+  return this->InsertPessimistic(key, value);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key) -> WritePageGuard {
+  ReadPageGuard header_guard = this->FetchRead(this->header_page_id_);
+  const auto *header = header_guard.As<BPlusTreeHeaderPage>();
+  if (header->root_page_id_ == INVALID_PAGE_ID) {
+    return WritePageGuard();
+  }
+  // The header read latch keeps a leaf root from being replaced while it is write-latched.
+  if (header->root_level_ == 0) {
+    return this->FetchWrite(header->root_page_id_);
+  }
+
+  ReadPageGuard guard = this->FetchRead(header->root_page_id_);
+  header_guard.Drop();
+  while (true) {
+    const auto *node = guard.As<InternalPage>();
+    page_id_t child = node->Lookup(key, this->comparator_);
+    if (node->GetLevel() == 1) {
+      return this->FetchWrite(child);
+    }
+    guard = this->FetchRead(child);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertPessimistic(const KeyType &key, const ValueType &value) -> bool {
+  WritePageGuard header_guard = this->FetchWrite(this->header_page_id_);
+  page_id_t root_page_id = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    WritePageGuard root_guard = this->NewNode(&root_page_id);
+    auto *root = root_guard.AsMut<LeafPage>();
+    root->Init(root_page_id, this->leaf_max_size_);
+    root->Insert(key, value, this->comparator_);
+    auto *header = header_guard.AsMut<BPlusTreeHeaderPage>();
+    header->root_page_id_ = root_page_id;
+    header->root_level_ = 0;
+    return true;
+  }
+
+  // Write latches of the nodes a split may still reach, the leaf last.
+  std::deque<WritePageGuard> path;
+  page_id_t page_id = root_page_id;
+  while (true) {
+    WritePageGuard guard = this->FetchWrite(page_id);
+    const auto *node = guard.As<BPlusTreePage>();
+    if (IsSafeForInsert(node)) {
+      path.clear();
+      header_guard.Drop();
+    }
+    bool is_leaf = node->IsLeafPage();
+    if (!is_leaf) {
+      page_id = guard.As<InternalPage>()->Lookup(key, this->comparator_);
+    }
+    path.push_back(std::move(guard));
+    if (is_leaf) {
+      break;
+    }
+  }
+
+  ValueType existing;
+  if (path.back().As<LeafPage>()->Lookup(key, &existing, this->comparator_)) {
+    return false;
+  }
+  auto *leaf = path.back().AsMut<LeafPage>();
+  if (leaf->Insert(key, value, this->comparator_) < leaf->GetMaxSize()) {
+    return true;
+  }
+
+  page_id_t new_page_id;
+  WritePageGuard new_guard = this->NewNode(&new_page_id);
+  auto *new_leaf = new_guard.AsMut<LeafPage>();
+  new_leaf->Init(new_page_id, this->leaf_max_size_);
+  leaf->MoveHalfTo(new_leaf);
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  leaf->SetNextPageId(new_page_id);
+  KeyType separator = new_leaf->KeyAt(0);
+  page_id_t leaf_page_id = leaf->GetPageId();
+  // Both halves are complete and linked; readers coming through the parent wait on its latch.
+  new_guard.Drop();
+  path.pop_back();
+  this->InsertIntoParent(&path, &header_guard, leaf_page_id, separator, new_page_id, 1);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(std::deque<WritePageGuard> *path, WritePageGuard *header, page_id_t left_id,
+                                      const KeyType &key, page_id_t right_id, int level) {
+  KeyType separator = key;
+  while (!path->empty()) {
+    auto *parent = path->back().AsMut<InternalPage>();
+    if (parent->InsertNodeAfter(left_id, separator, right_id) <= parent->GetMaxSize()) {
+      return;
+    }
+    page_id_t new_page_id;
+    WritePageGuard new_guard = this->NewNode(&new_page_id);
+    auto *sibling = new_guard.AsMut<InternalPage>();
+    sibling->Init(new_page_id, parent->GetLevel(), this->internal_max_size_);
+    parent->MoveHalfTo(sibling);
+    separator = sibling->KeyAt(0);
+    left_id = parent->GetPageId();
+    right_id = new_page_id;
+    level = parent->GetLevel() + 1;
+    path->pop_back();
+  }
+
+  // The root split; it was not safe, so the header is still latched.
+  BUSTUB_ASSERT(header->IsValid(), "Root split without the header latch.");
+  page_id_t root_page_id;
+  WritePageGuard root_guard = this->NewNode(&root_page_id);
+  auto *root = root_guard.AsMut<InternalPage>();
+  root->Init(root_page_id, level, this->internal_max_size_);
+  root->PopulateNewRoot(left_id, separator, right_id);
+  auto *header_page = header->AsMut<BPlusTreeHeaderPage>();
+  header_page->root_page_id_ = root_page_id;
+  header_page->root_level_ = level;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafeForInsert(const BPlusTreePage *node) -> bool {
+  // A leaf splits when it reaches its max size, an internal page when it goes past it.
+  return node->IsLeafPage() ? node->GetSize() + 1 < node->GetMaxSize() : node->GetSize() < node->GetMaxSize();
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key. The leaf is never merged, so this only ever needs the
+ * optimistic descent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key) {
+  WritePageGuard guard = this->FindLeafOptimistic(key);
+  if (!guard.IsValid()) {
+    return;
+  }
+  ValueType existing;
+  if (guard.As<LeafPage>()->Lookup(key, &existing, this->comparator_)) {
+    guard.AsMut<LeafPage>()->RemoveAndDeleteRecord(key, this->comparator_);
+  }
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &items, double fill_factor) -> bool {
+  BUSTUB_ASSERT(fill_factor > 0 && fill_factor <= 1, "Fill factor out of range.");
+  for (size_t i = 1; i < items.size(); ++i) {
+    if (this->comparator_(items[i - 1].first, items[i].first) >= 0) {
+      return false;
+    }
+  }
+  WritePageGuard header_guard = this->FetchWrite(this->header_page_id_);
+  if (header_guard.As<BPlusTreeHeaderPage>()->root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  if (items.empty()) {
+    return true;
+  }
+
+  // Spread the entries evenly so that the last node of a level is not a runt.
+  auto node_sizes = [fill_factor](size_t count, int max_entries) {
+    auto per_node = static_cast<size_t>(std::max(1.0, fill_factor * max_entries));
+    size_t num_nodes = (count + per_node - 1) / per_node;
+    std::vector<size_t> sizes(num_nodes, count / num_nodes);
+    for (size_t i = 0; i < count % num_nodes; ++i) {
+      ++sizes[i];
+    }
+    return sizes;
+  };
+
+  // First key and page id of every node of the level just built.
+  std::vector<std::pair<KeyType, page_id_t>> level_nodes;
+  WritePageGuard prev_guard;
+  size_t pos = 0;
+  for (size_t size : node_sizes(items.size(), this->leaf_max_size_ - 1)) {
+    page_id_t page_id;
+    WritePageGuard guard = this->NewNode(&page_id);
+    auto *leaf = guard.AsMut<LeafPage>();
+    leaf->Init(page_id, this->leaf_max_size_);
+    leaf->CopyNFrom(items.data() + pos, static_cast<int>(size));
+    if (prev_guard.IsValid()) {
+      prev_guard.AsMut<LeafPage>()->SetNextPageId(page_id);
+    }
+    prev_guard = std::move(guard);
+    level_nodes.emplace_back(items[pos].first, page_id);
+    pos += size;
+  }
+  prev_guard.Drop();
+
+  int level = 0;
+  while (level_nodes.size() > 1) {
+    ++level;
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    pos = 0;
+    for (size_t size : node_sizes(level_nodes.size(), this->internal_max_size_)) {
+      page_id_t page_id;
+      WritePageGuard guard = this->NewNode(&page_id);
+      auto *node = guard.AsMut<InternalPage>();
+      node->Init(page_id, level, this->internal_max_size_);
+      node->CopyNFrom(level_nodes.data() + pos, static_cast<int>(size));
+      parents.emplace_back(level_nodes[pos].first, page_id);
+      pos += size;
+    }
+    level_nodes.swap(parents);
+  }
+
+  auto *header = header_guard.AsMut<BPlusTreeHeaderPage>();
+  header->root_page_id_ = level_nodes[0].second;
+  header->root_level_ = level;
+  return true;
+}
+
+/*****************************************************************************
+ * INDEX ITERATOR
+ *****************************************************************************/
+/*
+ * Input parameter is void, find the leftmost leaf page first, then construct index iterator
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return this->BeginAt(nullptr); }
+
+/*
+ * Input parameter is low key, find the leaf page that contains the input key first, then construct index iterator
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return this->BeginAt(&key); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BeginAt(const KeyType *key) -> INDEXITERATOR_TYPE {
+  ReadPageGuard guard = this->FetchRead(this->header_page_id_);
+  page_id_t root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return this->End();
+  }
+
+  INDEXITERATOR_TYPE iterator(this);
+  std::vector<page_id_t> leaves;
+  KeyType high_key{};
+  bool has_high_key = false;
+  guard = this->FetchRead(root_page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    const auto *node = guard.As<InternalPage>();
+    int index = key == nullptr ? 0 : node->ChildIndex(*key, this->comparator_);
+    if (node->GetLevel() == 1 && this->read_ahead_pages_ > 0) {
+      this->FillReadAhead(node, index + 1, high_key, has_high_key, &iterator, &leaves);
+    }
+    if (index + 1 < node->GetSize()) {
+      high_key = node->KeyAt(index + 1);
+      has_high_key = true;
+    }
+    guard = this->FetchRead(node->ValueAt(index));
+  }
+
+  iterator.index_ = key == nullptr ? 0 : guard.As<LeafPage>()->KeyIndex(*key, this->comparator_);
+  iterator.page_id_ = guard.PageId();
+  iterator.guard_ = std::move(guard);
+  this->DispatchReadAhead(leaves);
+  iterator.Advance();
+  return iterator;
+}
+
+/*****************************************************************************
+ * READ-AHEAD
+ *****************************************************************************/
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetReadAhead(int num_pages) {
+  BUSTUB_ASSERT(num_pages == 0 || this->buffer_pool_manager_->IsAsyncFetchEnabled(), "Async fetch is not enabled.");
+  this->read_ahead_pages_ = num_pages;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FillReadAhead(const InternalPage *node, int first, const KeyType &high_key, bool has_high_key,
+                                   INDEXITERATOR_TYPE *iterator, std::vector<page_id_t> *leaves) {
+  int end = std::min(node->GetSize(), first + this->read_ahead_pages_);
+  leaves->clear();
+  for (int i = first; i < end; ++i) {
+    leaves->push_back(node->ValueAt(i));
+  }
+  iterator->has_read_ahead_key_ = end < node->GetSize() || has_high_key;
+  iterator->read_ahead_key_ = end < node->GetSize() ? node->KeyAt(end) : high_key;
+  iterator->read_ahead_trigger_ = leaves->empty() ? INVALID_PAGE_ID : (*leaves)[leaves->size() / 2];
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReadAhead(INDEXITERATOR_TYPE *iterator) {
+  // No latch is held here, but optimistic reads still keep the lookup off the latches writers are waiting for.
+  page_id_t page_id = INVALID_PAGE_ID;
+  int level = 0;
+  OptimisticPageHandle header_handle(this->header_page_id_);
+  bool ok = this->buffer_pool_manager_->ReadPageOptimistic(&header_handle, [&](const char *data) {
+    const auto *header = reinterpret_cast<const BPlusTreeHeaderPage *>(data);
+    page_id = header->root_page_id_;
+    level = header->root_level_;
+  });
+  iterator->has_read_ahead_key_ = false;
+  if (!ok || page_id == INVALID_PAGE_ID || level <= 0) {
+    return;
+  }
+
+  const KeyType key = iterator->read_ahead_key_;
+  KeyType high_key{};
+  bool has_high_key = false;
+  std::vector<page_id_t> leaves;
+  while (true) {
+    bool valid = false;
+    page_id_t child = INVALID_PAGE_ID;
+    KeyType child_high_key{};
+    bool child_has_high_key = false;
+    OptimisticPageHandle handle(page_id);
+    // The page may be torn or even reused for something else while read_fn runs; check before trusting its size.
+    ok = this->buffer_pool_manager_->ReadPageOptimistic(&handle, [&](const char *data) {
+      const auto *node = reinterpret_cast<const InternalPage *>(data);
+      valid = !node->IsLeafPage() && node->GetLevel() == level && node->GetSize() > 0 &&
+              node->GetSize() <= InternalPage::Capacity();
+      if (!valid) {
+        return;
+      }
+      int index = node->ChildIndex(key, this->comparator_);
+      if (level == 1) {
+        this->FillReadAhead(node, index, high_key, has_high_key, iterator, &leaves);
+        return;
+      }
+      child = node->ValueAt(index);
+      child_has_high_key = index + 1 < node->GetSize() || has_high_key;
+      child_high_key = index + 1 < node->GetSize() ? node->KeyAt(index + 1) : high_key;
+    });
+    if (!ok || !valid) {
+      // The tree changed shape under the lookup; the scan goes on without read-ahead.
+      iterator->has_read_ahead_key_ = false;
+      return;
+    }
+    if (level == 1) {
+      break;
+    }
+    page_id = child;
+    high_key = child_high_key;
+    has_high_key = child_has_high_key;
+    --level;
+  }
+  this->DispatchReadAhead(leaves);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DispatchReadAhead(const std::vector<page_id_t> &leaves) {
+  ParallelBufferPoolManager *bpm = this->buffer_pool_manager_;
+  for (page_id_t page_id : leaves) {
+    bpm->FetchPageAsync(page_id, [bpm](Page *page) {
+      if (page != nullptr) {
+        bpm->UnpinPage(page->GetPageId(), false);
+      }
+    });
+  }
+}
+
+/*****************************************************************************
+ * UTILITIES
+ *****************************************************************************/
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchRead(page_id_t page_id) -> ReadPageGuard {
+  ReadPageGuard guard = this->buffer_pool_manager_->FetchPageRead(page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to fetch a page of index " + this->index_name_);
+  }
+  return guard;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchWrite(page_id_t page_id) -> WritePageGuard {
+  WritePageGuard guard = this->buffer_pool_manager_->FetchPageWrite(page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to fetch a page of index " + this->index_name_);
+  }
+  return guard;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewNode(page_id_t *page_id) -> WritePageGuard {
+  WritePageGuard guard = this->buffer_pool_manager_->NewPageGuarded(page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to allocate a page of index " + this->index_name_);
+  }
+  return guard;
+}
+
+template class BPlusTree<int32_t, int64_t, IntComparator<int32_t>>;
+template class BPlusTree<int64_t, int64_t, IntComparator<int64_t>>;
+
+}  // namespace bustub
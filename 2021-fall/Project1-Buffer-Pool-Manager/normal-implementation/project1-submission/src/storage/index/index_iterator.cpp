@@ -0,0 +1,49 @@
+/**
+ * index_iterator.cpp
+ */
+#include "storage/index/index_iterator.h"
+
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  return this->guard_.template As<LeafPage>()->GetItem(this->index_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  ++this->index_;
+  this->Advance();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Advance() {
+  while (this->guard_.IsValid()) {
+    const auto *leaf = this->guard_.template As<LeafPage>();
+    if (this->index_ < leaf->GetSize()) {
+      return;
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    this->guard_.Drop();
+    this->page_id_ = INVALID_PAGE_ID;
+    this->index_ = 0;
+    if (next_page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    if (this->tree_->read_ahead_pages_ > 0 && this->has_read_ahead_key_ &&
+        (next_page_id == this->read_ahead_trigger_ || this->read_ahead_trigger_ == INVALID_PAGE_ID)) {
+      this->tree_->ReadAhead(this);
+    }
+    this->guard_ = this->tree_->FetchRead(next_page_id);
+    this->page_id_ = next_page_id;
+  }
+}
+
+template class IndexIterator<int32_t, int64_t, IntComparator<int32_t>>;
+template class IndexIterator<int64_t, int64_t, IntComparator<int64_t>>;
+
+}  // namespace bustub
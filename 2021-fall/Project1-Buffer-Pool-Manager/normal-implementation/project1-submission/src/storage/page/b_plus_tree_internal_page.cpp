@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_internal_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_internal_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_internal_page.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+
+/*
+ * Init method after creating a new internal page
+ * Including set page type, set current size, set page id, set level and set max page size
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, int level, int max_size) {
+  BUSTUB_ASSERT(level > 0, "Internal pages are above the leaves.");
+  BUSTUB_ASSERT(max_size >= 3 && max_size < Capacity(), "Internal max size out of range.");
+  this->SetPageType(IndexPageType::INTERNAL_PAGE);
+  this->SetLSN();
+  this->SetSize(0);
+  this->SetMaxSize(max_size);
+  this->SetLevel(level);
+  this->SetPageId(page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < this->GetSize(); ++i) {
+    if (this->array_[i].second == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+
+/*
+ * Find the last child whose key is not greater than key. The search starts from the second key, the first one is
+ * always invalid.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int lo = 1;
+  int hi = this->GetSize();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (comparator(this->array_[mid].first, key) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo - 1;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+
+/*
+ * Populate new root page with old_value + new_key & new_value. Only called when the old root splits.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) {
+  this->array_[0].second = old_value;
+  this->array_[1] = MappingType(new_key, new_value);
+  this->SetSize(2);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) -> int {
+  int size = this->GetSize();
+  int index = this->ValueIndex(old_value) + 1;
+  BUSTUB_ASSERT(index > 0, "The split child is not in its parent.");
+  std::move_backward(this->array_ + index, this->array_ + size, this->array_ + size + 1);
+  this->array_[index] = MappingType(new_key, new_value);
+  this->IncreaseSize(1);
+  return size + 1;
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient) {
+  int size = this->GetSize();
+  int keep = (size + 1) / 2;
+  recipient->CopyNFrom(this->array_ + keep, size - keep);
+  this->SetSize(keep);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(const MappingType *items, int size) {
+  std::copy(items, items + size, this->array_ + this->GetSize());
+  this->IncreaseSize(size);
+}
+
+// valuetype for internalNode should be page id_t
+template class BPlusTreeInternalPage<int32_t, page_id_t, IntComparator<int32_t>>;
+template class BPlusTreeInternalPage<int64_t, page_id_t, IntComparator<int64_t>>;
+
+}  // namespace bustub
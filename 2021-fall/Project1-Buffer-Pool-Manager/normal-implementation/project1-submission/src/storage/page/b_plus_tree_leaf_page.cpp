@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_leaf_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_leaf_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+
+/**
+ * Init method after creating a new leaf page
+ * Including set page type, set current size to zero, set page id/next page id and set max size
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, int max_size) {
+  BUSTUB_ASSERT(max_size >= 2 && max_size <= Capacity(), "Leaf max size out of range.");
+  this->SetPageType(IndexPageType::LEAF_PAGE);
+  this->SetLSN();
+  this->SetSize(0);
+  this->SetMaxSize(max_size);
+  this->SetLevel(0);
+  this->SetPageId(page_id);
+  this->next_page_id_ = INVALID_PAGE_ID;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int lo = 0;
+  int hi = this->GetSize();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (comparator(this->array_[mid].first, key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
+    -> int {
+  int size = this->GetSize();
+  int index = this->KeyIndex(key, comparator);
+  if (index < size && comparator(this->array_[index].first, key) == 0) {
+    return size;
+  }
+  std::move_backward(this->array_ + index, this->array_ + size, this->array_ + size + 1);
+  this->array_[index] = MappingType(key, value);
+  this->IncreaseSize(1);
+  return size + 1;
+}
+
+/*****************************************************************************
+ * SPLIT
+ *****************************************************************************/
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+  int size = this->GetSize();
+  int keep = size / 2;
+  recipient->CopyNFrom(this->array_ + keep, size - keep);
+  this->SetSize(keep);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const MappingType *items, int size) {
+  std::copy(items, items + size, this->array_ + this->GetSize());
+  this->IncreaseSize(size);
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const
+    -> bool {
+  int index = this->KeyIndex(key, comparator);
+  if (index == this->GetSize() || comparator(this->array_[index].first, key) != 0) {
+    return false;
+  }
+  *value = this->array_[index].second;
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> int {
+  int size = this->GetSize();
+  int index = this->KeyIndex(key, comparator);
+  if (index == size || comparator(this->array_[index].first, key) != 0) {
+    return size;
+  }
+  std::move(this->array_ + index + 1, this->array_ + size, this->array_ + index);
+  this->IncreaseSize(-1);
+  return size - 1;
+}
+
+template class BPlusTreeLeafPage<int32_t, int64_t, IntComparator<int32_t>>;
+template class BPlusTreeLeafPage<int64_t, int64_t, IntComparator<int64_t>>;
+
+}  // namespace bustub
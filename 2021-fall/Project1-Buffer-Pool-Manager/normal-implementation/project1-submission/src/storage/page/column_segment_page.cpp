@@ -0,0 +1,556 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_segment_page.cpp
+//
+// Identification: src/storage/page/column_segment_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/column_segment_page.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+void PackCodes(const std::vector<uint64_t> &codes, uint8_t width, char *out) {
+  size_t count = codes.size();
+  switch (width) {
+    case 0:
+      break;
+    case 8:
+      std::copy(codes.begin(), codes.end(), reinterpret_cast<uint8_t *>(out));
+      break;
+    case 16:
+      std::copy(codes.begin(), codes.end(), reinterpret_cast<uint16_t *>(out));
+      break;
+    case 32:
+      std::copy(codes.begin(), codes.end(), reinterpret_cast<uint32_t *>(out));
+      break;
+    case 64:
+      std::copy(codes.begin(), codes.end(), reinterpret_cast<uint64_t *>(out));
+      break;
+    default: {
+      auto *bytes = reinterpret_cast<uint8_t *>(out);
+      memset(bytes, 0, (count * width + 7) / 8);
+      for (size_t i = 0; i < count; ++i) {
+        size_t bit = i * width;
+        bytes[bit / 8] |= static_cast<uint8_t>(codes[i] << (bit % 8));
+      }
+      break;
+    }
+  }
+}
+
+auto CodeAt(const char *codes, uint8_t width, uint32_t row) -> uint64_t {
+  switch (width) {
+    case 0:
+      return 0;
+    case 8:
+      return reinterpret_cast<const uint8_t *>(codes)[row];
+    case 16:
+      return reinterpret_cast<const uint16_t *>(codes)[row];
+    case 32:
+      return reinterpret_cast<const uint32_t *>(codes)[row];
+    case 64:
+      return reinterpret_cast<const uint64_t *>(codes)[row];
+    default: {
+      size_t bit = static_cast<size_t>(row) * width;
+      return (reinterpret_cast<const uint8_t *>(codes)[bit / 8] >> (bit % 8)) & ((1U << width) - 1);
+    }
+  }
+}
+
+/**
+ * match[i] = lo <= codes[begin + i] <= hi, written as one unsigned comparison of code - lo with hi - lo, so that the
+ * loop over a plain array of codes compiles to vector instructions.
+ */
+template <class T>
+void MatchCodeArray(const T *codes, uint64_t lo, uint64_t hi, uint32_t begin, uint32_t count, uint8_t *match) {
+  auto low = static_cast<T>(lo);
+  auto range = static_cast<T>(hi - lo);
+  codes += begin;
+  for (uint32_t i = 0; i < count; ++i) {
+    match[i] = static_cast<uint8_t>(static_cast<T>(codes[i] - low) <= range);
+  }
+}
+
+/** The range of values a comparison with a constant holds for; false if it holds for none. */
+auto ValueRange(ComparisonType type, int64_t constant, int64_t *lo, int64_t *hi) -> bool {
+  *lo = INT64_MIN;
+  *hi = INT64_MAX;
+  switch (type) {
+    case ComparisonType::EQUAL:
+    case ComparisonType::NOT_EQUAL:
+      *lo = constant;
+      *hi = constant;
+      return true;
+    case ComparisonType::LESS_THAN:
+      if (constant == INT64_MIN) {
+        return false;
+      }
+      *hi = constant - 1;
+      return true;
+    case ComparisonType::LESS_THAN_OR_EQUAL:
+      *hi = constant;
+      return true;
+    case ComparisonType::GREATER_THAN:
+      if (constant == INT64_MAX) {
+        return false;
+      }
+      *lo = constant + 1;
+      return true;
+    case ComparisonType::GREATER_THAN_OR_EQUAL:
+      *lo = constant;
+      return true;
+  }
+  UNREACHABLE("Unknown comparison.");
+}
+
+/**
+ * The range of positions, in a sorted array, of the values a comparison holds for.
+ * @param lower first position not less than the constant
+ * @param upper first position greater than the constant
+ * @return false if the range is empty
+ */
+auto PositionRange(ComparisonType type, size_t lower, size_t upper, size_t size, uint64_t *lo, uint64_t *hi) -> bool {
+  size_t begin = 0;
+  size_t end = size;
+  switch (type) {
+    case ComparisonType::EQUAL:
+    case ComparisonType::NOT_EQUAL:
+      begin = lower;
+      end = upper;
+      break;
+    case ComparisonType::LESS_THAN:
+      end = lower;
+      break;
+    case ComparisonType::LESS_THAN_OR_EQUAL:
+      end = upper;
+      break;
+    case ComparisonType::GREATER_THAN:
+      begin = upper;
+      break;
+    case ComparisonType::GREATER_THAN_OR_EQUAL:
+      begin = lower;
+      break;
+  }
+  *lo = begin;
+  *hi = end - 1;
+  return begin < end;
+}
+
+template <class T>
+auto Compare(ComparisonType type, const T &a, const T &b) -> bool {
+  switch (type) {
+    case ComparisonType::EQUAL:
+      return a == b;
+    case ComparisonType::NOT_EQUAL:
+      return a != b;
+    case ComparisonType::LESS_THAN:
+      return a < b;
+    case ComparisonType::LESS_THAN_OR_EQUAL:
+      return a <= b;
+    case ComparisonType::GREATER_THAN:
+      return a > b;
+    case ComparisonType::GREATER_THAN_OR_EQUAL:
+      return a >= b;
+  }
+  UNREACHABLE("Unknown comparison.");
+}
+
+}  // namespace
+
+void ColumnSegmentPage::Init(page_id_t page_id, uint64_t start_row, uint32_t count, ColumnType type,
+                             SegmentEncoding encoding, const uint8_t *nulls) {
+  static_assert(offsetof(ColumnSegmentPage, data_) == HEADER_SIZE, "The regions follow the header.");
+  this->page_id_ = page_id;
+  this->lsn_ = INVALID_LSN;
+  this->next_page_id_ = INVALID_PAGE_ID;
+  this->row_count_ = count;
+  this->start_row_ = start_row;
+  this->base_ = 0;
+  this->entry_count_ = 0;
+  this->type_ = type;
+  this->encoding_ = encoding;
+  this->bit_width_ = 0;
+  this->has_nulls_ = static_cast<uint8_t>(std::any_of(nulls, nulls + count, [](uint8_t null) { return null != 0; }));
+  if (this->has_nulls_ != 0) {
+    auto *bitmap = reinterpret_cast<uint8_t *>(this->data_);
+    memset(bitmap, 0, NullBitmapSize(count, true));
+    for (uint32_t i = 0; i < count; ++i) {
+      bitmap[i / 8] |= static_cast<uint8_t>((nulls[i] != 0) << (i % 8));
+    }
+  }
+}
+
+void ColumnSegmentPage::WriteIntegers(page_id_t page_id, uint64_t start_row, const int64_t *values,
+                                      const uint8_t *nulls, uint32_t count, SegmentEncoding encoding) {
+  this->Init(page_id, start_row, count, ColumnType::INTEGER, encoding, nulls);
+  char *regions = this->Regions();
+  std::vector<uint64_t> codes(count, 0);
+  switch (encoding) {
+    case SegmentEncoding::BITPACK: {
+      int64_t min = INT64_MAX;
+      int64_t max = INT64_MIN;
+      for (uint32_t i = 0; i < count; ++i) {
+        if (nulls[i] == 0) {
+          min = std::min(min, values[i]);
+          max = std::max(max, values[i]);
+        }
+      }
+      this->base_ = min <= max ? min : 0;
+      for (uint32_t i = 0; i < count; ++i) {
+        codes[i] = nulls[i] != 0 ? 0 : static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(this->base_);
+      }
+      this->bit_width_ = min <= max ? BitWidth(static_cast<uint64_t>(max) - static_cast<uint64_t>(min)) : 0;
+      PackCodes(codes, this->bit_width_, regions);
+      break;
+    }
+    case SegmentEncoding::RLE: {
+      std::vector<int64_t> run_values;
+      std::vector<uint32_t> run_ends;
+      for (uint32_t i = 0; i < count; ++i) {
+        if (i == 0 || (nulls[i] == 0 && values[i] != run_values.back())) {
+          run_values.push_back(nulls[i] != 0 ? 0 : values[i]);
+          run_ends.push_back(i);
+        }
+        run_ends.back() = i + 1;
+      }
+      this->entry_count_ = static_cast<uint32_t>(run_values.size());
+      std::copy(run_values.begin(), run_values.end(), reinterpret_cast<int64_t *>(regions));
+      std::copy(run_ends.begin(), run_ends.end(),
+                reinterpret_cast<uint32_t *>(regions + Align8(run_values.size() * sizeof(int64_t))));
+      break;
+    }
+    case SegmentEncoding::DICTIONARY: {
+      std::vector<int64_t> dictionary;
+      for (uint32_t i = 0; i < count; ++i) {
+        if (nulls[i] == 0) {
+          dictionary.push_back(values[i]);
+        }
+      }
+      std::sort(dictionary.begin(), dictionary.end());
+      dictionary.erase(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+      for (uint32_t i = 0; i < count; ++i) {
+        if (nulls[i] == 0) {
+          codes[i] = std::lower_bound(dictionary.begin(), dictionary.end(), values[i]) - dictionary.begin();
+        }
+      }
+      this->entry_count_ = static_cast<uint32_t>(dictionary.size());
+      this->bit_width_ = CodeWidth(dictionary.size());
+      std::copy(dictionary.begin(), dictionary.end(), reinterpret_cast<int64_t *>(regions));
+      PackCodes(codes, this->bit_width_, regions + dictionary.size() * sizeof(int64_t));
+      break;
+    }
+    case SegmentEncoding::PLAIN:
+      UNREACHABLE("INTEGER segments are not stored plain.");
+  }
+}
+
+void ColumnSegmentPage::WriteTexts(page_id_t page_id, uint64_t start_row, const std::string_view *values,
+                                   const uint8_t *nulls, uint32_t count, SegmentEncoding encoding) {
+  this->Init(page_id, start_row, count, ColumnType::TEXT, encoding, nulls);
+  char *regions = this->Regions();
+  switch (encoding) {
+    case SegmentEncoding::DICTIONARY: {
+      std::vector<std::string_view> dictionary;
+      for (uint32_t i = 0; i < count; ++i) {
+        if (nulls[i] == 0) {
+          dictionary.push_back(values[i]);
+        }
+      }
+      std::sort(dictionary.begin(), dictionary.end());
+      dictionary.erase(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+      std::vector<uint64_t> codes(count, 0);
+      for (uint32_t i = 0; i < count; ++i) {
+        if (nulls[i] == 0) {
+          codes[i] = std::lower_bound(dictionary.begin(), dictionary.end(), values[i]) - dictionary.begin();
+        }
+      }
+      this->entry_count_ = static_cast<uint32_t>(dictionary.size());
+      this->bit_width_ = CodeWidth(dictionary.size());
+      auto *offsets = reinterpret_cast<uint32_t *>(regions);
+      char *packed = regions + Align8((dictionary.size() + 1) * sizeof(uint32_t));
+      char *bytes = packed + PackedSize(count, this->bit_width_);
+      PackCodes(codes, this->bit_width_, packed);
+      uint32_t offset = 0;
+      for (size_t i = 0; i < dictionary.size(); ++i) {
+        offsets[i] = offset;
+        memcpy(bytes + offset, dictionary[i].data(), dictionary[i].size());
+        offset += static_cast<uint32_t>(dictionary[i].size());
+      }
+      offsets[dictionary.size()] = offset;
+      BUSTUB_ASSERT(bytes + offset <= this->data_ + DATA_SIZE, "Segment overflows its page.");
+      break;
+    }
+    case SegmentEncoding::PLAIN: {
+      auto *offsets = reinterpret_cast<uint32_t *>(regions);
+      char *bytes = regions + Align8((count + 1) * sizeof(uint32_t));
+      uint32_t offset = 0;
+      for (uint32_t i = 0; i < count; ++i) {
+        offsets[i] = offset;
+        if (nulls[i] == 0) {
+          memcpy(bytes + offset, values[i].data(), values[i].size());
+          offset += static_cast<uint32_t>(values[i].size());
+        }
+      }
+      offsets[count] = offset;
+      BUSTUB_ASSERT(bytes + offset <= this->data_ + DATA_SIZE, "Segment overflows its page.");
+      break;
+    }
+    case SegmentEncoding::BITPACK:
+    case SegmentEncoding::RLE:
+      UNREACHABLE("TEXT segments are stored with a dictionary or plain.");
+  }
+}
+
+void ColumnSegmentPage::WriteReals(page_id_t page_id, uint64_t start_row, const double *values,
+                                   const uint8_t *nulls, uint32_t count) {
+  this->Init(page_id, start_row, count, ColumnType::REAL, SegmentEncoding::PLAIN, nulls);
+  std::copy(values, values + count, reinterpret_cast<double *>(this->Regions()));
+}
+
+void ColumnSegmentPage::Gather(const uint32_t *rows, size_t count, ColumnVector *out) const {
+  const char *regions = this->Regions();
+  if (this->type_ == ColumnType::INTEGER) {
+    switch (this->encoding_) {
+      case SegmentEncoding::BITPACK:
+        for (size_t i = 0; i < count; ++i) {
+          if (this->IsNull(rows[i])) {
+            out->AppendNull();
+          } else {
+            uint64_t code = CodeAt(regions, this->bit_width_, rows[i]);
+            out->AppendInteger(static_cast<int64_t>(static_cast<uint64_t>(this->base_) + code));
+          }
+        }
+        return;
+      case SegmentEncoding::RLE: {
+        const auto *run_values = reinterpret_cast<const int64_t *>(regions);
+        const auto *run_ends =
+            reinterpret_cast<const uint32_t *>(regions + Align8(this->entry_count_ * sizeof(int64_t)));
+        // The rows increase, so the run of each one is at or after the run of the one before.
+        const uint32_t *run = run_ends;
+        for (size_t i = 0; i < count; ++i) {
+          run = std::upper_bound(run, run_ends + this->entry_count_, rows[i]);
+          if (this->IsNull(rows[i])) {
+            out->AppendNull();
+          } else {
+            out->AppendInteger(run_values[run - run_ends]);
+          }
+        }
+        return;
+      }
+      case SegmentEncoding::DICTIONARY: {
+        const auto *dictionary = reinterpret_cast<const int64_t *>(regions);
+        const char *codes = regions + this->entry_count_ * sizeof(int64_t);
+        for (size_t i = 0; i < count; ++i) {
+          if (this->IsNull(rows[i])) {
+            out->AppendNull();
+          } else {
+            out->AppendInteger(dictionary[CodeAt(codes, this->bit_width_, rows[i])]);
+          }
+        }
+        return;
+      }
+      case SegmentEncoding::PLAIN:
+        break;
+    }
+    UNREACHABLE("Unknown INTEGER encoding.");
+  }
+  if (this->type_ == ColumnType::REAL) {
+    const auto *values = reinterpret_cast<const double *>(regions);
+    for (size_t i = 0; i < count; ++i) {
+      if (this->IsNull(rows[i])) {
+        out->AppendNull();
+      } else {
+        out->AppendReal(values[rows[i]]);
+      }
+    }
+    return;
+  }
+
+  const auto *offsets = reinterpret_cast<const uint32_t *>(regions);
+  if (this->encoding_ == SegmentEncoding::DICTIONARY) {
+    const char *codes = regions + Align8((this->entry_count_ + 1) * sizeof(uint32_t));
+    const char *bytes = codes + PackedSize(this->row_count_, this->bit_width_);
+    for (size_t i = 0; i < count; ++i) {
+      if (this->IsNull(rows[i])) {
+        out->AppendNull();
+      } else {
+        uint64_t code = CodeAt(codes, this->bit_width_, rows[i]);
+        out->AppendText({bytes + offsets[code], offsets[code + 1] - offsets[code]});
+      }
+    }
+    return;
+  }
+  const char *bytes = regions + Align8((this->row_count_ + 1) * sizeof(uint32_t));
+  for (size_t i = 0; i < count; ++i) {
+    if (this->IsNull(rows[i])) {
+      out->AppendNull();
+    } else {
+      out->AppendText({bytes + offsets[rows[i]], offsets[rows[i] + 1] - offsets[rows[i]]});
+    }
+  }
+}
+
+void ColumnSegmentPage::MatchCodes(const char *codes, uint64_t lo, uint64_t hi, uint32_t begin, uint32_t count,
+                                   uint8_t *match) const {
+  switch (this->bit_width_) {
+    case 0:
+      memset(match, static_cast<int>(lo == 0), count);
+      return;
+    case 8:
+      MatchCodeArray(reinterpret_cast<const uint8_t *>(codes), lo, hi, begin, count, match);
+      return;
+    case 16:
+      MatchCodeArray(reinterpret_cast<const uint16_t *>(codes), lo, hi, begin, count, match);
+      return;
+    case 32:
+      MatchCodeArray(reinterpret_cast<const uint32_t *>(codes), lo, hi, begin, count, match);
+      return;
+    case 64:
+      MatchCodeArray(reinterpret_cast<const uint64_t *>(codes), lo, hi, begin, count, match);
+      return;
+    default:
+      for (uint32_t i = 0; i < count; ++i) {
+        match[i] = static_cast<uint8_t>(CodeAt(codes, this->bit_width_, begin + i) - lo <= hi - lo);
+      }
+      return;
+  }
+}
+
+void ColumnSegmentPage::FinishMatch(bool negate, uint32_t begin, uint32_t count, uint8_t *match) const {
+  if (negate) {
+    for (uint32_t i = 0; i < count; ++i) {
+      match[i] ^= 1;
+    }
+  }
+  if (this->has_nulls_ != 0) {
+    for (uint32_t i = 0; i < count; ++i) {
+      match[i] &= static_cast<uint8_t>(!this->IsNull(begin + i));
+    }
+  }
+}
+
+void ColumnSegmentPage::Match(ComparisonType type, int64_t constant, uint32_t begin, uint32_t count,
+                              uint8_t *match) const {
+  BUSTUB_ASSERT(this->type_ == ColumnType::INTEGER, "Comparing a TEXT segment with a number.");
+  bool negate = type == ComparisonType::NOT_EQUAL;
+  const char *regions = this->Regions();
+  int64_t value_lo;
+  int64_t value_hi;
+  uint64_t lo = 1;
+  uint64_t hi = 0;
+  bool any = ValueRange(type, constant, &value_lo, &value_hi);
+  switch (this->encoding_) {
+    case SegmentEncoding::BITPACK: {
+      uint64_t max_code = this->bit_width_ == 64 ? UINT64_MAX : (uint64_t{1} << this->bit_width_) - 1;
+      if (any && value_hi >= this->base_) {
+        lo = value_lo <= this->base_ ? 0 : static_cast<uint64_t>(value_lo) - static_cast<uint64_t>(this->base_);
+        hi = std::min(max_code, static_cast<uint64_t>(value_hi) - static_cast<uint64_t>(this->base_));
+      }
+      if (lo <= hi) {
+        this->MatchCodes(regions, lo, hi, begin, count, match);
+      } else {
+        memset(match, 0, count);
+      }
+      break;
+    }
+    case SegmentEncoding::RLE: {
+      const auto *run_values = reinterpret_cast<const int64_t *>(regions);
+      const auto *run_ends =
+          reinterpret_cast<const uint32_t *>(regions + Align8(this->entry_count_ * sizeof(int64_t)));
+      // One comparison per run rather than per row.
+      size_t run = std::upper_bound(run_ends, run_ends + this->entry_count_, begin) - run_ends;
+      uint32_t row = begin;
+      while (row < begin + count) {
+        uint32_t end = std::min(run_ends[run], begin + count);
+        bool hit = any && run_values[run] >= value_lo && run_values[run] <= value_hi;
+        memset(match + (row - begin), static_cast<int>(hit), end - row);
+        row = end;
+        ++run;
+      }
+      break;
+    }
+    case SegmentEncoding::DICTIONARY: {
+      const auto *dictionary = reinterpret_cast<const int64_t *>(regions);
+      const int64_t *end = dictionary + this->entry_count_;
+      if (any) {
+        lo = std::lower_bound(dictionary, end, value_lo) - dictionary;
+        size_t upper = std::upper_bound(dictionary, end, value_hi) - dictionary;
+        hi = upper - 1;
+        any = lo < upper;
+      }
+      if (any) {
+        this->MatchCodes(regions + this->entry_count_ * sizeof(int64_t), lo, hi, begin, count, match);
+      } else {
+        memset(match, 0, count);
+      }
+      break;
+    }
+    case SegmentEncoding::PLAIN:
+      UNREACHABLE("INTEGER segments are not stored plain.");
+  }
+  this->FinishMatch(negate, begin, count, match);
+}
+
+void ColumnSegmentPage::Match(ComparisonType type, std::string_view constant, uint32_t begin, uint32_t count,
+                              uint8_t *match) const {
+  BUSTUB_ASSERT(this->type_ == ColumnType::TEXT, "Comparing a number segment with a string.");
+  bool negate = type == ComparisonType::NOT_EQUAL;
+  const char *regions = this->Regions();
+  const auto *offsets = reinterpret_cast<const uint32_t *>(regions);
+  if (this->encoding_ == SegmentEncoding::DICTIONARY) {
+    // The constant is looked up in the dictionary once; the rows only compare codes.
+    const char *codes = regions + Align8((this->entry_count_ + 1) * sizeof(uint32_t));
+    const char *bytes = codes + PackedSize(this->row_count_, this->bit_width_);
+    auto entry = [&](size_t code) {
+      return std::string_view(bytes + offsets[code], offsets[code + 1] - offsets[code]);
+    };
+    size_t lower = 0;
+    size_t upper = this->entry_count_;
+    for (size_t size = upper; size > 0;) {
+      size_t half = size / 2;
+      if (entry(lower + half) < constant) {
+        lower += half + 1;
+        size -= half + 1;
+      } else {
+        size = half;
+      }
+    }
+    upper = lower;
+    while (upper < this->entry_count_ && entry(upper) == constant) {
+      ++upper;
+    }
+    uint64_t lo;
+    uint64_t hi;
+    if (PositionRange(type, lower, upper, this->entry_count_, &lo, &hi)) {
+      this->MatchCodes(codes, lo, hi, begin, count, match);
+    } else {
+      memset(match, 0, count);
+    }
+  } else {
+    const char *bytes = regions + Align8((this->row_count_ + 1) * sizeof(uint32_t));
+    ComparisonType compare = negate ? ComparisonType::EQUAL : type;
+    for (uint32_t i = 0; i < count; ++i) {
+      uint32_t row = begin + i;
+      std::string_view value(bytes + offsets[row], offsets[row + 1] - offsets[row]);
+      match[i] = static_cast<uint8_t>(Compare(compare, value, constant));
+    }
+  }
+  this->FinishMatch(negate, begin, count, match);
+}
+
+}  // namespace bustub
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.cpp
+//
+// Identification: src/storage/page/hash_table_bucket_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_bucket_page.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::GetValue(const KeyType &key, const KeyComparator &cmp,
+                                      std::vector<ValueType> *result) const -> bool {
+  bool found = false;
+  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && this->IsOccupied(i); ++i) {
+    if (this->IsReadable(i) && cmp(this->array_[i].first, key) == 0) {
+      result->push_back(this->array_[i].second);
+      found = true;
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &cmp) -> bool {
+  uint32_t free_slot = BUCKET_ARRAY_SIZE;
+  uint32_t i = 0;
+  for (; i < BUCKET_ARRAY_SIZE && this->IsOccupied(i); ++i) {
+    if (!this->IsReadable(i)) {
+      free_slot = std::min(free_slot, i);
+    } else if (cmp(this->array_[i].first, key) == 0 && this->array_[i].second == value) {
+      return false;
+    }
+  }
+  // Past the last occupied slot everything is free; reuse a tombstone first.
+  if (free_slot == BUCKET_ARRAY_SIZE) {
+    if (i == BUCKET_ARRAY_SIZE) {
+      return false;
+    }
+    free_slot = i;
+  }
+  this->array_[free_slot] = MappingType(key, value);
+  this->SetOccupied(free_slot);
+  this->SetReadable(free_slot);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Remove(const KeyType &key, const ValueType &value, const KeyComparator &cmp) -> bool {
+  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && this->IsOccupied(i); ++i) {
+    if (this->IsReadable(i) && cmp(this->array_[i].first, key) == 0 && this->array_[i].second == value) {
+      this->RemoveAt(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Contains(const KeyType &key, const ValueType &value, const KeyComparator &cmp) const
+    -> bool {
+  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && this->IsOccupied(i); ++i) {
+    if (this->IsReadable(i) && cmp(this->array_[i].first, key) == 0 && this->array_[i].second == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::NumReadable() const -> uint32_t {
+  uint32_t count = 0;
+  for (char byte : this->readable_) {
+    count += std::bitset<8>(static_cast<unsigned char>(byte)).count();
+  }
+  return count;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::GetAllItems(std::vector<MappingType> *items) const {
+  for (uint32_t i = 0; i < BUCKET_ARRAY_SIZE && this->IsOccupied(i); ++i) {
+    if (this->IsReadable(i)) {
+      items->push_back(this->array_[i]);
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::Clear() {
+  memset(this->occupied_, 0, sizeof(this->occupied_));
+  memset(this->readable_, 0, sizeof(this->readable_));
+}
+
+template class HashTableBucketPage<int32_t, int64_t, IntComparator<int32_t>>;
+template class HashTableBucketPage<int64_t, int64_t, IntComparator<int64_t>>;
+
+}  // namespace bustub
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.cpp
+//
+// Identification: src/storage/page/hash_table_directory_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_directory_page.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  BUSTUB_ASSERT(global_depth_ < MAX_DEPTH, "The directory is full.");
+  uint32_t size = Size();
+  std::copy(local_depths_, local_depths_ + size, local_depths_ + size);
+  std::copy(bucket_page_ids_, bucket_page_ids_ + size, bucket_page_ids_ + size);
+  global_depth_++;
+}
+
+void HashTableDirectoryPage::VerifyIntegrity() const {
+  //  build maps of {bucket_page_id : pointer_count} and {bucket_page_id : local_depth}
+  std::unordered_map<page_id_t, uint32_t> page_id_to_count;
+  std::unordered_map<page_id_t, uint32_t> page_id_to_ld;
+
+  for (uint32_t curr_idx = 0; curr_idx < Size(); curr_idx++) {
+    page_id_t curr_page_id = bucket_page_ids_[curr_idx];
+    uint32_t curr_ld = local_depths_[curr_idx];
+    BUSTUB_ASSERT(curr_ld <= global_depth_, "there exists a local depth greater than the global depth");
+
+    ++page_id_to_count[curr_page_id];
+
+    auto itr = page_id_to_ld.find(curr_page_id);
+    if (itr != page_id_to_ld.end()) {
+      BUSTUB_ASSERT(itr->second == curr_ld, "local depth differs between pointers to the same bucket");
+    } else {
+      page_id_to_ld[curr_page_id] = curr_ld;
+    }
+  }
+
+  for (const auto &[curr_page_id, curr_count] : page_id_to_count) {
+    uint32_t curr_ld = page_id_to_ld[curr_page_id];
+    uint32_t required_count = 0x1 << (global_depth_ - curr_ld);
+    BUSTUB_ASSERT(curr_count == required_count, "a bucket does not have precisely 2^(GD - LD) pointers to it");
+  }
+}
+
+}  // namespace bustub
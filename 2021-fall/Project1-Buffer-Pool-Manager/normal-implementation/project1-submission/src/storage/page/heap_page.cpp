@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// heap_page.cpp
+//
+// Identification: src/storage/page/heap_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/heap_page.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void HeapPage::Init(page_id_t page_id, page_id_t prev_page_id) {
+  static_assert(offsetof(HeapPage, slots_) == HEADER_SIZE, "The slots follow the header.");
+  this->page_id_ = page_id;
+  this->lsn_ = INVALID_LSN;
+  this->prev_page_id_ = prev_page_id;
+  this->next_page_id_ = INVALID_PAGE_ID;
+  this->free_space_pointer_ = PAGE_SIZE;
+  this->tuple_count_ = 0;
+}
+
+auto HeapPage::InsertTuple(const char *data, uint32_t size) -> bool {
+  BUSTUB_ASSERT(size > 0, "Cannot have empty tuples.");
+  if (this->GetFreeSpaceRemaining() < size + sizeof(Slot)) {
+    return false;
+  }
+  this->free_space_pointer_ -= size;
+  memcpy(reinterpret_cast<char *>(this) + this->free_space_pointer_, data, size);
+  this->slots_[this->tuple_count_] = {this->free_space_pointer_, size};
+  this->tuple_count_++;
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.cpp
+//
+// Identification: src/storage/page/page_guard.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/page_guard.h"
+
+#include <utility>
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+namespace bustub {
+
+BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
+    : bpm_(that.bpm_), page_(that.page_), frame_id_(that.frame_id_), is_dirty_(that.is_dirty_) {
+  that.bpm_ = nullptr;
+  that.page_ = nullptr;
+  that.is_dirty_ = false;
+}
+
+auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard & {
+  if (this != &that) {
+    this->Drop();
+    this->bpm_ = that.bpm_;
+    this->page_ = that.page_;
+    this->frame_id_ = that.frame_id_;
+    this->is_dirty_ = that.is_dirty_;
+    that.bpm_ = nullptr;
+    that.page_ = nullptr;
+    that.is_dirty_ = false;
+  }
+  return *this;
+}
+
+BasicPageGuard::~BasicPageGuard() { this->Drop(); }
+
+void BasicPageGuard::Drop() {
+  if (this->page_ == nullptr) {
+    return;
+  }
+  this->bpm_->ReleasePage(this->page_, this->frame_id_, this->is_dirty_);
+  this->bpm_ = nullptr;
+  this->page_ = nullptr;
+  this->is_dirty_ = false;
+}
+
+auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard & {
+  if (this != &that) {
+    this->Drop();
+    this->guard_ = std::move(that.guard_);
+  }
+  return *this;
+}
+
+ReadPageGuard::~ReadPageGuard() { this->Drop(); }
+
+void ReadPageGuard::Drop() {
+  if (!this->guard_.IsValid()) {
+    return;
+  }
+  this->guard_.page_->RUnlatch();
+  this->guard_.Drop();
+}
+
+auto WritePageGuard::operator=(WritePageGuard &&that) noexcept -> WritePageGuard & {
+  if (this != &that) {
+    this->Drop();
+    this->guard_ = std::move(that.guard_);
+  }
+  return *this;
+}
+
+WritePageGuard::~WritePageGuard() { this->Drop(); }
+
+void WritePageGuard::Drop() {
+  if (!this->guard_.IsValid()) {
+    return;
+  }
+  this->guard_.page_->WUnlatch();
+  this->guard_.Drop();
+}
+
+}  // namespace bustub
@@ -0,0 +1,305 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// columnar_table.cpp
+//
+// Identification: src/storage/table/columnar_table.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/columnar_table.h"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+#include "common/exception.h"
+#include "execution/vector/heap_scan_operator.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+auto ColumnarTable::GetSize() const -> uint64_t {
+  uint64_t pages = 0;
+  for (const auto &segments : this->segments_) {
+    pages += segments.size();
+  }
+  for (const auto &zone_map : this->zone_maps_) {
+    pages += zone_map.GetPageIds().size();
+  }
+  return pages * PAGE_SIZE;
+}
+
+/**
+ * SegmentBuilder gathers the rows of the next segment of one column.
+ */
+class ColumnarTableWriter::SegmentBuilder {
+ public:
+  SegmentBuilder(BufferPoolManagerInstance *buffer_pool_manager, ColumnType type, std::vector<ColumnSegment> *segments)
+      : buffer_pool_manager_(buffer_pool_manager), type_(type), segments_(segments), zones_(buffer_pool_manager) {}
+
+  /** Append the value of a row of a column, writing the segment first if the value does not fit in it. */
+  void Add(const ColumnVector &column, size_t row) {
+    bool is_null = column.IsNull(row);
+    if (this->count_ > 0 && (this->count_ == MAX_SEGMENT_ROWS || this->SizeWith(column, row) > DATA_SIZE)) {
+      this->Flush();
+    }
+    if (this->count_ == 0 && this->SizeWith(column, row) > DATA_SIZE) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "A value does not fit in a column segment page");
+    }
+
+    this->has_nulls_ = this->has_nulls_ || is_null;
+    this->nulls_.push_back(static_cast<uint8_t>(is_null));
+    switch (this->type_) {
+      case ColumnType::INTEGER: {
+        int64_t value = is_null ? 0 : column.GetInteger(row);
+        this->integers_.push_back(value);
+        if (!is_null) {
+          this->min_ = std::min(this->min_, value);
+          this->max_ = std::max(this->max_, value);
+          this->distinct_integers_.insert(value);
+        }
+        // NULL rows extend the run before them; a leading one starts a run of 0.
+        if (this->count_ == 0 || (!is_null && value != this->run_value_)) {
+          ++this->num_runs_;
+          this->run_value_ = value;
+        }
+        break;
+      }
+      case ColumnType::REAL:
+        this->reals_.push_back(is_null ? 0 : column.GetReal(row));
+        break;
+      case ColumnType::TEXT:
+        if (!is_null) {
+          std::string_view value = column.GetText(row);
+          this->bytes_.append(value);
+          if (this->distinct_texts_.emplace(value).second) {
+            this->distinct_bytes_ += value.size();
+          }
+        }
+        this->text_ends_.push_back(this->bytes_.size());
+        break;
+    }
+    ++this->count_;
+  }
+
+  /** Write the rows gathered so far to a new page, with the encoding that takes the least space. */
+  void Flush() {
+    if (this->count_ == 0) {
+      return;
+    }
+    page_id_t page_id;
+    WritePageGuard guard = this->buffer_pool_manager_->NewPageGuarded(&page_id);
+    if (!guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to write a column segment");
+    }
+    auto *page = guard.AsMut<ColumnSegmentPage>();
+    SegmentEncoding encoding = SegmentEncoding::PLAIN;
+    switch (this->type_) {
+      case ColumnType::INTEGER:
+        encoding = this->BestIntegerEncoding(this->count_, this->has_nulls_, this->Range(this->min_, this->max_),
+                                             this->num_runs_, this->distinct_integers_.size());
+        page->WriteIntegers(page_id, this->start_row_, this->integers_.data(), this->nulls_.data(), this->count_,
+                            encoding);
+        break;
+      case ColumnType::REAL:
+        page->WriteReals(page_id, this->start_row_, this->reals_.data(), this->nulls_.data(), this->count_);
+        break;
+      case ColumnType::TEXT: {
+        std::vector<std::string_view> values(this->count_);
+        size_t begin = 0;
+        for (uint32_t i = 0; i < this->count_; ++i) {
+          values[i] = std::string_view(this->bytes_).substr(begin, this->text_ends_[i] - begin);
+          begin = this->text_ends_[i];
+        }
+        encoding = ColumnSegmentPage::TextSize(SegmentEncoding::DICTIONARY, this->count_, this->has_nulls_,
+                                               this->distinct_texts_.size(), this->distinct_bytes_,
+                                               this->bytes_.size()) <= this->TextPlainSize(this->count_)
+                       ? SegmentEncoding::DICTIONARY
+                       : SegmentEncoding::PLAIN;
+        page->WriteTexts(page_id, this->start_row_, values.data(), this->nulls_.data(), this->count_, encoding);
+        break;
+      }
+    }
+    if (this->last_guard_.IsValid()) {
+      this->last_guard_.AsMut<ColumnSegmentPage>()->SetNextPageId(page_id);
+    }
+    this->last_guard_ = std::move(guard);
+    this->segments_->push_back({page_id, this->start_row_, this->count_, encoding});
+    if (this->type_ == ColumnType::INTEGER) {
+      this->zones_.Append({page_id, this->count_, this->min_, this->max_});
+    }
+
+    this->start_row_ += this->count_;
+    this->count_ = 0;
+    this->has_nulls_ = false;
+    this->nulls_.clear();
+    this->integers_.clear();
+    this->reals_.clear();
+    this->min_ = INT64_MAX;
+    this->max_ = INT64_MIN;
+    this->num_runs_ = 0;
+    this->distinct_integers_.clear();
+    this->bytes_.clear();
+    this->text_ends_.clear();
+    this->distinct_texts_.clear();
+    this->distinct_bytes_ = 0;
+  }
+
+  /** Let go of the last page, and hand the zone map over. */
+  void Close(ZoneMap *zone_map) {
+    this->last_guard_.Drop();
+    this->zones_.Finish(zone_map);
+  }
+
+ private:
+  static constexpr size_t DATA_SIZE = ColumnSegmentPage::DATA_SIZE;
+
+  static auto Range(int64_t min, int64_t max) -> uint64_t {
+    return min <= max ? static_cast<uint64_t>(max) - static_cast<uint64_t>(min) : 0;
+  }
+
+  /** @return the smallest of the INTEGER encodings; BITPACK on a tie, since it matches and gathers fastest */
+  static auto BestIntegerEncoding(size_t count, bool has_nulls, uint64_t range, size_t num_runs, size_t num_distinct)
+      -> SegmentEncoding {
+    SegmentEncoding best = SegmentEncoding::BITPACK;
+    size_t best_size = SIZE_MAX;
+    for (SegmentEncoding encoding : {SegmentEncoding::BITPACK, SegmentEncoding::DICTIONARY, SegmentEncoding::RLE}) {
+      size_t size = ColumnSegmentPage::IntegerSize(encoding, count, has_nulls, range, num_runs, num_distinct);
+      if (size < best_size) {
+        best = encoding;
+        best_size = size;
+      }
+    }
+    return best;
+  }
+
+  auto TextPlainSize(size_t count) const -> size_t {
+    return ColumnSegmentPage::TextSize(SegmentEncoding::PLAIN, count, this->has_nulls_, 0, 0, this->bytes_.size());
+  }
+
+  /** @return the size of the smallest encoding of the segment with a row of a column appended */
+  auto SizeWith(const ColumnVector &column, size_t row) const -> size_t {
+    bool is_null = column.IsNull(row);
+    bool has_nulls = this->has_nulls_ || is_null;
+    size_t count = this->count_ + 1;
+    switch (this->type_) {
+      case ColumnType::INTEGER: {
+        int64_t min = this->min_;
+        int64_t max = this->max_;
+        size_t num_runs = this->count_ == 0 ? 1 : this->num_runs_;
+        size_t num_distinct = this->distinct_integers_.size();
+        if (!is_null) {
+          int64_t value = column.GetInteger(row);
+          min = std::min(min, value);
+          max = std::max(max, value);
+          num_runs += static_cast<size_t>(this->count_ > 0 && value != this->run_value_);
+          num_distinct += static_cast<size_t>(this->distinct_integers_.count(value) == 0);
+        }
+        SegmentEncoding encoding = BestIntegerEncoding(count, has_nulls, Range(min, max), num_runs, num_distinct);
+        return ColumnSegmentPage::IntegerSize(encoding, count, has_nulls, Range(min, max), num_runs, num_distinct);
+      }
+      case ColumnType::REAL:
+        return ColumnSegmentPage::RealSize(count, has_nulls);
+      case ColumnType::TEXT: {
+        size_t num_distinct = this->distinct_texts_.size();
+        size_t distinct_bytes = this->distinct_bytes_;
+        size_t total_bytes = this->bytes_.size();
+        if (!is_null) {
+          std::string_view value = column.GetText(row);
+          total_bytes += value.size();
+          if (this->distinct_texts_.count(std::string(value)) == 0) {
+            ++num_distinct;
+            distinct_bytes += value.size();
+          }
+        }
+        return std::min(ColumnSegmentPage::TextSize(SegmentEncoding::DICTIONARY, count, has_nulls, num_distinct,
+                                                    distinct_bytes, total_bytes),
+                        ColumnSegmentPage::TextSize(SegmentEncoding::PLAIN, count, has_nulls, 0, 0, total_bytes));
+      }
+    }
+    UNREACHABLE("Unknown column type.");
+  }
+
+  BufferPoolManagerInstance *buffer_pool_manager_;
+  const ColumnType type_;
+  std::vector<ColumnSegment> *segments_;
+  /** Last page written, kept to link the next one to it. */
+  WritePageGuard last_guard_;
+  ZoneMapBuilder zones_;
+  uint64_t start_row_{0};
+
+  uint32_t count_{0};
+  bool has_nulls_{false};
+  std::vector<uint8_t> nulls_;
+  std::vector<int64_t> integers_;
+  std::vector<double> reals_;
+  int64_t min_{INT64_MAX};
+  int64_t max_{INT64_MIN};
+  size_t num_runs_{0};
+  int64_t run_value_{0};
+  std::unordered_set<int64_t> distinct_integers_;
+  std::string bytes_;
+  std::vector<size_t> text_ends_;
+  std::unordered_set<std::string> distinct_texts_;
+  size_t distinct_bytes_{0};
+};
+
+ColumnarTableWriter::ColumnarTableWriter(BufferPoolManagerInstance *buffer_pool_manager, std::string name,
+                                         std::vector<std::string> column_names, std::vector<ColumnType> column_types) {
+  BUSTUB_ASSERT(column_names.size() == column_types.size(), "One type per column.");
+  this->table_.name_ = std::move(name);
+  this->table_.column_names_ = std::move(column_names);
+  this->table_.column_types_ = std::move(column_types);
+  this->table_.segments_.resize(this->table_.column_types_.size());
+  for (size_t i = 0; i < this->table_.column_types_.size(); ++i) {
+    this->builders_.push_back(std::make_unique<SegmentBuilder>(buffer_pool_manager, this->table_.column_types_[i],
+                                                               &this->table_.segments_[i]));
+  }
+}
+
+ColumnarTableWriter::~ColumnarTableWriter() = default;
+
+void ColumnarTableWriter::Append(const DataChunk &chunk) {
+  BUSTUB_ASSERT(chunk.ColumnCount() == this->builders_.size(), "One column per column of the table.");
+  for (size_t i = 0; i < this->builders_.size(); ++i) {
+    const ColumnVector &column = chunk.GetColumn(i);
+    for (size_t row = 0; row < chunk.Size(); ++row) {
+      this->builders_[i]->Add(column, row);
+    }
+  }
+  this->table_.row_count_ += chunk.Size();
+}
+
+void ColumnarTableWriter::Finish(ColumnarTable *table) {
+  this->table_.zone_maps_.resize(this->builders_.size());
+  for (size_t i = 0; i < this->builders_.size(); ++i) {
+    this->builders_[i]->Flush();
+    this->builders_[i]->Close(&this->table_.zone_maps_[i]);
+  }
+  this->builders_.clear();
+  *table = std::move(this->table_);
+  this->table_ = ColumnarTable();
+}
+
+void BuildColumnarTable(BufferPoolManagerInstance *buffer_pool_manager, const LoadedTable &heap,
+                        const std::vector<ColumnType> &column_types, ColumnarTable *table) {
+  std::vector<uint32_t> column_ids(column_types.size());
+  for (uint32_t i = 0; i < column_ids.size(); ++i) {
+    column_ids[i] = i;
+  }
+  HeapScanOperator scan(buffer_pool_manager, heap.first_page_id_, std::move(column_ids), column_types);
+  ColumnarTableWriter writer(buffer_pool_manager, heap.name_, heap.column_names_, column_types);
+  DataChunk chunk;
+  scan.Init();
+  while (scan.Next(&chunk)) {
+    writer.Append(chunk);
+  }
+  writer.Finish(table);
+}
+
+}  // namespace bustub
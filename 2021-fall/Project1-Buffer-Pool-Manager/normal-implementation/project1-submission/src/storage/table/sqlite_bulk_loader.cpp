@@ -0,0 +1,269 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sqlite_bulk_loader.cpp
+//
+// Identification: src/storage/table/sqlite_bulk_loader.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/sqlite_bulk_loader.h"
+
+#include <sqlite3.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return name quoted as an SQL identifier */
+auto QuoteIdentifier(const std::string &name) -> std::string {
+  std::string quoted = "\"";
+  for (char c : name) {
+    quoted += c;
+    if (c == '"') {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+void AddStats(const BulkLoadStats &from, BulkLoadStats *to) {
+  to->rows_ += from.rows_;
+  to->bytes_ += from.bytes_;
+  to->pages_ += from.pages_;
+  to->elapsed_ += from.elapsed_;
+}
+
+}  // namespace
+
+SqliteBulkLoader::SqliteBulkLoader(BufferPoolManagerInstance *buffer_pool_manager, size_t batch_pages)
+    : instances_{buffer_pool_manager}, batch_pages_(batch_pages) {
+  BUSTUB_ASSERT(batch_pages > 0, "A batch has at least one page.");
+}
+
+SqliteBulkLoader::SqliteBulkLoader(ParallelBufferPoolManager *buffer_pool_manager, size_t batch_pages)
+    : batch_pages_(batch_pages) {
+  BUSTUB_ASSERT(batch_pages > 0, "A batch has at least one page.");
+  for (size_t i = 0; i < buffer_pool_manager->GetNumInstances(); ++i) {
+    this->instances_.push_back(buffer_pool_manager->GetInstance(i));
+  }
+}
+
+SqliteBulkLoader::~SqliteBulkLoader() { sqlite3_close(this->db_); }
+
+auto SqliteBulkLoader::Open(const std::string &db_file) -> bool {
+  sqlite3_close(this->db_);
+  this->db_ = nullptr;
+  sqlite3 *db;
+  if (sqlite3_open_v2(db_file.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+    LOG_WARN("could not open %s: %s", db_file.c_str(), sqlite3_errmsg(db));
+    // A handle is allocated even when the open fails.
+    sqlite3_close(db);
+    return false;
+  }
+  this->db_ = db;
+  return true;
+}
+
+auto SqliteBulkLoader::ListTables(std::vector<std::string> *tables) -> bool {
+  BUSTUB_ASSERT(this->db_ != nullptr, "No database is open.");
+  sqlite3_stmt *stmt;
+  const char *sql = "SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' ORDER BY rowid";
+  if (sqlite3_prepare_v2(this->db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    LOG_WARN("could not list the tables: %s", sqlite3_errmsg(this->db_));
+    return false;
+  }
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    tables->emplace_back(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+  }
+  sqlite3_finalize(stmt);
+  return rc == SQLITE_DONE;
+}
+
+auto SqliteBulkLoader::LoadAll(std::vector<LoadedTable> *loaded) -> bool {
+  std::vector<std::string> tables;
+  if (!this->ListTables(&tables)) {
+    return false;
+  }
+  for (const std::string &table : tables) {
+    LoadedTable heap;
+    if (!this->LoadTable(table, &heap)) {
+      return false;
+    }
+    loaded->push_back(std::move(heap));
+  }
+  return true;
+}
+
+auto SqliteBulkLoader::LoadTable(const std::string &table, LoadedTable *loaded) -> bool {
+  BUSTUB_ASSERT(this->db_ != nullptr, "No database is open.");
+  auto start = std::chrono::steady_clock::now();
+  sqlite3_stmt *stmt;
+  std::string sql = "SELECT * FROM " + QuoteIdentifier(table);
+  if (sqlite3_prepare_v2(this->db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    LOG_WARN("could not read table %s: %s", table.c_str(), sqlite3_errmsg(this->db_));
+    return false;
+  }
+  int num_columns = sqlite3_column_count(stmt);
+  loaded->name_ = table;
+  loaded->column_names_.clear();
+  for (int i = 0; i < num_columns; ++i) {
+    loaded->column_names_.emplace_back(sqlite3_column_name(stmt, i));
+  }
+  loaded->stats_ = BulkLoadStats();
+
+  PageBatch batch;
+  std::vector<page_id_t> heap_pages;
+  if (!this->AllocateBatch(INVALID_PAGE_ID, &batch)) {
+    sqlite3_finalize(stmt);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frames to load table " + table);
+  }
+  heap_pages = batch.page_ids_;
+  loaded->first_page_id_ = batch.page_ids_[0];
+
+  HeapRowBuilder row;
+  bool row_too_large = false;
+  bool out_of_frames = false;
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    row.Reset();
+    for (int i = 0; i < num_columns; ++i) {
+      switch (sqlite3_column_type(stmt, i)) {
+        case SQLITE_INTEGER:
+          row.AppendInteger(sqlite3_column_int64(stmt, i));
+          break;
+        case SQLITE_FLOAT:
+          row.AppendReal(sqlite3_column_double(stmt, i));
+          break;
+        case SQLITE_TEXT: {
+          // The size is only valid once the value has been converted, so it is asked for after the text.
+          const auto *text = reinterpret_cast<const char *>(sqlite3_column_text(stmt, i));
+          row.AppendBytes(HeapValueType::TEXT, text, sqlite3_column_bytes(stmt, i));
+          break;
+        }
+        case SQLITE_BLOB: {
+          const auto *blob = static_cast<const char *>(sqlite3_column_blob(stmt, i));
+          row.AppendBytes(HeapValueType::BLOB, blob, sqlite3_column_bytes(stmt, i));
+          break;
+        }
+        default:
+          row.AppendNull();
+          break;
+      }
+    }
+    if (row.GetSize() > HeapPage::MAX_TUPLE_SIZE) {
+      LOG_WARN("a row of table %s takes %u bytes, more than a page", table.c_str(), row.GetSize());
+      row_too_large = true;
+      break;
+    }
+    if (!this->AppendRow(row, &batch, &heap_pages)) {
+      out_of_frames = true;
+      break;
+    }
+    loaded->stats_.rows_++;
+    loaded->stats_.bytes_ += row.GetSize();
+  }
+  bool read_failed = !row_too_large && !out_of_frames && rc != SQLITE_DONE;
+  if (read_failed) {
+    LOG_WARN("could not read table %s: %s", table.c_str(), sqlite3_errmsg(this->db_));
+  }
+  sqlite3_finalize(stmt);
+
+  if (row_too_large || out_of_frames || read_failed) {
+    this->DropHeap(&batch, heap_pages);
+    loaded->first_page_id_ = INVALID_PAGE_ID;
+    if (out_of_frames) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No frames to load table " + table);
+    }
+    return false;
+  }
+
+  this->FinishBatch(&batch);
+  heap_pages.resize(heap_pages.size() - (batch.page_ids_.size() - batch.current_ - 1));
+  loaded->page_ids_ = std::move(heap_pages);
+  loaded->stats_.pages_ = loaded->page_ids_.size();
+  loaded->stats_.elapsed_ = std::chrono::steady_clock::now() - start;
+  AddStats(loaded->stats_, &this->stats_);
+  LOG_INFO("loaded %s: %lu rows, %.0f rows/s, %.1f MB/s", table.c_str(), loaded->stats_.rows_,
+           loaded->stats_.RowsPerSecond(), loaded->stats_.MegabytesPerSecond());
+  return true;
+}
+
+auto SqliteBulkLoader::AllocateBatch(page_id_t prev_page_id, PageBatch *batch) -> bool {
+  batch->page_ids_.clear();
+  batch->pages_.assign(this->batch_pages_, nullptr);
+  batch->current_ = 0;
+  batch->instance_ = nullptr;
+  for (size_t i = 0; i < this->instances_.size() && batch->instance_ == nullptr; ++i) {
+    BufferPoolManagerInstance *instance = this->instances_[this->next_instance_];
+    this->next_instance_ = (this->next_instance_ + 1) % this->instances_.size();
+    if (instance->NewPageExtent(this->batch_pages_, &batch->page_ids_, batch->pages_.data())) {
+      batch->instance_ = instance;
+    }
+  }
+  if (batch->instance_ == nullptr) {
+    return false;
+  }
+  AsHeapPage(batch->pages_[0])->Init(batch->page_ids_[0], prev_page_id);
+  return true;
+}
+
+auto SqliteBulkLoader::AppendRow(const HeapRowBuilder &row, PageBatch *batch, std::vector<page_id_t> *heap_pages)
+    -> bool {
+  HeapPage *page = AsHeapPage(batch->pages_[batch->current_]);
+  while (!page->InsertTuple(row.GetData(), row.GetSize())) {
+    if (batch->current_ + 1 < batch->pages_.size()) {
+      page->SetNextPageId(batch->page_ids_[batch->current_ + 1]);
+      batch->current_++;
+      page = AsHeapPage(batch->pages_[batch->current_]);
+      page->Init(batch->page_ids_[batch->current_], batch->page_ids_[batch->current_ - 1]);
+      continue;
+    }
+    // The next batch is created before this one is let go of, so that its last page can link to it.
+    PageBatch next_batch;
+    if (!this->AllocateBatch(page->GetPageId(), &next_batch)) {
+      return false;
+    }
+    heap_pages->insert(heap_pages->end(), next_batch.page_ids_.begin(), next_batch.page_ids_.end());
+    page->SetNextPageId(next_batch.page_ids_[0]);
+    this->FinishBatch(batch);
+    *batch = std::move(next_batch);
+    page = AsHeapPage(batch->pages_[0]);
+  }
+  return true;
+}
+
+void SqliteBulkLoader::FinishBatch(PageBatch *batch) {
+  // The ids of an extent increase, so this writes them in order.
+  for (size_t i = 0; i <= batch->current_; ++i) {
+    batch->instance_->CheckpointPage(batch->page_ids_[i]);
+    batch->instance_->UnpinPage(batch->page_ids_[i], false);
+  }
+  for (size_t i = batch->current_ + 1; i < batch->page_ids_.size(); ++i) {
+    batch->instance_->UnpinPage(batch->page_ids_[i], false);
+    batch->instance_->DeletePage(batch->page_ids_[i]);
+  }
+}
+
+void SqliteBulkLoader::DropHeap(PageBatch *batch, const std::vector<page_id_t> &heap_pages) {
+  for (page_id_t page_id : batch->page_ids_) {
+    batch->instance_->UnpinPage(page_id, false);
+  }
+  for (page_id_t page_id : heap_pages) {
+    this->InstanceOf(page_id)->DeletePage(page_id);
+  }
+}
+
+}  // namespace bustub
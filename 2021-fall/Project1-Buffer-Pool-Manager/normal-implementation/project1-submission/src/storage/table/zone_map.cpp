@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/exception.h"
+#include "storage/page/heap_page.h"
+#include "storage/table/heap_row.h"
+
+namespace bustub {
+
+void ZoneMap::ReadEntries(BufferPoolManagerInstance *buffer_pool_manager, std::vector<ZoneEntry> *entries) const {
+  entries->clear();
+  entries->reserve(this->entry_count_);
+  for (page_id_t page_id : this->page_ids_) {
+    ReadPageGuard guard = buffer_pool_manager->FetchPageRead(page_id);
+    if (!guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to read a zone map page");
+    }
+    const auto *page = guard.As<ZoneMapPage>();
+    for (uint32_t i = 0; i < page->GetEntryCount(); ++i) {
+      entries->push_back(page->GetEntry(i));
+    }
+  }
+}
+
+void ZoneMapBuilder::Append(const ZoneEntry &entry) {
+  if (!this->guard_.IsValid() || this->guard_.As<ZoneMapPage>()->IsFull()) {
+    page_id_t page_id;
+    WritePageGuard guard = this->buffer_pool_manager_->NewPageGuarded(&page_id);
+    if (!guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to write a zone map page");
+    }
+    guard.AsMut<ZoneMapPage>()->Init(page_id);
+    if (this->guard_.IsValid()) {
+      this->guard_.AsMut<ZoneMapPage>()->SetNextPageId(page_id);
+    }
+    this->guard_ = std::move(guard);
+    this->zone_map_.page_ids_.push_back(page_id);
+  }
+  this->guard_.AsMut<ZoneMapPage>()->Append(entry);
+  ++this->zone_map_.entry_count_;
+}
+
+void ZoneMapBuilder::Finish(ZoneMap *zone_map) {
+  this->guard_.Drop();
+  *zone_map = std::move(this->zone_map_);
+  this->zone_map_ = ZoneMap();
+}
+
+auto ZoneMayMatch(const ZoneEntry &entry, ComparisonType type, int64_t constant) -> bool {
+  if (entry.min_ > entry.max_) {
+    return false;
+  }
+  switch (type) {
+    case ComparisonType::EQUAL:
+      return entry.min_ <= constant && constant <= entry.max_;
+    case ComparisonType::NOT_EQUAL:
+      return entry.min_ != constant || entry.max_ != constant;
+    case ComparisonType::LESS_THAN:
+      return entry.min_ < constant;
+    case ComparisonType::LESS_THAN_OR_EQUAL:
+      return entry.min_ <= constant;
+    case ComparisonType::GREATER_THAN:
+      return entry.max_ > constant;
+    case ComparisonType::GREATER_THAN_OR_EQUAL:
+      return entry.max_ >= constant;
+  }
+  UNREACHABLE("Unknown comparison.");
+}
+
+void BuildHeapZoneMap(BufferPoolManagerInstance *buffer_pool_manager, const LoadedTable &table, uint32_t column,
+                      ZoneMap *zone_map) {
+  ZoneMapBuilder builder(buffer_pool_manager);
+  page_id_t page_id = table.first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    ReadPageGuard guard = buffer_pool_manager->FetchPageRead(page_id);
+    if (!guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame to read heap page of table " + table.name_);
+    }
+    const auto *page = guard.As<HeapPage>();
+    ZoneEntry entry{page_id, page->GetTupleCount(), INT64_MAX, INT64_MIN};
+    for (uint32_t slot = 0; slot < page->GetTupleCount(); ++slot) {
+      uint32_t size;
+      const char *data = page->GetTuple(slot, &size);
+      HeapRowReader reader(data, size);
+      if (column >= reader.GetColumnCount()) {
+        continue;
+      }
+      HeapValueType type = HeapValueType::NULL_VALUE;
+      for (uint32_t i = 0; i <= column; ++i) {
+        type = reader.Next();
+      }
+      int64_t value;
+      if (type == HeapValueType::INTEGER) {
+        value = reader.GetInteger();
+      } else if (type == HeapValueType::REAL) {
+        value = static_cast<int64_t>(reader.GetReal());
+      } else {
+        continue;
+      }
+      entry.min_ = std::min(entry.min_, value);
+      entry.max_ = std::max(entry.max_, value);
+    }
+    page_id = page->GetNextPageId();
+    guard.Drop();
+    builder.Append(entry);
+  }
+  builder.Finish(zone_map);
+}
+
+}  // namespace bustub
@@ -0,0 +1,208 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_fetch_bench.cpp
+//
+// Identification: tools/async_fetch_bench/async_fetch_bench.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Point lookups in a B+ tree whose leaves mostly miss the pool, on a simulated NVMe drive in real time. Compares a
+// thread per lookup, blocking in FetchPage, with a few threads keeping many lookups in flight through FetchPageAsync,
+// once on a device that completes reads on its own and once on one that reads on the calling thread, as the database
+// file does. Usage: async_fetch_bench [num_keys] [num_probes] [probes_in_flight]
+//
+// Every lookup in flight pins a frame, keep probes_in_flight well below the 256 frames of the pool.
+
+#include <atomic>
+#include <cinttypes>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "storage/disk/simulated_disk_manager.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+namespace {
+
+using Comparator = IntComparator<int64_t>;
+using Tree = BPlusTree<int64_t, int64_t, Comparator>;
+using InternalPage = BPlusTreeInternalPage<int64_t, page_id_t, Comparator>;
+using LeafPage = BPlusTreeLeafPage<int64_t, int64_t, Comparator>;
+
+constexpr size_t NUM_INSTANCES = 4;
+constexpr size_t FRAMES_PER_INSTANCE = 64;
+constexpr size_t EXECUTOR_THREADS = 2;
+
+/** Serves reads on the calling thread, the way DiskManager reads the database file. */
+class BlockingDiskManager : public SimulatedDiskManager {
+ public:
+  using SimulatedDiskManager::SimulatedDiskManager;
+
+  void ReadPageAsync(page_id_t page_id, char *page_data, std::function<void()> callback) override {
+    this->ReadPage(page_id, page_data);
+    callback();
+  }
+};
+
+struct Result {
+  double probes_per_sec_;
+  uint64_t found_;
+};
+
+/** Descends the tree with FetchPageAsync, keeping up to a number of lookups in flight from one thread. */
+class AsyncProber {
+ public:
+  AsyncProber(ParallelBufferPoolManager *bpm, page_id_t root_page_id) : bpm_(bpm), root_page_id_(root_page_id) {}
+
+  auto Run(const std::vector<int64_t> &keys, size_t in_flight) -> uint64_t {
+    std::unique_lock<std::mutex> lk(this->mutex_);
+    for (int64_t key : keys) {
+      this->cv_.wait(lk, [this, in_flight] { return this->in_flight_ < in_flight; });
+      ++this->in_flight_;
+      lk.unlock();
+      this->Step(key, this->root_page_id_);
+      lk.lock();
+    }
+    this->cv_.wait(lk, [this] { return this->in_flight_ == 0; });
+    return this->found_;
+  }
+
+ private:
+  void Step(int64_t key, page_id_t page_id) {
+    this->bpm_->FetchPageAsync(page_id, [this, key, page_id](Page *page) {
+      if (page == nullptr) {
+        this->Finish(false);
+        return;
+      }
+      page->RLatch();
+      const auto *node = reinterpret_cast<const BPlusTreePage *>(page->GetData());
+      page_id_t child_page_id = INVALID_PAGE_ID;
+      bool found = false;
+      if (node->IsLeafPage()) {
+        int64_t value;
+        found = reinterpret_cast<const LeafPage *>(node)->Lookup(key, &value, this->comparator_);
+      } else {
+        child_page_id = reinterpret_cast<const InternalPage *>(node)->Lookup(key, this->comparator_);
+      }
+      page->RUnlatch();
+      this->bpm_->UnpinPage(page_id, false);
+      if (child_page_id != INVALID_PAGE_ID) {
+        this->Step(key, child_page_id);
+        return;
+      }
+      this->Finish(found);
+    });
+  }
+
+  void Finish(bool found) {
+    {
+      std::lock_guard<std::mutex> lg(this->mutex_);
+      --this->in_flight_;
+      this->found_ += found ? 1 : 0;
+    }
+    this->cv_.notify_one();
+  }
+
+  ParallelBufferPoolManager *bpm_;
+  page_id_t root_page_id_;
+  Comparator comparator_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t in_flight_{0};
+  uint64_t found_{0};
+};
+
+/** @return the keys to look up, uniform over the loaded ones */
+auto MakeProbes(size_t num_keys, size_t num_probes) -> std::vector<int64_t> {
+  std::mt19937_64 rng(7);
+  std::vector<int64_t> keys(num_probes);
+  for (auto &key : keys) {
+    key = static_cast<int64_t>(rng() % num_keys);
+  }
+  return keys;
+}
+
+/**
+ * Build the index on a fresh device and run the lookups.
+ * @param threads threads blocking in FetchPage; 0 to go through FetchPageAsync instead
+ */
+template <typename Disk>
+auto RunOne(size_t num_keys, const std::vector<int64_t> &keys, size_t threads, size_t in_flight) -> Result {
+  Disk disk_manager(DeviceProfile::NVMe());
+  ParallelBufferPoolManager bpm(NUM_INSTANCES, FRAMES_PER_INSTANCE, &disk_manager);
+  bpm.EnableAsyncFetch(EXECUTOR_THREADS);
+  Tree tree("bench", &bpm, Comparator());
+  std::vector<std::pair<int64_t, int64_t>> items(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    items[i] = {static_cast<int64_t>(i), static_cast<int64_t>(i)};
+  }
+  tree.BulkLoad(items);
+  page_id_t root_page_id = tree.GetRootPageId();
+
+  auto start = std::chrono::steady_clock::now();
+  uint64_t found = 0;
+  if (threads == 0) {
+    AsyncProber prober(&bpm, root_page_id);
+    found = prober.Run(keys, in_flight);
+  } else {
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> hits{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&] {
+        std::vector<int64_t> result;
+        for (size_t i = next++; i < keys.size(); i = next++) {
+          result.clear();
+          hits += tree.GetValue(keys[i], &result) ? 1 : 0;
+        }
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    found = hits.load();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return {static_cast<double>(keys.size()) / seconds, found};
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  using bustub::BlockingDiskManager;
+  using bustub::SimulatedDiskManager;
+  size_t num_keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  size_t num_probes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+  size_t in_flight = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+  auto keys = bustub::MakeProbes(num_keys, num_probes);
+
+  std::printf("%zu keys, %zu lookups, %zu frames, NVMe profile in real time\n", num_keys, num_probes,
+              bustub::NUM_INSTANCES * bustub::FRAMES_PER_INSTANCE);
+  auto print = [&](const char *name, const bustub::Result &result) {
+    // Every key is in the index: a lookup only comes back empty when it found no free frame for one of its pages.
+    std::printf("%-44s %10.0f lookups/s  %6" PRIu64 " failed\n", name, result.probes_per_sec_,
+                num_probes - result.found_);
+    std::fflush(stdout);
+  };
+  print("FetchPage, 2 threads", bustub::RunOne<SimulatedDiskManager>(num_keys, keys, 2, 0));
+  print("FetchPage, 64 threads", bustub::RunOne<SimulatedDiskManager>(num_keys, keys, 64, 0));
+  std::printf("FetchPageAsync, %zu executor threads, %zu lookups in flight:\n", bustub::EXECUTOR_THREADS, in_flight);
+  print("  device reads on the calling thread", bustub::RunOne<BlockingDiskManager>(num_keys, keys, 0, in_flight));
+  print("  device completes reads on its own", bustub::RunOne<SimulatedDiskManager>(num_keys, keys, 0, in_flight));
+  return 0;
+}
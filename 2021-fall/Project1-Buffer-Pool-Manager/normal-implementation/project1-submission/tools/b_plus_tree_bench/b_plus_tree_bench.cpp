@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bench.cpp
+//
+// Identification: tools/b_plus_tree_bench/b_plus_tree_bench.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Insert, lookup and full-scan rates of a BPlusTree as threads are added, with the tree resident in the pool, then
+// cold scans on a simulated NVMe with and without read-ahead.
+// Usage: b_plus_tree_bench [max_threads] [num_keys]
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "storage/disk/simulated_disk_manager.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+namespace {
+
+using Tree = BPlusTree<int64_t, int64_t, IntComparator<int64_t>>;
+
+constexpr size_t NUM_INSTANCES = 8;
+constexpr size_t INSTANCE_POOL_SIZE = 4096;
+constexpr int64_t COLD_SCAN_KEYS = 100000;
+
+/** @return a key spread over the whole int64 range, distinct for every i */
+auto MixKey(uint64_t i) -> int64_t {
+  i = (i ^ (i >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  i = (i ^ (i >> 27)) * 0x94d049bb133111ebULL;
+  return static_cast<int64_t>((i ^ (i >> 31)) >> 1);
+}
+
+/** @return seconds taken by num_threads threads running body(thread index) */
+template <typename Body>
+auto RunThreads(size_t num_threads, Body body) -> double {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back(body, t);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Insert num_keys random keys split over the threads, look each one up, then have every thread scan the tree. */
+void RunResident(size_t num_threads, int64_t num_keys) {
+  SimulatedDiskManager disk_manager(DeviceProfile::NVMe(), 0, true);
+  ParallelBufferPoolManager bpm(NUM_INSTANCES, INSTANCE_POOL_SIZE, &disk_manager);
+  Tree tree("bench", &bpm, IntComparator<int64_t>());
+
+  double insert_secs = RunThreads(num_threads, [&](size_t t) {
+    for (auto i = static_cast<int64_t>(t); i < num_keys; i += num_threads) {
+      tree.Insert(MixKey(i), i);
+    }
+  });
+
+  std::atomic<int64_t> missing{0};
+  double lookup_secs = RunThreads(num_threads, [&](size_t t) {
+    std::vector<int64_t> result;
+    for (auto i = static_cast<int64_t>(t); i < num_keys; i += num_threads) {
+      result.clear();
+      if (!tree.GetValue(MixKey(i), &result)) {
+        ++missing;
+      }
+    }
+  });
+
+  std::atomic<int64_t> scanned{0};
+  double scan_secs = RunThreads(num_threads, [&](size_t /*t*/) {
+    int64_t count = 0;
+    for (auto itr = tree.Begin(); !itr.IsEnd(); ++itr) {
+      ++count;
+    }
+    scanned += count;
+  });
+
+  std::printf("%8zu%14.0f%14.0f%18.0f", num_threads, num_keys / insert_secs, num_keys / lookup_secs,
+              scanned.load() / scan_secs);
+  if (missing.load() != 0) {
+    std::printf("  (%" PRId64 " keys missing)", missing.load());
+  }
+  std::printf("\n");
+}
+
+/**
+ * Scan a tree whose leaves were pushed out of a small pool by loading a second tree, on a real-time NVMe.
+ * @param read_ahead leaves kept loading ahead of the scan, 0 for none
+ */
+void RunColdScan(int read_ahead) {
+  SimulatedDiskManager disk_manager(DeviceProfile::NVMe(), 0);
+  ParallelBufferPoolManager bpm(4, 128, &disk_manager);
+  bpm.EnableAsyncFetch(8);
+  std::vector<std::pair<int64_t, int64_t>> items;
+  for (int64_t i = 0; i < COLD_SCAN_KEYS; ++i) {
+    items.emplace_back(i, i);
+  }
+  Tree tree("cold", &bpm, IntComparator<int64_t>(), 64, 64);
+  tree.BulkLoad(items);
+  Tree evict("evict", &bpm, IntComparator<int64_t>(), 64, 64);
+  evict.BulkLoad(items);
+  tree.SetReadAhead(read_ahead);
+
+  uint64_t reads = disk_manager.GetStats().reads_.load();
+  auto start = std::chrono::steady_clock::now();
+  int64_t count = 0;
+  for (auto itr = tree.Begin(); !itr.IsEnd(); ++itr) {
+    ++count;
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::printf("%12d%12" PRId64 "%12.1f%12" PRIu64 "\n", read_ahead, count, secs * 1000,
+              disk_manager.GetStats().reads_.load() - reads);
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+  int64_t num_keys = argc > 2 ? std::strtol(argv[2], nullptr, 10) : 200000;
+
+  std::printf("%u hardware threads, %" PRId64 " random keys, operations per second\n",
+              std::thread::hardware_concurrency(), num_keys);
+  std::printf("%8s%14s%14s%18s\n", "threads", "insert", "lookup", "scanned entries");
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    bustub::RunResident(threads, num_keys);
+    std::fflush(stdout);
+  }
+
+  std::printf("\ncold scan of %" PRId64 " sequential keys, simulated NVMe\n", bustub::COLD_SCAN_KEYS);
+  std::printf("%12s%12s%12s%12s\n", "read-ahead", "entries", "ms", "reads");
+  for (int read_ahead : {0, 16, 64}) {
+    bustub::RunColdScan(read_ahead);
+    std::fflush(stdout);
+  }
+  return 0;
+}
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bpm_bench.cpp
+//
+// Identification: tools/bpm_bench/bpm_bench.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Fetch and unpin throughput of one buffer pool instance as threads are added, with every page resident, so that
+// only the latches are measured. Usage: bpm_bench [max_threads] [milliseconds_per_run]
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/simulated_disk_manager.h"
+
+namespace bustub {
+namespace {
+
+constexpr size_t POOL_SIZE = 1024;
+
+/** @return fetches per second of threads fetching and unpinning random resident pages */
+auto Run(ReplacerType replacer_type, size_t num_threads, std::chrono::milliseconds duration) -> double {
+  SimulatedDiskManager disk_manager(DeviceProfile::NVMe(), 0, true);
+  BufferPoolManagerInstance bpm(POOL_SIZE, &disk_manager, nullptr, replacer_type);
+  std::vector<page_id_t> page_ids(POOL_SIZE);
+  for (auto &page_id : page_ids) {
+    bpm.NewPage(&page_id);
+    bpm.UnpinPage(page_id, false);
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> fetches{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      uint64_t local = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        page_id_t page_id = page_ids[rng() % POOL_SIZE];
+        if (bpm.FetchPage(page_id) != nullptr) {
+          bpm.UnpinPage(page_id, false);
+          ++local;
+        }
+      }
+      fetches += local;
+    });
+  }
+  std::this_thread::sleep_for(duration);
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return static_cast<double>(fetches.load()) / std::chrono::duration<double>(duration).count();
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  using bustub::ReplacerType;
+  size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+  std::chrono::milliseconds duration(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500);
+
+  const std::vector<std::pair<const char *, ReplacerType>> replacers = {
+      {"LRU", ReplacerType::LRU},
+      {"ARC", ReplacerType::ARC},
+      {"BufferedLRU", ReplacerType::BUFFERED_LRU},
+  };
+  std::printf("%u hardware threads, %zu resident pages, fetch + unpin per second\n",
+              std::thread::hardware_concurrency(), bustub::POOL_SIZE);
+  std::printf("%8s", "threads");
+  for (const auto &[name, type] : replacers) {
+    std::printf("%14s", name);
+  }
+  std::printf("\n");
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    std::printf("%8zu", threads);
+    for (const auto &[name, type] : replacers) {
+      std::printf("%14.0f", bustub::Run(type, threads, duration));
+      std::fflush(stdout);
+    }
+    std::printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sort_bench.cpp
+//
+// Identification: tools/external_sort_bench/external_sort_bench.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Spill benchmark of ExternalSortOperator: the id, name and language of release ORDER BY name, from a database with
+// the MusicBrainz schema, sorted with memory_pages from 6 up to max_memory_pages on a simulated NVMe drive in real
+// time. Each size runs once with the run I/O on the calling thread and once double buffered through an IoExecutor.
+// Usage: external_sort_bench <db_file> [pool_frames] [max_memory_pages]
+//
+// The rows are read into memory before the sorts, so that only the I/O of the runs is timed.
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "buffer/io_executor.h"
+#include "execution/vector/external_sort_operator.h"
+#include "execution/vector/heap_scan_operator.h"
+#include "execution/vector/musicbrainz_queries.h"
+#include "storage/disk/simulated_disk_manager.h"
+#include "storage/table/sqlite_bulk_loader.h"
+
+namespace bustub {
+namespace {
+
+constexpr size_t EXECUTOR_THREADS = 4;
+
+/** Hands out chunks held in memory. */
+class ChunkSource : public VectorOperator {
+ public:
+  ChunkSource(std::vector<ColumnType> types, const std::vector<DataChunk> *chunks)
+      : VectorOperator(std::move(types)), chunks_(chunks) {}
+
+  void Init() override { next_ = 0; }
+
+  auto Next(DataChunk *chunk) -> bool override {
+    if (next_ == chunks_->size()) {
+      return false;
+    }
+    chunk->Initialize(this->output_types_);
+    chunk->Append((*chunks_)[next_++]);
+    return true;
+  }
+
+ private:
+  const std::vector<DataChunk> *chunks_;
+  size_t next_{0};
+};
+
+struct SortResult {
+  double ms_;
+  size_t rows_;
+  bool ordered_;
+};
+
+/** Run the sort to the end, checking that every row is ordered after the one before it. */
+auto Drain(ExternalSortOperator *sort, const std::vector<SortKey> &keys) -> SortResult {
+  auto start = std::chrono::steady_clock::now();
+  SortResult result{0, 0, true};
+  DataChunk chunk;
+  DataChunk last;
+  sort->Init();
+  while (sort->Next(&chunk)) {
+    if (result.rows_ > 0 && CompareRows(keys, last, last.Size() - 1, chunk, 0) > 0) {
+      result.ordered_ = false;
+    }
+    for (size_t row = 1; row < chunk.Size(); ++row) {
+      if (CompareRows(keys, chunk, row - 1, chunk, row) > 0) {
+        result.ordered_ = false;
+      }
+    }
+    result.rows_ += chunk.Size();
+    last.Initialize(sort->GetOutputTypes());
+    last.Append(chunk);
+  }
+  result.ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  using bustub::ColumnType;
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <db_file> [pool_frames] [max_memory_pages]\n", argv[0]);
+    return 2;
+  }
+  size_t pool_frames = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 512;
+  size_t max_memory_pages = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 256;
+
+  bustub::SimulatedDiskManager disk_manager(bustub::DeviceProfile::NVMe(), 0);
+  bustub::BufferPoolManagerInstance bpm(pool_frames, &disk_manager);
+  bpm.EnableFreeSpaceMap();
+  bustub::LoadedTable release;
+  {
+    bustub::SqliteBulkLoader loader(&bpm);
+    if (!loader.Open(argv[1]) || !loader.LoadTable("release", &release)) {
+      return 2;
+    }
+  }
+
+  const std::vector<ColumnType> types = {ColumnType::INTEGER, ColumnType::TEXT, ColumnType::INTEGER};
+  const std::vector<bustub::SortKey> keys = {{1}};
+  std::vector<bustub::DataChunk> chunks;
+  size_t rows = 0;
+  {
+    bustub::HeapScanOperator scan(&bpm, release.first_page_id_,
+                                  {bustub::ColumnIndex(release, "id"), bustub::ColumnIndex(release, "name"),
+                                   bustub::ColumnIndex(release, "language")},
+                                  types);
+    scan.Init();
+    bustub::DataChunk chunk;
+    while (scan.Next(&chunk)) {
+      chunks.emplace_back(types);
+      chunks.back().Append(chunk);
+      rows += chunk.Size();
+    }
+  }
+
+  bustub::IoExecutor executor(bustub::EXECUTOR_THREADS);
+  std::printf("release (id, name, language) ORDER BY name, %zu rows, %zu frames, NVMe profile in real time\n", rows,
+              pool_frames);
+  std::printf("%12s%8s%8s%8s%12s%18s\n", "memory pages", "fan-in", "runs", "passes", "sync ms", "double buffered");
+  bool all_ordered = true;
+  size_t memory_pages = bustub::ExternalSortOperator::MIN_MEMORY_PAGES;
+  while (memory_pages <= max_memory_pages) {
+    bustub::SortResult results[2];
+    size_t runs = 0;
+    size_t passes = 0;
+    size_t fan_in = 0;
+    for (int buffered = 0; buffered < 2; ++buffered) {
+      bustub::ExternalSortOperator sort(&bpm, std::make_unique<bustub::ChunkSource>(types, &chunks), keys,
+                                        memory_pages, buffered == 1 ? &executor : nullptr);
+      results[buffered] = bustub::Drain(&sort, keys);
+      all_ordered = all_ordered && results[buffered].ordered_ && results[buffered].rows_ == rows;
+      runs = sort.GetRunsWritten();
+      passes = sort.GetMergePasses();
+      fan_in = sort.GetFanIn();
+    }
+    std::printf("%12zu%8zu%8zu%8zu%12.0f%18.0f\n", memory_pages, fan_in, runs, passes, results[0].ms_,
+                results[1].ms_);
+    std::fflush(stdout);
+    memory_pages = memory_pages < 16 ? 16 : memory_pages * 4;
+  }
+  if (!all_ordered) {
+    std::printf("a sort returned rows out of order or lost rows\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bench.cpp
+//
+// Identification: tools/hash_table_bench/hash_table_bench.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Insert, lookup and mixed throughput of an ExtendibleHashTable as threads are added, on a pool that holds the whole
+// table, so that only the latches and the optimistic directory reads are measured. Each phase runs for the given time;
+// the insert and mixed phases stop earlier once their NUM_KEYS keys are used up, which keeps the table under the
+// directory limit. Usage: hash_table_bench [max_threads] [milliseconds_per_phase]
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/disk/simulated_disk_manager.h"
+#include "storage/index/int_comparator.h"
+
+namespace bustub {
+namespace {
+
+using HashTable = ExtendibleHashTable<int64_t, int64_t, IntComparator<int64_t>>;
+
+constexpr size_t POOL_SIZE = 1024;
+constexpr int64_t NUM_KEYS = 48000;
+// Operations between two looks at the clock
+constexpr int64_t DEADLINE_CHECK_INTERVAL = 64;
+
+struct Rates {
+  double insert_;
+  double lookup_;
+  double mixed_;
+  int64_t failed_;
+};
+
+/**
+ * Run body(thread index, deadline) on num_threads threads.
+ * @return operations per second, body returning the operations it performed
+ */
+template <typename Body>
+auto RunPhase(size_t num_threads, std::chrono::milliseconds duration, Body body) -> double {
+  auto start = std::chrono::steady_clock::now();
+  auto deadline = start + duration;
+  std::atomic<int64_t> ops{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] { ops += body(static_cast<int64_t>(t), deadline); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return static_cast<double>(ops.load()) /
+         std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+auto PastDeadline(int64_t i, std::chrono::steady_clock::time_point deadline) -> bool {
+  return i % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline;
+}
+
+/** Insert NUM_KEYS keys split over the threads, look up random inserted keys, then mix inserts and lookups. */
+auto Run(size_t num_threads, std::chrono::milliseconds duration) -> Rates {
+  SimulatedDiskManager disk_manager(DeviceProfile::NVMe(), 0, true);
+  BufferPoolManagerInstance bpm(POOL_SIZE, &disk_manager);
+  HashTable table("bench", &bpm, IntComparator<int64_t>(), HashFunction<int64_t>());
+  auto stride = static_cast<int64_t>(num_threads);
+  int64_t keys_per_thread = NUM_KEYS / stride;
+  std::atomic<int64_t> failed{0};
+  Rates rates{};
+
+  // Thread t inserts t, t + stride, ...; inserted[t] is how far it got.
+  std::vector<int64_t> inserted(num_threads);
+  rates.insert_ = RunPhase(num_threads, duration, [&](int64_t t, auto deadline) {
+    int64_t i = 0;
+    for (; i < keys_per_thread && !PastDeadline(i, deadline); ++i) {
+      if (!table.Insert(i * stride + t, i)) {
+        ++failed;
+      }
+    }
+    inserted[t] = i;
+    return i;
+  });
+
+  // A key inserted above, -1 if the thread drawn inserted none
+  auto random_inserted_key = [&](std::mt19937_64 *rng) -> int64_t {
+    int64_t t = (*rng)() % stride;
+    return inserted[t] == 0 ? -1 : static_cast<int64_t>((*rng)() % inserted[t]) * stride + t;
+  };
+
+  rates.lookup_ = RunPhase(num_threads, duration, [&](int64_t t, auto deadline) {
+    std::mt19937_64 rng(t);
+    std::vector<int64_t> result;
+    int64_t i = 0;
+    for (; !PastDeadline(i, deadline); ++i) {
+      result.clear();
+      int64_t key = random_inserted_key(&rng);
+      if (key >= 0 && !table.GetValue(key, &result)) {
+        ++failed;
+      }
+    }
+    return i;
+  });
+
+  // Inserts of new negative keys racing lookups of the keys inserted above, one for one.
+  rates.mixed_ = RunPhase(num_threads, duration, [&](int64_t t, auto deadline) {
+    std::mt19937_64 rng(t + num_threads);
+    std::vector<int64_t> result;
+    int64_t i = 0;
+    for (; i < keys_per_thread && !PastDeadline(i, deadline); ++i) {
+      if (i % 2 == 1) {
+        if (!table.Insert(-1 - (i * stride + t), i)) {
+          ++failed;
+        }
+        continue;
+      }
+      result.clear();
+      int64_t key = random_inserted_key(&rng);
+      if (key >= 0 && !table.GetValue(key, &result)) {
+        ++failed;
+      }
+    }
+    return i;
+  });
+
+  rates.failed_ = failed.load();
+  return rates;
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+  std::chrono::milliseconds duration(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500);
+
+  std::printf("%u hardware threads, %zu frames, up to %" PRId64 " keys, operations per second\n",
+              std::thread::hardware_concurrency(), bustub::POOL_SIZE, bustub::NUM_KEYS);
+  std::printf("%8s%14s%14s%14s\n", "threads", "insert", "lookup", "mixed");
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    bustub::Rates rates = bustub::Run(threads, duration);
+    std::printf("%8zu%14.0f%14.0f%14.0f", threads, rates.insert_, rates.lookup_, rates.mixed_);
+    if (rates.failed_ != 0) {
+      std::printf("  (%" PRId64 " failed)", rates.failed_);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+  }
+  return 0;
+}
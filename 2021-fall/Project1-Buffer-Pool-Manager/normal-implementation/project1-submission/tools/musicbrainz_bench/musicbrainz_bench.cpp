@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// musicbrainz_bench.cpp
+//
+// Identification: tools/musicbrainz_bench/musicbrainz_bench.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Runs the vectorized plans of q7 and q8 of the SQL homework over tables bulk loaded from an SQLite database, checks
+// their rows and times them against sqlite3 running the official solution SQL on the same file.
+// Usage: musicbrainz_bench <db_file> <assignment1_dir> [pool_frames] [runs]
+//
+// assignment1_dir is 2020-fall/Assignment1-SQL. On the homework's musicbrainz-cmudb2020.db the rows must match
+// solution-output/q7.txt and q8.txt; on any other database with the same schema they must match what sqlite3 returns
+// for solution/q7_*.sql and q8_*.sql. Exits with 1 on a mismatch.
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "execution/vector/musicbrainz_queries.h"
+#include "storage/disk/simulated_disk_manager.h"
+#include "storage/table/sqlite_bulk_loader.h"
+
+namespace bustub {
+namespace {
+
+// The database file the homework hands out, whose results are in solution-output
+constexpr const char *HOMEWORK_DB_NAME = "musicbrainz-cmudb2020.db";
+
+struct Query {
+  const char *name_;
+  const char *solution_sql_;
+  const char *solution_output_;
+  std::function<std::vector<std::string>()> run_;
+};
+
+auto ReadFile(const std::string &path, std::string *contents) -> bool {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  *contents = buffer.str();
+  return true;
+}
+
+/** @return the non-empty lines of a file, as sqlite3 printed them */
+auto ReadRows(const std::string &path, std::vector<std::string> *rows) -> bool {
+  std::string contents;
+  if (!ReadFile(path, &contents)) {
+    return false;
+  }
+  std::stringstream lines(contents);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (!line.empty()) {
+      rows->push_back(line);
+    }
+  }
+  return true;
+}
+
+/** Run one statement, formatting each row the way the sqlite3 shell does: values separated by '|', NULL empty. */
+auto RunSqlite(sqlite3 *db, const std::string &sql, std::vector<std::string> *rows) -> bool {
+  sqlite3_stmt *stmt;
+  if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    std::fprintf(stderr, "sqlite3: %s\n", sqlite3_errmsg(db));
+    return false;
+  }
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+    std::string row;
+    for (int i = 0; i < sqlite3_column_count(stmt); ++i) {
+      if (i > 0) {
+        row += '|';
+      }
+      const unsigned char *text = sqlite3_column_text(stmt, i);
+      if (text != nullptr) {
+        row += reinterpret_cast<const char *>(text);
+      }
+    }
+    rows->push_back(row);
+  }
+  sqlite3_finalize(stmt);
+  if (rc != SQLITE_DONE) {
+    std::fprintf(stderr, "sqlite3: %s\n", sqlite3_errmsg(db));
+    return false;
+  }
+  return true;
+}
+
+/** @return the best of runs wall times of fn, in milliseconds */
+auto BestOf(size_t runs, const std::function<void()> &fn) -> double {
+  double best = 0;
+  for (size_t i = 0; i < runs; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    best = i == 0 ? ms : std::min(best, ms);
+  }
+  return best;
+}
+
+/** Print the first row where actual and expected differ. @return true if they are the same */
+auto CompareRows(const char *name, const std::vector<std::string> &actual, const std::vector<std::string> &expected)
+    -> bool {
+  size_t rows = std::max(actual.size(), expected.size());
+  for (size_t i = 0; i < rows; ++i) {
+    const char *got = i < actual.size() ? actual[i].c_str() : "(no row)";
+    const char *want = i < expected.size() ? expected[i].c_str() : "(no row)";
+    if (i >= actual.size() || i >= expected.size() || actual[i] != expected[i]) {
+      std::printf("%s: row %zu is \"%s\", expected \"%s\"\n", name, i + 1, got, want);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  using bustub::LoadedTable;
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: %s <db_file> <assignment1_dir> [pool_frames] [runs]\n", argv[0]);
+    return 2;
+  }
+  std::string db_file = argv[1];
+  std::string dir = std::string(argv[2]) + "/";
+  size_t pool_frames = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 40000;
+  size_t runs = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 3;
+  size_t slash = db_file.find_last_of('/');
+  bool homework_db = db_file.substr(slash == std::string::npos ? 0 : slash + 1) == bustub::HOMEWORK_DB_NAME;
+
+  bustub::SimulatedDiskManager disk_manager(bustub::DeviceProfile::NVMe(), 0, true);
+  bustub::BufferPoolManagerInstance bpm(pool_frames, &disk_manager);
+  bpm.EnableFreeSpaceMap();
+  bustub::SqliteBulkLoader loader(&bpm);
+  if (!loader.Open(db_file)) {
+    return 2;
+  }
+  std::map<std::string, LoadedTable> tables;
+  for (const char *name : {"release", "release_info", "artist_credit_name"}) {
+    if (!loader.LoadTable(name, &tables[name])) {
+      std::fprintf(stderr, "could not load %s, the pool may be too small\n", name);
+      return 2;
+    }
+  }
+  const bustub::BulkLoadStats &load = loader.GetStats();
+  std::printf("loaded %" PRIu64 " rows into %" PRIu64 " pages at %.0f rows/s\n", load.rows_, load.pages_,
+              load.RowsPerSecond());
+
+  sqlite3 *db;
+  if (sqlite3_open_v2(db_file.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+    std::fprintf(stderr, "could not open %s: %s\n", db_file.c_str(), sqlite3_errmsg(db));
+    sqlite3_close(db);
+    return 2;
+  }
+
+  const std::vector<bustub::Query> queries = {
+      {"q7", "solution/q7_release_percentage.sql", "solution-output/q7.txt",
+       [&] { return bustub::RunReleasePercentageQuery(&bpm, tables["release"], tables["release_info"]); }},
+      {"q8", "solution/q8_collaborate_artist.sql", "solution-output/q8.txt",
+       [&] { return bustub::RunCollaborateArtistQuery(&bpm, tables["artist_credit_name"]); }},
+  };
+  std::printf("expected rows from %s, best of %zu runs\n",
+              homework_db ? "solution-output" : "sqlite3 running the solution SQL", runs);
+  bool all_match = true;
+  for (const auto &query : queries) {
+    std::string sql;
+    if (!bustub::ReadFile(dir + query.solution_sql_, &sql)) {
+      std::fprintf(stderr, "could not read %s%s\n", dir.c_str(), query.solution_sql_);
+      sqlite3_close(db);
+      return 2;
+    }
+
+    std::vector<std::string> rows;
+    double engine_ms = bustub::BestOf(runs, [&] { rows = query.run_(); });
+    std::vector<std::string> sqlite_rows;
+    bool sqlite_ok = true;
+    double sqlite_ms = bustub::BestOf(runs, [&] {
+      sqlite_rows.clear();
+      sqlite_ok = bustub::RunSqlite(db, sql, &sqlite_rows) && sqlite_ok;
+    });
+
+    std::vector<std::string> expected;
+    if (homework_db && !bustub::ReadRows(dir + query.solution_output_, &expected)) {
+      std::fprintf(stderr, "could not read %s%s\n", dir.c_str(), query.solution_output_);
+      sqlite3_close(db);
+      return 2;
+    }
+    bool match = sqlite_ok && bustub::CompareRows(query.name_, rows, homework_db ? expected : sqlite_rows);
+    all_match = all_match && match;
+    std::printf("%s: %zu rows %s, engine %.1f ms, sqlite3 %.1f ms\n", query.name_, rows.size(),
+                match ? "match" : "DIFFER", engine_ms, sqlite_ms);
+  }
+  sqlite3_close(db);
+  return all_match ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_bench.cpp
+//
+// Identification: tools/replacer_bench/replacer_bench.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Replays page reference traces against one buffer pool per replacement policy and prints the hit ratio of each.
+// The pool sits on a SimulatedDiskManager in virtual time, so a run takes seconds and gives the same numbers on any
+// machine. Usage: replacer_bench [pool_size] [num_pages] [num_refs]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/simulated_disk_manager.h"
+
+namespace bustub {
+namespace {
+
+/** A trace hands out the next page to reference; it may also delete and create pages through the pool. */
+using Trace = std::function<page_id_t(BufferPoolManagerInstance *bpm, std::mt19937_64 *rng)>;
+
+/** Draws ranks 0..n-1 with probability proportional to 1 / (rank + 1)^theta. */
+class ZipfGenerator {
+ public:
+  ZipfGenerator(size_t n, double theta) : cdf_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+      this->cdf_[i] = sum;
+    }
+    for (auto &c : this->cdf_) {
+      c /= sum;
+    }
+  }
+
+  auto Next(std::mt19937_64 *rng) -> size_t {
+    double u = std::uniform_real_distribution<double>(0, 1)(*rng);
+    auto it = std::lower_bound(this->cdf_.begin(), this->cdf_.end(), u);
+    return std::min(static_cast<size_t>(it - this->cdf_.begin()), this->cdf_.size() - 1);
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+struct TraceSpec {
+  std::string name_;
+  std::function<Trace()> make_;
+};
+
+auto MakeTraces(size_t pool_size, size_t num_pages) -> std::vector<TraceSpec> {
+  auto hot_size = pool_size / 2;
+  std::vector<TraceSpec> traces;
+
+  // Skewed point lookups, the way an index with a popular key range is hit.
+  traces.push_back({"zipf 0.99", [=] {
+                      auto zipf = std::make_shared<ZipfGenerator>(num_pages, 0.99);
+                      // Scatter the ranks so that popular pages are not neighbours.
+                      auto perm = std::make_shared<std::vector<page_id_t>>(num_pages);
+                      for (size_t i = 0; i < num_pages; ++i) {
+                        (*perm)[i] = static_cast<page_id_t>(i);
+                      }
+                      std::shuffle(perm->begin(), perm->end(), std::mt19937_64(1));
+                      return [=](BufferPoolManagerInstance *, std::mt19937_64 *rng) {
+                        return (*perm)[zipf->Next(rng)];
+                      };
+                    }});
+
+  // A hot set that fits in half the pool, read 3 times out of 4, interleaved with long sequential scans.
+  traces.push_back({"hot set + scans", [=] {
+                      auto scan = std::make_shared<size_t>(0);
+                      return [=](BufferPoolManagerInstance *, std::mt19937_64 *rng) {
+                        if ((*rng)() % 4 != 0) {
+                          return static_cast<page_id_t>((*rng)() % hot_size);
+                        }
+                        auto page = hot_size + (*scan)++ % (num_pages - hot_size);
+                        return static_cast<page_id_t>(page);
+                      };
+                    }});
+
+  // A loop over 1.2 times the pool: LRU always evicts the page needed next.
+  traces.push_back({"loop 1.2x pool", [=] {
+                      auto next = std::make_shared<size_t>(0);
+                      auto loop = pool_size * 6 / 5;
+                      return [=](BufferPoolManagerInstance *, std::mt19937_64 *) {
+                        return static_cast<page_id_t>((*next)++ % loop);
+                      };
+                    }});
+
+  // Phases of skewed lookups alternating with phases of pure scanning, as when reports run next to transactions.
+  traces.push_back({"oltp / scan phases", [=] {
+                      auto zipf = std::make_shared<ZipfGenerator>(num_pages / 4, 0.9);
+                      auto step = std::make_shared<size_t>(0);
+                      auto scan = std::make_shared<size_t>(0);
+                      auto phase = pool_size * 20;
+                      return [=](BufferPoolManagerInstance *, std::mt19937_64 *rng) {
+                        if ((*step)++ / phase % 4 == 3) {
+                          return static_cast<page_id_t>(num_pages / 4 + (*scan)++ % (num_pages * 3 / 4));
+                        }
+                        return static_cast<page_id_t>(zipf->Next(rng));
+                      };
+                    }});
+
+  // A hot set that moves to other pages every so often; a policy must forget the old one quickly.
+  traces.push_back({"shifting hot set", [=] {
+                      auto step = std::make_shared<size_t>(0);
+                      auto period = pool_size * 30;
+                      return [=](BufferPoolManagerInstance *, std::mt19937_64 *rng) {
+                        auto base = (*step)++ / period * hot_size % (num_pages - hot_size);
+                        if ((*rng)() % 10 != 0) {
+                          return static_cast<page_id_t>(base + (*rng)() % hot_size);
+                        }
+                        return static_cast<page_id_t>((*rng)() % num_pages);
+                      };
+                    }});
+
+  // Skewed lookups while pages are dropped from the pool, leaving frames that hold no page.
+  traces.push_back({"zipf + delete churn", [=] {
+                      auto zipf = std::make_shared<ZipfGenerator>(num_pages, 0.99);
+                      auto step = std::make_shared<size_t>(0);
+                      return [=](BufferPoolManagerInstance *bpm, std::mt19937_64 *rng) {
+                        auto page = static_cast<page_id_t>(zipf->Next(rng));
+                        if (++*step % 8 == 0) {
+                          // Dropping the page frees its frame; the next reference reads it back.
+                          bpm->DeletePage(page);
+                          return static_cast<page_id_t>(zipf->Next(rng));
+                        }
+                        return page;
+                      };
+                    }});
+  return traces;
+}
+
+/** @return the hit ratio of the pool over the trace, not counting the first num_refs / 5 references */
+auto Run(ReplacerType replacer_type, const TraceSpec &spec, size_t pool_size, size_t num_pages, size_t num_refs)
+    -> double {
+  SimulatedDiskManager disk_manager(DeviceProfile::NVMe(), 0, true);
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager, nullptr, replacer_type);
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    if (bpm.NewPage(&page_id) != nullptr) {
+      bpm.UnpinPage(page_id, true);
+    }
+  }
+
+  std::mt19937_64 rng(42);
+  auto trace = spec.make_();
+  auto warmup = num_refs / 5;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  for (size_t i = 0; i < num_refs; ++i) {
+    if (i == warmup) {
+      hits = bpm.GetStats().pool_.hits_.load();
+      misses = bpm.GetStats().pool_.misses_.load();
+    }
+    page_id_t page_id = trace(&bpm, &rng);
+    if (bpm.FetchPage(page_id) != nullptr) {
+      bpm.UnpinPage(page_id, false);
+    }
+  }
+  hits = bpm.GetStats().pool_.hits_.load() - hits;
+  misses = bpm.GetStats().pool_.misses_.load() - misses;
+  return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  using bustub::ReplacerType;
+  size_t pool_size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+  size_t num_pages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+  size_t num_refs = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 500000;
+
+  const std::vector<std::pair<const char *, ReplacerType>> replacers = {
+      {"LRU", ReplacerType::LRU},
+      {"ARC", ReplacerType::ARC},
+      {"TinyLFU", ReplacerType::TINY_LFU},
+      {"BufferedLRU", ReplacerType::BUFFERED_LRU},
+  };
+
+  std::printf("pool %zu pages, %zu pages on disk, %zu references, hit ratio after warm-up\n", pool_size, num_pages,
+              num_refs);
+  std::printf("%-22s", "trace");
+  for (const auto &[name, type] : replacers) {
+    std::printf("%12s", name);
+  }
+  std::printf("\n");
+  for (const auto &spec : bustub::MakeTraces(pool_size, num_pages)) {
+    std::printf("%-22s", spec.name_.c_str());
+    for (const auto &[name, type] : replacers) {
+      std::printf("%11.1f%%", 100 * bustub::Run(type, spec, pool_size, num_pages, num_refs));
+      std::fflush(stdout);
+    }
+    std::printf("\n");
+  }
+  return 0;
+}